@@ -1,4 +1,4 @@
-QT       += core gui widgets printsupport svg xml
+QT       += core gui widgets printsupport svg concurrent
 
 CONFIG += c++17
 
@@ -18,11 +18,30 @@ SOURCES += \
     src/core/conceptnode.cpp \
     src/core/conceptedge.cpp \
     src/core/conceptmap.cpp \
+    src/core/idregistry.cpp \
+    src/core/nodegeometry.cpp \
+    src/core/edgegeometry.cpp \
+    src/core/stringpool.cpp \
+    src/core/changeset.cpp \
+    src/core/operationprogress.cpp \
+    src/core/backgroundtask.cpp \
+    src/core/recordbatch.cpp \
+    src/core/jsonstream.cpp \
+    src/core/conceptmapjson.cpp \
+    src/core/conceptmapxml.cpp \
+    src/core/conceptmapbinary.cpp \
+    src/core/conceptmapcompressed.cpp \
+    src/core/recordstream.cpp \
+    src/core/conceptmaptiles.cpp \
+    src/core/conceptmapjournal.cpp \
     src/core/conceptmapserializer.cpp \
+    src/core/maprenderer.cpp \
     src/graphics/graphicsnode.cpp \
     src/graphics/graphicsedge.cpp \
     src/graphics/graphicsscene.cpp \
     src/graphics/graphicsview.cpp \
+    src/graphics/textlayoutcache.cpp \
+    src/graphics/rendercachemanager.cpp \
     src/commands/addnodecommand.cpp \
     src/commands/addedgecommand.cpp \
     src/commands/deletenodecommand.cpp \
@@ -33,6 +52,8 @@ SOURCES += \
     src/models/mapmodel.cpp \
     src/managers/stylemanager.cpp \
     src/managers/filemanager.cpp \
+    src/managers/filemanagerexport.cpp \
+    src/managers/thumbnailprovider.cpp \
     src/ui/mainwindow.cpp \
     src/ui/toolbar.cpp \
     src/ui/propertypanel.cpp \
@@ -42,10 +63,34 @@ HEADERS += \
     src/core/conceptnode.h \
     src/core/conceptedge.h \
     src/core/conceptmap.h \
+    src/core/slotmap.h \
+    src/core/chunkedvector.h \
+    src/core/chunkedhash.h \
+    src/core/idregistry.h \
+    src/core/nodegeometry.h \
+    src/core/edgegeometry.h \
+    src/core/stringpool.h \
+    src/core/changeset.h \
+    src/core/operationprogress.h \
+    src/core/backgroundtask.h \
+    src/core/recordbatch.h \
+    src/core/jsonstream.h \
+    src/core/conceptmapjson.h \
+    src/core/conceptmapxml.h \
+    src/core/conceptmapbinary.h \
+    src/core/conceptmapcompressed.h \
+    src/core/recordstream.h \
+    src/core/conceptmaptiles.h \
+    src/core/conceptmapjournal.h \
+    src/core/conceptmapserializer.h \
+    src/core/maprenderer.h \
     src/graphics/graphicsnode.h \
+    src/graphics/detaillevel.h \
     src/graphics/graphicsedge.h \
     src/graphics/graphicsscene.h \
     src/graphics/graphicsview.h \
+    src/graphics/textlayoutcache.h \
+    src/graphics/rendercachemanager.h \
     src/commands/addnodecommand.h \
     src/commands/addedgecommand.h \
     src/commands/deletenodecommand.h \
@@ -56,6 +101,7 @@ HEADERS += \
     src/models/mapmodel.h \
     src/managers/stylemanager.h \
     src/managers/filemanager.h \
+    src/managers/thumbnailprovider.h \
     src/ui/mainwindow.h \
     src/ui/toolbar.h \
     src/ui/propertypanel.h
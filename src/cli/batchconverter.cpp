@@ -0,0 +1,303 @@
+#include "batchconverter.h"
+#include "filemanager.h"
+#include "conceptmap.h"
+#include "idregistry.h"
+#include "maprenderer.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QtConcurrent/QtConcurrentMap>
+#include <cmath>
+
+namespace {
+
+QtMessageHandler previousHandler = nullptr;        // run() 之前的消息处理函数
+thread_local QStringList* currentMessages = nullptr;  // 当前线程正在处理的文件的消息
+
+/**
+ * @brief 把处理文件时输出的警告记到该文件的结果中，其余消息交给原来的处理函数
+ */
+void captureMessage(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    if (currentMessages && type != QtDebugMsg && type != QtInfoMsg) {
+        currentMessages->append(message);
+        return;
+    }
+    previousHandler(type, context, message);
+}
+
+/**
+ * @brief 在作用域内把当前线程的警告记到指定列表
+ */
+class MessageCapture
+{
+public:
+    explicit MessageCapture(QStringList* messages) { currentMessages = messages; }
+    ~MessageCapture() { currentMessages = nullptr; }
+};
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ * @param command 批处理命令
+ */
+BatchConverter::BatchConverter(Command command)
+    : m_command(command)
+    , m_outputFormat(command == Command::Render ? QStringLiteral("png") : QStringLiteral("json"))
+    , m_renderSize(0)
+    , m_threadCount(qMax(1, QThread::idealThreadCount()))
+{
+}
+
+/**
+ * @brief 设置输出格式
+ * @param suffix 扩展名：转换时为 supportedFormats() 之一，渲染时为 imageFormats() 之一
+ * @return 如果支持该格式返回 true，否则返回 false
+ */
+bool BatchConverter::setOutputFormat(const QString& suffix)
+{
+    const QString format = suffix.toLower();
+    const QStringList formats = m_command == Command::Render ? imageFormats() : supportedFormats();
+    if (!formats.contains(format)) {
+        return false;
+    }
+    m_outputFormat = format;
+    return true;
+}
+
+/**
+ * @brief 处理全部文件（阻塞到全部完成）
+ * @param inputPaths 输入文件
+ * @return 与输入文件一一对应的结果
+ */
+QVector<BatchConverter::Result> BatchConverter::run(const QStringList& inputPaths) const
+{
+    QVector<Result> results(inputPaths.size());
+    for (int i = 0; i < results.size(); ++i) {
+        results[i].inputPath = inputPaths.at(i);
+    }
+
+    const bool writesFiles = m_command == Command::Convert || m_command == Command::Render;
+    if (writesFiles && !m_outputDirectory.isEmpty() && !QDir().mkpath(m_outputDirectory)) {
+        for (Result& result : results) {
+            result.messages.append(QStringLiteral("无法创建输出目录: %1").arg(m_outputDirectory));
+        }
+        return results;
+    }
+
+    // 转换前先排除会写到同一个输出文件的输入，避免并行写入时互相覆盖
+    QVector<Result*> pending;
+    pending.reserve(results.size());
+    QHash<QString, QString> outputs;
+    for (Result& result : results) {
+        if (writesFiles) {
+            result.outputPath = outputPathFor(result.inputPath);
+            const QString output = QFileInfo(result.outputPath).absoluteFilePath();
+            if (output == QFileInfo(result.inputPath).absoluteFilePath()) {
+                result.messages.append(QStringLiteral("输出文件与输入文件相同"));
+                continue;
+            }
+            const auto existing = outputs.constFind(output);
+            if (existing != outputs.constEnd()) {
+                result.messages.append(QStringLiteral("与 %1 的输出文件相同").arg(existing.value()));
+                continue;
+            }
+            outputs.insert(output, result.inputPath);
+        }
+        pending.append(&result);
+    }
+
+    previousHandler = qInstallMessageHandler(captureMessage);
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_threadCount);
+    QtConcurrent::blockingMap(&pool, pending, [this](Result* result) {
+        process(*result);
+    });
+    qInstallMessageHandler(previousHandler);
+    return results;
+}
+
+/**
+ * @brief 获取支持的格式
+ * @return 扩展名列表
+ */
+QStringList BatchConverter::supportedFormats()
+{
+    return { QStringLiteral("json"), QStringLiteral("xml"), QStringLiteral("cmap"),
+             QStringLiteral("cmapb"), QStringLiteral("cmapz"), QStringLiteral("cmapt") };
+}
+
+/**
+ * @brief 获取渲染支持的图片格式
+ * @return 扩展名列表
+ */
+QStringList BatchConverter::imageFormats()
+{
+    return { QStringLiteral("png"), QStringLiteral("jpg"), QStringLiteral("bmp") };
+}
+
+/**
+ * @brief 展开命令行给出的路径
+ * @param paths 文件或目录
+ * @return 文件列表
+ */
+QStringList BatchConverter::expandInputs(const QStringList& paths)
+{
+    QStringList nameFilters;
+    for (const QString& format : supportedFormats()) {
+        nameFilters.append(QStringLiteral("*.") + format);
+    }
+
+    QStringList files;
+    for (const QString& path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            files.append(path);
+            continue;
+        }
+        QStringList found;
+        QDirIterator it(path, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            found.append(it.next());
+        }
+        found.sort();
+        files.append(found);
+    }
+    return files;
+}
+
+/**
+ * @brief 处理一个文件（在线程池中调用）
+ * @param result 处理结果，调用前已设置 inputPath
+ */
+void BatchConverter::process(Result& result) const
+{
+    const MessageCapture capture(&result.messages);
+    result.inputBytes = QFileInfo(result.inputPath).size();
+
+    // 每个文件使用私有的句柄表，处理完连同驻留的 UUID 一起释放，
+    // 批量处理大量文件时全局句柄表不会增长
+    const IdRegistry::Scope ids;
+
+    // 每个线程使用自己的文件管理器和概念图
+    FileManager files;
+    ConceptMap map;
+    QElapsedTimer timer;
+    timer.start();
+    const bool loaded = files.loadMap(result.inputPath, map);
+    result.loadNanoseconds = timer.nsecsElapsed();
+    if (!loaded) {
+        if (result.messages.isEmpty()) {
+            result.messages.append(QStringLiteral("无法加载文件"));
+        }
+        return;
+    }
+    result.nodeCount = map.nodeCount();
+    result.edgeCount = map.edgeCount();
+
+    switch (m_command) {
+    case Command::Convert: {
+        timer.restart();
+        const bool saved = files.saveMap(result.outputPath, map);
+        result.saveNanoseconds = timer.nsecsElapsed();
+        if (!saved) {
+            result.messages.append(QStringLiteral("无法保存文件: %1").arg(result.outputPath));
+            return;
+        }
+        result.outputBytes = QFileInfo(result.outputPath).size();
+        result.success = true;
+        break;
+    }
+    case Command::Validate:
+        // 加载时输出的警告（被剔除的记录）同样算作问题
+        validate(map, result);
+        result.success = result.messages.isEmpty();
+        break;
+    case Command::Stats:
+        collectStats(map, result);
+        result.success = true;
+        break;
+    case Command::Render: {
+        timer.restart();
+        const MapRenderer renderer;
+        const QImage image = m_renderSize > 0 ? renderer.render(map, QSize(m_renderSize, m_renderSize))
+                                              : renderer.render(map, 1.0);
+        const bool saved = !image.isNull() && image.save(result.outputPath);
+        result.saveNanoseconds = timer.nsecsElapsed();
+        if (!saved) {
+            result.messages.append(QStringLiteral("无法写入图片: %1").arg(result.outputPath));
+            return;
+        }
+        result.outputBytes = QFileInfo(result.outputPath).size();
+        result.success = true;
+        break;
+    }
+    }
+}
+
+/**
+ * @brief 计算输出路径
+ * @param inputPath 输入文件
+ * @return 输出文件
+ */
+QString BatchConverter::outputPathFor(const QString& inputPath) const
+{
+    const QFileInfo input(inputPath);
+    const QDir directory(m_outputDirectory.isEmpty() ? input.absolutePath() : m_outputDirectory);
+    return directory.filePath(input.completeBaseName() + QLatin1Char('.') + m_outputFormat);
+}
+
+/**
+ * @brief 检查概念图内容，把发现的问题记到结果中
+ * @param map 概念图对象
+ * @param result 处理结果
+ */
+void BatchConverter::validate(const ConceptMap& map, Result& result)
+{
+    for (const ConceptNode& node : map.allNodes()) {
+        if (!std::isfinite(node.x()) || !std::isfinite(node.y())) {
+            result.messages.append(QStringLiteral("节点 %1 的位置无效").arg(IdRegistry::toUuid(node.id())));
+        }
+        if (!(node.width() > 0.0) || !(node.height() > 0.0)) {
+            result.messages.append(QStringLiteral("节点 %1 的大小无效").arg(IdRegistry::toUuid(node.id())));
+        }
+        if (node.text().trimmed().isEmpty()) {
+            result.messages.append(QStringLiteral("节点 %1 没有文本").arg(IdRegistry::toUuid(node.id())));
+        }
+    }
+
+    QSet<QPair<NodeId, NodeId>> endpoints;
+    for (const ConceptEdge& edge : map.allEdges()) {
+        const QPair<NodeId, NodeId> ends(edge.sourceNodeId(), edge.targetNodeId());
+        if (ends.first == ends.second) {
+            result.messages.append(QStringLiteral("连接线 %1 的两端是同一个节点").arg(IdRegistry::toUuid(edge.id())));
+        } else if (endpoints.contains(ends)) {
+            result.messages.append(QStringLiteral("连接线 %1 与另一条连接线的端点相同").arg(IdRegistry::toUuid(edge.id())));
+        } else {
+            endpoints.insert(ends);
+        }
+    }
+}
+
+/**
+ * @brief 统计概念图的结构
+ * @param map 概念图对象
+ * @param result 处理结果
+ */
+void BatchConverter::collectStats(const ConceptMap& map, Result& result)
+{
+    for (const ConceptNode& node : map.allNodes()) {
+        const int degree = map.outEdges(node.id()).size() + map.inEdges(node.id()).size();
+        if (degree == 0) {
+            ++result.isolatedNodeCount;
+        }
+        result.maxDegree = qMax(result.maxDegree, degree);
+    }
+    result.bounds = map.nodesBoundingRect();
+}
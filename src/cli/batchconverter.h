@@ -0,0 +1,157 @@
+#ifndef BATCHCONVERTER_H
+#define BATCHCONVERTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QRectF>
+
+class ConceptMap;
+
+/**
+ * @brief 命令行批处理：在线程池中转换、校验、统计或渲染多个概念图文件
+ *
+ * 每个文件由线程池中的一个线程独立处理（各自的 FileManager 和 ConceptMap），
+ * 大文件的读写函数内部仍会使用全局线程池并行解析。处理期间安装消息处理函数，
+ * 把处理某个文件时输出的警告（例如加载时被剔除的记录）记到这个文件的结果中，
+ * 不与其他文件的输出交错。
+ *
+ * 渲染用 MapRenderer 离屏绘制，需要 QGuiApplication（可以使用 offscreen 平台）。
+ *
+ * 结果与输入文件一一对应、顺序相同，计时均为单调时钟的纳秒数。
+ */
+class BatchConverter
+{
+public:
+    /**
+     * @brief 批处理命令
+     */
+    enum class Command {
+        Convert,    // 转换为另一种格式
+        Validate,   // 加载并检查内容
+        Stats,      // 加载并统计
+        Render      // 绘制成图片
+    };
+
+    /**
+     * @brief 单个文件的处理结果
+     */
+    struct Result
+    {
+        QString inputPath;          // 输入文件
+        QString outputPath;         // 输出文件（转换和渲染）
+        bool success = false;       // 是否成功（校验发现问题也算失败）
+        QStringList messages;       // 错误、加载警告和校验发现的问题
+        qint64 inputBytes = 0;      // 输入文件字节数
+        qint64 outputBytes = 0;     // 输出文件字节数（转换和渲染）
+        qint64 loadNanoseconds = 0; // 加载耗时
+        qint64 saveNanoseconds = 0; // 保存耗时（转换），或绘制和写图片的耗时（渲染）
+        int nodeCount = 0;          // 节点数量
+        int edgeCount = 0;          // 连接线数量
+        int isolatedNodeCount = 0;  // 没有连接线的节点数量（仅统计）
+        int maxDegree = 0;          // 节点的最大连接线数量（仅统计）
+        QRectF bounds;              // 节点范围（仅统计）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param command 批处理命令
+     */
+    explicit BatchConverter(Command command);
+
+    /**
+     * @brief 设置输出格式
+     * @param suffix 扩展名：转换时为 supportedFormats() 之一，渲染时为 imageFormats() 之一
+     * @return 如果支持该格式返回 true，否则返回 false
+     */
+    bool setOutputFormat(const QString& suffix);
+
+    /**
+     * @brief 设置渲染图片的最大边长
+     * @param size 边长（像素），0 表示按 1:1 绘制整个概念图
+     */
+    void setRenderSize(int size) { m_renderSize = qMax(0, size); }
+
+    /**
+     * @brief 设置输出目录
+     * @param directory 输出目录，空字符串表示与输入文件相同的目录
+     */
+    void setOutputDirectory(const QString& directory) { m_outputDirectory = directory; }
+
+    /**
+     * @brief 设置并行处理的文件数
+     * @param count 线程数，小于 1 时使用 1
+     */
+    void setThreadCount(int count) { m_threadCount = qMax(1, count); }
+
+    /**
+     * @brief 获取并行处理的文件数
+     * @return 线程数
+     */
+    int threadCount() const { return m_threadCount; }
+
+    /**
+     * @brief 处理全部文件（阻塞到全部完成）
+     * @param inputPaths 输入文件
+     * @return 与输入文件一一对应的结果
+     */
+    QVector<Result> run(const QStringList& inputPaths) const;
+
+    /**
+     * @brief 获取支持的格式
+     * @return 扩展名列表
+     */
+    static QStringList supportedFormats();
+
+    /**
+     * @brief 获取渲染支持的图片格式
+     * @return 扩展名列表
+     */
+    static QStringList imageFormats();
+
+    /**
+     * @brief 展开命令行给出的路径
+     *
+     * 文件原样保留；目录递归查找其中支持格式的文件，按路径排序。
+     *
+     * @param paths 文件或目录
+     * @return 文件列表
+     */
+    static QStringList expandInputs(const QStringList& paths);
+
+private:
+    /**
+     * @brief 处理一个文件（在线程池中调用）
+     * @param result 处理结果，调用前已设置 inputPath
+     */
+    void process(Result& result) const;
+
+    /**
+     * @brief 计算输出路径
+     * @param inputPath 输入文件
+     * @return 输出文件
+     */
+    QString outputPathFor(const QString& inputPath) const;
+
+    /**
+     * @brief 检查概念图内容，把发现的问题记到结果中
+     * @param map 概念图对象
+     * @param result 处理结果
+     */
+    static void validate(const ConceptMap& map, Result& result);
+
+    /**
+     * @brief 统计概念图的结构
+     * @param map 概念图对象
+     * @param result 处理结果
+     */
+    static void collectStats(const ConceptMap& map, Result& result);
+
+    Command m_command;              // 批处理命令
+    QString m_outputFormat;         // 输出格式
+    QString m_outputDirectory;      // 输出目录
+    int m_renderSize;               // 渲染图片的最大边长，0 表示 1:1
+    int m_threadCount;              // 并行处理的文件数
+};
+
+#endif // BATCHCONVERTER_H
@@ -0,0 +1,72 @@
+# 命令行工具 conceptmap-cli：批量转换、校验、统计和渲染概念图文件
+# 只使用核心模块和文件管理器，不依赖 Widgets
+
+QT       = core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = conceptmap-cli
+
+# 设置包含路径
+INCLUDEPATH += ../core \
+               ../managers
+
+SOURCES += \
+    ../core/conceptnode.cpp \
+    ../core/conceptedge.cpp \
+    ../core/conceptmap.cpp \
+    ../core/idregistry.cpp \
+    ../core/nodegeometry.cpp \
+    ../core/edgegeometry.cpp \
+    ../core/stringpool.cpp \
+    ../core/changeset.cpp \
+    ../core/operationprogress.cpp \
+    ../core/backgroundtask.cpp \
+    ../core/recordbatch.cpp \
+    ../core/jsonstream.cpp \
+    ../core/conceptmapjson.cpp \
+    ../core/conceptmapxml.cpp \
+    ../core/conceptmapbinary.cpp \
+    ../core/conceptmapcompressed.cpp \
+    ../core/recordstream.cpp \
+    ../core/conceptmaptiles.cpp \
+    ../core/conceptmapjournal.cpp \
+    ../core/conceptmapserializer.cpp \
+    ../core/maprenderer.cpp \
+    ../managers/filemanager.cpp \
+    batchconverter.cpp \
+    main.cpp
+
+HEADERS += \
+    ../core/conceptnode.h \
+    ../core/conceptedge.h \
+    ../core/conceptmap.h \
+    ../core/slotmap.h \
+    ../core/chunkedvector.h \
+    ../core/chunkedhash.h \
+    ../core/idregistry.h \
+    ../core/nodegeometry.h \
+    ../core/edgegeometry.h \
+    ../core/stringpool.h \
+    ../core/changeset.h \
+    ../core/operationprogress.h \
+    ../core/backgroundtask.h \
+    ../core/recordbatch.h \
+    ../core/jsonstream.h \
+    ../core/conceptmapjson.h \
+    ../core/conceptmapxml.h \
+    ../core/conceptmapbinary.h \
+    ../core/conceptmapcompressed.h \
+    ../core/recordstream.h \
+    ../core/conceptmaptiles.h \
+    ../core/conceptmapjournal.h \
+    ../core/conceptmapserializer.h \
+    ../core/maprenderer.h \
+    ../managers/filemanager.h \
+    batchconverter.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,240 @@
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QScopedPointer>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QFileInfo>
+#include "batchconverter.h"
+
+namespace {
+
+constexpr int MaxMessagesPerFile = 20;  // 每个文件最多列出的消息条数
+
+/**
+ * @brief 把纳秒格式化为毫秒
+ */
+QString formatMilliseconds(qint64 nanoseconds)
+{
+    return QString::number(nanoseconds / 1e6, 'f', 1) + QStringLiteral(" ms");
+}
+
+/**
+ * @brief 输出单个文件的结果
+ */
+void printResult(QTextStream& out, BatchConverter::Command command, const BatchConverter::Result& result, bool quiet)
+{
+    if (quiet && result.success) {
+        return;
+    }
+
+    const QString status = result.success ? QStringLiteral("OK  ") : QStringLiteral("FAIL");
+    out << status << "  " << result.inputPath;
+    switch (command) {
+    case BatchConverter::Command::Convert:
+    case BatchConverter::Command::Render:
+        if (!result.outputPath.isEmpty()) {
+            out << " -> " << result.outputPath;
+        }
+        out << "  载入 " << formatMilliseconds(result.loadNanoseconds)
+            << (command == BatchConverter::Command::Render ? "  渲染 " : "  保存 ")
+            << formatMilliseconds(result.saveNanoseconds);
+        break;
+    case BatchConverter::Command::Validate:
+        out << "  载入 " << formatMilliseconds(result.loadNanoseconds);
+        break;
+    case BatchConverter::Command::Stats: {
+        const QRectF& bounds = result.bounds;
+        out << "  载入 " << formatMilliseconds(result.loadNanoseconds)
+            << "  字节 " << result.inputBytes
+            << "  孤立节点 " << result.isolatedNodeCount
+            << "  最大度 " << result.maxDegree
+            << "  范围 (" << bounds.x() << ", " << bounds.y() << ", "
+            << bounds.width() << " x " << bounds.height() << ")";
+        break;
+    }
+    }
+    out << "  节点 " << result.nodeCount << "  连接线 " << result.edgeCount << Qt::endl;
+
+    const int shown = qMin(int(result.messages.size()), MaxMessagesPerFile);
+    for (int i = 0; i < shown; ++i) {
+        out << "      " << result.messages.at(i) << Qt::endl;
+    }
+    if (result.messages.size() > shown) {
+        out << "      …… 另有 " << result.messages.size() - shown << " 条" << Qt::endl;
+    }
+}
+
+/**
+ * @brief 输出汇总：成功和失败数量、总耗时、吞吐量和最慢的文件
+ */
+void printSummary(QTextStream& out, const QVector<BatchConverter::Result>& results, qint64 elapsed, int threads)
+{
+    int succeeded = 0;
+    qint64 bytes = 0;
+    qint64 records = 0;
+    qint64 fileTime = 0;
+    const BatchConverter::Result* slowest = nullptr;
+    for (const BatchConverter::Result& result : results) {
+        if (result.success) {
+            ++succeeded;
+        }
+        bytes += result.inputBytes;
+        records += result.nodeCount + result.edgeCount;
+        const qint64 time = result.loadNanoseconds + result.saveNanoseconds;
+        fileTime += time;
+        if (!slowest || time > slowest->loadNanoseconds + slowest->saveNanoseconds) {
+            slowest = &result;
+        }
+    }
+
+    const double seconds = qMax(elapsed, qint64(1)) / 1e9;
+    out << Qt::endl
+        << "文件 " << results.size() << "（成功 " << succeeded << "，失败 " << results.size() - succeeded
+        << "），线程 " << threads << Qt::endl
+        << "总耗时 " << QString::number(seconds, 'f', 2) << " s"
+        << "，吞吐量 " << QString::number(results.size() / seconds, 'f', 1) << " 文件/s"
+        << "，" << QString::number(bytes / seconds / (1024.0 * 1024.0), 'f', 1) << " MiB/s"
+        << "，" << QString::number(records / seconds, 'f', 0) << " 记录/s" << Qt::endl;
+    if (slowest) {
+        out << "单文件耗时 平均 " << formatMilliseconds(fileTime / results.size())
+            << "，最长 " << formatMilliseconds(slowest->loadNanoseconds + slowest->saveNanoseconds)
+            << "（" << slowest->inputPath << "）" << Qt::endl;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 命令行工具的主函数
+ *
+ * conceptmap-cli convert|validate|stats|render [选项] 文件或目录...
+ * 全部成功返回 0，有文件失败返回 1，参数错误返回 2。
+ * render 需要 QGuiApplication，没有设置 QT_QPA_PLATFORM 时使用 offscreen 平台，
+ * 不需要显示器。
+ *
+ * @param argc 参数计数
+ * @param argv 参数向量
+ * @return 退出码
+ */
+int main(int argc, char* argv[])
+{
+    // 只有渲染需要字体和绘制，其他命令不加载平台插件
+    const bool render = argc > 1 && qstrcmp(argv[1], "render") == 0;
+    if (render && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QScopedPointer<QCoreApplication> app(render ? new QGuiApplication(argc, argv)
+                                                : new QCoreApplication(argc, argv));
+    app->setApplicationName("conceptmap-cli");
+    app->setApplicationVersion("1.0.0");
+    app->setOrganizationName("ConceptMap");
+
+    const QString formats = BatchConverter::supportedFormats().join(QStringLiteral(", "));
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("批量转换、校验、统计和渲染概念图文件（%1）。\n"
+                       "  convert   转换为 --to 指定的格式\n"
+                       "  validate  加载并检查内容\n"
+                       "  stats     加载并统计结构\n"
+                       "  render    绘制成图片（%2）").arg(formats, BatchConverter::imageFormats().join(QStringLiteral(", "))));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", "convert、validate、stats 或 render");
+    parser.addPositionalArgument("paths", "概念图文件或目录（递归查找）", "<路径...>");
+
+    const QCommandLineOption toOption({ "t", "to" }, QStringLiteral("转换的目标格式（%1），渲染的图片格式（默认 png）").arg(formats), "format");
+    const QCommandLineOption outputOption({ "o", "output-dir" }, "转换或渲染的输出目录，默认与输入文件相同", "dir");
+    const QCommandLineOption sizeOption({ "s", "size" }, "渲染图片的最大边长，默认按 1:1 绘制", "px");
+    const QCommandLineOption jobsOption({ "j", "jobs" }, "并行处理的文件数，默认为处理器核数", "n");
+    const QCommandLineOption quietOption({ "q", "quiet" }, "只输出失败的文件和汇总");
+    parser.addOption(toOption);
+    parser.addOption(outputOption);
+    parser.addOption(sizeOption);
+    parser.addOption(jobsOption);
+    parser.addOption(quietOption);
+    parser.process(*app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() < 2) {
+        err << parser.helpText();
+        return 2;
+    }
+
+    const QString name = arguments.first();
+    BatchConverter::Command command;
+    if (name == "convert") {
+        command = BatchConverter::Command::Convert;
+    } else if (name == "validate") {
+        command = BatchConverter::Command::Validate;
+    } else if (name == "stats") {
+        command = BatchConverter::Command::Stats;
+    } else if (name == "render") {
+        command = BatchConverter::Command::Render;
+    } else {
+        err << "未知命令: " << name << Qt::endl;
+        return 2;
+    }
+
+    BatchConverter converter(command);
+    if (command == BatchConverter::Command::Convert) {
+        if (!parser.isSet(toOption)) {
+            err << "convert 需要 --to 指定目标格式" << Qt::endl;
+            return 2;
+        }
+        if (!converter.setOutputFormat(parser.value(toOption))) {
+            err << "不支持的格式: " << parser.value(toOption) << Qt::endl;
+            return 2;
+        }
+        converter.setOutputDirectory(parser.value(outputOption));
+    }
+    if (command == BatchConverter::Command::Render) {
+        if (parser.isSet(toOption) && !converter.setOutputFormat(parser.value(toOption))) {
+            err << "不支持的图片格式: " << parser.value(toOption) << Qt::endl;
+            return 2;
+        }
+        if (parser.isSet(sizeOption)) {
+            bool ok = false;
+            const int size = parser.value(sizeOption).toInt(&ok);
+            if (!ok || size < 1) {
+                err << "无效的图片边长: " << parser.value(sizeOption) << Qt::endl;
+                return 2;
+            }
+            converter.setRenderSize(size);
+        }
+        converter.setOutputDirectory(parser.value(outputOption));
+    }
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1) {
+            err << "无效的并行数: " << parser.value(jobsOption) << Qt::endl;
+            return 2;
+        }
+        converter.setThreadCount(jobs);
+    }
+
+    const QStringList files = BatchConverter::expandInputs(arguments.mid(1));
+    if (files.isEmpty()) {
+        err << "没有找到概念图文件" << Qt::endl;
+        return 2;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<BatchConverter::Result> results = converter.run(files);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    const bool quiet = parser.isSet(quietOption);
+    bool allSucceeded = true;
+    for (const BatchConverter::Result& result : results) {
+        printResult(out, command, result, quiet);
+        allSucceeded = allSucceeded && result.success;
+    }
+    printSummary(out, results, elapsed, converter.threadCount());
+
+    return allSucceeded ? 0 : 1;
+}
@@ -6,7 +6,7 @@
  * @param edgeId 要删除的连接线ID
  * @param parent 父命令
  */
-DeleteEdgeCommand::DeleteEdgeCommand(GraphicsScene* scene, const QString& edgeId, QUndoCommand* parent)
+DeleteEdgeCommand::DeleteEdgeCommand(GraphicsScene* scene, EdgeId edgeId, QUndoCommand* parent)
     : QUndoCommand(parent)
     , m_scene(scene)
     , m_edgeId(edgeId)
@@ -22,7 +22,7 @@ public:
      * @param edgeId 要删除的连接线ID
      * @param parent 父命令
      */
-    explicit DeleteEdgeCommand(GraphicsScene* scene, const QString& edgeId, QUndoCommand* parent = nullptr);
+    explicit DeleteEdgeCommand(GraphicsScene* scene, EdgeId edgeId, QUndoCommand* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -41,7 +41,7 @@ public:
 
 private:
     GraphicsScene* m_scene;    // 图形场景
-    QString m_edgeId;         // 要删除的连接线ID
+    EdgeId m_edgeId;         // 要删除的连接线ID
     ConceptEdge m_edge;        // 连接线数据
 };
 
@@ -7,7 +7,7 @@
  * @param nodeId 要删除的节点ID
  * @param parent 父命令
  */
-DeleteNodeCommand::DeleteNodeCommand(GraphicsScene* scene, const QString& nodeId, QUndoCommand* parent)
+DeleteNodeCommand::DeleteNodeCommand(GraphicsScene* scene, NodeId nodeId, QUndoCommand* parent)
     : QUndoCommand(parent)
     , m_scene(scene)
     , m_nodeId(nodeId)
@@ -23,7 +23,7 @@ public:
      * @param nodeId 要删除的节点ID
      * @param parent 父命令
      */
-    explicit DeleteNodeCommand(GraphicsScene* scene, const QString& nodeId, QUndoCommand* parent = nullptr);
+    explicit DeleteNodeCommand(GraphicsScene* scene, NodeId nodeId, QUndoCommand* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -42,7 +42,7 @@ public:
 
 private:
     GraphicsScene* m_scene;              // 图形场景
-    QString m_nodeId;                    // 要删除的节点ID
+    NodeId m_nodeId;                    // 要删除的节点ID
     ConceptNode m_node;                   // 节点数据
     QVector<ConceptEdge> m_relatedEdges;  // 相关的连接线数据
 };
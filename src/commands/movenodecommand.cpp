@@ -9,7 +9,7 @@
  * @param newPos 新位置
  * @param parent 父命令
  */
-MoveNodeCommand::MoveNodeCommand(GraphicsScene* scene, const QString& nodeId,
+MoveNodeCommand::MoveNodeCommand(GraphicsScene* scene, NodeId nodeId,
                                  const QPointF& oldPos, const QPointF& newPos,
                                  QUndoCommand* parent)
     : QUndoCommand(parent)
@@ -25,7 +25,7 @@ public:
      * @param newPos 新位置
      * @param parent 父命令
      */
-    explicit MoveNodeCommand(GraphicsScene* scene, const QString& nodeId,
+    explicit MoveNodeCommand(GraphicsScene* scene, NodeId nodeId,
                             const QPointF& oldPos, const QPointF& newPos,
                             QUndoCommand* parent = nullptr);
 
@@ -59,7 +59,7 @@ public:
 
 private:
     GraphicsScene* m_scene;    // 图形场景
-    QString m_nodeId;         // 要移动的节点ID
+    NodeId m_nodeId;         // 要移动的节点ID
     QPointF m_oldPos;         // 旧位置
     QPointF m_newPos;         // 新位置
 };
@@ -0,0 +1,104 @@
+#include "backgroundtask.h"
+#include <QtConcurrent/QtConcurrentRun>
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象
+ */
+BackgroundTask::BackgroundTask(QObject* parent)
+    : QObject(parent)
+    , m_lastPercent(0)
+    , m_pending(false)
+{
+    m_pollTimer.setInterval(PollInterval);
+    connect(&m_pollTimer, &QTimer::timeout, this, &BackgroundTask::pollProgress);
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &BackgroundTask::finish);
+}
+
+/**
+ * @brief 析构函数，取消并等待正在运行的操作（不再发出 finished()）
+ */
+BackgroundTask::~BackgroundTask()
+{
+    if (m_pending) {
+        m_progress->cancel();
+        m_watcher.waitForFinished();
+    }
+}
+
+/**
+ * @brief 开始操作
+ * @param description 操作描述（显示在状态栏）
+ * @param job 在工作线程中执行的操作
+ * @return 如果已有操作在运行返回 false，否则返回 true
+ */
+bool BackgroundTask::start(const QString& description, Job job)
+{
+    if (m_pending) {
+        return false;
+    }
+
+    // 进度由工作线程和界面线程共享，随任务一起释放
+    const QSharedPointer<OperationProgress> progress = QSharedPointer<OperationProgress>::create();
+    m_progress = progress;
+    m_description = description;
+    m_lastPercent = 0;
+    m_pending = true;
+    m_watcher.setFuture(QtConcurrent::run([job = std::move(job), progress]() {
+        return job(*progress);
+    }));
+    m_pollTimer.start();
+
+    emit started(description);
+    emit progressChanged(0);
+    return true;
+}
+
+/**
+ * @brief 请求取消正在运行的操作
+ */
+void BackgroundTask::cancel()
+{
+    if (m_pending) {
+        m_progress->cancel();
+    }
+}
+
+/**
+ * @brief 等待正在运行的操作结束，并在返回前发出 finished()
+ */
+void BackgroundTask::waitForFinished()
+{
+    if (m_pending) {
+        m_watcher.waitForFinished();
+        finish();
+    }
+}
+
+/**
+ * @brief 读取进度，变化时发出 progressChanged()
+ */
+void BackgroundTask::pollProgress()
+{
+    const int percent = m_progress->percent();
+    if (percent != m_lastPercent) {
+        m_lastPercent = percent;
+        emit progressChanged(percent);
+    }
+}
+
+/**
+ * @brief 操作结束后停止定时器并发出 finished()
+ */
+void BackgroundTask::finish()
+{
+    // waitForFinished() 已经处理过时，稍后到达的 finished 信号不再重复处理
+    if (!m_pending) {
+        return;
+    }
+
+    m_pending = false;
+    m_pollTimer.stop();
+    const bool success = m_watcher.result() && !m_progress->isCanceled();
+    emit finished(success);
+}
@@ -0,0 +1,118 @@
+#ifndef BACKGROUNDTASK_H
+#define BACKGROUNDTASK_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <functional>
+#include "operationprogress.h"
+
+/**
+ * @brief 在线程池中运行的单个文件操作
+ *
+ * 同一时间只运行一个操作。操作在工作线程中执行，只能读取交给它的快照或自己的
+ * 数据；界面线程定时读取进度并发出 progressChanged()，操作结束后在界面线程
+ * 发出 finished()。调用 cancel() 后，操作在下一次检查进度时放弃，不修改目标。
+ */
+class BackgroundTask : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 在工作线程中执行的操作
+     *
+     * 参数是本次操作的进度，返回是否成功。
+     */
+    using Job = std::function<bool(OperationProgress& progress)>;
+
+    static constexpr int PollInterval = 100;   // 读取进度的间隔（毫秒）
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象
+     */
+    explicit BackgroundTask(QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数，取消并等待正在运行的操作（不再发出 finished()）
+     */
+    ~BackgroundTask();
+
+    /**
+     * @brief 开始操作
+     * @param description 操作描述（显示在状态栏）
+     * @param job 在工作线程中执行的操作
+     * @return 如果已有操作在运行返回 false，否则返回 true
+     */
+    bool start(const QString& description, Job job);
+
+    /**
+     * @brief 请求取消正在运行的操作
+     */
+    void cancel();
+
+    /**
+     * @brief 等待正在运行的操作结束，并在返回前发出 finished()
+     */
+    void waitForFinished();
+
+    /**
+     * @brief 检查是否有操作在运行（包括已结束但尚未发出 finished() 的操作）
+     * @return 如果有操作在运行返回 true，否则返回 false
+     */
+    bool isRunning() const { return m_pending; }
+
+    /**
+     * @brief 检查最近一次操作是否被取消
+     * @return 如果被取消返回 true，否则返回 false
+     */
+    bool isCanceled() const { return m_progress && m_progress->isCanceled(); }
+
+    /**
+     * @brief 获取最近一次操作的描述
+     * @return 操作描述
+     */
+    QString description() const { return m_description; }
+
+signals:
+    /**
+     * @brief 操作开始信号
+     * @param description 操作描述
+     */
+    void started(const QString& description);
+
+    /**
+     * @brief 进度变化信号
+     * @param percent 完成百分比
+     */
+    void progressChanged(int percent);
+
+    /**
+     * @brief 操作结束信号
+     * @param success 是否成功（被取消时为 false）
+     */
+    void finished(bool success);
+
+private:
+    /**
+     * @brief 读取进度，变化时发出 progressChanged()
+     */
+    void pollProgress();
+
+    /**
+     * @brief 操作结束后停止定时器并发出 finished()
+     */
+    void finish();
+
+    QFutureWatcher<bool> m_watcher;                 // 工作线程中的操作
+    QSharedPointer<OperationProgress> m_progress;   // 本次操作的进度
+    QTimer m_pollTimer;                             // 定时读取进度
+    QString m_description;                          // 操作描述
+    int m_lastPercent;                              // 上次发出的百分比
+    bool m_pending;                                 // 操作尚未发出 finished()
+};
+
+#endif // BACKGROUNDTASK_H
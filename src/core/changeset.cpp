@@ -0,0 +1,275 @@
+#include "changeset.h"
+
+/**
+ * @brief 记录节点插入
+ * @param id 节点ID
+ */
+void ChangeSet::nodeInserted(NodeId id)
+{
+    recordInsert(m_nodes, id, AllNodeFields);
+}
+
+/**
+ * @brief 记录节点删除
+ * @param id 节点ID
+ */
+void ChangeSet::nodeRemoved(NodeId id)
+{
+    recordRemove(m_nodes, id);
+}
+
+/**
+ * @brief 记录节点修改
+ * @param id 节点ID
+ * @param fields 发生变化的字段
+ */
+void ChangeSet::nodeModified(NodeId id, NodeFields fields)
+{
+    recordModify(m_nodes, id, quint32(fields));
+}
+
+/**
+ * @brief 记录连接线插入
+ * @param id 连接线ID
+ */
+void ChangeSet::edgeInserted(EdgeId id)
+{
+    recordInsert(m_edges, id, AllEdgeFields);
+}
+
+/**
+ * @brief 记录连接线删除
+ * @param id 连接线ID
+ */
+void ChangeSet::edgeRemoved(EdgeId id)
+{
+    recordRemove(m_edges, id);
+}
+
+/**
+ * @brief 记录连接线修改
+ * @param id 连接线ID
+ * @param fields 发生变化的字段
+ */
+void ChangeSet::edgeModified(EdgeId id, EdgeFields fields)
+{
+    recordModify(m_edges, id, quint32(fields));
+}
+
+/**
+ * @brief 合并另一份变更记录（按发生顺序排在本记录之后）
+ * @param other 另一份变更记录
+ */
+void ChangeSet::merge(const ChangeSet& other)
+{
+    for (auto it = other.m_nodes.constBegin(); it != other.m_nodes.constEnd(); ++it) {
+        switch (it.value().kind) {
+            case Entry::Inserted: recordInsert(m_nodes, it.key(), AllNodeFields); break;
+            case Entry::Removed: recordRemove(m_nodes, it.key()); break;
+            case Entry::Modified: recordModify(m_nodes, it.key(), it.value().fields); break;
+        }
+    }
+    for (auto it = other.m_edges.constBegin(); it != other.m_edges.constEnd(); ++it) {
+        switch (it.value().kind) {
+            case Entry::Inserted: recordInsert(m_edges, it.key(), AllEdgeFields); break;
+            case Entry::Removed: recordRemove(m_edges, it.key()); break;
+            case Entry::Modified: recordModify(m_edges, it.key(), it.value().fields); break;
+        }
+    }
+}
+
+/**
+ * @brief 获取被插入的节点
+ * @return 节点ID列表
+ */
+QVector<NodeId> ChangeSet::insertedNodes() const
+{
+    return idsOfKind(m_nodes, Entry::Inserted);
+}
+
+/**
+ * @brief 获取被删除的节点
+ * @return 节点ID列表
+ */
+QVector<NodeId> ChangeSet::removedNodes() const
+{
+    return idsOfKind(m_nodes, Entry::Removed);
+}
+
+/**
+ * @brief 获取被修改的节点
+ * @return 节点ID到字段掩码的映射
+ */
+QHash<NodeId, ChangeSet::NodeFields> ChangeSet::modifiedNodes() const
+{
+    QHash<NodeId, NodeFields> result;
+    for (auto it = m_nodes.constBegin(); it != m_nodes.constEnd(); ++it) {
+        if (it.value().kind == Entry::Modified) {
+            result.insert(it.key(), NodeFields(int(it.value().fields)));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 获取被插入的连接线
+ * @return 连接线ID列表
+ */
+QVector<EdgeId> ChangeSet::insertedEdges() const
+{
+    return idsOfKind(m_edges, Entry::Inserted);
+}
+
+/**
+ * @brief 获取被删除的连接线
+ * @return 连接线ID列表
+ */
+QVector<EdgeId> ChangeSet::removedEdges() const
+{
+    return idsOfKind(m_edges, Entry::Removed);
+}
+
+/**
+ * @brief 获取被修改的连接线
+ * @return 连接线ID到字段掩码的映射
+ */
+QHash<EdgeId, ChangeSet::EdgeFields> ChangeSet::modifiedEdges() const
+{
+    QHash<EdgeId, EdgeFields> result;
+    for (auto it = m_edges.constBegin(); it != m_edges.constEnd(); ++it) {
+        if (it.value().kind == Entry::Modified) {
+            result.insert(it.key(), EdgeFields(int(it.value().fields)));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 清空变更记录
+ */
+void ChangeSet::clear()
+{
+    m_nodes.clear();
+    m_edges.clear();
+}
+
+/**
+ * @brief 比较两个节点，得到发生变化的字段
+ * @param before 修改前的节点
+ * @param after 修改后的节点
+ * @return 字段掩码
+ */
+ChangeSet::NodeFields ChangeSet::diff(const ConceptNode& before, const ConceptNode& after)
+{
+    NodeFields fields;
+    if (before.text() != after.text()) {
+        fields |= NodeText;
+    }
+    if (before.pos() != after.pos()) {
+        fields |= NodePosition;
+    }
+    if (before.size() != after.size()) {
+        fields |= NodeSize;
+    }
+    if (before.color() != after.color()) {
+        fields |= NodeColor;
+    }
+    if (before.style() != after.style()) {
+        fields |= NodeStyle;
+    }
+    if (before.shape() != after.shape()) {
+        fields |= NodeShape;
+    }
+    return fields;
+}
+
+/**
+ * @brief 比较两条连接线，得到发生变化的字段
+ * @param before 修改前的连接线
+ * @param after 修改后的连接线
+ * @return 字段掩码
+ */
+ChangeSet::EdgeFields ChangeSet::diff(const ConceptEdge& before, const ConceptEdge& after)
+{
+    EdgeFields fields;
+    if (before.sourceNodeId() != after.sourceNodeId() || before.targetNodeId() != after.targetNodeId()) {
+        fields |= EdgeEndpoints;
+    }
+    if (before.label() != after.label()) {
+        fields |= EdgeLabel;
+    }
+    if (before.color() != after.color()) {
+        fields |= EdgeColor;
+    }
+    if (before.style() != after.style()) {
+        fields |= EdgeStyle;
+    }
+    return fields;
+}
+
+/**
+ * @brief 记录插入：删除后再插入视为全部字段被修改
+ */
+void ChangeSet::recordInsert(QHash<quint32, Entry>& entries, quint32 id, quint32 allFields)
+{
+    auto it = entries.find(id);
+    if (it != entries.end() && it.value().kind == Entry::Removed) {
+        it.value().kind = Entry::Modified;
+        it.value().fields = allFields;
+        return;
+    }
+
+    Entry entry;
+    entry.kind = Entry::Inserted;
+    entries.insert(id, entry);
+}
+
+/**
+ * @brief 记录删除：插入后再删除相互抵消
+ */
+void ChangeSet::recordRemove(QHash<quint32, Entry>& entries, quint32 id)
+{
+    auto it = entries.find(id);
+    if (it != entries.end() && it.value().kind == Entry::Inserted) {
+        entries.erase(it);
+        return;
+    }
+
+    Entry entry;
+    entry.kind = Entry::Removed;
+    entries.insert(id, entry);
+}
+
+/**
+ * @brief 记录修改：插入后的修改不单独记录，多次修改合并字段掩码
+ */
+void ChangeSet::recordModify(QHash<quint32, Entry>& entries, quint32 id, quint32 fields)
+{
+    if (fields == 0) {
+        return;
+    }
+
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        Entry entry;
+        entry.kind = Entry::Modified;
+        entry.fields = fields;
+        entries.insert(id, entry);
+    } else if (it.value().kind == Entry::Modified) {
+        it.value().fields |= fields;
+    }
+}
+
+/**
+ * @brief 收集指定类型的变更ID
+ */
+QVector<quint32> ChangeSet::idsOfKind(const QHash<quint32, Entry>& entries, Entry::Kind kind)
+{
+    QVector<quint32> ids;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (it.value().kind == kind) {
+            ids.append(it.key());
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,188 @@
+#ifndef CHANGESET_H
+#define CHANGESET_H
+
+#include <QHash>
+#include <QVector>
+#include <QFlags>
+#include "conceptnode.h"
+#include "conceptedge.h"
+
+/**
+ * @brief 概念图变更记录
+ *
+ * 记录一次事务中被插入、删除和修改的节点与连接线ID，修改记录带有字段掩码，
+ * 说明哪些字段发生了变化。同一个元素的多次变更会被合并：
+ * - 插入后再修改仍记为插入
+ * - 插入后再删除相互抵消
+ * - 删除后再插入（例如撤销）记为全部字段被修改
+ *
+ * 视图、索引和保存器根据变更记录只处理受影响的元素，而不必整体重建。
+ */
+class ChangeSet
+{
+public:
+    /**
+     * @brief 节点字段
+     */
+    enum NodeField {
+        NodeText     = 0x01,    // 文本
+        NodePosition = 0x02,    // 位置
+        NodeSize     = 0x04,    // 尺寸
+        NodeColor    = 0x08,    // 颜色
+        NodeStyle    = 0x10,    // 样式
+        NodeShape    = 0x20,    // 形状
+        AllNodeFields = 0x3F
+    };
+    Q_DECLARE_FLAGS(NodeFields, NodeField)
+
+    /**
+     * @brief 连接线字段
+     */
+    enum EdgeField {
+        EdgeEndpoints = 0x01,   // 源节点或目标节点
+        EdgeLabel     = 0x02,   // 标签
+        EdgeColor     = 0x04,   // 颜色
+        EdgeStyle     = 0x08,   // 样式
+        AllEdgeFields = 0x0F
+    };
+    Q_DECLARE_FLAGS(EdgeFields, EdgeField)
+
+    // 记录变更
+    /**
+     * @brief 记录节点插入
+     * @param id 节点ID
+     */
+    void nodeInserted(NodeId id);
+
+    /**
+     * @brief 记录节点删除
+     * @param id 节点ID
+     */
+    void nodeRemoved(NodeId id);
+
+    /**
+     * @brief 记录节点修改
+     * @param id 节点ID
+     * @param fields 发生变化的字段
+     */
+    void nodeModified(NodeId id, NodeFields fields);
+
+    /**
+     * @brief 记录连接线插入
+     * @param id 连接线ID
+     */
+    void edgeInserted(EdgeId id);
+
+    /**
+     * @brief 记录连接线删除
+     * @param id 连接线ID
+     */
+    void edgeRemoved(EdgeId id);
+
+    /**
+     * @brief 记录连接线修改
+     * @param id 连接线ID
+     * @param fields 发生变化的字段
+     */
+    void edgeModified(EdgeId id, EdgeFields fields);
+
+    /**
+     * @brief 合并另一份变更记录（按发生顺序排在本记录之后）
+     * @param other 另一份变更记录
+     */
+    void merge(const ChangeSet& other);
+
+    // 查询变更
+    /**
+     * @brief 获取被插入的节点
+     * @return 节点ID列表
+     */
+    QVector<NodeId> insertedNodes() const;
+
+    /**
+     * @brief 获取被删除的节点
+     * @return 节点ID列表
+     */
+    QVector<NodeId> removedNodes() const;
+
+    /**
+     * @brief 获取被修改的节点
+     * @return 节点ID到字段掩码的映射
+     */
+    QHash<NodeId, NodeFields> modifiedNodes() const;
+
+    /**
+     * @brief 获取被插入的连接线
+     * @return 连接线ID列表
+     */
+    QVector<EdgeId> insertedEdges() const;
+
+    /**
+     * @brief 获取被删除的连接线
+     * @return 连接线ID列表
+     */
+    QVector<EdgeId> removedEdges() const;
+
+    /**
+     * @brief 获取被修改的连接线
+     * @return 连接线ID到字段掩码的映射
+     */
+    QHash<EdgeId, EdgeFields> modifiedEdges() const;
+
+    /**
+     * @brief 获取受影响的节点和连接线总数
+     * @return 变更条目数量
+     */
+    int size() const { return m_nodes.size() + m_edges.size(); }
+
+    /**
+     * @brief 检查是否没有任何变更
+     * @return 如果没有变更返回 true，否则返回 false
+     */
+    bool isEmpty() const { return m_nodes.isEmpty() && m_edges.isEmpty(); }
+
+    /**
+     * @brief 清空变更记录
+     */
+    void clear();
+
+    /**
+     * @brief 比较两个节点，得到发生变化的字段
+     * @param before 修改前的节点
+     * @param after 修改后的节点
+     * @return 字段掩码
+     */
+    static NodeFields diff(const ConceptNode& before, const ConceptNode& after);
+
+    /**
+     * @brief 比较两条连接线，得到发生变化的字段
+     * @param before 修改前的连接线
+     * @param after 修改后的连接线
+     * @return 字段掩码
+     */
+    static EdgeFields diff(const ConceptEdge& before, const ConceptEdge& after);
+
+private:
+    /**
+     * @brief 单个元素的变更
+     */
+    struct Entry
+    {
+        enum Kind : quint8 { Inserted, Removed, Modified };
+        Kind kind = Modified;
+        quint32 fields = 0;     // 仅 Modified 有意义
+    };
+
+    static void recordInsert(QHash<quint32, Entry>& entries, quint32 id, quint32 allFields);
+    static void recordRemove(QHash<quint32, Entry>& entries, quint32 id);
+    static void recordModify(QHash<quint32, Entry>& entries, quint32 id, quint32 fields);
+    static QVector<quint32> idsOfKind(const QHash<quint32, Entry>& entries, Entry::Kind kind);
+
+    QHash<quint32, Entry> m_nodes;  // 节点变更
+    QHash<quint32, Entry> m_edges;  // 连接线变更
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ChangeSet::NodeFields)
+Q_DECLARE_OPERATORS_FOR_FLAGS(ChangeSet::EdgeFields)
+
+#endif // CHANGESET_H
@@ -0,0 +1,176 @@
+#ifndef CHUNKEDHASH_H
+#define CHUNKEDHASH_H
+
+#include <QHash>
+#include <QVector>
+#include <QSharedData>
+#include <QSharedDataPointer>
+
+/**
+ * @brief 分片的隐式共享哈希表
+ *
+ * 按键的哈希值把元素分到固定数量的分片中，每个分片是单独隐式共享的 QHash。
+ * 复制整个哈希表只复制分片指针表，复制后修改某个键只会分离（深拷贝）该键所在的分片，
+ * 其余分片仍与副本共享。与 ChunkedVector 配合，快照之后的单次编辑只复制
+ * 约 1/ShardCount 的索引。
+ *
+ * 分片在第一次写入其中的键时才分配，未写入过的分片保持为空指针，小图不为用不到的分片付出代价。
+ * 只读查找 find() 从不分离分片；需要原地修改值时用 findMutable()。
+ * 与 QHash 一样，不同实例可以在不同线程中使用；同一实例不能同时读写。
+ */
+template <typename K, typename V>
+class ChunkedHash
+{
+public:
+    static constexpr int ShardCount = 256;  // 分片数量
+
+    /**
+     * @brief 查找键（只读，不分离分片）
+     * @param key 键
+     * @return 值的指针，不存在时返回 nullptr
+     */
+    const V* find(const K& key) const
+    {
+        if (m_shards.isEmpty()) {
+            return nullptr;
+        }
+        const Shard* shard = m_shards.at(shardOf(key)).constData();
+        if (!shard) {
+            return nullptr;
+        }
+        auto it = shard->items.constFind(key);
+        return it == shard->items.constEnd() ? nullptr : &it.value();
+    }
+
+    /**
+     * @brief 查找键，用于原地修改值（只在键存在时分离所在的分片）
+     * @param key 键
+     * @return 值的指针，不存在时返回 nullptr
+     */
+    V* findMutable(const K& key)
+    {
+        if (!find(key)) {
+            return nullptr;
+        }
+        return &m_shards[shardOf(key)]->items[key];
+    }
+
+    /**
+     * @brief 检查键是否存在
+     */
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief 获取值，不存在时返回默认值
+     */
+    V value(const K& key, const V& defaultValue = V()) const
+    {
+        const V* found = find(key);
+        return found ? *found : defaultValue;
+    }
+
+    /**
+     * @brief 插入或替换
+     * @param key 键
+     * @param value 值
+     */
+    void insert(const K& key, const V& value)
+    {
+        QHash<K, V>& items = shardFor(key);
+        const qsizetype before = items.size();
+        items.insert(key, value);
+        m_size += int(items.size() - before);
+    }
+
+    /**
+     * @brief 获取值的引用，不存在时先插入默认值
+     */
+    V& operator[](const K& key)
+    {
+        QHash<K, V>& items = shardFor(key);
+        const qsizetype before = items.size();
+        V& value = items[key];
+        m_size += int(items.size() - before);
+        return value;
+    }
+
+    /**
+     * @brief 删除键
+     * @return 如果删除了返回 true，否则返回 false
+     */
+    bool remove(const K& key)
+    {
+        if (!find(key)) {
+            return false;
+        }
+        m_shards[shardOf(key)]->items.remove(key);
+        --m_size;
+        return true;
+    }
+
+    /**
+     * @brief 取出并删除键的值，不存在时返回默认值
+     */
+    V take(const K& key)
+    {
+        if (!find(key)) {
+            return V();
+        }
+        --m_size;
+        return m_shards[shardOf(key)]->items.take(key);
+    }
+
+    /**
+     * @brief 预留容量（按分片平均分摊，不足每个分片一个元素时不预先分配）
+     * @param size 预计的元素数量
+     */
+    void reserve(int size)
+    {
+        const int perShard = size / ShardCount;
+        for (int i = 0; i < ShardCount && perShard > 0; ++i) {
+            shardAt(i).reserve(perShard);
+        }
+    }
+
+    /**
+     * @brief 清空哈希表
+     */
+    void clear()
+    {
+        m_shards.clear();
+        m_size = 0;
+    }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+private:
+    struct Shard : public QSharedData
+    {
+        QHash<K, V> items;
+    };
+
+    static int shardOf(const K& key) { return int(qHash(key) % ShardCount); }
+
+    /**
+     * @brief 获取分片（可写，按需分配分片指针表和这一个分片，只分离这一个分片）
+     */
+    QHash<K, V>& shardAt(int index)
+    {
+        if (m_shards.isEmpty()) {
+            m_shards.resize(ShardCount);
+        }
+        QSharedDataPointer<Shard>& shard = m_shards[index];
+        if (!shard) {
+            shard = new Shard;
+        }
+        return shard->items;
+    }
+
+    QHash<K, V>& shardFor(const K& key) { return shardAt(shardOf(key)); }
+
+    QVector<QSharedDataPointer<Shard>> m_shards;    // 分片指针表（第一次写入时分配，未写入的分片为空）
+    int m_size = 0;                                 // 元素总数
+};
+
+#endif // CHUNKEDHASH_H
@@ -0,0 +1,196 @@
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+#include <QVector>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <iterator>
+#include <utility>
+
+/**
+ * @brief 分块的隐式共享数组
+ *
+ * 元素按固定大小分块存放，每块单独隐式共享。复制整个数组只复制块指针表，
+ * 复制后修改某个元素只会分离（深拷贝）该元素所在的块，其余块仍与副本共享。
+ * 这样为概念图拍快照是 O(1) 的，快照之后的单次编辑也只复制一个块。
+ *
+ * 与 QVector 一样，不同实例可以在不同线程中使用；同一实例不能同时读写。
+ */
+template <typename T>
+class ChunkedVector
+{
+public:
+    static constexpr int ChunkSize = 256;  // 每块的元素数量
+
+    /**
+     * @brief 只读迭代器
+     */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const ChunkedVector* vector, int pos)
+            : m_vector(vector), m_pos(pos) {}
+
+        reference operator*() const { return m_vector->at(m_pos); }
+        pointer operator->() const { return &m_vector->at(m_pos); }
+        const_iterator& operator++() { ++m_pos; return *this; }
+        bool operator==(const const_iterator& other) const { return m_pos == other.m_pos; }
+        bool operator!=(const const_iterator& other) const { return m_pos != other.m_pos; }
+
+    private:
+        const ChunkedVector* m_vector;
+        int m_pos;
+    };
+
+    /**
+     * @brief 按下标读取元素
+     */
+    const T& at(int index) const
+    {
+        return m_chunks.at(index / ChunkSize)->items.at(index % ChunkSize);
+    }
+
+    /**
+     * @brief 按下标访问元素（可写，只分离所在的块）
+     */
+    T& operator[](int index)
+    {
+        return m_chunks[index / ChunkSize]->items[index % ChunkSize];
+    }
+
+    const T& operator[](int index) const { return at(index); }
+
+    /**
+     * @brief 在末尾追加元素
+     * @param value 要追加的元素
+     */
+    void append(const T& value)
+    {
+        T copy(value);
+        append(std::move(copy));
+    }
+
+    /**
+     * @brief 在末尾追加元素（移动版本）
+     * @param value 要追加的元素
+     */
+    void append(T&& value)
+    {
+        if (m_size % ChunkSize == 0) {
+            QSharedDataPointer<Chunk> chunk(new Chunk);
+            chunk->items.reserve(ChunkSize);
+            m_chunks.append(chunk);
+        }
+        m_chunks.last()->items.append(std::move(value));
+        ++m_size;
+    }
+
+    /**
+     * @brief 获取最后一个元素
+     */
+    const T& last() const { return m_chunks.last()->items.last(); }
+
+    /**
+     * @brief 取出并删除最后一个元素
+     * @return 最后一个元素
+     */
+    T takeLast()
+    {
+        T value = std::move(m_chunks.last()->items.last());
+        removeLast();
+        return value;
+    }
+
+    /**
+     * @brief 删除最后一个元素
+     */
+    void removeLast()
+    {
+        Chunk* chunk = m_chunks.last().data();
+        chunk->items.removeLast();
+        if (chunk->items.isEmpty()) {
+            m_chunks.removeLast();
+        }
+        --m_size;
+    }
+
+    /**
+     * @brief 预留容量（只预留块指针表）
+     * @param size 预计的元素数量
+     */
+    void reserve(int size) { m_chunks.reserve((size + ChunkSize - 1) / ChunkSize); }
+
+    /**
+     * @brief 清空数组
+     */
+    void clear()
+    {
+        m_chunks.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 复制为连续的 QVector
+     * @return 所有元素
+     */
+    QVector<T> toVector() const
+    {
+        QVector<T> result;
+        result.reserve(m_size);
+        for (const QSharedDataPointer<Chunk>& chunk : m_chunks) {
+            result.append(chunk->items);
+        }
+        return result;
+    }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 获取块的数量
+     *
+     * 块内的元素是连续存放的，批量扫描可以按块取得指针逐块处理。
+     * 除最后一块外每块都有 ChunkSize 个元素。
+     */
+    int chunkCount() const { return int(m_chunks.size()); }
+
+    /**
+     * @brief 获取一块中的元素数量
+     * @param chunk 块下标
+     */
+    int chunkLength(int chunk) const { return int(m_chunks.at(chunk)->items.size()); }
+
+    /**
+     * @brief 获取一块的连续元素（只读）
+     * @param chunk 块下标
+     * @return 块内第一个元素的指针
+     */
+    const T* chunkData(int chunk) const { return m_chunks.at(chunk)->items.constData(); }
+
+    /**
+     * @brief 获取一块的连续元素（可写，只分离这一块）
+     * @param chunk 块下标
+     * @return 块内第一个元素的指针
+     */
+    T* chunkData(int chunk) { return m_chunks[chunk]->items.data(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+private:
+    struct Chunk : public QSharedData
+    {
+        QVector<T> items;
+    };
+
+    QVector<QSharedDataPointer<Chunk>> m_chunks;    // 块指针表
+    int m_size = 0;                                 // 元素总数
+};
+
+#endif // CHUNKEDVECTOR_H
@@ -1,16 +1,15 @@
 #include "conceptedge.h"
-#include <QUuid>
 
 /**
- * @brief 构造函数 - 创建一个空的连接线
+ * @brief 构造函数 - 创建一个空的连接线（ID 为 InvalidId）
  */
 ConceptEdge::ConceptEdge()
-    : m_id(generateId())
-    , m_sourceNodeId("")
-    , m_targetNodeId("")
-    , m_label("")
-    , m_color(100, 100, 100)
-    , m_style("default")
+    : m_id(InvalidId)
+    , m_sourceNodeId(InvalidId)
+    , m_targetNodeId(InvalidId)
+    , m_label()
+    , m_color(qRgb(100, 100, 100))
+    , m_style(QStringLiteral("default"))
 {
 }
 
@@ -21,14 +20,28 @@ ConceptEdge::ConceptEdge()
  * @param label 连接线标签
  * @param color 连接线颜色
  */
-ConceptEdge::ConceptEdge(const QString& sourceNodeId, const QString& targetNodeId,
+ConceptEdge::ConceptEdge(NodeId sourceNodeId, NodeId targetNodeId,
                          const QString& label, const QColor& color)
     : m_id(generateId())
     , m_sourceNodeId(sourceNodeId)
     , m_targetNodeId(targetNodeId)
     , m_label(label)
-    , m_color(color)
-    , m_style("default")
+    , m_color(color.rgba())
+    , m_style(QStringLiteral("default"))
+{
+}
+
+/**
+ * @brief 构造函数 - 创建一个使用指定ID的空连接线
+ * @param id 连接线ID
+ */
+ConceptEdge::ConceptEdge(EdgeId id)
+    : m_id(id)
+    , m_sourceNodeId(InvalidId)
+    , m_targetNodeId(InvalidId)
+    , m_label()
+    , m_color(qRgb(100, 100, 100))
+    , m_style(QStringLiteral("default"))
 {
 }
 
@@ -41,9 +54,18 @@ ConceptEdge::~ConceptEdge()
 
 /**
  * @brief 生成新的唯一标识符
- * @return 新的UUID字符串
+ * @return 新的连接线ID
+ */
+EdgeId ConceptEdge::generateId()
+{
+    return IdRegistry::create();
+}
+
+/**
+ * @brief 获取新建连接线的默认标签
+ * @return 默认标签（静态字符串，所有连接线共享）
  */
-QString ConceptEdge::generateId()
+QString ConceptEdge::defaultLabel()
 {
-    return QUuid::createUuid().toString(QUuid::WithoutBraces);
+    return QStringLiteral("连接");
 }
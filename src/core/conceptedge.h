@@ -3,7 +3,7 @@
 
 #include <QString>
 #include <QColor>
-#include <QUuid>
+#include "idregistry.h"
 
 /**
  * @brief 连接线数据类
@@ -21,19 +21,33 @@ class ConceptEdge
 public:
     /**
      * @brief 构造函数 - 创建一个空的连接线
+     *
+     * ID 为 InvalidId，不向 IdRegistry 申请句柄（占位、容器和读取失败时的返回值）。
      */
     ConceptEdge();
 
     /**
-     * @brief 构造函数 - 创建一个带有指定参数的连接线
+     * @brief 构造函数 - 创建一个带有指定参数的新连接线（分配新的ID）
+     *
+     * 只用于新建要加入概念图的连接线；加载文件时用 ConceptEdge(EdgeId)。
+     *
      * @param sourceNodeId 源节点ID
      * @param targetNodeId 目标节点ID
      * @param label 连接线标签
      * @param color 连接线颜色
      */
-    ConceptEdge(const QString& sourceNodeId, const QString& targetNodeId,
+    ConceptEdge(NodeId sourceNodeId, NodeId targetNodeId,
                 const QString& label = "", const QColor& color = QColor(100, 100, 100));
 
+    /**
+     * @brief 构造函数 - 创建一个使用指定ID的空连接线
+     *
+     * 不向 IdRegistry 申请新句柄，用于加载文件。
+     *
+     * @param id 连接线ID
+     */
+    explicit ConceptEdge(EdgeId id);
+
     /**
      * @brief 析构函数
      */
@@ -44,19 +58,19 @@ public:
      * @brief 获取连接线唯一标识符
      * @return 连接线ID
      */
-    QString id() const { return m_id; }
+    EdgeId id() const { return m_id; }
 
     /**
      * @brief 获取源节点ID
      * @return 源节点ID
      */
-    QString sourceNodeId() const { return m_sourceNodeId; }
+    NodeId sourceNodeId() const { return m_sourceNodeId; }
 
     /**
      * @brief 获取目标节点ID
      * @return 目标节点ID
      */
-    QString targetNodeId() const { return m_targetNodeId; }
+    NodeId targetNodeId() const { return m_targetNodeId; }
 
     /**
      * @brief 获取连接线标签
@@ -68,7 +82,7 @@ public:
      * @brief 获取连接线颜色
      * @return 连接线颜色
      */
-    QColor color() const { return m_color; }
+    QColor color() const { return QColor::fromRgba(m_color); }
 
     /**
      * @brief 获取连接线样式
@@ -81,13 +95,13 @@ public:
      * @brief 设置源节点ID
      * @param sourceNodeId 新的源节点ID
      */
-    void setSourceNodeId(const QString& sourceNodeId) { m_sourceNodeId = sourceNodeId; }
+    void setSourceNodeId(NodeId sourceNodeId) { m_sourceNodeId = sourceNodeId; }
 
     /**
      * @brief 设置目标节点ID
      * @param targetNodeId 新的目标节点ID
      */
-    void setTargetNodeId(const QString& targetNodeId) { m_targetNodeId = targetNodeId; }
+    void setTargetNodeId(NodeId targetNodeId) { m_targetNodeId = targetNodeId; }
 
     /**
      * @brief 设置连接线标签
@@ -99,7 +113,7 @@ public:
      * @brief 设置连接线颜色
      * @param color 新的颜色
      */
-    void setColor(const QColor& color) { m_color = color; }
+    void setColor(const QColor& color) { m_color = color.rgba(); }
 
     /**
      * @brief 设置连接线样式
@@ -111,20 +125,26 @@ public:
      * @brief 设置连接线ID
      * @param id 新的连接线ID
      */
-    void setId(const QString& id) { m_id = id; }
+    void setId(EdgeId id) { m_id = id; }
 
     /**
      * @brief 生成新的唯一标识符
-     * @return 新的UUID字符串
+     * @return 新的连接线ID
+     */
+    static EdgeId generateId();
+
+    /**
+     * @brief 获取新建连接线的默认标签
+     * @return 默认标签（静态字符串，所有连接线共享）
      */
-    static QString generateId();
+    static QString defaultLabel();
 
 private:
-    QString m_id;              // 连接线唯一标识符
-    QString m_sourceNodeId;    // 源节点ID
-    QString m_targetNodeId;    // 目标节点ID
+    EdgeId m_id;               // 连接线唯一标识符
+    NodeId m_sourceNodeId;     // 源节点ID
+    NodeId m_targetNodeId;     // 目标节点ID
     QString m_label;           // 连接线标签
-    QColor m_color;            // 连接线颜色
+    QRgb m_color;              // 连接线颜色
     QString m_style;           // 连接线样式
 };
 
@@ -28,81 +28,144 @@ ConceptMap::~ConceptMap()
 }
 
 /**
- * @brief 根据ID获取节点
- * @param id 节点ID
- * @return 节点指针，如果不存在则返回 nullptr
+ * @brief 创建只读快照
+ * @return 快照
  */
-ConceptNode* ConceptMap::nodeById(const QString& id)
+ConceptMapSnapshot ConceptMap::snapshot() const
 {
-    if (!m_nodeIndexMap.contains(id)) {
-        return nullptr;
-    }
-    return &m_nodes[m_nodeIndexMap[id]];
+    ConceptMapSnapshot result(new ConceptMap(*this));
+    return result;
 }
 
 /**
- * @brief 根据ID获取节点（常量版本）
+ * @brief 根据ID获取节点（只读，修改节点用 updateNode() 或 setNodePos()）
  * @param id 节点ID
  * @return 节点指针，如果不存在则返回 nullptr
  */
-const ConceptNode* ConceptMap::nodeById(const QString& id) const
+const ConceptNode* ConceptMap::nodeById(NodeId id) const
 {
-    if (!m_nodeIndexMap.contains(id)) {
+    const SlotHandle* handle = m_nodeIndex.find(id);
+    if (!handle) {
         return nullptr;
     }
-    return &m_nodes[m_nodeIndexMap[id]];
+    return m_nodes.get(*handle);
 }
 
 /**
- * @brief 根据ID获取连接线
+ * @brief 根据ID获取连接线（只读，修改连接线用 updateEdge()）
  * @param id 连接线ID
  * @return 连接线指针，如果不存在则返回 nullptr
  */
-ConceptEdge* ConceptMap::edgeById(const QString& id)
+const ConceptEdge* ConceptMap::edgeById(EdgeId id) const
 {
-    if (!m_edgeIndexMap.contains(id)) {
+    const SlotHandle* handle = m_edgeIndex.find(id);
+    if (!handle) {
         return nullptr;
     }
-    return &m_edges[m_edgeIndexMap[id]];
+    return m_edges.get(*handle);
 }
 
 /**
- * @brief 根据ID获取连接线（常量版本）
- * @param id 连接线ID
- * @return 连接线指针，如果不存在则返回 nullptr
+ * @brief 获取与指定节点相关的所有连接线
+ * @param nodeId 节点ID
+ * @return 连接线列表
  */
-const ConceptEdge* ConceptMap::edgeById(const QString& id) const
+QVector<ConceptEdge> ConceptMap::edgesByNodeId(NodeId nodeId) const
 {
-    if (!m_edgeIndexMap.contains(id)) {
-        return nullptr;
+    QVector<ConceptEdge> result;
+    const EdgeRange out = outEdges(nodeId);
+    const EdgeRange in = inEdges(nodeId);
+    result.reserve(out.size() + in.size());
+
+    for (const ConceptEdge& edge : out) {
+        result.append(edge);
+    }
+    for (const ConceptEdge& edge : in) {
+        // 自环已经在出边中出现过
+        if (edge.sourceNodeId() != nodeId) {
+            result.append(edge);
+        }
     }
-    return &m_edges[m_edgeIndexMap[id]];
+    return result;
 }
 
 /**
- * @brief 获取与指定节点相关的所有连接线
+ * @brief 获取与指定节点相关的所有连接线ID
  * @param nodeId 节点ID
- * @return 连接线列表
+ * @return 连接线ID列表
  */
-QVector<ConceptEdge> ConceptMap::edgesByNodeId(const QString& nodeId) const
+QVector<EdgeId> ConceptMap::edgeIdsByNodeId(NodeId nodeId) const
 {
-    QVector<ConceptEdge> result;
-    for (const ConceptEdge& edge : m_edges) {
-        if (edge.sourceNodeId() == nodeId || edge.targetNodeId() == nodeId) {
-            result.append(edge);
+    QVector<EdgeId> result;
+    const EdgeRange out = outEdges(nodeId);
+    const EdgeRange in = inEdges(nodeId);
+    result.reserve(out.size() + in.size());
+
+    for (const ConceptEdge& edge : out) {
+        result.append(edge.id());
+    }
+    for (const ConceptEdge& edge : in) {
+        if (edge.sourceNodeId() != nodeId) {
+            result.append(edge.id());
         }
     }
     return result;
 }
 
+/**
+ * @brief 获取以指定节点为源节点的连接线
+ * @param nodeId 节点ID
+ * @return 出边区间
+ */
+ConceptMap::EdgeRange ConceptMap::outEdges(NodeId nodeId) const
+{
+    return EdgeRange(&m_edges, &adjacency(m_outEdges, nodeId));
+}
+
+/**
+ * @brief 获取以指定节点为目标节点的连接线
+ * @param nodeId 节点ID
+ * @return 入边区间
+ */
+ConceptMap::EdgeRange ConceptMap::inEdges(NodeId nodeId) const
+{
+    return EdgeRange(&m_edges, &adjacency(m_inEdges, nodeId));
+}
+
+/**
+ * @brief 获取与指定节点直接相连的节点
+ * @param nodeId 节点ID
+ * @return 相邻节点区间
+ */
+ConceptMap::NeighborRange ConceptMap::neighbors(NodeId nodeId) const
+{
+    return NeighborRange(this, &adjacency(m_outEdges, nodeId), &adjacency(m_inEdges, nodeId));
+}
+
+/**
+ * @brief 获取区间中指定位置的相邻节点
+ * @param pos 位置（先出边后入边）
+ * @return 相邻节点指针
+ */
+const ConceptNode* ConceptMap::NeighborRange::neighborAt(int pos) const
+{
+    if (pos < m_out->size()) {
+        const ConceptEdge* edge = m_map->m_edges.get(m_out->at(pos));
+        return m_map->nodeById(edge->targetNodeId());
+    }
+
+    const ConceptEdge* edge = m_map->m_edges.get(m_in->at(pos - m_out->size()));
+    return m_map->nodeById(edge->sourceNodeId());
+}
+
 /**
  * @brief 检查节点是否存在
  * @param id 节点ID
  * @return 如果存在返回 true，否则返回 false
  */
-bool ConceptMap::hasNode(const QString& id) const
+bool ConceptMap::hasNode(NodeId id) const
 {
-    return m_nodeIndexMap.contains(id);
+    return m_nodeIndex.contains(id);
 }
 
 /**
@@ -110,9 +173,48 @@ bool ConceptMap::hasNode(const QString& id) const
  * @param id 连接线ID
  * @return 如果存在返回 true，否则返回 false
  */
-bool ConceptMap::hasEdge(const QString& id) const
+bool ConceptMap::hasEdge(EdgeId id) const
+{
+    return m_edgeIndex.contains(id);
+}
+
+/**
+ * @brief 获取所有节点的包围盒
+ * @return 包围盒，没有节点时返回空矩形
+ */
+QRectF ConceptMap::nodesBoundingRect() const
 {
-    return m_edgeIndexMap.contains(id);
+    return m_geometry.boundingRect();
+}
+
+/**
+ * @brief 获取与矩形相交的节点
+ * @param rect 查询矩形
+ * @return 节点ID列表
+ */
+QVector<NodeId> ConceptMap::nodesIntersecting(const QRectF& rect) const
+{
+    const NodeGeometry& columns = m_geometry;
+    const QVector<int> indices = columns.indicesIntersecting(rect);
+
+    QVector<NodeId> result;
+    result.reserve(indices.size());
+    for (int index : indices) {
+        result.append(columns.idAt(index));
+    }
+    return result;
+}
+
+/**
+ * @brief 获取离指定点最近的节点
+ * @param point 查询点
+ * @return 节点ID，没有节点时返回 InvalidId
+ */
+NodeId ConceptMap::nearestNode(const QPointF& point) const
+{
+    const NodeGeometry& columns = m_geometry;
+    const int index = columns.nearestIndex(point);
+    return index < 0 ? InvalidId : columns.idAt(index);
 }
 
 /**
@@ -126,8 +228,14 @@ bool ConceptMap::addNode(const ConceptNode& node)
         return false;
     }
 
-    m_nodes.append(node);
-    m_nodeIndexMap[node.id()] = m_nodes.size() - 1;
+    ConceptNode stored(node);
+    internStrings(stored);
+    m_nodeIndex.insert(node.id(), m_nodes.insert(std::move(stored)));
+    m_geometry.append(node.id(), QRectF(node.pos(), node.size()));
+
+    if (isRecording()) {
+        m_journal.nodeInserted(node.id());
+    }
     return true;
 }
 
@@ -136,30 +244,30 @@ bool ConceptMap::addNode(const ConceptNode& node)
  * @param id 要删除的节点ID
  * @return 如果成功删除返回 true，如果不存在则返回 false
  */
-bool ConceptMap::removeNode(const QString& id)
+bool ConceptMap::removeNode(NodeId id)
 {
     if (!hasNode(id)) {
         return false;
     }
 
-    // 删除与该节点相关的所有连接线
-    QVector<ConceptEdge> relatedEdges = edgesByNodeId(id);
-    for (const ConceptEdge& edge : relatedEdges) {
-        removeEdge(edge.id());
+    // 删除与该节点相关的所有连接线。先整体去掉本节点的邻接表，
+    // 每条连接线只需从另一端的邻接表中移除，不必在本节点的表里逐条查找
+    const QVector<EdgeId> relatedEdgeIds = edgeIdsByNodeId(id);
+    m_outEdges.remove(id);
+    m_inEdges.remove(id);
+    for (EdgeId edgeId : relatedEdgeIds) {
+        removeEdge(edgeId);
     }
 
-    // 删除节点
-    int index = m_nodeIndexMap[id];
-    m_nodes.removeAt(index);
+    // 删除节点（swap-remove，其余节点的句柄不受影响），几何列存储做同样的交换
+    const SlotHandle handle = m_nodeIndex.take(id);
+    const int denseIndex = m_nodes.denseIndexOf(handle);
+    m_nodes.remove(handle);
+    m_geometry.removeAt(denseIndex);
 
-    // 使用增量更新索引映射，只更新受影响的索引
-    for (auto it = m_nodeIndexMap.begin(); it != m_nodeIndexMap.end(); ++it) {
-        if (it.value() > index) {
-            --it.value();
-        }
+    if (isRecording()) {
+        m_journal.nodeRemoved(id);
     }
-    m_nodeIndexMap.remove(id);
-
     return true;
 }
 
@@ -170,22 +278,105 @@ bool ConceptMap::removeNode(const QString& id)
  */
 bool ConceptMap::updateNode(const ConceptNode& node)
 {
-    if (!hasNode(node.id())) {
+    const SlotHandle* handle = m_nodeIndex.find(node.id());
+    if (!handle) {
         return false;
     }
 
-    int index = m_nodeIndexMap[node.id()];
-    m_nodes[index] = node;
+    const int denseIndex = m_nodes.denseIndexOf(*handle);
+    ConceptNode& stored = m_nodes.at(denseIndex);
+    if (isRecording()) {
+        m_journal.nodeModified(node.id(), ChangeSet::diff(stored, node));
+    }
+    stored = node;
+    internStrings(stored);
+    m_geometry.set(denseIndex, QRectF(node.pos(), node.size()));
     return true;
 }
 
+/**
+ * @brief 设置节点位置
+ * @param id 节点ID
+ * @param pos 新的位置
+ * @return 如果成功设置返回 true，如果不存在则返回 false
+ */
+bool ConceptMap::setNodePos(NodeId id, const QPointF& pos)
+{
+    const SlotHandle* handle = m_nodeIndex.find(id);
+    if (!handle) {
+        return false;
+    }
+
+    const int denseIndex = m_nodes.denseIndexOf(*handle);
+    ConceptNode& node = m_nodes.at(denseIndex);
+    if (node.pos() == pos) {
+        return true;
+    }
+
+    node.setPos(pos);
+    m_geometry.setPos(denseIndex, pos);
+
+    if (isRecording()) {
+        m_journal.nodeModified(id, ChangeSet::NodePosition);
+    }
+    return true;
+}
+
+/**
+ * @brief 平移所有节点
+ * @param delta 平移量
+ */
+void ConceptMap::translateNodes(const QPointF& delta)
+{
+    m_geometry.translate(delta);
+
+    // 节点对象中的坐标按 qreal 精度单独累加，避免引入 float 舍入误差
+    const bool recording = isRecording();
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        ConceptNode& node = m_nodes.at(i);
+        node.setPos(node.pos() + delta);
+        if (recording) {
+            m_journal.nodeModified(node.id(), ChangeSet::NodePosition);
+        }
+    }
+}
+
+/**
+ * @brief 平移指定节点
+ * @param ids 节点ID列表
+ * @param delta 平移量
+ */
+void ConceptMap::translateNodes(const QVector<NodeId>& ids, const QPointF& delta)
+{
+    for (NodeId id : ids) {
+        const SlotHandle* handle = m_nodeIndex.find(id);
+        if (!handle) {
+            continue;
+        }
+        const int denseIndex = m_nodes.denseIndexOf(*handle);
+        ConceptNode& node = m_nodes.at(denseIndex);
+        node.setPos(node.pos() + delta);
+        m_geometry.setPos(denseIndex, node.pos());
+        if (isRecording()) {
+            m_journal.nodeModified(id, ChangeSet::NodePosition);
+        }
+    }
+}
+
 /**
  * @brief 清空所有节点
  */
 void ConceptMap::clearNodes()
 {
+    if (isRecording()) {
+        for (const ConceptNode& node : m_nodes.values()) {
+            m_journal.nodeRemoved(node.id());
+        }
+    }
+
     m_nodes.clear();
-    m_nodeIndexMap.clear();
+    m_nodeIndex.clear();
+    m_geometry.clear();
 }
 
 /**
@@ -204,8 +395,15 @@ bool ConceptMap::addEdge(const ConceptEdge& edge)
         return false;
     }
 
-    m_edges.append(edge);
-    m_edgeIndexMap[edge.id()] = m_edges.size() - 1;
+    ConceptEdge stored(edge);
+    internStrings(stored);
+    SlotHandle handle = m_edges.insert(std::move(stored));
+    m_edgeIndex.insert(edge.id(), handle);
+    attachEdge(edge, handle);
+
+    if (isRecording()) {
+        m_journal.edgeInserted(edge.id());
+    }
     return true;
 }
 
@@ -214,21 +412,22 @@ bool ConceptMap::addEdge(const ConceptEdge& edge)
  * @param id 要删除的连接线ID
  * @return 如果成功删除返回 true，如果不存在则返回 false
  */
-bool ConceptMap::removeEdge(const QString& id)
+bool ConceptMap::removeEdge(EdgeId id)
 {
-    if (!hasEdge(id)) {
+    const SlotHandle* found = m_edgeIndex.find(id);
+    if (!found) {
         return false;
     }
 
-    int index = m_edgeIndexMap[id];
-    m_edges.removeAt(index);
+    // swap-remove，无需重建索引
+    const SlotHandle handle = *found;
+    detachEdge(*m_edges.get(handle), handle);
+    m_edges.remove(handle);
+    m_edgeIndex.remove(id);
 
-    // 更新索引映射
-    m_edgeIndexMap.clear();
-    for (int i = 0; i < m_edges.size(); ++i) {
-        m_edgeIndexMap[m_edges[i].id()] = i;
+    if (isRecording()) {
+        m_journal.edgeRemoved(id);
     }
-
     return true;
 }
 
@@ -239,12 +438,24 @@ bool ConceptMap::removeEdge(const QString& id)
  */
 bool ConceptMap::updateEdge(const ConceptEdge& edge)
 {
-    if (!hasEdge(edge.id())) {
+    const SlotHandle* handle = m_edgeIndex.find(edge.id());
+    if (!handle) {
         return false;
     }
 
-    int index = m_edgeIndexMap[edge.id()];
-    m_edges[index] = edge;
+    ConceptEdge* stored = m_edges.get(*handle);
+    if (isRecording()) {
+        m_journal.edgeModified(edge.id(), ChangeSet::diff(*stored, edge));
+    }
+
+    // 端点变化时同步邻接表
+    if (stored->sourceNodeId() != edge.sourceNodeId() || stored->targetNodeId() != edge.targetNodeId()) {
+        detachEdge(*stored, *handle);
+        attachEdge(edge, *handle);
+    }
+
+    *stored = edge;
+    internStrings(*stored);
     return true;
 }
 
@@ -253,8 +464,16 @@ bool ConceptMap::updateEdge(const ConceptEdge& edge)
  */
 void ConceptMap::clearEdges()
 {
+    if (isRecording()) {
+        for (const ConceptEdge& edge : m_edges.values()) {
+            m_journal.edgeRemoved(edge.id());
+        }
+    }
+
     m_edges.clear();
-    m_edgeIndexMap.clear();
+    m_edgeIndex.clear();
+    m_outEdges.clear();
+    m_inEdges.clear();
 }
 
 /**
@@ -264,4 +483,179 @@ void ConceptMap::clear()
 {
     clearNodes();
     clearEdges();
+    m_strings.clear();
+}
+
+/**
+ * @brief 开始事务
+ *
+ * 事务可以嵌套，只有最外层的 commit() 返回累计的变更记录。
+ */
+void ConceptMap::beginTransaction()
+{
+    ++m_transactionDepth;
+}
+
+/**
+ * @brief 提交事务
+ * @return 最外层提交时返回事务期间的变更记录，嵌套提交返回空记录
+ */
+ChangeSet ConceptMap::commit()
+{
+    if (m_transactionDepth == 0) {
+        return ChangeSet();
+    }
+
+    if (--m_transactionDepth > 0) {
+        return ChangeSet();
+    }
+
+    ChangeSet changes = m_journal;
+    m_journal.clear();
+    return changes;
+}
+
+/**
+ * @brief 批量加载节点和连接线
+ * @param nodes 节点列表（内容被移走）
+ * @param edges 连接线列表（内容被移走）
+ * @return 被剔除的记录数量
+ */
+int ConceptMap::bulkLoad(QVector<ConceptNode>&& nodes, QVector<ConceptEdge>&& edges)
+{
+    clear();
+
+    QVector<ConceptNode> nodeRecords = std::move(nodes);
+    QVector<ConceptEdge> edgeRecords = std::move(edges);
+    int rejected = 0;
+
+    m_nodes.reserve(nodeRecords.size());
+    m_nodeIndex.reserve(nodeRecords.size());
+    m_geometry.reserve(nodeRecords.size());
+    m_edges.reserve(edgeRecords.size());
+    m_edgeIndex.reserve(edgeRecords.size());
+    m_outEdges.reserve(nodeRecords.size());
+    m_inEdges.reserve(nodeRecords.size());
+
+    // 移入节点，同时建立ID索引和几何列存储
+    for (ConceptNode& node : nodeRecords) {
+        const NodeId id = node.id();
+        if (m_nodeIndex.contains(id)) {
+            ++rejected;
+            continue;
+        }
+        internStrings(node);
+        m_geometry.append(id, QRectF(node.pos(), node.size()));
+        m_nodeIndex.insert(id, m_nodes.insert(std::move(node)));
+    }
+    nodeRecords = QVector<ConceptNode>();
+
+    // 移入连接线，端点检查推迟到最后统一进行
+    for (ConceptEdge& edge : edgeRecords) {
+        const EdgeId id = edge.id();
+        if (m_edgeIndex.contains(id)) {
+            ++rejected;
+            continue;
+        }
+        internStrings(edge);
+        m_edgeIndex.insert(id, m_edges.insert(std::move(edge)));
+    }
+    edgeRecords = QVector<ConceptEdge>();
+
+    // 从后往前剔除悬空连接线：swap-remove 移入的元素都已检查过
+    for (int i = m_edges.size() - 1; i >= 0; --i) {
+        const ConceptEdge& edge = m_edges.at(i);
+        if (!m_nodeIndex.contains(edge.sourceNodeId()) || !m_nodeIndex.contains(edge.targetNodeId())) {
+            m_edgeIndex.remove(edge.id());
+            m_edges.remove(m_edges.handleAt(i));
+            ++rejected;
+        }
+    }
+
+    // 一次性建立邻接表
+    for (int i = 0; i < m_edges.size(); ++i) {
+        attachEdge(m_edges.at(i), m_edges.handleAt(i));
+    }
+
+    if (isRecording()) {
+        for (const ConceptNode& node : m_nodes.values()) {
+            m_journal.nodeInserted(node.id());
+        }
+        for (const ConceptEdge& edge : m_edges.values()) {
+            m_journal.edgeInserted(edge.id());
+        }
+    }
+
+    return rejected;
+}
+
+/**
+ * @brief 驻留节点中的重复字符串
+ * @param node 节点
+ */
+void ConceptMap::internStrings(ConceptNode& node)
+{
+    node.setStyle(m_strings.intern(node.style()));
+}
+
+/**
+ * @brief 驻留连接线中的重复字符串
+ * @param edge 连接线
+ */
+void ConceptMap::internStrings(ConceptEdge& edge)
+{
+    edge.setLabel(m_strings.intern(edge.label()));
+    edge.setStyle(m_strings.intern(edge.style()));
+}
+
+/**
+ * @brief 把连接线登记到两端节点的邻接表
+ * @param edge 连接线
+ * @param handle 连接线句柄
+ */
+void ConceptMap::attachEdge(const ConceptEdge& edge, const SlotHandle& handle)
+{
+    m_outEdges[edge.sourceNodeId()].append(handle);
+    m_inEdges[edge.targetNodeId()].append(handle);
+}
+
+/**
+ * @brief 从两端节点的邻接表中移除连接线
+ * @param edge 连接线
+ * @param handle 连接线句柄
+ */
+void ConceptMap::detachEdge(const ConceptEdge& edge, const SlotHandle& handle)
+{
+    // 邻接表无序，用末尾元素填补空位
+    auto removeFrom = [&handle](ChunkedHash<NodeId, QVector<SlotHandle>>& lists, NodeId nodeId) {
+        QVector<SlotHandle>* handles = lists.findMutable(nodeId);
+        if (!handles) {
+            return;
+        }
+        int pos = handles->indexOf(handle);
+        if (pos >= 0) {
+            (*handles)[pos] = handles->last();
+            handles->removeLast();
+        }
+        if (handles->isEmpty()) {
+            lists.remove(nodeId);
+        }
+    };
+
+    removeFrom(m_outEdges, edge.sourceNodeId());
+    removeFrom(m_inEdges, edge.targetNodeId());
+}
+
+/**
+ * @brief 获取邻接表，不存在时返回空表
+ * @param lists 邻接表集合
+ * @param nodeId 节点ID
+ * @return 邻接表引用
+ */
+const QVector<SlotHandle>& ConceptMap::adjacency(const ChunkedHash<NodeId, QVector<SlotHandle>>& lists,
+                                                 NodeId nodeId)
+{
+    static const QVector<SlotHandle> empty;
+    const QVector<SlotHandle>* handles = lists.find(nodeId);
+    return handles ? *handles : empty;
 }
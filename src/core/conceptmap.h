@@ -3,10 +3,25 @@
 
 #include <QString>
 #include <QVector>
-#include <QMap>
-#include <QUuid>
+#include <QHash>
+#include <QSharedPointer>
 #include "conceptnode.h"
 #include "conceptedge.h"
+#include "slotmap.h"
+#include "chunkedhash.h"
+#include "nodegeometry.h"
+#include "stringpool.h"
+#include "changeset.h"
+#include <iterator>
+
+class ConceptMap;
+
+/**
+ * @brief 概念图只读快照
+ *
+ * 由 ConceptMap::snapshot() 创建，内容在创建后不再变化，可以交给工作线程读取。
+ */
+using ConceptMapSnapshot = QSharedPointer<const ConceptMap>;
 
 /**
  * @brief 概念图数据类
@@ -17,10 +32,127 @@
  * - 概念图名称
  * - 概念图版本
  * - 节点和连接线的增删改查操作
+ *
+ * 节点和连接线存放在槽位映射（SlotMap）中，并通过哈希索引按ID定位，
+ * 因此增删查都是 O(1)。删除采用 swap-remove，nodes()/edges() 的顺序
+ * 在删除后可能改变。
+ *
+ * 每个节点维护出边和入边邻接表，随 addEdge/removeEdge/updateEdge 增量更新，
+ * 按节点查询连接线的代价为 O(度数)。
+ *
+ * 节点的位置和尺寸另外以列存储（NodeGeometry）保存一份，供包围盒、区域查询、
+ * 最近节点和批量平移等整图操作使用。列存储随 addNode/updateNode/setNodePos/
+ * translateNodes/removeNode 增量更新；nodeById() 只返回只读指针，节点只能经由这些方法修改。
+ *
+ * 写入节点和连接线时，样式名和连接线标签会经过概念图自己的字符串驻留池，
+ * 相同内容的字符串在整张图中只保留一份。
+ *
+ * 在 beginTransaction()/commit() 之间的修改会记入变更记录（ChangeSet），
+ * 提交后由视图按记录增量更新。nodeById() 和 edgeById() 只返回只读指针，
+ * 所有修改都经由上述方法进行，邻接表、变更记录和字符串驻留池因此始终保持一致。
+ *
+ * 所有成员都是隐式共享的：节点、连接线、几何列存储和槽位表按块共享（ChunkedVector），
+ * ID索引和邻接表按分片共享（ChunkedHash），因此复制概念图或调用 snapshot() 都是 O(1)。
+ * 快照之后在原对象上的编辑只分离被修改的块和分片（以及各自的块指针表），
+ * 快照本身保持不变，可以在其它线程中读取。字符串驻留池仍整体共享，
+ * 只在写入新的样式名或标签时分离，它的大小与不同字符串的数量成正比。
  */
 class ConceptMap
 {
 public:
+    /**
+     * @brief 连接线区间（不复制连接线数据）
+     *
+     * 遍历某个节点的出边或入边邻接表。区间在概念图被修改后失效。
+     */
+    class EdgeRange
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ConceptEdge;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ConceptEdge*;
+            using reference = const ConceptEdge&;
+
+            const_iterator(const SlotMap<ConceptEdge>* edges, const SlotHandle* pos)
+                : m_edges(edges), m_pos(pos) {}
+
+            reference operator*() const { return *m_edges->get(*m_pos); }
+            pointer operator->() const { return m_edges->get(*m_pos); }
+            const_iterator& operator++() { ++m_pos; return *this; }
+            bool operator==(const const_iterator& other) const { return m_pos == other.m_pos; }
+            bool operator!=(const const_iterator& other) const { return m_pos != other.m_pos; }
+
+        private:
+            const SlotMap<ConceptEdge>* m_edges;
+            const SlotHandle* m_pos;
+        };
+
+        EdgeRange(const SlotMap<ConceptEdge>* edges, const QVector<SlotHandle>* handles)
+            : m_edges(edges), m_handles(handles) {}
+
+        const_iterator begin() const { return const_iterator(m_edges, m_handles->constData()); }
+        const_iterator end() const { return const_iterator(m_edges, m_handles->constData() + m_handles->size()); }
+        int size() const { return m_handles->size(); }
+        bool isEmpty() const { return m_handles->isEmpty(); }
+
+    private:
+        const SlotMap<ConceptEdge>* m_edges;
+        const QVector<SlotHandle>* m_handles;
+    };
+
+    /**
+     * @brief 相邻节点区间（不复制节点数据）
+     *
+     * 先遍历出边的目标节点，再遍历入边的源节点。自环或双向连接会使
+     * 同一个节点出现多次。区间在概念图被修改后失效。
+     */
+    class NeighborRange
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ConceptNode;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ConceptNode*;
+            using reference = const ConceptNode&;
+
+            const_iterator(const NeighborRange* range, int pos)
+                : m_range(range), m_pos(pos) {}
+
+            reference operator*() const { return *m_range->neighborAt(m_pos); }
+            pointer operator->() const { return m_range->neighborAt(m_pos); }
+            const_iterator& operator++() { ++m_pos; return *this; }
+            bool operator==(const const_iterator& other) const { return m_pos == other.m_pos; }
+            bool operator!=(const const_iterator& other) const { return m_pos != other.m_pos; }
+
+        private:
+            const NeighborRange* m_range;
+            int m_pos;
+        };
+
+        NeighborRange(const ConceptMap* map, const QVector<SlotHandle>* outHandles,
+                      const QVector<SlotHandle>* inHandles)
+            : m_map(map), m_out(outHandles), m_in(inHandles) {}
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        int size() const { return m_out->size() + m_in->size(); }
+        bool isEmpty() const { return size() == 0; }
+
+    private:
+        const ConceptNode* neighborAt(int pos) const;
+
+        const ConceptMap* m_map;
+        const QVector<SlotHandle>* m_out;
+        const QVector<SlotHandle>* m_in;
+    };
+
     /**
      * @brief 构造函数 - 创建一个空的概念图
      */
@@ -52,64 +184,120 @@ public:
 
     /**
      * @brief 获取所有节点
-     * @return 节点列表
+     * @return 节点列表（复制为连续数组）
      */
-    QVector<ConceptNode> nodes() const { return m_nodes; }
+    QVector<ConceptNode> nodes() const { return m_nodes.values().toVector(); }
 
     /**
      * @brief 获取所有连接线
-     * @return 连接线列表
+     * @return 连接线列表（复制为连续数组）
      */
-    QVector<ConceptEdge> edges() const { return m_edges; }
+    QVector<ConceptEdge> edges() const { return m_edges.values().toVector(); }
 
     /**
-     * @brief 根据ID获取节点
-     * @param id 节点ID
-     * @return 节点指针，如果不存在则返回 nullptr
+     * @brief 遍历所有节点（不复制）
+     * @return 节点数组
      */
-    ConceptNode* nodeById(const QString& id);
+    const ChunkedVector<ConceptNode>& allNodes() const { return m_nodes.values(); }
 
     /**
-     * @brief 根据ID获取节点（常量版本）
-     * @param id 节点ID
-     * @return 节点指针，如果不存在则返回 nullptr
+     * @brief 遍历所有连接线（不复制）
+     * @return 连接线数组
      */
-    const ConceptNode* nodeById(const QString& id) const;
+    const ChunkedVector<ConceptEdge>& allEdges() const { return m_edges.values(); }
 
     /**
-     * @brief 根据ID获取连接线
-     * @param id 连接线ID
-     * @return 连接线指针，如果不存在则返回 nullptr
+     * @brief 创建只读快照
+     *
+     * 快照与当前数据共享存储，创建代价为 O(1)。
+     *
+     * @return 快照
      */
-    ConceptEdge* edgeById(const QString& id);
+    ConceptMapSnapshot snapshot() const;
 
     /**
-     * @brief 根据ID获取连接线（常量版本）
+     * @brief 根据ID获取节点（只读，修改节点用 updateNode() 或 setNodePos()）
+     * @param id 节点ID
+     * @return 节点指针，如果不存在则返回 nullptr
+     */
+    const ConceptNode* nodeById(NodeId id) const;
+
+    /**
+     * @brief 根据ID获取连接线（只读，修改连接线用 updateEdge()）
      * @param id 连接线ID
      * @return 连接线指针，如果不存在则返回 nullptr
      */
-    const ConceptEdge* edgeById(const QString& id) const;
+    const ConceptEdge* edgeById(EdgeId id) const;
 
     /**
      * @brief 获取与指定节点相关的所有连接线
      * @param nodeId 节点ID
      * @return 连接线列表
      */
-    QVector<ConceptEdge> edgesByNodeId(const QString& nodeId) const;
+    QVector<ConceptEdge> edgesByNodeId(NodeId nodeId) const;
+
+    /**
+     * @brief 获取与指定节点相关的所有连接线ID
+     * @param nodeId 节点ID
+     * @return 连接线ID列表
+     */
+    QVector<EdgeId> edgeIdsByNodeId(NodeId nodeId) const;
+
+    /**
+     * @brief 获取以指定节点为源节点的连接线
+     * @param nodeId 节点ID
+     * @return 出边区间
+     */
+    EdgeRange outEdges(NodeId nodeId) const;
+
+    /**
+     * @brief 获取以指定节点为目标节点的连接线
+     * @param nodeId 节点ID
+     * @return 入边区间
+     */
+    EdgeRange inEdges(NodeId nodeId) const;
+
+    /**
+     * @brief 获取与指定节点直接相连的节点
+     * @param nodeId 节点ID
+     * @return 相邻节点区间
+     */
+    NeighborRange neighbors(NodeId nodeId) const;
 
     /**
      * @brief 检查节点是否存在
      * @param id 节点ID
      * @return 如果存在返回 true，否则返回 false
      */
-    bool hasNode(const QString& id) const;
+    bool hasNode(NodeId id) const;
 
     /**
      * @brief 检查连接线是否存在
      * @param id 连接线ID
      * @return 如果存在返回 true，否则返回 false
      */
-    bool hasEdge(const QString& id) const;
+    bool hasEdge(EdgeId id) const;
+
+    // 几何查询
+    /**
+     * @brief 获取所有节点的包围盒
+     * @return 包围盒，没有节点时返回空矩形
+     */
+    QRectF nodesBoundingRect() const;
+
+    /**
+     * @brief 获取与矩形相交的节点
+     * @param rect 查询矩形
+     * @return 节点ID列表
+     */
+    QVector<NodeId> nodesIntersecting(const QRectF& rect) const;
+
+    /**
+     * @brief 获取离指定点最近的节点
+     * @param point 查询点
+     * @return 节点ID，没有节点时返回 InvalidId
+     */
+    NodeId nearestNode(const QPointF& point) const;
 
     // Setter 方法
     /**
@@ -137,7 +325,7 @@ public:
      * @param id 要删除的节点ID
      * @return 如果成功删除返回 true，如果不存在则返回 false
      */
-    bool removeNode(const QString& id);
+    bool removeNode(NodeId id);
 
     /**
      * @brief 更新节点
@@ -146,6 +334,27 @@ public:
      */
     bool updateNode(const ConceptNode& node);
 
+    /**
+     * @brief 设置节点位置
+     * @param id 节点ID
+     * @param pos 新的位置
+     * @return 如果成功设置返回 true，如果不存在则返回 false
+     */
+    bool setNodePos(NodeId id, const QPointF& pos);
+
+    /**
+     * @brief 平移所有节点
+     * @param delta 平移量
+     */
+    void translateNodes(const QPointF& delta);
+
+    /**
+     * @brief 平移指定节点
+     * @param ids 节点ID列表
+     * @param delta 平移量
+     */
+    void translateNodes(const QVector<NodeId>& ids, const QPointF& delta);
+
     /**
      * @brief 清空所有节点
      */
@@ -164,7 +373,7 @@ public:
      * @param id 要删除的连接线ID
      * @return 如果成功删除返回 true，如果不存在则返回 false
      */
-    bool removeEdge(const QString& id);
+    bool removeEdge(EdgeId id);
 
     /**
      * @brief 更新连接线
@@ -183,6 +392,39 @@ public:
      */
     void clear();
 
+    // 事务
+    /**
+     * @brief 开始事务
+     *
+     * 事务可以嵌套，只有最外层的 commit() 返回累计的变更记录。
+     */
+    void beginTransaction();
+
+    /**
+     * @brief 提交事务
+     * @return 最外层提交时返回事务期间的变更记录，嵌套提交返回空记录
+     */
+    ChangeSet commit();
+
+    /**
+     * @brief 检查是否处于事务中
+     * @return 如果处于事务中返回 true，否则返回 false
+     */
+    bool inTransaction() const { return m_transactionDepth > 0; }
+
+    /**
+     * @brief 批量加载节点和连接线
+     *
+     * 用于从文件加载：替换概念图中的现有内容，按记录数预留容量，
+     * 把记录移动进来后一次性建立索引和邻接表。ID 重复的记录，以及
+     * 端点不存在的连接线，在全部记录载入后统一剔除。
+     *
+     * @param nodes 节点列表（内容被移走）
+     * @param edges 连接线列表（内容被移走）
+     * @return 被剔除的记录数量
+     */
+    int bulkLoad(QVector<ConceptNode>&& nodes, QVector<ConceptEdge>&& edges);
+
     /**
      * @brief 获取节点数量
      * @return 节点数量
@@ -202,12 +444,55 @@ public:
     bool isEmpty() const { return m_nodes.isEmpty() && m_edges.isEmpty(); }
 
 private:
+    /**
+     * @brief 把连接线登记到两端节点的邻接表
+     * @param edge 连接线
+     * @param handle 连接线句柄
+     */
+    void attachEdge(const ConceptEdge& edge, const SlotHandle& handle);
+
+    /**
+     * @brief 从两端节点的邻接表中移除连接线
+     * @param edge 连接线
+     * @param handle 连接线句柄
+     */
+    void detachEdge(const ConceptEdge& edge, const SlotHandle& handle);
+
+    /**
+     * @brief 检查是否需要记录变更
+     */
+    bool isRecording() const { return m_transactionDepth > 0; }
+
+    /**
+     * @brief 驻留节点中的重复字符串
+     * @param node 节点
+     */
+    void internStrings(ConceptNode& node);
+
+    /**
+     * @brief 驻留连接线中的重复字符串
+     * @param edge 连接线
+     */
+    void internStrings(ConceptEdge& edge);
+
+    /**
+     * @brief 获取邻接表，不存在时返回空表
+     */
+    static const QVector<SlotHandle>& adjacency(const ChunkedHash<NodeId, QVector<SlotHandle>>& lists,
+                                                NodeId nodeId);
+
     QString m_name;                       // 概念图名称
     QString m_version;                    // 概念图版本
-    QVector<ConceptNode> m_nodes;         // 节点列表
-    QVector<ConceptEdge> m_edges;         // 连接线列表
-    QMap<QString, int> m_nodeIndexMap;    // 节点ID到索引的映射
-    QMap<QString, int> m_edgeIndexMap;    // 连接线ID到索引的映射
+    SlotMap<ConceptNode> m_nodes;               // 节点存储
+    SlotMap<ConceptEdge> m_edges;               // 连接线存储
+    ChunkedHash<NodeId, SlotHandle> m_nodeIndex;            // 节点ID到句柄的映射
+    ChunkedHash<EdgeId, SlotHandle> m_edgeIndex;            // 连接线ID到句柄的映射
+    ChunkedHash<NodeId, QVector<SlotHandle>> m_outEdges;    // 节点ID到出边的邻接表
+    ChunkedHash<NodeId, QVector<SlotHandle>> m_inEdges;     // 节点ID到入边的邻接表
+    StringPool m_strings;                       // 样式名和标签的驻留池
+    NodeGeometry m_geometry;                    // 节点几何列存储（下标与节点稠密数组一致）
+    int m_transactionDepth = 0;                 // 事务嵌套深度
+    ChangeSet m_journal;                        // 当前事务的变更记录
 };
 
 #endif // CONCEPTMAP_H
@@ -0,0 +1,450 @@
+#include "conceptmapbinary.h"
+#include "operationprogress.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QHash>
+#include <QBitArray>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+constexpr char Magic[4] = { 'C', 'M', 'P', 'B' };
+constexpr qint64 HeaderSize = 64;          // 文件头字节数
+constexpr qint64 NodeRecordSize = 56;      // 节点记录字节数
+constexpr qint64 EdgeRecordSize = 32;      // 连接线记录字节数
+constexpr qint64 StringEntrySize = 8;      // 字符串索引条目字节数
+constexpr quint32 NoIndex = 0xFFFFFFFFu;   // 连接线端点不在节点记录中
+constexpr int WriteBatchSize = 64 * 1024;  // 写入时的批量缓冲区大小
+
+// 文件头字段偏移
+enum HeaderField {
+    HeaderMajor = 4,
+    HeaderMinor = 6,
+    HeaderNodeCount = 8,
+    HeaderEdgeCount = 12,
+    HeaderStringCount = 16,
+    HeaderName = 20,
+    HeaderVersion = 24,
+    HeaderNodeOffset = 32,
+    HeaderEdgeOffset = 40,
+    HeaderStringIndexOffset = 48,
+    HeaderStringDataOffset = 56
+};
+
+// 节点记录字段偏移
+enum NodeField {
+    NodeIdString = 0,
+    NodeTextString = 4,
+    NodeStyleString = 8,
+    NodeColor = 12,
+    NodeX = 16,
+    NodeY = 24,
+    NodeWidth = 32,
+    NodeHeight = 40,
+    NodeShapeByte = 48
+};
+
+// 连接线记录字段偏移
+enum EdgeField {
+    EdgeIdString = 0,
+    EdgeSourceIndex = 4,
+    EdgeTargetIndex = 8,
+    EdgeLabelString = 12,
+    EdgeStyleString = 16,
+    EdgeColor = 20
+};
+
+double readDouble(const uchar* p)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(p);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void writeDouble(uchar* p, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, p);
+}
+
+/**
+ * @brief 读取时使用的字符串表
+ *
+ * 每个字符串只解码一次，引用同一字符串的记录（样式名、重复的标签）共享同一份 QString。
+ * 所有记录都在加载时读完，因此被引用的字符串都会在加载期间解码。
+ */
+class StringTable
+{
+public:
+    StringTable(const uchar* index, const uchar* data, quint32 count)
+        : m_index(index), m_data(data), m_count(count)
+        , m_strings(int(count)), m_decoded(int(count))
+    {
+    }
+
+    /**
+     * @brief 获取字符串，下标越界时记录错误并返回空字符串
+     */
+    QString at(quint32 i)
+    {
+        if (i >= m_count) {
+            m_valid = false;
+            return QString();
+        }
+        if (!m_decoded.testBit(int(i))) {
+            const uchar* entry = m_index + qint64(i) * StringEntrySize;
+            const quint32 offset = qFromLittleEndian<quint32>(entry);
+            const quint32 length = qFromLittleEndian<quint32>(entry + 4);
+            m_strings[int(i)] = QString::fromUtf8(reinterpret_cast<const char*>(m_data + offset), int(length));
+            m_decoded.setBit(int(i));
+        }
+        return m_strings.at(int(i));
+    }
+
+    bool isValid() const { return m_valid; }
+
+private:
+    const uchar* m_index;
+    const uchar* m_data;
+    quint32 m_count;
+    QVector<QString> m_strings;     // 已解码的字符串
+    QBitArray m_decoded;            // 哪些字符串已解码
+    bool m_valid = true;
+};
+
+/**
+ * @brief 写入时使用的字符串表，相同的字符串只存一份
+ */
+class StringTableBuilder
+{
+public:
+    quint32 add(const QString& text)
+    {
+        auto it = m_lookup.constFind(text);
+        if (it != m_lookup.constEnd()) {
+            return it.value();
+        }
+
+        const QByteArray utf8 = text.toUtf8();
+        const quint32 index = quint32(m_lookup.size());
+        if (quint64(m_data.size()) + quint64(utf8.size()) > 0xFFFFFFFFull) {
+            m_overflow = true;
+        }
+
+        uchar entry[StringEntrySize];
+        qToLittleEndian<quint32>(quint32(m_data.size()), entry);
+        qToLittleEndian<quint32>(quint32(utf8.size()), entry + 4);
+        m_entries.append(reinterpret_cast<const char*>(entry), int(StringEntrySize));
+        m_data.append(utf8);
+        m_lookup.insert(text, index);
+        return index;
+    }
+
+    quint32 count() const { return quint32(m_lookup.size()); }
+    const QByteArray& entries() const { return m_entries; }
+    const QByteArray& data() const { return m_data; }
+    bool overflow() const { return m_overflow; }
+
+private:
+    QHash<QString, quint32> m_lookup;   // 字符串到下标的映射
+    QByteArray m_entries;               // 字符串索引
+    QByteArray m_data;                  // 字符串数据
+    bool m_overflow = false;            // 字符串数据超过 4 GiB
+};
+
+} // namespace
+
+/**
+ * @brief 从文件加载概念图
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool ConceptMapBinary::load(const QString& filePath, ConceptMap& map, OperationProgress* progress)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+
+    QString error;
+    bool ok = false;
+    const qint64 size = file.size();
+    if (uchar* data = (size > 0) ? file.map(0, size) : nullptr) {
+        ok = read(data, size, map, &error, progress);
+        file.unmap(data);
+    } else {
+        // 文件系统不支持映射时退回到整体读取
+        const QByteArray content = file.readAll();
+        ok = read(reinterpret_cast<const uchar*>(content.constData()), content.size(), map, &error, progress);
+    }
+
+    if (!ok && !(progress && progress->isCanceled())) {
+        qWarning() << "无效的二进制概念图:" << error;
+    }
+    return ok;
+}
+
+/**
+ * @brief 从内存中的文件内容读取概念图
+ * @param data 文件内容起始地址
+ * @param size 文件内容字节数
+ * @param map 概念图对象
+ * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool ConceptMapBinary::read(const uchar* data, qint64 size, ConceptMap& map, QString* errorMessage,
+                            OperationProgress* progress)
+{
+    auto failed = [errorMessage](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    // 文件头
+    if (size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return failed(QStringLiteral("文件头不匹配"));
+    }
+    const quint16 major = qFromLittleEndian<quint16>(data + HeaderMajor);
+    if (major != MajorVersion) {
+        return failed(QStringLiteral("不支持的文件版本: %1").arg(major));
+    }
+
+    const quint32 nodeCount = qFromLittleEndian<quint32>(data + HeaderNodeCount);
+    const quint32 edgeCount = qFromLittleEndian<quint32>(data + HeaderEdgeCount);
+    const quint32 stringCount = qFromLittleEndian<quint32>(data + HeaderStringCount);
+    const quint64 nodeOffset = qFromLittleEndian<quint64>(data + HeaderNodeOffset);
+    const quint64 edgeOffset = qFromLittleEndian<quint64>(data + HeaderEdgeOffset);
+    const quint64 stringIndexOffset = qFromLittleEndian<quint64>(data + HeaderStringIndexOffset);
+    const quint64 stringDataOffset = qFromLittleEndian<quint64>(data + HeaderStringDataOffset);
+
+    // 各段必须完整落在文件内
+    const quint64 fileSize = quint64(size);
+    auto fits = [fileSize](quint64 offset, quint64 count, quint64 recordSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / recordSize;
+    };
+    if (!fits(nodeOffset, nodeCount, NodeRecordSize)
+        || !fits(edgeOffset, edgeCount, EdgeRecordSize)
+        || !fits(stringIndexOffset, stringCount, StringEntrySize)
+        || stringDataOffset > fileSize) {
+        return failed(QStringLiteral("段偏移超出文件范围"));
+    }
+
+    // 字符串索引只校验范围，不解码
+    const uchar* stringIndex = data + stringIndexOffset;
+    const quint64 stringDataSize = fileSize - stringDataOffset;
+    for (quint32 i = 0; i < stringCount; ++i) {
+        const uchar* entry = stringIndex + qint64(i) * StringEntrySize;
+        const quint64 offset = qFromLittleEndian<quint32>(entry);
+        const quint64 length = qFromLittleEndian<quint32>(entry + 4);
+        if (offset + length > stringDataSize) {
+            return failed(QStringLiteral("字符串超出文件范围"));
+        }
+    }
+    StringTable strings(stringIndex, data + stringDataOffset, stringCount);
+    if (progress) {
+        progress->addTotal(qint64(nodeCount) + qint64(edgeCount));
+    }
+    ProgressReporter reporter(progress);
+
+    // 节点记录，UUID 先暂存，整批换成句柄
+    QVector<ConceptNode> nodes;
+    QVector<QString> nodeUuids;
+    nodes.reserve(int(nodeCount));
+    nodeUuids.reserve(int(nodeCount));
+    const uchar* record = data + nodeOffset;
+    for (quint32 i = 0; i < nodeCount; ++i, record += NodeRecordSize) {
+        ConceptNode node(InvalidId);
+        nodeUuids.append(strings.at(qFromLittleEndian<quint32>(record + NodeIdString)));
+        node.setText(strings.at(qFromLittleEndian<quint32>(record + NodeTextString)));
+        node.setStyle(strings.at(qFromLittleEndian<quint32>(record + NodeStyleString)));
+        node.setColor(QColor::fromRgba(qFromLittleEndian<quint32>(record + NodeColor)));
+        node.setPos(QPointF(readDouble(record + NodeX), readDouble(record + NodeY)));
+        node.setSize(QSizeF(readDouble(record + NodeWidth), readDouble(record + NodeHeight)));
+        const quint8 shape = record[NodeShapeByte];
+        node.setShape(shape <= quint8(NodeShape::RoundedRect) ? NodeShape(shape) : NodeShape::Rectangle);
+        nodes.append(std::move(node));
+        if (!reporter.step()) {
+            return failed(QStringLiteral("已取消"));
+        }
+    }
+    const QVector<NodeId> nodeIds = IdRegistry::fromUuids(nodeUuids);
+    nodeUuids = QVector<QString>();
+    for (int i = 0; i < nodes.size(); ++i) {
+        nodes[i].setId(nodeIds.at(i));
+    }
+
+    // 连接线记录，端点按节点记录下标解析，不需要再查 UUID
+    QVector<ConceptEdge> edges;
+    QVector<QString> edgeUuids;
+    edges.reserve(int(edgeCount));
+    edgeUuids.reserve(int(edgeCount));
+    record = data + edgeOffset;
+    for (quint32 i = 0; i < edgeCount; ++i, record += EdgeRecordSize) {
+        const quint32 source = qFromLittleEndian<quint32>(record + EdgeSourceIndex);
+        const quint32 target = qFromLittleEndian<quint32>(record + EdgeTargetIndex);
+        ConceptEdge edge(InvalidId);
+        edge.setSourceNodeId(source < nodeCount ? nodeIds.at(int(source)) : InvalidId);
+        edge.setTargetNodeId(target < nodeCount ? nodeIds.at(int(target)) : InvalidId);
+        edgeUuids.append(strings.at(qFromLittleEndian<quint32>(record + EdgeIdString)));
+        edge.setLabel(strings.at(qFromLittleEndian<quint32>(record + EdgeLabelString)));
+        edge.setStyle(strings.at(qFromLittleEndian<quint32>(record + EdgeStyleString)));
+        edge.setColor(QColor::fromRgba(qFromLittleEndian<quint32>(record + EdgeColor)));
+        edges.append(std::move(edge));
+        if (!reporter.step()) {
+            return failed(QStringLiteral("已取消"));
+        }
+    }
+    const QVector<EdgeId> edgeIds = IdRegistry::fromUuids(edgeUuids);
+    for (int i = 0; i < edges.size(); ++i) {
+        edges[i].setId(edgeIds.at(i));
+    }
+
+    const QString name = strings.at(qFromLittleEndian<quint32>(data + HeaderName));
+    const QString version = strings.at(qFromLittleEndian<quint32>(data + HeaderVersion));
+    if (!strings.isValid()) {
+        return failed(QStringLiteral("字符串下标越界"));
+    }
+
+    // 全部解析成功后才修改概念图
+    map.setName(name);
+    map.setVersion(version);
+    const int rejected = map.bulkLoad(std::move(nodes), std::move(edges));
+    if (rejected > 0) {
+        qWarning() << "忽略无效记录（ID重复或连接线端点不存在）:" << rejected;
+    }
+    return true;
+}
+
+/**
+ * @brief 保存概念图到文件（写完后原子替换目标文件）
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapBinary::save(const QString& filePath, const ConceptMap& map, OperationProgress* progress)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+
+    StringTableBuilder strings;
+    const quint32 nameString = strings.add(map.name());
+    const quint32 versionString = strings.add(map.version());
+
+    if (progress) {
+        progress->addTotal(map.nodeCount() + map.edgeCount());
+    }
+    ProgressReporter reporter(progress);
+
+    // 文件头最后回填，先占位
+    QByteArray batch(int(HeaderSize), '\0');
+    batch.reserve(WriteBatchSize + int(NodeRecordSize));
+    bool ok = true;
+    auto flushBatch = [&]() {
+        if (file.write(batch) != batch.size()) {
+            ok = false;
+        }
+        batch.resize(0);
+    };
+
+    // 节点记录
+    QHash<NodeId, quint32> nodeIndex;
+    nodeIndex.reserve(map.nodeCount());
+    for (const ConceptNode& node : map.allNodes()) {
+        uchar record[NodeRecordSize] = {};
+        qToLittleEndian<quint32>(strings.add(IdRegistry::toUuid(node.id())), record + NodeIdString);
+        qToLittleEndian<quint32>(strings.add(node.text()), record + NodeTextString);
+        qToLittleEndian<quint32>(strings.add(node.style()), record + NodeStyleString);
+        qToLittleEndian<quint32>(node.color().rgba(), record + NodeColor);
+        writeDouble(record + NodeX, node.x());
+        writeDouble(record + NodeY, node.y());
+        writeDouble(record + NodeWidth, node.width());
+        writeDouble(record + NodeHeight, node.height());
+        record[NodeShapeByte] = quint8(node.shape());
+
+        nodeIndex.insert(node.id(), quint32(nodeIndex.size()));
+        batch.append(reinterpret_cast<const char*>(record), int(NodeRecordSize));
+        if (batch.size() >= WriteBatchSize) {
+            flushBatch();
+        }
+        if (!reporter.step()) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+
+    // 连接线记录
+    for (const ConceptEdge& edge : map.allEdges()) {
+        uchar record[EdgeRecordSize] = {};
+        qToLittleEndian<quint32>(strings.add(IdRegistry::toUuid(edge.id())), record + EdgeIdString);
+        qToLittleEndian<quint32>(nodeIndex.value(edge.sourceNodeId(), NoIndex), record + EdgeSourceIndex);
+        qToLittleEndian<quint32>(nodeIndex.value(edge.targetNodeId(), NoIndex), record + EdgeTargetIndex);
+        qToLittleEndian<quint32>(strings.add(edge.label()), record + EdgeLabelString);
+        qToLittleEndian<quint32>(strings.add(edge.style()), record + EdgeStyleString);
+        qToLittleEndian<quint32>(edge.color().rgba(), record + EdgeColor);
+
+        batch.append(reinterpret_cast<const char*>(record), int(EdgeRecordSize));
+        if (batch.size() >= WriteBatchSize) {
+            flushBatch();
+        }
+        if (!reporter.step()) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+    flushBatch();
+
+    // 字符串索引和数据
+    const quint32 nodeCount = quint32(map.nodeCount());
+    const quint32 edgeCount = quint32(map.edgeCount());
+    const quint64 nodeOffset = quint64(HeaderSize);
+    const quint64 edgeOffset = nodeOffset + quint64(nodeCount) * NodeRecordSize;
+    const quint64 stringIndexOffset = edgeOffset + quint64(edgeCount) * EdgeRecordSize;
+    const quint64 stringDataOffset = stringIndexOffset + quint64(strings.count()) * StringEntrySize;
+    if (file.write(strings.entries()) != strings.entries().size()
+        || file.write(strings.data()) != strings.data().size()) {
+        ok = false;
+    }
+
+    // 回填文件头
+    uchar header[HeaderSize] = {};
+    std::memcpy(header, Magic, sizeof(Magic));
+    qToLittleEndian<quint16>(MajorVersion, header + HeaderMajor);
+    qToLittleEndian<quint16>(MinorVersion, header + HeaderMinor);
+    qToLittleEndian<quint32>(nodeCount, header + HeaderNodeCount);
+    qToLittleEndian<quint32>(edgeCount, header + HeaderEdgeCount);
+    qToLittleEndian<quint32>(strings.count(), header + HeaderStringCount);
+    qToLittleEndian<quint32>(nameString, header + HeaderName);
+    qToLittleEndian<quint32>(versionString, header + HeaderVersion);
+    qToLittleEndian<quint64>(nodeOffset, header + HeaderNodeOffset);
+    qToLittleEndian<quint64>(edgeOffset, header + HeaderEdgeOffset);
+    qToLittleEndian<quint64>(stringIndexOffset, header + HeaderStringIndexOffset);
+    qToLittleEndian<quint64>(stringDataOffset, header + HeaderStringDataOffset);
+    if (!file.seek(0) || file.write(reinterpret_cast<const char*>(header), HeaderSize) != HeaderSize) {
+        ok = false;
+    }
+
+    if (!ok || strings.overflow()) {
+        qWarning() << "写入文件失败:" << (strings.overflow() ? QStringLiteral("字符串数据超过 4 GiB") : file.errorString());
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef CONCEPTMAPBINARY_H
+#define CONCEPTMAPBINARY_H
+
+#include <QString>
+#include "conceptmap.h"
+
+class OperationProgress;
+
+/**
+ * @brief 概念图二进制格式（.cmapb）
+ *
+ * 文件布局（所有整数和浮点数均为小端序）：
+ * - 文件头（64 字节）：魔数 "CMPB"、主/次版本号、记录数量、各段的偏移
+ * - 节点记录：每条 56 字节，字段位置固定
+ * - 连接线记录：每条 32 字节，端点保存为节点记录的下标
+ * - 字符串索引：每条 8 字节（数据偏移、UTF-8 字节长度）
+ * - 字符串数据：去重后的 UTF-8 字符串，依次紧排
+ *
+ * 记录中的 ID、文本、样式、标签都保存为字符串索引的下标，相同的字符串只存一份。
+ * 读取时用 QFile::map 映射整个文件，直接在映射内存上按偏移读取定长记录，
+ * 不经过读缓冲区；每个字符串只解码一次，引用它的记录共享同一份 QString，
+ * 记录中的 UUID 整批换成句柄（IdRegistry::fromUuids）。
+ *
+ * 主版本号不同的文件拒绝读取；次版本号只用于向后兼容的扩展（例如使用保留字节）。
+ */
+class ConceptMapBinary
+{
+public:
+    static constexpr quint16 MajorVersion = 1;     // 不兼容修改时递增
+    static constexpr quint16 MinorVersion = 0;     // 向后兼容的扩展时递增
+
+    /**
+     * @brief 从文件加载概念图
+     *
+     * 解析失败时概念图保持不变。
+     *
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    static bool load(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从内存中的文件内容读取概念图
+     * @param data 文件内容起始地址
+     * @param size 文件内容字节数
+     * @param map 概念图对象
+     * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool read(const uchar* data, qint64 size, ConceptMap& map, QString* errorMessage = nullptr,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 保存概念图到文件（写完后原子替换目标文件）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool save(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+};
+
+#endif // CONCEPTMAPBINARY_H
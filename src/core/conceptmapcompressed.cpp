@@ -0,0 +1,422 @@
+#include "conceptmapcompressed.h"
+#include "conceptmapjson.h"
+#include "operationprogress.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+constexpr char Magic[4] = { 'C', 'M', 'P', 'Z' };
+constexpr qint64 HeaderSize = 24;          // 文件头字节数
+constexpr qint64 FrameHeaderSize = 8;      // 分块头字节数
+constexpr quint16 PayloadJson = 0;         // 内容为文档格式的 JSON
+constexpr quint64 MaxDeflateRatio = 1032;  // deflate 的最大压缩比（解压后 / 压缩后）
+constexpr qint64 QCompressHeaderSize = 4;  // qCompress 输出开头的解压后字节数（大端序）
+
+// 文件头字段偏移
+enum HeaderField {
+    HeaderMajor = 4,
+    HeaderMinor = 6,
+    HeaderPayload = 8,
+    HeaderChunkCount = 12,
+    HeaderRawSize = 16
+};
+
+// 分块头字段偏移
+enum FrameField {
+    FrameRawSize = 0,
+    FrameCompressedSize = 4
+};
+
+/**
+ * @brief 读取时一个分块的位置
+ */
+struct Frame
+{
+    qint64 offset = 0;          // 压缩数据在文件中的位置
+    quint32 compressedSize = 0;
+    quint32 rawSize = 0;
+};
+
+/**
+ * @brief 分块压缩写入设备
+ *
+ * 写入的数据按 ChunkSize 切块，攒够一批（每个线程一块）后并行压缩，
+ * 再按顺序写到目标设备，内存中最多同时保留一批分块。
+ */
+class ChunkWriter : public QIODevice
+{
+public:
+    explicit ChunkWriter(QIODevice* target)
+        : m_target(target)
+        , m_batchSize(qMax(1, QThread::idealThreadCount()))
+    {
+        m_current.reserve(ConceptMapCompressed::ChunkSize);
+    }
+
+    /**
+     * @brief 压缩并写出剩余的数据
+     * @return 如果全部写入成功返回 true，否则返回 false
+     */
+    bool finish()
+    {
+        if (!m_current.isEmpty()) {
+            m_pending.append(m_current);
+            m_current.clear();
+        }
+        return flushPending() && !m_error;
+    }
+
+    quint32 chunkCount() const { return m_chunkCount; }
+    quint64 rawSize() const { return m_rawSize; }
+
+protected:
+    qint64 readData(char*, qint64) override
+    {
+        return -1;
+    }
+
+    qint64 writeData(const char* data, qint64 length) override
+    {
+        qint64 written = 0;
+        while (written < length) {
+            const qint64 room = ConceptMapCompressed::ChunkSize - m_current.size();
+            const qint64 take = qMin(room, length - written);
+            m_current.append(data + written, take);
+            written += take;
+            if (m_current.size() == ConceptMapCompressed::ChunkSize) {
+                m_pending.append(m_current);
+                m_current.clear();
+                if (m_pending.size() >= m_batchSize && !flushPending()) {
+                    return -1;
+                }
+            }
+        }
+        m_rawSize += quint64(length);
+        return length;
+    }
+
+private:
+    bool flushPending()
+    {
+        if (m_pending.isEmpty()) {
+            return true;
+        }
+
+        QVector<QByteArray> compressed(m_pending.size());
+        QVector<int> indices(m_pending.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        QtConcurrent::blockingMap(indices, [&](int index) {
+            compressed[index] = qCompress(m_pending[index]);
+        });
+
+        for (int i = 0; i < m_pending.size() && !m_error; ++i) {
+            uchar frame[FrameHeaderSize];
+            qToLittleEndian<quint32>(quint32(m_pending[i].size()), frame + FrameRawSize);
+            qToLittleEndian<quint32>(quint32(compressed[i].size()), frame + FrameCompressedSize);
+            if (m_target->write(reinterpret_cast<const char*>(frame), FrameHeaderSize) != FrameHeaderSize
+                || m_target->write(compressed[i]) != compressed[i].size()) {
+                m_error = true;
+            }
+            ++m_chunkCount;
+        }
+        m_pending.clear();
+        return !m_error;
+    }
+
+    QIODevice* m_target;
+    int m_batchSize;                // 每批并行压缩的分块数量
+    QByteArray m_current;           // 正在填充的分块
+    QVector<QByteArray> m_pending;  // 已填满、等待压缩的分块
+    quint32 m_chunkCount = 0;
+    quint64 m_rawSize = 0;
+    bool m_error = false;
+};
+
+/**
+ * @brief 分块解压读取设备
+ *
+ * ChunkWriter 的逆过程：按顺序每次取一批分块（每个线程一块）并行解压，
+ * 再把解压结果依次交给读取方，内存中最多同时保留一批解压后的分块，
+ * 读取方（JsonStreamReader）边读边解析，不需要先拼出完整的内容。
+ */
+class ChunkReader : public QIODevice
+{
+public:
+    ChunkReader(const uchar* data, const QVector<Frame>& frames, quint64 rawSize, OperationProgress* progress)
+        : m_data(data)
+        , m_frames(frames)
+        , m_rawSize(rawSize)
+        , m_progress(progress)
+        , m_batchSize(qMax(1, QThread::idealThreadCount()))
+        , m_ready(1)
+    {
+    }
+
+    bool isSequential() const override { return true; }
+
+    // 解压后的总字节数，供解析进度使用
+    qint64 size() const override { return qint64(m_rawSize); }
+
+    /**
+     * @brief 检查是否遇到损坏的分块
+     * @return 如果某个分块解压失败返回 true，否则返回 false
+     */
+    bool isCorrupt() const { return m_corrupt; }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        qint64 copied = 0;
+        while (copied < maxSize) {
+            if (m_position == m_ready.at(m_current).size()) {
+                if (!nextChunk()) {
+                    break;
+                }
+                continue;
+            }
+            const QByteArray& chunk = m_ready.at(m_current);
+            const qint64 take = qMin<qint64>(maxSize - copied, chunk.size() - m_position);
+            std::memcpy(data + copied, chunk.constData() + m_position, size_t(take));
+            m_position += take;
+            copied += take;
+        }
+        if (copied == 0 && (m_corrupt || (m_progress && m_progress->isCanceled()))) {
+            return -1;
+        }
+        return copied;
+    }
+
+    qint64 writeData(const char*, qint64) override
+    {
+        return -1;
+    }
+
+private:
+    /**
+     * @brief 切换到下一个解压好的分块，当前一批用完时并行解压下一批
+     * @return 如果还有数据返回 true，到达结尾或出错返回 false
+     */
+    bool nextChunk()
+    {
+        if (m_current + 1 < m_ready.size()) {
+            ++m_current;
+            m_position = 0;
+            return true;
+        }
+        if (m_corrupt || m_next >= m_frames.size() || (m_progress && m_progress->isCanceled())) {
+            return false;
+        }
+
+        const int count = qMin(m_batchSize, int(m_frames.size()) - m_next);
+        QVector<QByteArray> ready(count);
+        QVector<int> indices(count);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::atomic<bool> ok(true);
+        QtConcurrent::blockingMap(indices, [&](int index) {
+            const Frame& frame = m_frames.at(m_next + index);
+            ready[index] = qUncompress(m_data + frame.offset, qsizetype(frame.compressedSize));
+            if (ready[index].size() != qsizetype(frame.rawSize)) {
+                ok = false;
+            } else if (m_progress) {
+                m_progress->advance(FrameHeaderSize + frame.compressedSize);
+            }
+        });
+        if (!ok) {
+            m_corrupt = true;
+            setErrorString(QStringLiteral("分块数据损坏"));
+            return false;
+        }
+
+        m_next += count;
+        m_ready = ready;
+        m_current = 0;
+        m_position = 0;
+        return true;
+    }
+
+    const uchar* m_data;
+    QVector<Frame> m_frames;
+    quint64 m_rawSize;
+    OperationProgress* m_progress;
+    int m_batchSize;                        // 每批并行解压的分块数量
+    QVector<QByteArray> m_ready;            // 当前一批解压好的分块
+    int m_current = 0;                      // 正在读取的分块
+    qint64 m_position = 0;                  // 在当前分块中的读取位置
+    int m_next = 0;                         // 下一批的第一个分块
+    bool m_corrupt = false;
+};
+
+} // namespace
+
+/**
+ * @brief 从文件加载概念图
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool ConceptMapCompressed::load(const QString& filePath, ConceptMap& map, OperationProgress* progress)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+
+    QString error;
+    bool ok = false;
+    const qint64 size = file.size();
+    if (uchar* data = (size > 0) ? file.map(0, size) : nullptr) {
+        ok = read(data, size, map, &error, progress);
+        file.unmap(data);
+    } else {
+        // 文件系统不支持映射时退回到整体读取
+        const QByteArray content = file.readAll();
+        ok = read(reinterpret_cast<const uchar*>(content.constData()), content.size(), map, &error, progress);
+    }
+
+    if (!ok && !(progress && progress->isCanceled())) {
+        qWarning() << "无效的压缩概念图:" << error;
+    }
+    return ok;
+}
+
+/**
+ * @brief 从内存中的文件内容读取概念图
+ * @param data 文件内容起始地址
+ * @param size 文件内容字节数
+ * @param map 概念图对象
+ * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool ConceptMapCompressed::read(const uchar* data, qint64 size, ConceptMap& map, QString* errorMessage,
+                                OperationProgress* progress)
+{
+    auto failed = [errorMessage](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    // 文件头
+    if (size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return failed(QStringLiteral("不是压缩概念图文件"));
+    }
+    const quint16 major = qFromLittleEndian<quint16>(data + HeaderMajor);
+    if (major != MajorVersion) {
+        return failed(QStringLiteral("不支持的文件版本 %1").arg(major));
+    }
+    if (qFromLittleEndian<quint16>(data + HeaderPayload) != PayloadJson) {
+        return failed(QStringLiteral("不支持的内容格式"));
+    }
+    const quint32 chunkCount = qFromLittleEndian<quint32>(data + HeaderChunkCount);
+    const quint64 rawSize = qFromLittleEndian<quint64>(data + HeaderRawSize);
+
+    // 扫描分块头，确定每块的位置
+    QVector<Frame> frames;
+    frames.reserve(int(qMin<quint64>(chunkCount, quint64(size / FrameHeaderSize))));
+    qint64 offset = HeaderSize;
+    quint64 total = 0;
+    for (quint32 i = 0; i < chunkCount; ++i) {
+        if (size - offset < FrameHeaderSize) {
+            return failed(QStringLiteral("文件被截断"));
+        }
+        Frame frame;
+        frame.rawSize = qFromLittleEndian<quint32>(data + offset + FrameRawSize);
+        frame.compressedSize = qFromLittleEndian<quint32>(data + offset + FrameCompressedSize);
+        frame.offset = offset + FrameHeaderSize;
+        if (size - frame.offset < qint64(frame.compressedSize)) {
+            return failed(QStringLiteral("文件被截断"));
+        }
+        // 解压之前先核对分块头：写入时每块不超过 ChunkSize，
+        // 解压后的大小也不可能超过压缩数据的最大压缩比
+        if (frame.rawSize > quint32(ChunkSize)
+            || quint64(frame.rawSize) > quint64(frame.compressedSize) * MaxDeflateRatio) {
+            return failed(QStringLiteral("分块大小无效"));
+        }
+        // qUncompress 按压缩数据开头记录的大小分配缓冲区，它必须与分块头一致
+        if (frame.rawSize > 0
+            && (frame.compressedSize < QCompressHeaderSize
+                || qFromBigEndian<quint32>(data + frame.offset) != frame.rawSize)) {
+            return failed(QStringLiteral("分块大小无效"));
+        }
+        offset = frame.offset + frame.compressedSize;
+        total += frame.rawSize;
+        frames.append(frame);
+    }
+    if (total != rawSize || total > quint64(std::numeric_limits<qint64>::max())) {
+        return failed(QStringLiteral("分块大小与文件头不符"));
+    }
+
+    // 分块按批并行解压，边解压边解析，内存中只保留一批解压后的分块；
+    // 进度按压缩数据的字节数（解压）和解压后的字节数（解析）推进
+    if (progress) {
+        progress->addTotal(offset - HeaderSize);
+    }
+    ChunkReader reader(data, frames, rawSize, progress);
+    reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    if (!ConceptMapJson::read(&reader, map, errorMessage, progress)) {
+        return reader.isCorrupt() ? failed(QStringLiteral("分块数据损坏")) : false;
+    }
+    return true;
+}
+
+/**
+ * @brief 保存概念图到文件（写完后原子替换目标文件）
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapCompressed::save(const QString& filePath, const ConceptMap& map, OperationProgress* progress)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+
+    // 文件头最后回填，先占位
+    bool ok = file.write(QByteArray(int(HeaderSize), '\0')) == HeaderSize;
+
+    ChunkWriter writer(&file);
+    writer.open(QIODevice::WriteOnly);
+    ok = ok && ConceptMapJson::write(&writer, map, ConceptMapJson::DocumentDialect, progress) && writer.finish();
+
+    // 回填文件头
+    uchar header[HeaderSize] = {};
+    std::memcpy(header, Magic, sizeof(Magic));
+    qToLittleEndian<quint16>(MajorVersion, header + HeaderMajor);
+    qToLittleEndian<quint16>(MinorVersion, header + HeaderMinor);
+    qToLittleEndian<quint16>(PayloadJson, header + HeaderPayload);
+    qToLittleEndian<quint32>(writer.chunkCount(), header + HeaderChunkCount);
+    qToLittleEndian<quint64>(writer.rawSize(), header + HeaderRawSize);
+    if (!file.seek(0) || file.write(reinterpret_cast<const char*>(header), HeaderSize) != HeaderSize) {
+        ok = false;
+    }
+
+    // 取消或失败时放弃临时文件，目标文件保持原样
+    if (!ok) {
+        if (!(progress && progress->isCanceled())) {
+            qWarning() << "写入文件失败:" << file.errorString();
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef CONCEPTMAPCOMPRESSED_H
+#define CONCEPTMAPCOMPRESSED_H
+
+#include <QString>
+#include "conceptmap.h"
+
+class OperationProgress;
+
+/**
+ * @brief 压缩概念图格式（.cmapz）
+ *
+ * 内容是文档格式的 JSON（与 FileManager 保存的 .json 相同），按固定大小切块后
+ * 分别用 qCompress 压缩。文件布局（所有整数均为小端序）：
+ * - 文件头（24 字节）：魔数 "CMPZ"、主/次版本号、内容格式、分块数量、解压后的总字节数
+ * - 分块：解压后字节数（4 字节）、压缩后字节数（4 字节）、qCompress 的输出
+ *
+ * 每个分块都可以独立解压。保存时 JSON 写入器的输出边写边压缩，攒够一批分块后
+ * 在线程池中并行压缩再按顺序写出；读取时先扫描分块头，再按批并行解压，
+ * 解压结果按顺序流入 ConceptMapJson 边读边解析。两个方向上内存中都最多只有一批分块，
+ * 不会出现完整的解压后内容。
+ *
+ * 主版本号不同的文件拒绝读取；分块解压后超过 ChunkSize、或超过压缩数据的最大压缩比的
+ * 文件视为损坏，在解压之前拒绝读取。
+ */
+class ConceptMapCompressed
+{
+public:
+    static constexpr quint16 MajorVersion = 1;     // 不兼容修改时递增
+    static constexpr quint16 MinorVersion = 0;     // 向后兼容的扩展时递增
+    static constexpr int ChunkSize = 1024 * 1024;  // 每个分块压缩前的字节数
+
+    /**
+     * @brief 从文件加载概念图
+     *
+     * 解析失败时概念图保持不变。
+     *
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    static bool load(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从内存中的文件内容读取概念图
+     * @param data 文件内容起始地址
+     * @param size 文件内容字节数
+     * @param map 概念图对象
+     * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool read(const uchar* data, qint64 size, ConceptMap& map, QString* errorMessage = nullptr,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 保存概念图到文件（写完后原子替换目标文件）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool save(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+};
+
+#endif // CONCEPTMAPCOMPRESSED_H
@@ -0,0 +1,485 @@
+#include "conceptmapjournal.h"
+#include "recordstream.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+constexpr char Magic[4] = { 'C', 'M', 'P', 'J' };
+constexpr qint64 HeaderSize = 24;          // 文件头字节数
+constexpr qint64 EntryHeaderSize = 8;      // 条目头字节数
+
+// 文件头字段偏移
+enum HeaderField {
+    HeaderMajor = 4,
+    HeaderMinor = 6,
+    HeaderBaseSize = 8,
+    HeaderBaseModified = 16
+};
+
+// 条目头字段偏移
+enum EntryField {
+    EntryLength = 0,
+    EntryChecksum = 4
+};
+
+/**
+ * @brief 基础文件的标识：大小和修改时间
+ */
+struct BaseStamp
+{
+    qint64 size = -1;
+    qint64 modified = -1;
+
+    bool isValid() const { return size >= 0; }
+    bool operator==(const BaseStamp& other) const
+    {
+        return size == other.size && modified == other.modified;
+    }
+};
+
+/**
+ * @brief 读取基础文件当前的标识
+ */
+BaseStamp stampOf(const QString& basePath)
+{
+    BaseStamp stamp;
+    const QFileInfo info(basePath);
+    if (info.exists()) {
+        stamp.size = info.size();
+        stamp.modified = info.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+/**
+ * @brief 生成文件头
+ */
+QByteArray headerFor(const BaseStamp& stamp)
+{
+    uchar header[HeaderSize] = {};
+    std::memcpy(header, Magic, sizeof(Magic));
+    qToLittleEndian<quint16>(ConceptMapJournal::MajorVersion, header + HeaderMajor);
+    qToLittleEndian<quint16>(ConceptMapJournal::MinorVersion, header + HeaderMinor);
+    qToLittleEndian<qint64>(stamp.size, header + HeaderBaseSize);
+    qToLittleEndian<qint64>(stamp.modified, header + HeaderBaseModified);
+    return QByteArray(reinterpret_cast<const char*>(header), HeaderSize);
+}
+
+/**
+ * @brief 读取文件头中记录的标识
+ * @return 文件头无效时返回无效的标识
+ */
+BaseStamp headerStamp(const QByteArray& header)
+{
+    BaseStamp recorded;
+    if (header.size() < HeaderSize || std::memcmp(header.constData(), Magic, sizeof(Magic)) != 0) {
+        return recorded;
+    }
+    const uchar* p = reinterpret_cast<const uchar*>(header.constData());
+    if (qFromLittleEndian<quint16>(p + HeaderMajor) != ConceptMapJournal::MajorVersion) {
+        return recorded;
+    }
+    recorded.size = qFromLittleEndian<qint64>(p + HeaderBaseSize);
+    recorded.modified = qFromLittleEndian<qint64>(p + HeaderBaseModified);
+    return recorded;
+}
+
+/**
+ * @brief 检查文件头是否有效并属于指定的基础文件
+ */
+bool headerMatches(const QByteArray& header, const BaseStamp& stamp)
+{
+    const BaseStamp recorded = headerStamp(header);
+    return recorded.isValid() && recorded == stamp;
+}
+
+/**
+ * @brief 读取日志文件头中记录的标识
+ * @return 文件不存在或文件头无效时返回无效的标识
+ */
+BaseStamp journalStamp(const QString& path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? headerStamp(file.read(HeaderSize)) : BaseStamp();
+}
+
+/**
+ * @brief 检查日志文件是否属于指定的基础文件
+ */
+bool journalMatches(const QString& path, const BaseStamp& stamp)
+{
+    const BaseStamp recorded = journalStamp(path);
+    return recorded.isValid() && recorded == stamp;
+}
+
+/**
+ * @brief 检查当前日志是否属于基础文件
+ *
+ * 当前日志的文件头记录基础文件的标识；整理期间创建的日志接在整理日志之后，
+ * 文件头记录的是整理日志的标识，只要整理日志还在就有效。
+ */
+bool liveJournalMatches(const QString& basePath, const BaseStamp& recorded)
+{
+    if (!recorded.isValid()) {
+        return false;
+    }
+    if (recorded == stampOf(basePath)) {
+        return true;
+    }
+    const BaseStamp compacting = stampOf(ConceptMapJournal::compactingPath(basePath));
+    return compacting.isValid() && recorded == compacting;
+}
+
+/**
+ * @brief 把接在整理日志之后的当前日志改为指向基础文件
+ *
+ * 整理日志的内容已经写入基础文件（或者整理日志已经过时）时调用，必须在删除整理日志之前。
+ */
+void rebaseJournal(const QString& basePath)
+{
+    const QString path = ConceptMapJournal::journalPath(basePath);
+    const BaseStamp compacting = stampOf(ConceptMapJournal::compactingPath(basePath));
+    if (!compacting.isValid() || !journalMatches(path, compacting)) {
+        return;
+    }
+    QFile journal(path);
+    if (!journal.open(QIODevice::ReadWrite) || journal.write(headerFor(stampOf(basePath))) != HeaderSize
+        || !journal.flush()) {
+        qWarning() << "无法更新日志的文件头:" << path;
+    }
+}
+
+/**
+ * @brief 把变更编码为一个条目的内容
+ */
+QByteArray encodeEntry(const ConceptMap& map, const ChangeSet& changes)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << map.name() << map.version();
+
+    // 被删除的ID
+    const QVector<EdgeId> removedEdges = changes.removedEdges();
+    out << quint32(removedEdges.size());
+    for (EdgeId id : removedEdges) {
+        out << IdRegistry::toUuid(id);
+    }
+    const QVector<NodeId> removedNodes = changes.removedNodes();
+    out << quint32(removedNodes.size());
+    for (NodeId id : removedNodes) {
+        out << IdRegistry::toUuid(id);
+    }
+
+    // 插入和修改的节点都写完整记录，重放时不必关心修改了哪些字段
+    QVector<const ConceptNode*> nodes;
+    for (NodeId id : changes.insertedNodes()) {
+        if (const ConceptNode* node = map.nodeById(id)) {
+            nodes.append(node);
+        }
+    }
+    const QHash<NodeId, ChangeSet::NodeFields> modifiedNodes = changes.modifiedNodes();
+    for (auto it = modifiedNodes.constBegin(); it != modifiedNodes.constEnd(); ++it) {
+        if (const ConceptNode* node = map.nodeById(it.key())) {
+            nodes.append(node);
+        }
+    }
+    out << quint32(nodes.size());
+    for (const ConceptNode* node : nodes) {
+        RecordStream::writeNode(out, *node);
+    }
+
+    // 连接线同样写完整记录
+    QVector<const ConceptEdge*> edges;
+    for (EdgeId id : changes.insertedEdges()) {
+        if (const ConceptEdge* edge = map.edgeById(id)) {
+            edges.append(edge);
+        }
+    }
+    const QHash<EdgeId, ChangeSet::EdgeFields> modifiedEdges = changes.modifiedEdges();
+    for (auto it = modifiedEdges.constBegin(); it != modifiedEdges.constEnd(); ++it) {
+        if (const ConceptEdge* edge = map.edgeById(it.key())) {
+            edges.append(edge);
+        }
+    }
+    out << quint32(edges.size());
+    for (const ConceptEdge* edge : edges) {
+        RecordStream::writeEdge(out, *edge);
+    }
+    return payload;
+}
+
+/**
+ * @brief 把一个条目应用到概念图
+ * @return 如果条目内容完整返回 true，否则返回 false（概念图可能已被部分修改）
+ */
+bool applyEntry(const QByteArray& payload, ConceptMap& map)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    QString name;
+    QString version;
+    in >> name >> version;
+
+    quint32 count = 0;
+    QString uuid;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        in >> uuid;
+        map.removeEdge(IdRegistry::fromUuid(uuid));
+    }
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        in >> uuid;
+        map.removeNode(IdRegistry::fromUuid(uuid));
+    }
+
+    in >> count;
+    ConceptNode node(InvalidId);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        if (!RecordStream::readNode(in, node)) {
+            break;
+        }
+        if (map.hasNode(node.id())) {
+            map.updateNode(node);
+        } else {
+            map.addNode(node);
+        }
+    }
+
+    in >> count;
+    ConceptEdge edge(InvalidId);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        if (!RecordStream::readEdge(in, edge)) {
+            break;
+        }
+        if (map.hasEdge(edge.id())) {
+            map.updateEdge(edge);
+        } else {
+            map.addEdge(edge);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    map.setName(name);
+    map.setVersion(version);
+    return true;
+}
+
+/**
+ * @brief 重放一个日志文件
+ * @param path 日志路径
+ * @param accepted 判断文件头记录的标识是否有效
+ * @param map 概念图对象
+ * @return 重放的条目数量
+ */
+template<typename Accept>
+int replayFile(const QString& path, Accept accepted, ConceptMap& map)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray data = file.readAll();
+    if (!accepted(headerStamp(data))) {
+        // 基础文件在日志之后被完整保存过，日志内容已经包含在基础文件中
+        qWarning() << "忽略过时的日志:" << path;
+        return 0;
+    }
+
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    qint64 offset = HeaderSize;
+    int entries = 0;
+    while (data.size() - offset >= EntryHeaderSize) {
+        const quint32 length = qFromLittleEndian<quint32>(p + offset + EntryLength);
+        const quint16 checksum = qFromLittleEndian<quint16>(p + offset + EntryChecksum);
+        if (data.size() - offset - EntryHeaderSize < qint64(length)) {
+            break;
+        }
+        const QByteArray payload = data.mid(offset + EntryHeaderSize, length);
+        if (qChecksum(payload) != checksum || !applyEntry(payload, map)) {
+            break;
+        }
+        offset += EntryHeaderSize + length;
+        ++entries;
+    }
+
+    if (offset != data.size()) {
+        qWarning() << "日志末尾的条目不完整，已忽略:" << path;
+    }
+    return entries;
+}
+
+} // namespace
+
+/**
+ * @brief 获取基础文件对应的日志路径
+ * @param basePath 基础文件路径
+ * @return 日志路径
+ */
+QString ConceptMapJournal::journalPath(const QString& basePath)
+{
+    return basePath + QStringLiteral(".journal");
+}
+
+/**
+ * @brief 获取整理期间改名的日志路径
+ * @param basePath 基础文件路径
+ * @return 日志路径
+ */
+QString ConceptMapJournal::compactingPath(const QString& basePath)
+{
+    return basePath + QStringLiteral(".journal.compacting");
+}
+
+/**
+ * @brief 把变更追加到日志
+ * @param basePath 基础文件路径（必须已存在）
+ * @param map 概念图对象（提供变更记录的当前内容）
+ * @param changes 上次保存以来的变更
+ * @return 如果成功写入返回 true，否则返回 false
+ */
+bool ConceptMapJournal::append(const QString& basePath, const ConceptMap& map, const ChangeSet& changes)
+{
+    const BaseStamp stamp = stampOf(basePath);
+    if (!stamp.isValid()) {
+        qWarning() << "基础文件不存在:" << basePath;
+        return false;
+    }
+
+    // 日志不存在时创建；整理期间（整理日志存在）新日志接在整理日志之后。
+    // 已有但不属于基础文件的日志不是这里创建的，不覆盖，由调用方改为完整保存
+    const QString path = journalPath(basePath);
+    const bool fresh = !QFile::exists(path);
+    if (!fresh && !liveJournalMatches(basePath, journalStamp(path))) {
+        qWarning() << "日志不属于当前的基础文件:" << path;
+        return false;
+    }
+    const BaseStamp compacting = stampOf(compactingPath(basePath));
+    QFile file(path);
+    if (!file.open(fresh ? QIODevice::NewOnly : (QIODevice::WriteOnly | QIODevice::Append))) {
+        qWarning() << "无法打开日志:" << path;
+        return false;
+    }
+
+    const QByteArray payload = encodeEntry(map, changes);
+    uchar entryHeader[EntryHeaderSize] = {};
+    qToLittleEndian<quint32>(quint32(payload.size()), entryHeader + EntryLength);
+    qToLittleEndian<quint16>(qChecksum(payload), entryHeader + EntryChecksum);
+
+    QByteArray entry;
+    entry.reserve((fresh ? HeaderSize : 0) + EntryHeaderSize + payload.size());
+    if (fresh) {
+        entry.append(headerFor(compacting.isValid() ? compacting : stamp));
+    }
+    entry.append(reinterpret_cast<const char*>(entryHeader), EntryHeaderSize);
+    entry.append(payload);
+
+    // 整个条目一次写入，中途失败时截掉写了一半的内容
+    const qint64 start = file.size();
+    if (file.write(entry) != entry.size() || !file.flush()) {
+        qWarning() << "写入日志失败:" << file.errorString();
+        file.resize(start);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 重放基础文件的日志
+ * @param basePath 基础文件路径
+ * @param map 已加载基础文件的概念图对象
+ * @return 重放的条目数量
+ */
+int ConceptMapJournal::replay(const QString& basePath, ConceptMap& map)
+{
+    // 整理日志中的条目早于当前日志。整理已经写完基础文件时整理日志过时，跳过；
+    // 接在它后面的当前日志是相对于整理结果记录的，仍然重放
+    const BaseStamp stamp = stampOf(basePath);
+    const int compacted = replayFile(compactingPath(basePath),
+                                     [&](const BaseStamp& recorded) { return recorded == stamp; }, map);
+    const int live = replayFile(journalPath(basePath),
+                                [&](const BaseStamp& recorded) { return liveJournalMatches(basePath, recorded); }, map);
+    return compacted + live;
+}
+
+/**
+ * @brief 检查日志是否大到需要整理
+ * @param basePath 基础文件路径
+ * @return 如果需要整理返回 true，否则返回 false
+ */
+bool ConceptMapJournal::needsCompaction(const QString& basePath)
+{
+    const qint64 journalSize = QFileInfo(journalPath(basePath)).size();
+    return journalSize >= qMax(MinCompactBytes, QFileInfo(basePath).size() / 4);
+}
+
+/**
+ * @brief 开始整理：把当前日志移到整理日志
+ * @param basePath 基础文件路径
+ * @return 如果成功返回 true，否则返回 false
+ */
+bool ConceptMapJournal::beginCompaction(const QString& basePath)
+{
+    const QString journal = journalPath(basePath);
+    const QString compacting = compactingPath(basePath);
+    const BaseStamp stamp = stampOf(basePath);
+
+    // 过时的整理日志（上次整理已经写完基础文件）丢弃，接在它后面的日志先改为指向基础文件
+    if (QFile::exists(compacting) && !journalMatches(compacting, stamp)) {
+        rebaseJournal(basePath);
+        QFile::remove(compacting);
+    }
+    if (!QFile::exists(compacting)) {
+        return QFile::rename(journal, compacting);
+    }
+
+    // 上次整理失败，把当前日志的条目接到整理日志后面
+    QFile source(journal);
+    QFile target(compacting);
+    if (!source.open(QIODevice::ReadOnly) || !target.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    const QByteArray data = source.readAll();
+    if (!liveJournalMatches(basePath, headerStamp(data))) {
+        return false;
+    }
+    const QByteArray entries = data.mid(HeaderSize);
+    if (target.write(entries) != entries.size() || !target.flush()) {
+        return false;
+    }
+    source.close();
+    return QFile::remove(journal);
+}
+
+/**
+ * @brief 完成整理：基础文件已经完整写入后调用
+ * @param basePath 基础文件路径
+ */
+void ConceptMapJournal::finishCompaction(const QString& basePath)
+{
+    // 整理期间写入的日志是相对于整理结果记录的，先改为指向新的基础文件再删除整理日志；
+    // 两步之间中断时日志仍接在整理日志之后，重放结果相同
+    rebaseJournal(basePath);
+    QFile::remove(compactingPath(basePath));
+}
+
+/**
+ * @brief 删除基础文件的所有日志（完整保存之后调用）
+ * @param basePath 基础文件路径
+ */
+void ConceptMapJournal::discard(const QString& basePath)
+{
+    QFile::remove(journalPath(basePath));
+    QFile::remove(compactingPath(basePath));
+}
@@ -0,0 +1,108 @@
+#ifndef CONCEPTMAPJOURNAL_H
+#define CONCEPTMAPJOURNAL_H
+
+#include <QString>
+#include "conceptmap.h"
+#include "changeset.h"
+
+/**
+ * @brief 概念图增量保存日志
+ *
+ * 保存时只把上次保存以来变化的记录追加到基础文件旁边的日志（"<文件>.journal"），
+ * 保存耗时只与修改量有关，与概念图大小无关。打开文件时先加载基础文件，再按顺序
+ * 重放日志。
+ *
+ * 日志布局（整数均为小端序）：
+ * - 文件头（24 字节）：魔数 "CMPJ"、主/次版本号、基础文件的大小和修改时间
+ * - 条目：内容字节数（4 字节）、内容的 CRC-16（2 字节）、保留（2 字节）、内容
+ *
+ * 每个条目保存概念图名称和版本、被删除的ID、以及被插入或修改的完整记录，
+ * 因此重放是幂等的：同一条目重放两次结果不变。文件头记录的基础文件与磁盘上的
+ * 不一致时（基础文件已被完整保存覆盖），日志已经过时，重放时忽略。
+ * 末尾不完整或校验失败的条目（写入时断电）被丢弃，之前的条目仍然有效。
+ *
+ * 日志过大时整理（compaction）：先把日志改名为 "<文件>.journal.compacting"，
+ * 之后的保存写入新日志，新日志的文件头记录整理日志的标识（接在整理日志之后），
+ * 只要整理日志还在就有效，不受基础文件被整理结果替换的影响；后台把快照完整写入
+ * 基础文件后，先把新日志改为指向新的基础文件，再删除整理日志。
+ *
+ * 已有但不属于基础文件的日志不会被覆盖，追加失败，调用方改为完整保存。
+ */
+class ConceptMapJournal
+{
+public:
+    static constexpr quint16 MajorVersion = 1;             // 不兼容修改时递增
+    static constexpr quint16 MinorVersion = 0;             // 向后兼容的扩展时递增
+    static constexpr qint64 MinCompactBytes = 1024 * 1024; // 日志达到该大小才考虑整理
+
+    /**
+     * @brief 获取基础文件对应的日志路径
+     * @param basePath 基础文件路径
+     * @return 日志路径
+     */
+    static QString journalPath(const QString& basePath);
+
+    /**
+     * @brief 获取整理期间改名的日志路径
+     * @param basePath 基础文件路径
+     * @return 日志路径
+     */
+    static QString compactingPath(const QString& basePath);
+
+    /**
+     * @brief 把变更追加到日志
+     *
+     * 日志不存在时先创建；已有的日志不属于基础文件时不覆盖，返回 false。
+     *
+     * @param basePath 基础文件路径（必须已存在）
+     * @param map 概念图对象（提供变更记录的当前内容）
+     * @param changes 上次保存以来的变更
+     * @return 如果成功写入返回 true，否则返回 false
+     */
+    static bool append(const QString& basePath, const ConceptMap& map, const ChangeSet& changes);
+
+    /**
+     * @brief 重放基础文件的日志
+     * @param basePath 基础文件路径
+     * @param map 已加载基础文件的概念图对象
+     * @return 重放的条目数量
+     */
+    static int replay(const QString& basePath, ConceptMap& map);
+
+    /**
+     * @brief 检查日志是否大到需要整理
+     *
+     * 日志达到 MinCompactBytes 且超过基础文件的四分之一时需要整理。
+     *
+     * @param basePath 基础文件路径
+     * @return 如果需要整理返回 true，否则返回 false
+     */
+    static bool needsCompaction(const QString& basePath);
+
+    /**
+     * @brief 开始整理：把当前日志移到整理日志
+     *
+     * 上一次整理失败留下的整理日志仍然有效，此时把当前日志的条目接在它后面。
+     *
+     * @param basePath 基础文件路径
+     * @return 如果成功返回 true，否则返回 false
+     */
+    static bool beginCompaction(const QString& basePath);
+
+    /**
+     * @brief 完成整理：基础文件已经完整写入后调用
+     *
+     * 把整理期间写入的新日志指向新的基础文件，然后删除整理日志。
+     *
+     * @param basePath 基础文件路径
+     */
+    static void finishCompaction(const QString& basePath);
+
+    /**
+     * @brief 删除基础文件的所有日志（完整保存之后调用）
+     * @param basePath 基础文件路径
+     */
+    static void discard(const QString& basePath);
+};
+
+#endif // CONCEPTMAPJOURNAL_H
@@ -0,0 +1,721 @@
+#include "conceptmapjson.h"
+#include "jsonstream.h"
+#include "conceptmapxml.h"
+#include "recordbatch.h"
+#include "operationprogress.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+#include <atomic>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief 读取字符串值，类型不符时跳过该值并保持默认值
+ */
+bool readStringValue(JsonStreamReader& reader, QString& out)
+{
+    switch (reader.readNext()) {
+        case JsonStreamReader::String:
+            out = reader.text();
+            return true;
+        case JsonStreamReader::Invalid:
+            return false;
+        default:
+            return reader.skipValue();
+    }
+}
+
+/**
+ * @brief 读取数值，类型不符时跳过该值并保持默认值
+ */
+bool readNumberValue(JsonStreamReader& reader, qreal& out)
+{
+    switch (reader.readNext()) {
+        case JsonStreamReader::Number:
+            out = reader.number();
+            return true;
+        case JsonStreamReader::Invalid:
+            return false;
+        default:
+            return reader.skipValue();
+    }
+}
+
+/**
+ * @brief 读取颜色值：{"red","green","blue"} 对象、"#rrggbb" 或 "r,g,b"
+ */
+bool readColorValue(JsonStreamReader& reader, QColor& out)
+{
+    switch (reader.readNext()) {
+        case JsonStreamReader::String: {
+            const QColor color = ConceptMapXml::colorFromString(reader.text());
+            if (color.isValid()) {
+                out = color;
+            }
+            return true;
+        }
+        case JsonStreamReader::BeginObject: {
+            qreal red = 0;
+            qreal green = 0;
+            qreal blue = 0;
+            qreal alpha = 255;
+            while (reader.readNext() == JsonStreamReader::Name) {
+                const QString key = reader.text();
+                bool ok = true;
+                if (key == QLatin1String("red")) {
+                    ok = readNumberValue(reader, red);
+                } else if (key == QLatin1String("green")) {
+                    ok = readNumberValue(reader, green);
+                } else if (key == QLatin1String("blue")) {
+                    ok = readNumberValue(reader, blue);
+                } else if (key == QLatin1String("alpha")) {
+                    ok = readNumberValue(reader, alpha);
+                } else {
+                    ok = reader.skipValue();
+                }
+                if (!ok) {
+                    return false;
+                }
+            }
+            out = QColor(int(red), int(green), int(blue), int(alpha));
+            return reader.tokenType() == JsonStreamReader::EndObject;
+        }
+        case JsonStreamReader::Invalid:
+            return false;
+        default:
+            return reader.skipValue();
+    }
+}
+
+/**
+ * @brief 读取一个节点对象（BeginObject 已读过）
+ */
+bool readNode(JsonStreamReader& reader, RecordBatch& batch)
+{
+    ConceptNode node(InvalidId);
+    QString id;
+    QString text = node.text();
+    QString style = node.style();
+    qreal x = node.x();
+    qreal y = node.y();
+    qreal width = node.width();
+    qreal height = node.height();
+    QColor color = node.color();
+
+    while (reader.readNext() == JsonStreamReader::Name) {
+        const QString key = reader.text();
+        bool ok = true;
+        if (key == QLatin1String("id")) {
+            ok = readStringValue(reader, id);
+        } else if (key == QLatin1String("text")) {
+            ok = readStringValue(reader, text);
+        } else if (key == QLatin1String("x")) {
+            ok = readNumberValue(reader, x);
+        } else if (key == QLatin1String("y")) {
+            ok = readNumberValue(reader, y);
+        } else if (key == QLatin1String("width")) {
+            ok = readNumberValue(reader, width);
+        } else if (key == QLatin1String("height")) {
+            ok = readNumberValue(reader, height);
+        } else if (key == QLatin1String("color")) {
+            ok = readColorValue(reader, color);
+        } else if (key == QLatin1String("style")) {
+            ok = readStringValue(reader, style);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (reader.tokenType() != JsonStreamReader::EndObject) {
+        return false;
+    }
+
+    node.setText(text);
+    node.setPos(QPointF(x, y));
+    node.setSize(QSizeF(width, height));
+    node.setColor(color);
+    node.setStyle(style);
+    batch.addNode(std::move(node), id);
+    return true;
+}
+
+/**
+ * @brief 读取一个连接线对象（BeginObject 已读过）
+ */
+bool readEdge(JsonStreamReader& reader, RecordBatch& batch)
+{
+    ConceptEdge edge(InvalidId);
+    QString id;
+    QString sourceId;
+    QString targetId;
+    QString label = edge.label();
+    QString style = edge.style();
+    QColor color = edge.color();
+
+    while (reader.readNext() == JsonStreamReader::Name) {
+        const QString key = reader.text();
+        bool ok = true;
+        if (key == QLatin1String("id")) {
+            ok = readStringValue(reader, id);
+        } else if (key == QLatin1String("sourceId") || key == QLatin1String("sourceNodeId")) {
+            ok = readStringValue(reader, sourceId);
+        } else if (key == QLatin1String("targetId") || key == QLatin1String("targetNodeId")) {
+            ok = readStringValue(reader, targetId);
+        } else if (key == QLatin1String("label")) {
+            ok = readStringValue(reader, label);
+        } else if (key == QLatin1String("color")) {
+            ok = readColorValue(reader, color);
+        } else if (key == QLatin1String("style")) {
+            ok = readStringValue(reader, style);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (reader.tokenType() != JsonStreamReader::EndObject) {
+        return false;
+    }
+
+    edge.setLabel(label);
+    edge.setColor(color);
+    edge.setStyle(style);
+    batch.addEdge(std::move(edge), id, sourceId, targetId);
+    return true;
+}
+
+using RecordReader = bool (*)(JsonStreamReader&, RecordBatch&);
+
+/**
+ * @brief 读取记录数组的元素（BeginArray 已读过），不是对象的元素被忽略
+ *
+ * reporter 不为空时定期报告读取位置，已取消时返回 false。
+ */
+bool readRecordArray(JsonStreamReader& reader, RecordBatch& batch, RecordReader readRecord,
+                     ProgressReporter* reporter = nullptr)
+{
+    int count = 0;
+    for (;;) {
+        switch (reader.readNext()) {
+            case JsonStreamReader::EndArray:
+                return true;
+            case JsonStreamReader::BeginObject:
+                if (!readRecord(reader, batch)) {
+                    return false;
+                }
+                if (reporter && ++count % OperationProgress::ReportInterval == 0
+                    && !reporter->moveTo(reader.offset())) {
+                    return false;
+                }
+                break;
+            case JsonStreamReader::Invalid:
+                return false;
+            default:
+                if (!reader.skipValue()) {
+                    return false;
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief 读取键之后的记录数组，值不是数组时跳过
+ */
+bool readRecords(JsonStreamReader& reader, RecordBatch& batch, RecordReader readRecord, ProgressReporter* reporter)
+{
+    const JsonStreamReader::Token token = reader.readNext();
+    if (token != JsonStreamReader::BeginArray) {
+        return token != JsonStreamReader::Invalid && reader.skipValue();
+    }
+    return readRecordArray(reader, batch, readRecord, reporter);
+}
+
+/**
+ * @brief 解析得到的整个文档
+ */
+struct Document
+{
+    RecordBatch batch;
+    QString name;
+    QString version;
+    bool hasName = false;
+    bool hasVersion = false;
+};
+
+/**
+ * @brief 串行解析整个文档
+ */
+bool parseDocument(JsonStreamReader& reader, Document& document, QString* errorMessage,
+                   OperationProgress* progress = nullptr)
+{
+    ProgressReporter reporter(progress);
+    auto failed = [&](const QString& fallback) {
+        if (errorMessage) {
+            if (progress && progress->isCanceled()) {
+                *errorMessage = QStringLiteral("已取消");
+            } else {
+                *errorMessage = reader.hasError() ? reader.errorString() : fallback;
+            }
+        }
+        return false;
+    };
+
+    if (reader.readNext() != JsonStreamReader::BeginObject) {
+        return failed(QStringLiteral("根元素不是对象"));
+    }
+
+    while (reader.readNext() == JsonStreamReader::Name) {
+        const QString key = reader.text();
+        bool ok = true;
+        if (key == QLatin1String("nodes")) {
+            ok = readRecords(reader, document.batch, &readNode, &reporter);
+        } else if (key == QLatin1String("edges")) {
+            ok = readRecords(reader, document.batch, &readEdge, &reporter);
+        } else if (key == QLatin1String("name")) {
+            ok = readStringValue(reader, document.name);
+            document.hasName = true;
+        } else if (key == QLatin1String("version")) {
+            ok = readStringValue(reader, document.version);
+            document.hasVersion = true;
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return failed(QStringLiteral("记录格式错误"));
+        }
+    }
+    if (reader.tokenType() != JsonStreamReader::EndObject
+        || reader.readNext() != JsonStreamReader::EndDocument) {
+        return failed(QStringLiteral("文档结构错误"));
+    }
+    reporter.moveTo(reader.offset());
+    return true;
+}
+
+/**
+ * @brief 把解析结果载入概念图
+ */
+void applyDocument(Document& document, ConceptMap& map)
+{
+    if (document.hasName) {
+        map.setName(document.name);
+    }
+    if (document.hasVersion) {
+        map.setVersion(document.version);
+    }
+    document.batch.loadInto(map);
+}
+
+/**
+ * @brief 并行解析的一个分块：顶层 nodes 或 edges 数组中连续的若干元素
+ */
+struct Segment
+{
+    bool edges = false;     // 属于 edges 数组
+    qsizetype begin = 0;    // 第一个元素之前的位置
+    qsizetype end = 0;      // 最后一个元素之后的位置
+};
+
+/**
+ * @brief 扫描文档，按元素边界把顶层 nodes/edges 数组切成分块
+ *
+ * 只跟踪字符串、转义和括号深度，不解码任何值，速度远高于完整解析。
+ * 文档本身有语法错误时扫描结果可能不正确，由之后的分块解析发现并退回串行解析。
+ *
+ * @param data 文档内容
+ * @param chunkBytes 每块的目标字节数
+ * @param segments 输出的分块（按在文档中的顺序）
+ * @param skeleton 去掉数组内容后的文档，用于读取 name/version 等其它键
+ * @return 如果切分出的分块都非空返回 true（数组末尾多余的逗号会切出空块）
+ */
+bool scanDocument(const QByteArray& data, qint64 chunkBytes, QVector<Segment>& segments, QByteArray& skeleton)
+{
+    const char* p = data.constData();
+    const qsizetype size = data.size();
+    int depth = 0;
+    qsizetype stringStart = -1;     // 根对象中最近一个字符串的内容范围
+    qsizetype stringEnd = -1;
+    QByteArray key;                 // 根对象中当前的键
+    bool inArray = false;           // 正在扫描要切分的数组
+    bool edges = false;
+    qsizetype segmentBegin = 0;
+    qsizetype copied = 0;           // skeleton 已复制到的位置
+
+    for (qsizetype i = 0; i < size; ++i) {
+        const char c = p[i];
+        if (c == '"') {
+            const qsizetype start = i + 1;
+            for (++i; i < size && p[i] != '"'; ++i) {
+                if (p[i] == '\\') {
+                    ++i;
+                }
+            }
+            if (depth == 1) {
+                stringStart = start;
+                stringEnd = i;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case ':':
+                if (depth == 1 && stringStart >= 0) {
+                    key = QByteArray(p + stringStart, stringEnd - stringStart);
+                }
+                break;
+            case '[':
+                if (depth == 1 && (key == "nodes" || key == "edges")) {
+                    inArray = true;
+                    edges = (key == "edges");
+                    segmentBegin = i + 1;
+                    skeleton.append(p + copied, i + 1 - copied);
+                }
+                ++depth;
+                break;
+            case '{':
+                ++depth;
+                break;
+            case ']':
+                --depth;
+                if (inArray && depth == 1) {
+                    const bool split = !segments.isEmpty() && segments.last().end == segmentBegin - 1;
+                    if (split && QByteArray(p + segmentBegin, i - segmentBegin).trimmed().isEmpty()) {
+                        return false;
+                    }
+                    segments.append({ edges, segmentBegin, i });
+                    inArray = false;
+                    copied = i;
+                }
+                break;
+            case '}':
+                --depth;
+                break;
+            case ',':
+                if (inArray && depth == 2 && i - segmentBegin >= chunkBytes) {
+                    segments.append({ edges, segmentBegin, i });
+                    segmentBegin = i + 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    skeleton.append(p + copied, size - copied);
+    return true;
+}
+
+/**
+ * @brief 解析一个分块
+ */
+bool parseSegment(const QByteArray& data, const Segment& segment, RecordBatch& batch)
+{
+    QByteArray chunk;
+    chunk.reserve(segment.end - segment.begin + 2);
+    chunk.append('[');
+    chunk.append(data.constData() + segment.begin, segment.end - segment.begin);
+    chunk.append(']');
+
+    JsonStreamReader reader(chunk);
+    if (reader.readNext() != JsonStreamReader::BeginArray
+        || !readRecordArray(reader, batch, segment.edges ? &readEdge : &readNode)
+        || reader.readNext() != JsonStreamReader::EndDocument) {
+        return false;
+    }
+    batch.resolveIds();
+    return true;
+}
+
+/**
+ * @brief 并行解析内存中的整个文档
+ *
+ * 分块之间互不依赖，由 QtConcurrent 分配到线程池；结果按分块顺序合并，
+ * 记录顺序与串行解析相同。任何一步失败都退回串行解析，以得到相同的错误信息。
+ * 每解析完一块按该块的字节数推进进度，取消时不再退回串行解析。
+ */
+bool parseParallel(const QByteArray& data, Document& document, QString* errorMessage,
+                   OperationProgress* progress)
+{
+    QVector<Segment> segments;
+    QByteArray skeleton;
+    const bool scanned = scanDocument(data, RecordBatch::chunkBytes(data.size()), segments, skeleton);
+
+    auto serial = [&]() {
+        document = Document();
+        JsonStreamReader reader(data);
+        return parseDocument(reader, document, errorMessage, progress);
+    };
+
+    // 先解析骨架，得到 name/version 并确认整体结构正确
+    JsonStreamReader skeletonReader(skeleton);
+    if (!scanned || segments.isEmpty() || !parseDocument(skeletonReader, document, nullptr)) {
+        return serial();
+    }
+
+    QVector<RecordBatch> batches(segments.size());
+    QVector<int> indices(segments.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::atomic<bool> ok(true);
+    const IdRegistry::TablePointer ids = IdRegistry::currentTable();
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        const IdRegistry::Scope scope(ids);
+        if (!ok || (progress && progress->isCanceled())) {
+            return;
+        }
+        if (!parseSegment(data, segments[index], batches[index])) {
+            ok = false;
+        } else if (progress) {
+            progress->advance(segments[index].end - segments[index].begin);
+        }
+    });
+    if (progress && progress->isCanceled()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("已取消");
+        }
+        return false;
+    }
+    if (!ok) {
+        return serial();
+    }
+
+    qint64 parsed = 0;
+    for (int i = 0; i < batches.size(); ++i) {
+        document.batch.append(std::move(batches[i]));
+        parsed += segments[i].end - segments[i].begin;
+    }
+    if (progress) {
+        progress->advance(data.size() - parsed);
+    }
+    return true;
+}
+
+/**
+ * @brief 按格式写入颜色
+ */
+void writeColor(JsonStreamWriter& writer, const QColor& color, ConceptMapJson::Dialect dialect)
+{
+    writer.writeName(QStringLiteral("color"));
+    if (dialect == ConceptMapJson::DocumentDialect) {
+        writer.writeString(color.name());
+        return;
+    }
+    writer.writeStartObject();
+    writer.writeName(QStringLiteral("red"));
+    writer.writeNumber(color.red());
+    writer.writeName(QStringLiteral("green"));
+    writer.writeNumber(color.green());
+    writer.writeName(QStringLiteral("blue"));
+    writer.writeNumber(color.blue());
+    writer.writeEndObject();
+}
+
+} // namespace
+
+/**
+ * @brief 从设备读取概念图
+ * @param device 已打开的输入设备
+ * @param map 概念图对象
+ * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool ConceptMapJson::read(QIODevice* device, ConceptMap& map, QString* errorMessage, OperationProgress* progress)
+{
+    if (progress) {
+        progress->addTotal(device->size());
+    }
+
+    JsonStreamReader reader(device);
+    Document document;
+    if (!parseDocument(reader, document, errorMessage, progress)) {
+        return false;
+    }
+
+    // 全部解析成功后才修改概念图
+    applyDocument(document, map);
+    return true;
+}
+
+/**
+ * @brief 从内存中的文档读取概念图
+ * @param data JSON 文本
+ * @param map 概念图对象
+ * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool ConceptMapJson::read(const QByteArray& data, ConceptMap& map, QString* errorMessage, OperationProgress* progress)
+{
+    if (progress) {
+        progress->addTotal(data.size());
+    }
+
+    Document document;
+    bool ok = false;
+    if (data.size() >= RecordBatch::ParallelThreshold && QThread::idealThreadCount() > 1) {
+        ok = parseParallel(data, document, errorMessage, progress);
+    } else {
+        JsonStreamReader reader(data);
+        ok = parseDocument(reader, document, errorMessage, progress);
+    }
+
+    if (ok) {
+        applyDocument(document, map);
+    }
+    return ok;
+}
+
+/**
+ * @brief 把概念图写入设备
+ * @param device 已打开的输出设备
+ * @param map 概念图对象
+ * @param dialect 写入格式
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果全部写入成功返回 true，否则返回 false
+ */
+bool ConceptMapJson::write(QIODevice* device, const ConceptMap& map, Dialect dialect, OperationProgress* progress)
+{
+    if (progress) {
+        progress->addTotal(map.nodeCount() + map.edgeCount());
+    }
+    ProgressReporter reporter(progress);
+
+    const bool document = (dialect == DocumentDialect);
+    JsonStreamWriter writer(device);
+    writer.writeStartObject();
+
+    if (document) {
+        writer.writeName(QStringLiteral("name"));
+        writer.writeString(map.name());
+        writer.writeName(QStringLiteral("version"));
+        writer.writeString(map.version());
+    }
+
+    // 节点
+    writer.writeName(QStringLiteral("nodes"));
+    writer.writeStartArray();
+    for (const ConceptNode& node : map.allNodes()) {
+        writer.writeStartObject();
+        writer.writeName(QStringLiteral("id"));
+        writer.writeString(IdRegistry::toUuid(node.id()));
+        writer.writeName(QStringLiteral("text"));
+        writer.writeString(node.text());
+        writer.writeName(QStringLiteral("x"));
+        writer.writeNumber(node.x());
+        writer.writeName(QStringLiteral("y"));
+        writer.writeNumber(node.y());
+        writer.writeName(QStringLiteral("width"));
+        writer.writeNumber(node.width());
+        writer.writeName(QStringLiteral("height"));
+        writer.writeNumber(node.height());
+        writeColor(writer, node.color(), dialect);
+        writer.writeName(QStringLiteral("style"));
+        writer.writeString(node.style());
+        writer.writeEndObject();
+        if (!reporter.step()) {
+            return false;
+        }
+    }
+    writer.writeEndArray();
+
+    // 连接线
+    writer.writeName(QStringLiteral("edges"));
+    writer.writeStartArray();
+    for (const ConceptEdge& edge : map.allEdges()) {
+        writer.writeStartObject();
+        writer.writeName(QStringLiteral("id"));
+        writer.writeString(IdRegistry::toUuid(edge.id()));
+        writer.writeName(document ? QStringLiteral("sourceNodeId") : QStringLiteral("sourceId"));
+        writer.writeString(IdRegistry::toUuid(edge.sourceNodeId()));
+        writer.writeName(document ? QStringLiteral("targetNodeId") : QStringLiteral("targetId"));
+        writer.writeString(IdRegistry::toUuid(edge.targetNodeId()));
+        writer.writeName(QStringLiteral("label"));
+        writer.writeString(edge.label());
+        writeColor(writer, edge.color(), dialect);
+        writer.writeName(QStringLiteral("style"));
+        writer.writeString(edge.style());
+        writer.writeEndObject();
+        if (!reporter.step()) {
+            return false;
+        }
+    }
+    writer.writeEndArray();
+
+    writer.writeEndObject();
+    return writer.flush();
+}
+
+/**
+ * @brief 从文件加载概念图
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool ConceptMapJson::load(const QString& filePath, ConceptMap& map, OperationProgress* progress)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+
+    QString error;
+    bool ok = false;
+    const qint64 size = file.size();
+    uchar* mapped = nullptr;
+    if (size >= RecordBatch::ParallelThreshold && QThread::idealThreadCount() > 1) {
+        mapped = file.map(0, size);
+    }
+
+    if (mapped) {
+        // 大文件映射后分块并行解析
+        ok = read(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size), map, &error, progress);
+        file.unmap(mapped);
+    } else {
+        ok = read(&file, map, &error, progress);
+    }
+
+    if (!ok && !(progress && progress->isCanceled())) {
+        qWarning() << "无效的JSON格式:" << error;
+    }
+    return ok;
+}
+
+/**
+ * @brief 保存概念图到文件（写完后原子替换目标文件）
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param dialect 写入格式
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapJson::save(const QString& filePath, const ConceptMap& map, Dialect dialect, OperationProgress* progress)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+
+    // 取消或失败时放弃临时文件，目标文件保持原样
+    if (!write(&file, map, dialect, progress)) {
+        if (!(progress && progress->isCanceled())) {
+            qWarning() << "写入文件失败:" << file.errorString();
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef CONCEPTMAPJSON_H
+#define CONCEPTMAPJSON_H
+
+#include <QString>
+#include <QByteArray>
+#include "conceptmap.h"
+
+class QIODevice;
+class OperationProgress;
+
+/**
+ * @brief 概念图 JSON 流式编解码
+ *
+ * 读取时用 JsonStreamReader 逐个记号解析，节点和连接线记录直接构造后交给
+ * ConceptMap::bulkLoad，不经过 QJsonDocument；写入时用 JsonStreamWriter 逐条
+ * 输出记录，保存到文件时通过 QSaveFile 写临时文件再原子替换。
+ *
+ * 项目中有两种 JSON 写法，读取时两种都接受：
+ * - 序列化器格式：颜色为 {"red","green","blue"} 对象，端点键为 sourceId/targetId
+ * - 文档格式：带 name/version，颜色为 "#rrggbb"，端点键为 sourceNodeId/targetNodeId
+ */
+class ConceptMapJson
+{
+public:
+    /**
+     * @brief 写入格式
+     */
+    enum Dialect {
+        SerializerDialect,  // ConceptMapSerializer 使用的格式
+        DocumentDialect     // FileManager 使用的格式
+    };
+
+    /**
+     * @brief 从设备读取概念图
+     *
+     * 解析失败时概念图保持不变。文件中没有 name/version 时不修改这两项。
+     *
+     * @param device 已打开的输入设备
+     * @param map 概念图对象
+     * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool read(QIODevice* device, ConceptMap& map, QString* errorMessage = nullptr,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从内存中的文档读取概念图
+     *
+     * 数据达到 RecordBatch::ParallelThreshold 时分块并行解析，结果与串行读取相同。
+     * 解析失败时概念图保持不变。
+     *
+     * @param data JSON 文本（可以是 QByteArray::fromRawData 包装的映射内存）
+     * @param map 概念图对象
+     * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool read(const QByteArray& data, ConceptMap& map, QString* errorMessage = nullptr,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 把概念图写入设备
+     * @param device 已打开的输出设备
+     * @param map 概念图对象
+     * @param dialect 写入格式
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果全部写入成功返回 true，否则返回 false
+     */
+    static bool write(QIODevice* device, const ConceptMap& map, Dialect dialect,
+                      OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从文件加载概念图
+     *
+     * 文件达到 RecordBatch::ParallelThreshold 时映射到内存，切成分块在线程池中并行解析，
+     * 结果与串行读取完全相同；无法切分或任一分块出错时退回串行解析。
+     *
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    static bool load(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 保存概念图到文件（写完后原子替换目标文件）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param dialect 写入格式
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool save(const QString& filePath, const ConceptMap& map, Dialect dialect,
+                     OperationProgress* progress = nullptr);
+};
+
+#endif // CONCEPTMAPJSON_H
@@ -10,10 +10,12 @@
 
 #include "conceptmap.h"
 
+class OperationProgress;
+
 /**
  * @brief 概念图序列化类
  * 
- * 该类负责概念图的序列化和反序列化，支持 JSON 和 XML 格式。
+ * 该类负责概念图的序列化和反序列化，支持 JSON、XML 和二进制格式。
  * 消除了 MapModel 和 FileManager 中的代码重复。
  * 
  * @author AI Assistant
@@ -22,37 +24,108 @@
 class ConceptMapSerializer
 {
 public:
+    /**
+     * @brief 按扩展名从文件加载概念图，并重放增量保存的日志
+     *
+     * 所有读取已保存文件的地方（界面、命令行、缩略图）都经过这里，
+     * 看到的都是基础文件加上 "<文件>.journal" 之后的同一份文档。
+     *
+     * @param filePath 文件路径（.json、.xml、.cmapb、.cmapz 或 .cmapt）
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功加载
+     */
+    static bool loadFromFile(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
     /**
      * @brief 从 JSON 文件加载概念图
      * @param filePath 文件路径
      * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
      * @return 是否成功加载
      */
-    static bool loadFromJson(const QString& filePath, ConceptMap& map);
+    static bool loadFromJson(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
     
     /**
      * @brief 保存概念图到 JSON 文件
      * @param filePath 文件路径
      * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
      * @return 是否成功保存
      */
-    static bool saveToJson(const QString& filePath, const ConceptMap& map);
+    static bool saveToJson(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
     
     /**
      * @brief 从 XML 文件加载概念图
      * @param filePath 文件路径
      * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
      * @return 是否成功加载
      */
-    static bool loadFromXml(const QString& filePath, ConceptMap& map);
+    static bool loadFromXml(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
     
     /**
      * @brief 保存概念图到 XML 文件
      * @param filePath 文件路径
      * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功保存
+     */
+    static bool saveToXml(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 从二进制文件（.cmapb）加载概念图
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功加载
+     */
+    static bool loadFromBinary(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 保存概念图到二进制文件（.cmapb）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功保存
+     */
+    static bool saveToBinary(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 从压缩文件（.cmapz）加载概念图
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功加载
+     */
+    static bool loadFromCompressed(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 保存概念图到压缩文件（.cmapz）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功保存
+     */
+    static bool saveToCompressed(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 从瓦片文件（.cmapt）加载整个概念图
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 是否成功加载
+     */
+    static bool loadFromTiles(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+    
+    /**
+     * @brief 保存概念图到瓦片文件（.cmapt）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
      * @return 是否成功保存
      */
-    static bool saveToXml(const QString& filePath, const ConceptMap& map);
+    static bool saveToTiles(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
 };
 
 #endif // CONCEPTMAPSERIALIZER_H
@@ -0,0 +1,1347 @@
+#include "conceptmaptiles.h"
+#include "recordstream.h"
+#include "operationprogress.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QSet>
+#include <QThread>
+#include <QDataStream>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+constexpr char Magic[4] = { 'C', 'M', 'P', 'T' };
+constexpr qint64 HeaderSize = 64;          // 文件头字节数
+constexpr qint64 IndexEntrySize = 32;      // 索引项字节数
+
+// 文件头字段偏移
+enum HeaderField {
+    HeaderMajor = 4,
+    HeaderMinor = 6,
+    HeaderTileSize = 8,
+    HeaderTileCount = 16,
+    HeaderIndexOffset = 24,
+    HeaderMetaOffset = 32,
+    HeaderMetaSize = 40
+};
+
+// 索引项字段偏移
+enum IndexField {
+    EntryX = 0,
+    EntryY = 4,
+    EntryOffset = 8,
+    EntryCompressedSize = 16,
+    EntryRawSize = 20,
+    EntryNodeCount = 24,
+    EntryEdgeCount = 28
+};
+
+quint64 makeKey(qint32 x, qint32 y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+qint32 keyX(quint64 key)
+{
+    return qint32(quint32(key >> 32));
+}
+
+qint32 keyY(quint64 key)
+{
+    return qint32(quint32(key));
+}
+
+double readDouble(const uchar* data)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void writeDouble(double value, uchar* data)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, data);
+}
+
+/**
+ * @brief 只读打开的整个文件，优先使用内存映射
+ */
+class FileView
+{
+public:
+    explicit FileView(const QString& filePath)
+        : m_file(filePath)
+    {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return;
+        }
+        m_size = m_file.size();
+        m_data = (m_size > 0) ? m_file.map(0, m_size) : nullptr;
+        if (!m_data) {
+            // 文件系统不支持映射时退回到整体读取
+            m_buffer = m_file.readAll();
+            m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+            m_size = m_buffer.size();
+        }
+        m_open = true;
+    }
+
+    bool isOpen() const { return m_open; }
+    const uchar* data() const { return m_data; }
+    qint64 size() const { return m_size; }
+
+private:
+    QFile m_file;               // 析构时自动解除映射
+    QByteArray m_buffer;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    bool m_open = false;
+};
+
+/**
+ * @brief 编码时引用的连接线
+ */
+struct EdgeRef
+{
+    const ConceptEdge* edge = nullptr;
+    quint64 sourceTile = 0;
+    quint64 targetTile = 0;
+};
+
+/**
+ * @brief 编码后的瓦片
+ */
+struct EncodedTile
+{
+    QByteArray compressed;
+    quint32 rawSize = 0;
+    quint32 nodeCount = 0;
+    quint32 edgeCount = 0;
+};
+
+EncodedTile encodeTile(const QVector<const ConceptNode*>& nodes, const QVector<EdgeRef>& edges)
+{
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint32(nodes.size());
+    for (const ConceptNode* node : nodes) {
+        RecordStream::writeNode(out, *node);
+    }
+    out << quint32(edges.size());
+    for (const EdgeRef& ref : edges) {
+        RecordStream::writeEdge(out, *ref.edge);
+        out << ref.sourceTile << ref.targetTile;
+    }
+
+    EncodedTile tile;
+    tile.compressed = qCompress(raw);
+    tile.rawSize = quint32(raw.size());
+    tile.nodeCount = quint32(nodes.size());
+    tile.edgeCount = quint32(edges.size());
+    return tile;
+}
+
+/**
+ * @brief 按文件布局顺序写出瓦片、元数据、索引和文件头
+ */
+class TileWriter
+{
+public:
+    struct Record
+    {
+        quint64 key = 0;
+        qint64 offset = 0;
+        quint32 compressedSize = 0;
+        quint32 rawSize = 0;
+        quint32 nodeCount = 0;
+        quint32 edgeCount = 0;
+    };
+
+    explicit TileWriter(QSaveFile* file)
+        : m_file(file)
+        , m_offset(HeaderSize)
+    {
+        // 文件头最后回填，先占位
+        m_ok = file->write(QByteArray(int(HeaderSize), '\0')) == HeaderSize;
+    }
+
+    bool append(quint64 key, const char* data, quint32 compressedSize, quint32 rawSize,
+                quint32 nodeCount, quint32 edgeCount)
+    {
+        if (!m_ok) {
+            return false;
+        }
+        if (m_file->write(data, compressedSize) != qint64(compressedSize)) {
+            m_ok = false;
+            return false;
+        }
+        m_records.append({ key, m_offset, compressedSize, rawSize, nodeCount, edgeCount });
+        m_offset += compressedSize;
+        return true;
+    }
+
+    bool finish(const QString& name, const QString& version, double tileSize)
+    {
+        if (!m_ok) {
+            return false;
+        }
+
+        QByteArray meta;
+        QDataStream out(&meta, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << name << version;
+        const qint64 metaOffset = m_offset;
+
+        QByteArray index(int(m_records.size() * IndexEntrySize), '\0');
+        uchar* entry = reinterpret_cast<uchar*>(index.data());
+        for (const Record& record : m_records) {
+            qToLittleEndian<qint32>(keyX(record.key), entry + EntryX);
+            qToLittleEndian<qint32>(keyY(record.key), entry + EntryY);
+            qToLittleEndian<quint64>(quint64(record.offset), entry + EntryOffset);
+            qToLittleEndian<quint32>(record.compressedSize, entry + EntryCompressedSize);
+            qToLittleEndian<quint32>(record.rawSize, entry + EntryRawSize);
+            qToLittleEndian<quint32>(record.nodeCount, entry + EntryNodeCount);
+            qToLittleEndian<quint32>(record.edgeCount, entry + EntryEdgeCount);
+            entry += IndexEntrySize;
+        }
+        const qint64 indexOffset = metaOffset + meta.size();
+
+        uchar header[HeaderSize] = {};
+        std::memcpy(header, Magic, sizeof(Magic));
+        qToLittleEndian<quint16>(ConceptMapTiles::MajorVersion, header + HeaderMajor);
+        qToLittleEndian<quint16>(ConceptMapTiles::MinorVersion, header + HeaderMinor);
+        writeDouble(tileSize, header + HeaderTileSize);
+        qToLittleEndian<quint64>(quint64(m_records.size()), header + HeaderTileCount);
+        qToLittleEndian<quint64>(quint64(indexOffset), header + HeaderIndexOffset);
+        qToLittleEndian<quint64>(quint64(metaOffset), header + HeaderMetaOffset);
+        qToLittleEndian<quint64>(quint64(meta.size()), header + HeaderMetaSize);
+
+        m_ok = m_file->write(meta) == meta.size()
+            && m_file->write(index) == index.size()
+            && m_file->seek(0)
+            && m_file->write(reinterpret_cast<const char*>(header), HeaderSize) == HeaderSize;
+        return m_ok;
+    }
+
+    const QVector<Record>& records() const { return m_records; }
+
+private:
+    QSaveFile* m_file;
+    qint64 m_offset;            // 下一个瓦片的位置
+    QVector<Record> m_records;
+    bool m_ok = false;
+};
+
+/**
+ * @brief 结束写入：失败或取消时放弃临时文件，否则替换目标文件
+ * @param file 保存文件
+ * @param ok 写入是否成功
+ * @param progress 进度，可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool commitFile(QSaveFile& file, bool ok, OperationProgress* progress)
+{
+    if (!ok) {
+        if (!(progress && progress->isCanceled())) {
+            qWarning() << "写入文件失败:" << file.errorString();
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数，创建未打开文件的存储
+ */
+ConceptMapTiles::ConceptMapTiles()
+    : m_tileSize(DefaultTileSize)
+    , m_budget(DefaultBudget)
+    , m_residentBytes(0)
+    , m_clock(0)
+    , m_generation(0)
+    , m_savedGeneration(0)
+{
+}
+
+/**
+ * @brief 打开文件，读取索引和元数据（不载入任何瓦片）
+ * @param filePath 文件路径
+ * @return 如果成功打开返回 true，否则返回 false
+ */
+bool ConceptMapTiles::open(const QString& filePath)
+{
+    close();
+
+    FileView file(filePath);
+    if (!file.isOpen()) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+    auto failed = [](const QString& message) {
+        qWarning() << "无效的瓦片概念图:" << message;
+        return false;
+    };
+
+    // 文件头
+    const uchar* data = file.data();
+    const quint64 size = quint64(file.size());
+    if (size < quint64(HeaderSize) || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return failed(QStringLiteral("不是瓦片概念图文件"));
+    }
+    const quint16 major = qFromLittleEndian<quint16>(data + HeaderMajor);
+    if (major != MajorVersion) {
+        return failed(QStringLiteral("不支持的文件版本 %1").arg(major));
+    }
+    const double tileSize = readDouble(data + HeaderTileSize);
+    if (!std::isfinite(tileSize) || tileSize <= 0) {
+        return failed(QStringLiteral("瓦片边长无效"));
+    }
+    const quint64 tileCount = qFromLittleEndian<quint64>(data + HeaderTileCount);
+    const quint64 indexOffset = qFromLittleEndian<quint64>(data + HeaderIndexOffset);
+    const quint64 metaOffset = qFromLittleEndian<quint64>(data + HeaderMetaOffset);
+    const quint64 metaSize = qFromLittleEndian<quint64>(data + HeaderMetaSize);
+    if (indexOffset > size || (size - indexOffset) / IndexEntrySize < tileCount
+        || metaOffset > size || size - metaOffset < metaSize) {
+        return failed(QStringLiteral("文件被截断"));
+    }
+
+    // 元数据
+    QString name;
+    QString version;
+    QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char*>(data + metaOffset), qsizetype(metaSize)));
+    in.setVersion(QDataStream::Qt_6_0);
+    in >> name >> version;
+    if (in.status() != QDataStream::Ok) {
+        return failed(QStringLiteral("元数据损坏"));
+    }
+
+    // 索引
+    QHash<quint64, TileEntry> index;
+    index.reserve(qsizetype(tileCount));
+    const uchar* record = data + indexOffset;
+    for (quint64 i = 0; i < tileCount; ++i, record += IndexEntrySize) {
+        TileEntry entry;
+        entry.offset = qint64(qFromLittleEndian<quint64>(record + EntryOffset));
+        entry.compressedSize = qFromLittleEndian<quint32>(record + EntryCompressedSize);
+        entry.rawSize = qFromLittleEndian<quint32>(record + EntryRawSize);
+        entry.nodeCount = qFromLittleEndian<quint32>(record + EntryNodeCount);
+        entry.edgeCount = qFromLittleEndian<quint32>(record + EntryEdgeCount);
+        if (entry.offset < HeaderSize || quint64(entry.offset) > size
+            || size - quint64(entry.offset) < entry.compressedSize) {
+            return failed(QStringLiteral("瓦片位置越界"));
+        }
+        index.insert(makeKey(qFromLittleEndian<qint32>(record + EntryX), qFromLittleEndian<qint32>(record + EntryY)),
+                     entry);
+    }
+
+    m_filePath = filePath;
+    m_tileSize = tileSize;
+    m_mapName = name;
+    m_mapVersion = version;
+    m_index = std::move(index);
+    return true;
+}
+
+/**
+ * @brief 关闭文件，丢弃全部状态
+ */
+void ConceptMapTiles::close()
+{
+    const qint64 budget = m_budget;
+    *this = ConceptMapTiles();
+    m_budget = budget;
+}
+
+/**
+ * @brief 获取文件中全部瓦片覆盖的范围
+ * @return 场景矩形，没有瓦片时返回空矩形
+ */
+QRectF ConceptMapTiles::bounds() const
+{
+    QRectF rect;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        rect = rect.united(tileRect(it.key()));
+    }
+    return rect;
+}
+
+/**
+ * @brief 获取打开文件后首先载入的区域
+ * @return 场景矩形
+ */
+QRectF ConceptMapTiles::initialRegion() const
+{
+    const QRectF all = bounds();
+    qint64 total = 0;
+    for (const TileEntry& entry : m_index) {
+        total += entry.rawSize;
+    }
+    if (total <= m_budget) {
+        return all;
+    }
+
+    // page() 还会向四周预取，区域本身只取半个预算扣除预取后的部分
+    const double average = double(total) / m_index.size();
+    const double prefetch = (1 + 2 * PrefetchMargin) * (1 + 2 * PrefetchMargin);
+    const double tiles = qMax(1.0, m_budget / 2.0 / average / prefetch);
+    const double side = std::sqrt(tiles) * m_tileSize;
+    QRectF region(0, 0, side, side);
+    region.moveCenter(all.center());
+    return region;
+}
+
+/**
+ * @brief 载入区域附近的瓦片，并在超过预算时卸载其余没有修改的瓦片
+ * @param map 概念图对象
+ * @param region 需要的区域（场景坐标）
+ * @param progress 进度（按压缩后的字节），可以为 nullptr
+ * @return 如果成功载入返回 true，否则返回 false
+ */
+bool ConceptMapTiles::page(ConceptMap& map, const QRectF& region, OperationProgress* progress)
+{
+    if (!isOpen()) {
+        return false;
+    }
+    if (!region.isValid()) {
+        return true;
+    }
+
+    ++m_clock;
+    const QRectF wanted = region.adjusted(-region.width() * PrefetchMargin, -region.height() * PrefetchMargin,
+                                          region.width() * PrefetchMargin, region.height() * PrefetchMargin);
+    const QVector<quint64> keys = tilesIntersecting(wanted);
+    QVector<quint64> missing;
+    for (quint64 key : keys) {
+        auto it = m_resident.find(key);
+        if (it != m_resident.end()) {
+            it.value() = m_clock;
+        } else {
+            missing.append(key);
+        }
+    }
+
+    QVector<TileData> tiles;
+    if (!decodeTiles(missing, tiles, progress)) {
+        return false;
+    }
+    mergeTiles(map, missing, tiles);
+    evict(map, keys);
+    return true;
+}
+
+/**
+ * @brief 载入全部尚未载入的瓦片（不受预算限制）
+ * @param map 概念图对象
+ * @param progress 进度（按压缩后的字节），可以为 nullptr
+ * @return 如果成功载入返回 true，否则返回 false
+ */
+bool ConceptMapTiles::loadAll(ConceptMap& map, OperationProgress* progress)
+{
+    ++m_clock;
+    QVector<quint64> missing;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (!m_resident.contains(it.key())) {
+            missing.append(it.key());
+        }
+    }
+
+    QVector<TileData> tiles;
+    if (!decodeTiles(missing, tiles, progress)) {
+        return false;
+    }
+    mergeTiles(map, missing, tiles);
+    return true;
+}
+
+/**
+ * @brief 根据一次提交的变更标记需要重新编码的瓦片
+ * @param changes 变更记录
+ * @param map 提交后的概念图
+ */
+void ConceptMapTiles::markDirty(const ChangeSet& changes, const ConceptMap& map)
+{
+    if (!isOpen() || changes.isEmpty()) {
+        return;
+    }
+    ++m_generation;
+
+    auto touchNode = [this](NodeId id) {
+        auto it = m_nodeTile.constFind(id);
+        if (it != m_nodeTile.constEnd()) {
+            touch(it.value());
+        }
+    };
+
+    // 删除的连接线按原来的端点标记，必须在删除节点之前处理
+    for (EdgeId id : changes.removedEdges()) {
+        auto it = m_edgeEnds.find(id);
+        if (it != m_edgeEnds.end()) {
+            touchNode(it->first);
+            touchNode(it->second);
+            m_edgeEnds.erase(it);
+        }
+    }
+
+    for (NodeId id : changes.removedNodes()) {
+        auto it = m_nodeTile.find(id);
+        if (it != m_nodeTile.end()) {
+            touch(it.value());
+            m_nodeTile.erase(it);
+            m_removedNodes.insert(id, m_generation);
+        }
+    }
+
+    // 节点移到别的瓦片时，新旧瓦片和相邻节点所在瓦片（其中记有端点瓦片）都要重新编码
+    auto placeNode = [&](NodeId id) {
+        const ConceptNode* node = map.nodeById(id);
+        if (!node) {
+            return;
+        }
+        const quint64 key = tileOf(*node);
+        m_removedNodes.remove(id);
+        auto it = m_nodeTile.find(id);
+        if (it == m_nodeTile.end()) {
+            m_nodeTile.insert(id, key);
+        } else if (it.value() != key) {
+            touch(it.value());
+            it.value() = key;
+            for (EdgeId edgeId : map.edgeIdsByNodeId(id)) {
+                const ConceptEdge* edge = map.edgeById(edgeId);
+                touchNode(edge->sourceNodeId() == id ? edge->targetNodeId() : edge->sourceNodeId());
+            }
+        }
+        touch(key);
+    };
+    for (NodeId id : changes.insertedNodes()) {
+        placeNode(id);
+    }
+    const QHash<NodeId, ChangeSet::NodeFields> modifiedNodes = changes.modifiedNodes();
+    for (auto it = modifiedNodes.cbegin(); it != modifiedNodes.cend(); ++it) {
+        placeNode(it.key());
+    }
+
+    // 插入和修改的连接线：原来和现在的端点所在瓦片
+    auto placeEdge = [&](EdgeId id) {
+        const ConceptEdge* edge = map.edgeById(id);
+        if (!edge) {
+            return;
+        }
+        const QPair<NodeId, NodeId> ends(edge->sourceNodeId(), edge->targetNodeId());
+        auto it = m_edgeEnds.find(id);
+        if (it == m_edgeEnds.end()) {
+            m_edgeEnds.insert(id, ends);
+        } else {
+            touchNode(it->first);
+            touchNode(it->second);
+            it.value() = ends;
+        }
+        touchNode(ends.first);
+        touchNode(ends.second);
+    };
+    for (EdgeId id : changes.insertedEdges()) {
+        placeEdge(id);
+    }
+    const QHash<EdgeId, ChangeSet::EdgeFields> modifiedEdges = changes.modifiedEdges();
+    for (auto it = modifiedEdges.cbegin(); it != modifiedEdges.cend(); ++it) {
+        placeEdge(it.key());
+    }
+}
+
+/**
+ * @brief 写回文件（写完后原子替换目标文件）
+ * @param filePath 文件路径，可以与打开的文件相同
+ * @param map 概念图对象
+ * @param progress 进度（按瓦片），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapTiles::writeBack(const QString& filePath, const ConceptMap& map, OperationProgress* progress)
+{
+    m_savedGeneration = m_generation;
+
+    // 收集需要保留的未载入连接线：至少一个端点不在概念图中，而且两个端点都没有被删除。
+    // 端点所在瓦片变化时，另一个端点的瓦片中记录也要更新，于是加入重新编码的集合，
+    // 直到集合不再扩大。
+    QSet<quint64> encodeSet;
+    for (auto it = m_dirty.cbegin(); it != m_dirty.cend(); ++it) {
+        encodeSet.insert(it.key());
+    }
+    QHash<quint64, TileData> diskTiles;
+    QHash<EdgeId, TileEdge> offline;
+    QSet<EdgeId> dropped;
+    QVector<quint64> pending(encodeSet.cbegin(), encodeSet.cend());
+    while (!pending.isEmpty()) {
+        QVector<quint64> onDisk;
+        for (quint64 key : pending) {
+            if (m_index.contains(key) && !diskTiles.contains(key)) {
+                onDisk.append(key);
+            }
+        }
+        QVector<TileData> decoded;
+        if (!decodeTiles(onDisk, decoded, nullptr)) {
+            return false;
+        }
+
+        QVector<quint64> next;
+        auto require = [&](quint64 key) {
+            if (!encodeSet.contains(key)) {
+                encodeSet.insert(key);
+                next.append(key);
+            }
+        };
+        for (int i = 0; i < onDisk.size(); ++i) {
+            for (const TileEdge& stored : decoded[i].edges) {
+                const EdgeId id = stored.edge.id();
+                if (map.hasEdge(id) || offline.contains(id) || dropped.contains(id)) {
+                    continue;
+                }
+                // 端点不在概念图中、所在瓦片却已载入，也说明端点已被删除
+                const ConceptNode* source = map.nodeById(stored.edge.sourceNodeId());
+                const ConceptNode* target = map.nodeById(stored.edge.targetNodeId());
+                const bool sourceRemoved = !source && (m_removedNodes.contains(stored.edge.sourceNodeId())
+                                                       || m_resident.contains(stored.sourceTile));
+                const bool targetRemoved = !target && (m_removedNodes.contains(stored.edge.targetNodeId())
+                                                       || m_resident.contains(stored.targetTile));
+                if ((source && target) || sourceRemoved || targetRemoved) {
+                    dropped.insert(id);
+                    if (!source && !sourceRemoved) {
+                        require(stored.sourceTile);
+                    }
+                    if (!target && !targetRemoved) {
+                        require(stored.targetTile);
+                    }
+                    continue;
+                }
+
+                TileEdge kept = stored;
+                if (source) {
+                    kept.sourceTile = tileOf(*source);
+                }
+                if (target) {
+                    kept.targetTile = tileOf(*target);
+                }
+                if (kept.sourceTile != stored.sourceTile || kept.targetTile != stored.targetTile) {
+                    require(kept.sourceTile);
+                    require(kept.targetTile);
+                    require(stored.sourceTile);
+                    require(stored.targetTile);
+                }
+                offline.insert(id, kept);
+            }
+            diskTiles.insert(onDisk[i], std::move(decoded[i]));
+        }
+        pending = next;
+    }
+
+    // 按瓦片分组：已载入瓦片的节点全部来自概念图，未载入瓦片保留文件中的节点
+    QHash<quint64, QVector<const ConceptNode*>> tileNodes;
+    for (const ConceptNode& node : map.allNodes()) {
+        const quint64 key = tileOf(node);
+        if (encodeSet.contains(key)) {
+            tileNodes[key].append(&node);
+        }
+    }
+    for (auto it = diskTiles.cbegin(); it != diskTiles.cend(); ++it) {
+        if (m_resident.contains(it.key())) {
+            continue;
+        }
+        for (const ConceptNode& node : it->nodes) {
+            if (!map.hasNode(node.id()) && !m_removedNodes.contains(node.id())) {
+                tileNodes[it.key()].append(&node);
+            }
+        }
+    }
+
+    QHash<quint64, QVector<EdgeRef>> tileEdges;
+    auto addEdge = [&](const EdgeRef& ref) {
+        if (encodeSet.contains(ref.sourceTile)) {
+            tileEdges[ref.sourceTile].append(ref);
+        }
+        if (ref.targetTile != ref.sourceTile && encodeSet.contains(ref.targetTile)) {
+            tileEdges[ref.targetTile].append(ref);
+        }
+    };
+    for (const ConceptEdge& edge : map.allEdges()) {
+        addEdge({ &edge, tileOf(*map.nodeById(edge.sourceNodeId())), tileOf(*map.nodeById(edge.targetNodeId())) });
+    }
+    for (const TileEdge& kept : offline) {
+        addEdge({ &kept.edge, kept.sourceTile, kept.targetTile });
+    }
+
+    // 并行编码修改过的瓦片
+    QVector<quint64> encodeKeys(encodeSet.cbegin(), encodeSet.cend());
+    QVector<EncodedTile> encoded(encodeKeys.size());
+    EncodedTile* out = encoded.data();
+    QVector<int> indices(encodeKeys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    const IdRegistry::TablePointer ids = IdRegistry::currentTable();
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        const IdRegistry::Scope scope(ids);
+        const quint64 key = encodeKeys[index];
+        const auto nodes = tileNodes.constFind(key);
+        if (nodes != tileNodes.cend()) {
+            out[index] = encodeTile(nodes.value(), tileEdges.value(key));
+        }
+    });
+    QHash<quint64, int> encodedIndex;
+    for (int i = 0; i < encodeKeys.size(); ++i) {
+        encodedIndex.insert(encodeKeys[i], i);
+    }
+
+    // 按瓦片键顺序写出，没有修改的瓦片原样复制，变空的瓦片从文件中去掉
+    QVector<quint64> keys(encodeKeys);
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (!encodeSet.contains(it.key())) {
+            keys.append(it.key());
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+
+    QScopedPointer<FileView> source(new FileView(m_filePath));
+    if (!m_index.isEmpty() && !source->isOpen()) {
+        qWarning() << "无法打开文件:" << m_filePath;
+        return false;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+    if (progress) {
+        progress->addTotal(keys.size());
+    }
+
+    TileWriter writer(&file);
+    bool ok = true;
+    for (quint64 key : keys) {
+        auto encodedIt = encodedIndex.constFind(key);
+        if (encodedIt != encodedIndex.cend()) {
+            const EncodedTile& tile = encoded[encodedIt.value()];
+            if (tile.nodeCount > 0) {
+                ok = writer.append(key, tile.compressed.constData(), quint32(tile.compressed.size()), tile.rawSize,
+                                   tile.nodeCount, tile.edgeCount);
+            }
+        } else {
+            const TileEntry& entry = m_index[key];
+            ok = quint64(entry.offset) + entry.compressedSize <= quint64(source->size())
+                && writer.append(key, reinterpret_cast<const char*>(source->data() + entry.offset),
+                                 entry.compressedSize, entry.rawSize, entry.nodeCount, entry.edgeCount);
+        }
+        if (progress) {
+            progress->advance(1);
+            ok = ok && !progress->isCanceled();
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    ok = ok && writer.finish(map.name(), map.version(), m_tileSize);
+
+    // 替换目标文件前关闭原文件（有的平台不能替换仍被映射的文件）
+    source.reset();
+    if (!commitFile(file, ok, progress)) {
+        return false;
+    }
+
+    // 改为指向新文件
+    QHash<quint64, TileEntry> index;
+    index.reserve(writer.records().size());
+    for (const TileWriter::Record& record : writer.records()) {
+        TileEntry entry;
+        entry.offset = record.offset;
+        entry.compressedSize = record.compressedSize;
+        entry.rawSize = record.rawSize;
+        entry.nodeCount = record.nodeCount;
+        entry.edgeCount = record.edgeCount;
+        index.insert(record.key, entry);
+    }
+    m_filePath = filePath;
+    m_mapName = map.name();
+    m_mapVersion = map.version();
+    m_index = std::move(index);
+    adoptSaved(*this);
+    return true;
+}
+
+/**
+ * @brief 采用副本写回后的文件状态
+ * @param saved 成功调用过 writeBack() 的副本
+ */
+void ConceptMapTiles::adoptSaved(const ConceptMapTiles& saved)
+{
+    if (&saved != this) {
+        m_filePath = saved.m_filePath;
+        m_tileSize = saved.m_tileSize;
+        m_mapName = saved.m_mapName;
+        m_mapVersion = saved.m_mapVersion;
+        m_index = saved.m_index;
+    }
+
+    for (auto it = m_dirty.begin(); it != m_dirty.end();) {
+        if (it.value() <= saved.m_savedGeneration) {
+            it = m_dirty.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_removedNodes.begin(); it != m_removedNodes.end();) {
+        if (it.value() <= saved.m_savedGeneration) {
+            it = m_removedNodes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_residentBytes = 0;
+    for (auto it = m_resident.cbegin(); it != m_resident.cend(); ++it) {
+        m_residentBytes += m_index.value(it.key()).rawSize;
+    }
+}
+
+/**
+ * @brief 保存概念图到文件（写完后原子替换目标文件）
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param tileSize 瓦片边长
+ * @param progress 进度（按瓦片），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapTiles::save(const QString& filePath, const ConceptMap& map, double tileSize, OperationProgress* progress)
+{
+    ConceptMapTiles layout;
+    if (std::isfinite(tileSize) && tileSize > 0) {
+        layout.m_tileSize = tileSize;
+    }
+
+    // 节点按中心点分组，连接线放进两个端点的瓦片
+    QHash<quint64, QVector<const ConceptNode*>> tileNodes;
+    QHash<NodeId, quint64> nodeTile;
+    nodeTile.reserve(map.nodeCount());
+    for (const ConceptNode& node : map.allNodes()) {
+        const quint64 key = layout.tileOf(node);
+        tileNodes[key].append(&node);
+        nodeTile.insert(node.id(), key);
+    }
+    QHash<quint64, QVector<EdgeRef>> tileEdges;
+    for (const ConceptEdge& edge : map.allEdges()) {
+        const EdgeRef ref{ &edge, nodeTile.value(edge.sourceNodeId()), nodeTile.value(edge.targetNodeId()) };
+        tileEdges[ref.sourceTile].append(ref);
+        if (ref.targetTile != ref.sourceTile) {
+            tileEdges[ref.targetTile].append(ref);
+        }
+    }
+    QVector<quint64> keys = tileNodes.keys();
+    std::sort(keys.begin(), keys.end());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+    if (progress) {
+        progress->addTotal(keys.size());
+    }
+
+    // 每批（每个线程几块）并行编码后按顺序写出，内存中最多同时保留一批瓦片
+    TileWriter writer(&file);
+    bool ok = true;
+    const int batchSize = qMax(1, QThread::idealThreadCount()) * 4;
+    const IdRegistry::TablePointer ids = IdRegistry::currentTable();
+    for (int start = 0; start < keys.size() && ok; start += batchSize) {
+        const int count = qMin(batchSize, int(keys.size()) - start);
+        QVector<EncodedTile> encoded(count);
+        EncodedTile* out = encoded.data();
+        QVector<int> indices(count);
+        std::iota(indices.begin(), indices.end(), 0);
+        QtConcurrent::blockingMap(indices, [&](int index) {
+            const IdRegistry::Scope scope(ids);
+            const quint64 key = keys[start + index];
+            out[index] = encodeTile(tileNodes.value(key), tileEdges.value(key));
+        });
+        for (int i = 0; i < count && ok; ++i) {
+            ok = writer.append(keys[start + i], encoded[i].compressed.constData(),
+                               quint32(encoded[i].compressed.size()), encoded[i].rawSize,
+                               encoded[i].nodeCount, encoded[i].edgeCount);
+        }
+        if (progress) {
+            progress->advance(count);
+            ok = ok && !progress->isCanceled();
+        }
+    }
+    ok = ok && writer.finish(map.name(), map.version(), layout.m_tileSize);
+    return commitFile(file, ok, progress);
+}
+
+/**
+ * @brief 从文件载入一个区域内的瓦片
+ * @param filePath 文件路径
+ * @param region 区域（场景坐标），空矩形表示载入全部瓦片
+ * @param map 概念图对象
+ * @param progress 进度（按压缩后的字节），可以为 nullptr
+ * @return 如果成功载入返回 true，否则返回 false
+ */
+bool ConceptMapTiles::loadRegion(const QString& filePath, const QRectF& region, ConceptMap& map,
+                                 OperationProgress* progress)
+{
+    ConceptMapTiles store;
+    if (!store.open(filePath)) {
+        return false;
+    }
+    const QVector<quint64> keys = region.isNull() ? store.m_index.keys() : store.tilesIntersecting(region);
+    QVector<TileData> tiles;
+    if (!store.decodeTiles(keys, tiles, progress)) {
+        return false;
+    }
+
+    // 只保留两个端点都已载入的连接线，每条只取一次
+    QVector<ConceptNode> nodes;
+    QSet<NodeId> nodeIds;
+    for (TileData& tile : tiles) {
+        for (ConceptNode& node : tile.nodes) {
+            nodeIds.insert(node.id());
+            nodes.append(std::move(node));
+        }
+    }
+    QVector<ConceptEdge> edges;
+    QSet<EdgeId> edgeIds;
+    for (const TileData& tile : tiles) {
+        for (const TileEdge& stored : tile.edges) {
+            const ConceptEdge& edge = stored.edge;
+            if (nodeIds.contains(edge.sourceNodeId()) && nodeIds.contains(edge.targetNodeId())
+                && !edgeIds.contains(edge.id())) {
+                edgeIds.insert(edge.id());
+                edges.append(edge);
+            }
+        }
+    }
+
+    map.setName(store.mapName());
+    map.setVersion(store.mapVersion());
+    map.bulkLoad(std::move(nodes), std::move(edges));
+    return true;
+}
+
+/**
+ * @brief 从文件载入以若干节点为中心的子图
+ * @param filePath 文件路径
+ * @param seedUuids 种子节点的 UUID
+ * @param depth 扩展步数，0 表示只载入种子节点
+ * @param map 概念图对象
+ * @param progress 进度（按压缩后的字节），可以为 nullptr
+ * @return 如果成功载入返回 true，否则返回 false
+ */
+bool ConceptMapTiles::loadSubgraph(const QString& filePath, const QStringList& seedUuids, int depth, ConceptMap& map,
+                                   OperationProgress* progress)
+{
+    ConceptMapTiles store;
+    if (!store.open(filePath)) {
+        return false;
+    }
+
+    // 解码后的瓦片和按节点查找的下标
+    struct IndexedTile
+    {
+        TileData data;
+        QHash<NodeId, int> nodes;           // 节点 -> data.nodes 下标
+        QMultiHash<NodeId, int> edges;      // 端点 -> data.edges 下标
+    };
+    QHash<quint64, IndexedTile> tiles;
+    auto addTile = [&tiles](quint64 key, TileData&& data) {
+        IndexedTile& tile = tiles[key];
+        tile.data = std::move(data);
+        for (int i = 0; i < tile.data.nodes.size(); ++i) {
+            tile.nodes.insert(tile.data.nodes[i].id(), i);
+        }
+        for (int i = 0; i < tile.data.edges.size(); ++i) {
+            const ConceptEdge& edge = tile.data.edges[i].edge;
+            tile.edges.insert(edge.sourceNodeId(), i);
+            if (edge.targetNodeId() != edge.sourceNodeId()) {
+                tile.edges.insert(edge.targetNodeId(), i);
+            }
+        }
+    };
+
+    // 种子节点所在的瓦片未知，分批扫描全部瓦片，只留下含有种子的瓦片
+    QSet<NodeId> seeds;
+    for (const QString& uuid : seedUuids) {
+        const NodeId id = IdRegistry::fromUuid(uuid);
+        if (id != InvalidId) {
+            seeds.insert(id);
+        }
+    }
+    QHash<NodeId, quint64> included;    // 已选中的节点 -> 所在瓦片
+    const QVector<quint64> allKeys = store.m_index.keys();
+    const int batchSize = qMax(1, QThread::idealThreadCount()) * 4;
+    for (int start = 0; start < allKeys.size() && included.size() < seeds.size(); start += batchSize) {
+        const QVector<quint64> batch = allKeys.mid(start, batchSize);
+        QVector<TileData> decoded;
+        if (!store.decodeTiles(batch, decoded, progress)) {
+            return false;
+        }
+        for (int i = 0; i < batch.size(); ++i) {
+            bool hit = false;
+            for (const ConceptNode& node : decoded[i].nodes) {
+                if (seeds.contains(node.id())) {
+                    included.insert(node.id(), batch[i]);
+                    hit = true;
+                }
+            }
+            if (hit) {
+                addTile(batch[i], std::move(decoded[i]));
+            }
+        }
+    }
+    if (included.isEmpty()) {
+        qWarning() << "文件中没有找到种子节点:" << filePath;
+        return false;
+    }
+
+    // 按层扩展，连接线记录中的端点瓦片指明下一步要读取的瓦片
+    QVector<NodeId> frontier = included.keys();
+    for (int level = 0; level < depth && !frontier.isEmpty(); ++level) {
+        QVector<QPair<NodeId, quint64>> candidates;
+        for (NodeId id : frontier) {
+            const IndexedTile& tile = tiles[included.value(id)];
+            const auto range = tile.edges.equal_range(id);
+            for (auto it = range.first; it != range.second; ++it) {
+                const TileEdge& stored = tile.data.edges[it.value()];
+                if (stored.edge.sourceNodeId() == id) {
+                    candidates.append(qMakePair(stored.edge.targetNodeId(), stored.targetTile));
+                }
+                if (stored.edge.targetNodeId() == id) {
+                    candidates.append(qMakePair(stored.edge.sourceNodeId(), stored.sourceTile));
+                }
+            }
+        }
+
+        QVector<quint64> missing;
+        for (const auto& candidate : candidates) {
+            if (!included.contains(candidate.first) && !tiles.contains(candidate.second)
+                && store.m_index.contains(candidate.second) && !missing.contains(candidate.second)) {
+                missing.append(candidate.second);
+            }
+        }
+        QVector<TileData> decoded;
+        if (!store.decodeTiles(missing, decoded, progress)) {
+            return false;
+        }
+        for (int i = 0; i < missing.size(); ++i) {
+            addTile(missing[i], std::move(decoded[i]));
+        }
+
+        QVector<NodeId> next;
+        for (const auto& candidate : candidates) {
+            if (included.contains(candidate.first)) {
+                continue;
+            }
+            auto tile = tiles.constFind(candidate.second);
+            if (tile != tiles.cend() && tile->nodes.contains(candidate.first)) {
+                included.insert(candidate.first, candidate.second);
+                next.append(candidate.first);
+            }
+        }
+        frontier = next;
+    }
+
+    // 收集选中的节点和两端都被选中的连接线
+    QVector<ConceptNode> nodes;
+    nodes.reserve(included.size());
+    for (auto it = included.cbegin(); it != included.cend(); ++it) {
+        const IndexedTile& tile = tiles[it.value()];
+        nodes.append(tile.data.nodes[tile.nodes.value(it.key())]);
+    }
+    QVector<ConceptEdge> edges;
+    QSet<EdgeId> edgeIds;
+    for (const IndexedTile& tile : tiles) {
+        for (const TileEdge& stored : tile.data.edges) {
+            const ConceptEdge& edge = stored.edge;
+            if (included.contains(edge.sourceNodeId()) && included.contains(edge.targetNodeId())
+                && !edgeIds.contains(edge.id())) {
+                edgeIds.insert(edge.id());
+                edges.append(edge);
+            }
+        }
+    }
+
+    map.setName(store.mapName());
+    map.setVersion(store.mapVersion());
+    map.bulkLoad(std::move(nodes), std::move(edges));
+    return true;
+}
+
+/**
+ * @brief 计算节点所在的瓦片
+ * @param node 节点
+ * @return 瓦片键
+ */
+quint64 ConceptMapTiles::tileOf(const ConceptNode& node) const
+{
+    auto cell = [this](double value) {
+        const double index = std::floor(value / m_tileSize);
+        return qint32(qBound<double>(std::numeric_limits<qint32>::min(), index, std::numeric_limits<qint32>::max()));
+    };
+    return makeKey(cell(node.x() + node.width() / 2), cell(node.y() + node.height() / 2));
+}
+
+/**
+ * @brief 获取瓦片覆盖的矩形
+ * @param key 瓦片键
+ * @return 场景矩形
+ */
+QRectF ConceptMapTiles::tileRect(quint64 key) const
+{
+    return QRectF(keyX(key) * m_tileSize, keyY(key) * m_tileSize, m_tileSize, m_tileSize);
+}
+
+/**
+ * @brief 获取文件中与矩形相交的瓦片
+ * @param rect 场景矩形
+ * @return 瓦片键
+ */
+QVector<quint64> ConceptMapTiles::tilesIntersecting(const QRectF& rect) const
+{
+    auto cell = [this](double value) {
+        const double index = std::floor(value / m_tileSize);
+        return qint64(qBound<double>(std::numeric_limits<qint32>::min(), index, std::numeric_limits<qint32>::max()));
+    };
+    const qint64 left = cell(rect.left());
+    const qint64 right = cell(rect.right());
+    const qint64 top = cell(rect.top());
+    const qint64 bottom = cell(rect.bottom());
+
+    // 矩形覆盖的格子比文件中的瓦片还多时（缩得很小），直接遍历索引
+    QVector<quint64> keys;
+    if ((right - left + 1) * (bottom - top + 1) > m_index.size()) {
+        for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+            const qint64 x = keyX(it.key());
+            const qint64 y = keyY(it.key());
+            if (x >= left && x <= right && y >= top && y <= bottom) {
+                keys.append(it.key());
+            }
+        }
+        return keys;
+    }
+
+    for (qint64 y = top; y <= bottom; ++y) {
+        for (qint64 x = left; x <= right; ++x) {
+            const quint64 key = makeKey(qint32(x), qint32(y));
+            if (m_index.contains(key)) {
+                keys.append(key);
+            }
+        }
+    }
+    return keys;
+}
+
+/**
+ * @brief 并行解码文件中的瓦片
+ * @param keys 瓦片键
+ * @param tiles 解码结果，与 keys 一一对应
+ * @param progress 进度（按压缩后的字节），可以为 nullptr
+ * @return 如果全部解码成功返回 true，否则返回 false
+ */
+bool ConceptMapTiles::decodeTiles(const QVector<quint64>& keys, QVector<TileData>& tiles,
+                                  OperationProgress* progress) const
+{
+    tiles = QVector<TileData>(keys.size());
+    if (keys.isEmpty()) {
+        return true;
+    }
+
+    FileView file(m_filePath);
+    if (!file.isOpen()) {
+        qWarning() << "无法打开文件:" << m_filePath;
+        return false;
+    }
+    if (progress) {
+        qint64 total = 0;
+        for (quint64 key : keys) {
+            total += m_index.value(key).compressedSize;
+        }
+        progress->addTotal(total);
+    }
+
+    TileData* out = tiles.data();
+    QVector<int> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::atomic<bool> ok(true);
+    const IdRegistry::TablePointer ids = IdRegistry::currentTable();
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        const IdRegistry::Scope scope(ids);
+        if (!ok || (progress && progress->isCanceled())) {
+            return;
+        }
+        const auto entry = m_index.constFind(keys[index]);
+        if (entry == m_index.cend()) {
+            return;
+        }
+        if (quint64(entry->offset) + entry->compressedSize > quint64(file.size())) {
+            ok = false;
+            return;
+        }
+        const QByteArray raw = qUncompress(file.data() + entry->offset, qsizetype(entry->compressedSize));
+        if (raw.size() != qsizetype(entry->rawSize)) {
+            ok = false;
+            return;
+        }
+
+        QDataStream in(raw);
+        in.setVersion(QDataStream::Qt_6_0);
+        TileData& tile = out[index];
+        quint32 count = 0;
+        in >> count;
+        tile.nodes.reserve(int(qMin(count, entry->nodeCount)));
+        ConceptNode node(InvalidId);
+        for (quint32 i = 0; i < count; ++i) {
+            if (!RecordStream::readNode(in, node)) {
+                ok = false;
+                return;
+            }
+            tile.nodes.append(node);
+        }
+        in >> count;
+        tile.edges.reserve(int(qMin(count, entry->edgeCount)));
+        TileEdge stored;
+        for (quint32 i = 0; i < count; ++i) {
+            if (!RecordStream::readEdge(in, stored.edge)) {
+                ok = false;
+                return;
+            }
+            in >> stored.sourceTile >> stored.targetTile;
+            tile.edges.append(stored);
+        }
+        if (in.status() != QDataStream::Ok) {
+            ok = false;
+            return;
+        }
+        if (progress) {
+            progress->advance(entry->compressedSize);
+        }
+    });
+
+    if (progress && progress->isCanceled()) {
+        return false;
+    }
+    if (!ok) {
+        qWarning() << "瓦片数据损坏:" << m_filePath;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 把解码的瓦片加入概念图并记为已载入
+ * @param map 概念图对象
+ * @param keys 瓦片键
+ * @param tiles 解码后的瓦片
+ */
+void ConceptMapTiles::mergeTiles(ConceptMap& map, const QVector<quint64>& keys, const QVector<TileData>& tiles)
+{
+    // 先加入全部节点，相邻瓦片之间的连接线才能找到端点；已在概念图中的节点
+    // （例如移入尚未载入的瓦片的节点）保持不变，删除后尚未写回的节点不再加入
+    for (int i = 0; i < keys.size(); ++i) {
+        for (const ConceptNode& node : tiles[i].nodes) {
+            if (!map.hasNode(node.id()) && !m_removedNodes.contains(node.id()) && map.addNode(node)) {
+                m_nodeTile.insert(node.id(), keys[i]);
+            }
+        }
+    }
+
+    // 另一个端点尚未载入的连接线会在那个瓦片载入时加入
+    for (int i = 0; i < keys.size(); ++i) {
+        for (const TileEdge& stored : tiles[i].edges) {
+            const ConceptEdge& edge = stored.edge;
+            if (!map.hasEdge(edge.id()) && map.addEdge(edge)) {
+                m_edgeEnds.insert(edge.id(), qMakePair(edge.sourceNodeId(), edge.targetNodeId()));
+            }
+        }
+    }
+
+    for (quint64 key : keys) {
+        if (!m_resident.contains(key)) {
+            m_resident.insert(key, m_clock);
+            m_residentBytes += m_index.value(key).rawSize;
+        }
+    }
+}
+
+/**
+ * @brief 卸载最久未使用的瓦片，直到不超过预算
+ * @param map 概念图对象
+ * @param keep 不能卸载的瓦片
+ */
+void ConceptMapTiles::evict(ConceptMap& map, const QVector<quint64>& keep)
+{
+    if (m_residentBytes <= m_budget) {
+        return;
+    }
+
+    // 有修改的瓦片要等写回后才能卸载
+    const QSet<quint64> kept(keep.cbegin(), keep.cend());
+    QVector<QPair<quint64, quint64>> candidates;    // 最近使用的时钟, 瓦片键
+    for (auto it = m_resident.cbegin(); it != m_resident.cend(); ++it) {
+        if (!kept.contains(it.key()) && !m_dirty.contains(it.key())) {
+            candidates.append(qMakePair(it.value(), it.key()));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    QSet<quint64> evicted;
+    for (const auto& candidate : candidates) {
+        if (m_residentBytes <= m_budget) {
+            break;
+        }
+        evicted.insert(candidate.second);
+        m_resident.remove(candidate.second);
+        m_residentBytes -= m_index.value(candidate.second).rawSize;
+    }
+    if (evicted.isEmpty()) {
+        return;
+    }
+
+    QVector<NodeId> nodeIds;
+    for (auto it = m_nodeTile.cbegin(); it != m_nodeTile.cend(); ++it) {
+        if (evicted.contains(it.value())) {
+            nodeIds.append(it.key());
+        }
+    }
+    for (NodeId id : nodeIds) {
+        for (EdgeId edgeId : map.edgeIdsByNodeId(id)) {
+            m_edgeEnds.remove(edgeId);
+        }
+        map.removeNode(id);
+        m_nodeTile.remove(id);
+    }
+}
+
+/**
+ * @brief 标记瓦片有未保存的修改
+ * @param key 瓦片键
+ */
+void ConceptMapTiles::touch(quint64 key)
+{
+    m_dirty.insert(key, m_generation);
+
+    // 文件中还没有的瓦片没有内容可以载入，直接记为已载入
+    if (!m_index.contains(key) && !m_resident.contains(key)) {
+        m_resident.insert(key, m_clock);
+    }
+}
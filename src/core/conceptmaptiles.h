@@ -0,0 +1,327 @@
+#ifndef CONCEPTMAPTILES_H
+#define CONCEPTMAPTILES_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QPair>
+#include <QRectF>
+#include <QVector>
+#include "conceptmap.h"
+#include "changeset.h"
+
+class OperationProgress;
+
+/**
+ * @brief 分瓦片概念图格式（.cmapt）和按需载入的瓦片存储
+ *
+ * 平面按固定边长划分为方形瓦片，节点按中心点归入一个瓦片，连接线同时保存在
+ * 两个端点所在的瓦片中，并记下两个端点的瓦片，便于沿连接线找到相邻瓦片。
+ * 每个瓦片是一段用 qCompress 压缩的 QDataStream 记录（布局见 RecordStream），
+ * 可以单独读取。文件布局（所有整数均为小端序）：
+ * - 文件头（64 字节）：魔数 "CMPT"、主/次版本号、瓦片边长、瓦片数量、
+ *   索引位置、元数据位置和字节数
+ * - 瓦片数据
+ * - 元数据：名称和版本
+ * - 索引：每个瓦片的坐标、位置、压缩前后的字节数、节点和连接线数量
+ *
+ * 静态函数整体读写文件，或者只读取一个区域、一个子图。打开文件后，存储对象
+ * 跟随视口调用 page() 载入附近的瓦片，在内存超过预算时按最近使用顺序卸载
+ * 没有修改的瓦片；编辑通过 markDirty() 标记受影响的瓦片，保存时 writeBack()
+ * 只重新编码这些瓦片，其余瓦片原样复制。
+ *
+ * 存储对象不持有打开的文件，可以复制后交给工作线程保存，保存成功后在原对象上
+ * 调用 adoptSaved()。主版本号不同的文件拒绝读取。
+ */
+class ConceptMapTiles
+{
+public:
+    static constexpr quint16 MajorVersion = 1;                 // 不兼容修改时递增
+    static constexpr quint16 MinorVersion = 0;                 // 向后兼容的扩展时递增
+    static constexpr double DefaultTileSize = 2048.0;          // 默认瓦片边长（场景坐标）
+    static constexpr qint64 DefaultBudget = 64 * 1024 * 1024;  // 默认内存预算（字节）
+    static constexpr double PrefetchMargin = 0.5;              // 预取范围（相对区域尺寸）
+
+    /**
+     * @brief 构造函数，创建未打开文件的存储
+     */
+    ConceptMapTiles();
+
+    /**
+     * @brief 打开文件，读取索引和元数据（不载入任何瓦片）
+     * @param filePath 文件路径
+     * @return 如果成功打开返回 true，否则返回 false
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 关闭文件，丢弃全部状态
+     */
+    void close();
+
+    /**
+     * @brief 检查是否已打开文件
+     * @return 如果已打开返回 true，否则返回 false
+     */
+    bool isOpen() const { return !m_filePath.isEmpty(); }
+
+    /**
+     * @brief 获取打开的文件路径
+     * @return 文件路径
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief 获取文件中保存的概念图名称
+     * @return 名称
+     */
+    QString mapName() const { return m_mapName; }
+
+    /**
+     * @brief 获取文件中保存的概念图版本
+     * @return 版本
+     */
+    QString mapVersion() const { return m_mapVersion; }
+
+    /**
+     * @brief 设置内存预算
+     * @param bytes 已载入瓦片解压后的总字节数上限
+     */
+    void setBudget(qint64 bytes) { m_budget = bytes; }
+
+    /**
+     * @brief 获取内存预算
+     * @return 字节数
+     */
+    qint64 budget() const { return m_budget; }
+
+    /**
+     * @brief 获取已载入瓦片解压后的总字节数
+     * @return 字节数
+     */
+    qint64 residentBytes() const { return m_residentBytes; }
+
+    /**
+     * @brief 获取文件中的瓦片数量
+     * @return 瓦片数量
+     */
+    int tileCount() const { return m_index.size(); }
+
+    /**
+     * @brief 获取已载入的瓦片数量
+     * @return 瓦片数量
+     */
+    int residentTileCount() const { return m_resident.size(); }
+
+    /**
+     * @brief 检查是否有尚未写回的修改
+     * @return 如果有返回 true，否则返回 false
+     */
+    bool hasDirtyTiles() const { return !m_dirty.isEmpty(); }
+
+    /**
+     * @brief 获取文件中全部瓦片覆盖的范围
+     * @return 场景矩形，没有瓦片时返回空矩形
+     */
+    QRectF bounds() const;
+
+    /**
+     * @brief 获取打开文件后首先载入的区域
+     *
+     * 全部瓦片能放进预算时返回整个范围，否则返回范围中心附近大约占半个预算的区域。
+     *
+     * @return 场景矩形
+     */
+    QRectF initialRegion() const;
+
+    /**
+     * @brief 载入区域附近的瓦片，并在超过预算时卸载其余没有修改的瓦片
+     *
+     * 节点和连接线直接加入或移出概念图，调用方负责把它们作为一次事务提交。
+     *
+     * @param map 概念图对象
+     * @param region 需要的区域（场景坐标）
+     * @param progress 进度（按压缩后的字节），可以为 nullptr
+     * @return 如果成功载入返回 true，否则返回 false
+     */
+    bool page(ConceptMap& map, const QRectF& region, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 载入全部尚未载入的瓦片（不受预算限制）
+     * @param map 概念图对象
+     * @param progress 进度（按压缩后的字节），可以为 nullptr
+     * @return 如果成功载入返回 true，否则返回 false
+     */
+    bool loadAll(ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 根据一次提交的变更标记需要重新编码的瓦片
+     * @param changes 变更记录
+     * @param map 提交后的概念图
+     */
+    void markDirty(const ChangeSet& changes, const ConceptMap& map);
+
+    /**
+     * @brief 写回文件（写完后原子替换目标文件）
+     *
+     * 修改过的瓦片由概念图和原文件中未载入的记录重新编码，其余瓦片原样复制。
+     * 成功后存储改为指向新文件。
+     *
+     * @param filePath 文件路径，可以与打开的文件相同
+     * @param map 概念图对象
+     * @param progress 进度（按瓦片），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    bool writeBack(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 采用副本写回后的文件状态
+     *
+     * 副本开始写回之后才标记的瓦片仍然保持修改状态。
+     *
+     * @param saved 成功调用过 writeBack() 的副本
+     */
+    void adoptSaved(const ConceptMapTiles& saved);
+
+    /**
+     * @brief 保存概念图到文件（写完后原子替换目标文件）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param tileSize 瓦片边长
+     * @param progress 进度（按瓦片），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool save(const QString& filePath, const ConceptMap& map, double tileSize = DefaultTileSize,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从文件载入一个区域内的瓦片
+     *
+     * 读取失败时概念图保持不变。
+     *
+     * @param filePath 文件路径
+     * @param region 区域（场景坐标），空矩形表示载入全部瓦片
+     * @param map 概念图对象
+     * @param progress 进度（按压缩后的字节），可以为 nullptr
+     * @return 如果成功载入返回 true，否则返回 false
+     */
+    static bool loadRegion(const QString& filePath, const QRectF& region, ConceptMap& map,
+                           OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从文件载入以若干节点为中心的子图
+     *
+     * 从种子节点出发沿连接线（不分方向）扩展 depth 步，只读取途经的瓦片。
+     * 读取失败或找不到任何种子节点时概念图保持不变。
+     *
+     * @param filePath 文件路径
+     * @param seedUuids 种子节点的 UUID
+     * @param depth 扩展步数，0 表示只载入种子节点
+     * @param map 概念图对象
+     * @param progress 进度（按压缩后的字节），可以为 nullptr
+     * @return 如果成功载入返回 true，否则返回 false
+     */
+    static bool loadSubgraph(const QString& filePath, const QStringList& seedUuids, int depth, ConceptMap& map,
+                             OperationProgress* progress = nullptr);
+
+private:
+    /**
+     * @brief 索引中一个瓦片的位置
+     */
+    struct TileEntry
+    {
+        qint64 offset = 0;          // 压缩数据在文件中的位置
+        quint32 compressedSize = 0;
+        quint32 rawSize = 0;
+        quint32 nodeCount = 0;
+        quint32 edgeCount = 0;
+    };
+
+    /**
+     * @brief 瓦片中的连接线记录
+     */
+    struct TileEdge
+    {
+        ConceptEdge edge{InvalidId};
+        quint64 sourceTile = 0;     // 源节点所在瓦片
+        quint64 targetTile = 0;     // 目标节点所在瓦片
+    };
+
+    /**
+     * @brief 解码后的瓦片
+     */
+    struct TileData
+    {
+        QVector<ConceptNode> nodes;
+        QVector<TileEdge> edges;
+    };
+
+    /**
+     * @brief 计算节点所在的瓦片
+     * @param node 节点
+     * @return 瓦片键
+     */
+    quint64 tileOf(const ConceptNode& node) const;
+
+    /**
+     * @brief 获取瓦片覆盖的矩形
+     * @param key 瓦片键
+     * @return 场景矩形
+     */
+    QRectF tileRect(quint64 key) const;
+
+    /**
+     * @brief 获取文件中与矩形相交的瓦片
+     * @param rect 场景矩形
+     * @return 瓦片键
+     */
+    QVector<quint64> tilesIntersecting(const QRectF& rect) const;
+
+    /**
+     * @brief 并行解码文件中的瓦片
+     * @param keys 瓦片键
+     * @param tiles 解码结果，与 keys 一一对应
+     * @param progress 进度（按压缩后的字节），可以为 nullptr
+     * @return 如果全部解码成功返回 true，否则返回 false
+     */
+    bool decodeTiles(const QVector<quint64>& keys, QVector<TileData>& tiles, OperationProgress* progress) const;
+
+    /**
+     * @brief 把解码的瓦片加入概念图并记为已载入
+     * @param map 概念图对象
+     * @param keys 瓦片键
+     * @param tiles 解码后的瓦片
+     */
+    void mergeTiles(ConceptMap& map, const QVector<quint64>& keys, const QVector<TileData>& tiles);
+
+    /**
+     * @brief 卸载最久未使用的瓦片，直到不超过预算
+     * @param map 概念图对象
+     * @param keep 不能卸载的瓦片
+     */
+    void evict(ConceptMap& map, const QVector<quint64>& keep);
+
+    /**
+     * @brief 标记瓦片有未保存的修改
+     * @param key 瓦片键
+     */
+    void touch(quint64 key);
+
+    QString m_filePath;                             // 打开的文件，空表示未打开
+    double m_tileSize;                              // 瓦片边长
+    QString m_mapName;                              // 文件中的名称
+    QString m_mapVersion;                           // 文件中的版本
+    QHash<quint64, TileEntry> m_index;              // 文件中的瓦片
+    QHash<quint64, quint64> m_resident;             // 已载入的瓦片 -> 最近一次使用的时钟
+    QHash<quint64, quint64> m_dirty;                // 有未保存修改的瓦片 -> 标记时的代数
+    QHash<NodeId, quint64> m_nodeTile;              // 概念图中的节点 -> 所属瓦片
+    QHash<EdgeId, QPair<NodeId, NodeId>> m_edgeEnds;  // 概念图中的连接线 -> 端点
+    QHash<NodeId, quint64> m_removedNodes;          // 删除后尚未写回的节点 -> 标记时的代数
+    qint64 m_budget;                                // 内存预算
+    qint64 m_residentBytes;                         // 已载入瓦片解压后的总字节数
+    quint64 m_clock;                                // 每次 page() 递增，用于最近使用顺序
+    quint64 m_generation;                           // 每次 markDirty() 递增
+    quint64 m_savedGeneration;                      // 最近一次 writeBack() 开始时的代数
+};
+
+#endif // CONCEPTMAPTILES_H
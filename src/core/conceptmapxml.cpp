@@ -0,0 +1,602 @@
+#include "conceptmapxml.h"
+#include "recordbatch.h"
+#include "operationprogress.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QLocale>
+#include <QThread>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+#include <atomic>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief 读取字符串属性，属性不存在时保持默认值
+ */
+void readText(const QXmlStreamAttributes& attributes, QLatin1String name, QString& out)
+{
+    if (attributes.hasAttribute(name)) {
+        out = attributes.value(name).toString();
+    }
+}
+
+/**
+ * @brief 读取数值属性，属性不存在或无法解析时保持默认值
+ */
+void readNumber(const QXmlStreamAttributes& attributes, QLatin1String name, qreal& out)
+{
+    bool ok = false;
+    const qreal value = attributes.value(name).toDouble(&ok);
+    if (ok) {
+        out = value;
+    }
+}
+
+/**
+ * @brief 读取颜色属性，属性不存在或无法解析时保持默认值
+ */
+void readColor(const QXmlStreamAttributes& attributes, QColor& out)
+{
+    const QColor color = ConceptMapXml::colorFromString(attributes.value(QLatin1String("color")));
+    if (color.isValid()) {
+        out = color;
+    }
+}
+
+/**
+ * @brief 从 <node> 元素的属性读取节点
+ */
+void readNode(const QXmlStreamAttributes& attributes, RecordBatch& batch)
+{
+    ConceptNode node(InvalidId);
+    QString id;
+    QString text = node.text();
+    QString style = node.style();
+    qreal x = node.x();
+    qreal y = node.y();
+    qreal width = node.width();
+    qreal height = node.height();
+    QColor color = node.color();
+
+    readText(attributes, QLatin1String("id"), id);
+    readText(attributes, QLatin1String("text"), text);
+    readNumber(attributes, QLatin1String("x"), x);
+    readNumber(attributes, QLatin1String("y"), y);
+    readNumber(attributes, QLatin1String("width"), width);
+    readNumber(attributes, QLatin1String("height"), height);
+    readColor(attributes, color);
+    readText(attributes, QLatin1String("style"), style);
+
+    node.setText(text);
+    node.setPos(QPointF(x, y));
+    node.setSize(QSizeF(width, height));
+    node.setColor(color);
+    node.setStyle(style);
+    batch.addNode(std::move(node), id);
+}
+
+/**
+ * @brief 从 <edge> 元素的属性读取连接线
+ */
+void readEdge(const QXmlStreamAttributes& attributes, RecordBatch& batch)
+{
+    ConceptEdge edge(InvalidId);
+    QString id;
+    QString sourceId;
+    QString targetId;
+    QString label = edge.label();
+    QString style = edge.style();
+    QColor color = edge.color();
+
+    readText(attributes, QLatin1String("id"), id);
+    readText(attributes, QLatin1String("sourceNodeId"), sourceId);
+    readText(attributes, QLatin1String("sourceId"), sourceId);
+    readText(attributes, QLatin1String("targetNodeId"), targetId);
+    readText(attributes, QLatin1String("targetId"), targetId);
+    readText(attributes, QLatin1String("label"), label);
+    readColor(attributes, color);
+    readText(attributes, QLatin1String("style"), style);
+
+    edge.setLabel(label);
+    edge.setColor(color);
+    edge.setStyle(style);
+    batch.addEdge(std::move(edge), id, sourceId, targetId);
+}
+
+/**
+ * @brief 解析得到的整个文档
+ */
+struct Document
+{
+    RecordBatch batch;
+    QString name;
+    QString version;
+    bool hasName = false;
+    bool hasVersion = false;
+};
+
+/**
+ * @brief 解析文档：根元素的属性是概念图信息，任意层级的 <node>/<edge> 是记录
+ */
+bool parseDocument(QXmlStreamReader& xml, Document& document, QString* errorMessage,
+                   OperationProgress* progress = nullptr)
+{
+    ProgressReporter reporter(progress);
+    auto position = [&xml]() {
+        return xml.device() ? xml.device()->pos() : xml.characterOffset();
+    };
+
+    bool atRoot = true;
+    int elements = 0;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        if (progress && ++elements % OperationProgress::ReportInterval == 0 && !reporter.moveTo(position())) {
+            xml.raiseError(QStringLiteral("已取消"));
+            break;
+        }
+
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (atRoot) {
+            // 根元素上的概念图信息
+            atRoot = false;
+            document.hasName = attributes.hasAttribute(QLatin1String("name"));
+            document.hasVersion = attributes.hasAttribute(QLatin1String("version"));
+            readText(attributes, QLatin1String("name"), document.name);
+            readText(attributes, QLatin1String("version"), document.version);
+            continue;
+        }
+
+        const QStringView tag = xml.name();
+        if (tag == QLatin1String("node")) {
+            readNode(attributes, document.batch);
+        } else if (tag == QLatin1String("edge")) {
+            readEdge(attributes, document.batch);
+        }
+    }
+
+    if (xml.hasError()) {
+        if (errorMessage) {
+            if (progress && progress->isCanceled()) {
+                *errorMessage = xml.errorString();
+            } else {
+                *errorMessage = QStringLiteral("%1（行 %2，列 %3）")
+                                    .arg(xml.errorString())
+                                    .arg(xml.lineNumber())
+                                    .arg(xml.columnNumber());
+            }
+        }
+        return false;
+    }
+    reporter.moveTo(position());
+    return true;
+}
+
+/**
+ * @brief 把解析结果载入概念图
+ */
+void applyDocument(Document& document, ConceptMap& map)
+{
+    if (document.hasName) {
+        map.setName(document.name);
+    }
+    if (document.hasVersion) {
+        map.setVersion(document.version);
+    }
+    document.batch.loadInto(map);
+}
+
+/**
+ * @brief 检查 pos 处是否以 token 开头
+ */
+bool matchAt(const QByteArray& data, qsizetype pos, const char* token)
+{
+    const qsizetype length = qsizetype(qstrlen(token));
+    return pos + length <= data.size() && memcmp(data.constData() + pos, token, size_t(length)) == 0;
+}
+
+/**
+ * @brief 从 from 开始查找 token，返回其后的位置，找不到返回 -1
+ */
+qsizetype skipPast(const QByteArray& data, qsizetype from, const char* token)
+{
+    const qsizetype found = data.indexOf(token, from);
+    return found < 0 ? -1 : found + qsizetype(qstrlen(token));
+}
+
+/**
+ * @brief 跳过标签到 '>' 之后（忽略引号中的 '>'），返回其后的位置，找不到返回 -1
+ */
+qsizetype skipTag(const QByteArray& data, qsizetype from)
+{
+    const char* p = data.constData();
+    const qsizetype size = data.size();
+    char quote = 0;
+    for (qsizetype i = from; i < size; ++i) {
+        if (quote) {
+            if (p[i] == quote) {
+                quote = 0;
+            }
+        } else if (p[i] == '"' || p[i] == '\'') {
+            quote = p[i];
+        } else if (p[i] == '>') {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 扫描文档，在根元素的直接子元素之前切分
+ *
+ * 只识别标签、注释、CDATA 和处理指令的边界，不解析属性。含有 DOCTYPE
+ * （可能定义实体）或不是 ASCII 兼容编码的文档不切分。
+ *
+ * @param data 文档内容
+ * @param chunkBytes 每块的目标字节数
+ * @param head 输出：从文档开头到根元素开始标签结束的字节数
+ * @param rootName 输出：根元素的名称
+ * @param splits 输出：各分块（第一块除外）在文档中的起始位置
+ * @return 如果可以切分返回 true，否则返回 false
+ */
+bool scanDocument(const QByteArray& data, qint64 chunkBytes, qsizetype& head, QByteArray& rootName,
+                  QVector<qsizetype>& splits)
+{
+    const char* p = data.constData();
+    const qsizetype size = data.size();
+    // UTF-16/UTF-32 以字节序标记或 0 字节开头
+    if (size < 4 || !p[0] || !p[1] || uchar(p[0]) == 0xFE || uchar(p[0]) == 0xFF) {
+        return false;
+    }
+
+    // 查找根元素
+    qsizetype i = data.indexOf('<');
+    while (i >= 0 && (matchAt(data, i, "<?") || matchAt(data, i, "<!--"))) {
+        i = skipPast(data, i, matchAt(data, i, "<?") ? "?>" : "-->");
+        i = i < 0 ? -1 : data.indexOf('<', i);
+    }
+    if (i < 0 || matchAt(data, i, "<!")) {
+        return false;
+    }
+    qsizetype nameEnd = i + 1;
+    while (nameEnd < size && !QChar::isSpace(uchar(p[nameEnd])) && p[nameEnd] != '/' && p[nameEnd] != '>') {
+        ++nameEnd;
+    }
+    rootName = data.mid(i + 1, nameEnd - i - 1);
+    head = skipTag(data, i);
+    if (head < 0 || p[head - 2] == '/') {
+        return false;
+    }
+
+    // 扫描根元素的内容
+    int depth = 1;
+    qsizetype chunkBegin = 0;
+    i = data.indexOf('<', head);
+    while (i >= 0 && depth > 0) {
+        if (matchAt(data, i, "<!--")) {
+            i = skipPast(data, i, "-->");
+        } else if (matchAt(data, i, "<![CDATA[")) {
+            i = skipPast(data, i, "]]>");
+        } else if (matchAt(data, i, "<?")) {
+            i = skipPast(data, i, "?>");
+        } else if (matchAt(data, i, "</")) {
+            --depth;
+            i = skipTag(data, i);
+        } else {
+            if (depth == 1 && i - chunkBegin >= chunkBytes) {
+                splits.append(i);
+                chunkBegin = i;
+            }
+            i = skipTag(data, i);
+            if (i >= 0 && p[i - 2] != '/') {
+                ++depth;
+            }
+        }
+        if (i >= 0) {
+            i = data.indexOf('<', i);
+        }
+    }
+    return !splits.isEmpty();
+}
+
+/**
+ * @brief 并行解析内存中的整个文档
+ *
+ * 每个分块前面加上从文档开头到根元素开始标签的内容，除最后一块外后面补上根元素的结束标签，
+ * 这样每块都是完整的文档，命名空间声明和编码声明都保持不变。各块由 QtConcurrent
+ * 分配到线程池解析，结果按分块顺序合并，记录顺序与串行解析相同。
+ * 任何一步失败都退回串行解析，以得到相同的错误信息。
+ * 每解析完一块按该块的字节数推进进度，取消时不再退回串行解析。
+ */
+bool parseParallel(const QByteArray& data, Document& document, QString* errorMessage,
+                   OperationProgress* progress)
+{
+    qsizetype head = 0;
+    QByteArray rootName;
+    QVector<qsizetype> splits;
+    auto serial = [&]() {
+        document = Document();
+        QXmlStreamReader xml(data);
+        return parseDocument(xml, document, errorMessage, progress);
+    };
+    if (!scanDocument(data, RecordBatch::chunkBytes(data.size()), head, rootName, splits)) {
+        return serial();
+    }
+
+    const QByteArray closeTag = "</" + rootName + ">";
+    QVector<Document> documents(splits.size() + 1);
+    QVector<int> indices(documents.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::atomic<bool> ok(true);
+    const IdRegistry::TablePointer ids = IdRegistry::currentTable();
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        const IdRegistry::Scope scope(ids);
+        if (!ok || (progress && progress->isCanceled())) {
+            return;
+        }
+        const qsizetype begin = index == 0 ? head : splits[index - 1];
+        const qsizetype end = index < splits.size() ? splits[index] : data.size();
+        QByteArray chunk;
+        chunk.reserve(head + (end - begin) + closeTag.size());
+        chunk.append(data.constData(), head);
+        chunk.append(data.constData() + begin, end - begin);
+        if (index < splits.size()) {
+            chunk.append(closeTag);
+        }
+
+        QXmlStreamReader xml(chunk);
+        if (parseDocument(xml, documents[index], nullptr)) {
+            documents[index].batch.resolveIds();
+            if (progress) {
+                progress->advance(end - begin);
+            }
+        } else {
+            ok = false;
+        }
+    });
+    if (progress && progress->isCanceled()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("已取消");
+        }
+        return false;
+    }
+    if (!ok) {
+        return serial();
+    }
+
+    document = std::move(documents[0]);
+    for (int i = 1; i < documents.size(); ++i) {
+        document.batch.append(std::move(documents[i].batch));
+    }
+    if (progress) {
+        progress->advance(head);
+    }
+    return true;
+}
+
+/**
+ * @brief 以最短的无损形式格式化数值
+ */
+QString numberText(qreal value)
+{
+    return QString::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+/**
+ * @brief 按格式格式化颜色
+ */
+QString colorText(const QColor& color, ConceptMapXml::Dialect dialect)
+{
+    if (dialect == ConceptMapXml::DocumentDialect) {
+        return color.name();
+    }
+    QString text = QString::number(color.red());
+    text += QLatin1Char(',');
+    text += QString::number(color.green());
+    text += QLatin1Char(',');
+    text += QString::number(color.blue());
+    return text;
+}
+
+} // namespace
+
+/**
+ * @brief 从设备读取概念图
+ * @param device 已打开的输入设备
+ * @param map 概念图对象
+ * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool ConceptMapXml::read(QIODevice* device, ConceptMap& map, QString* errorMessage, OperationProgress* progress)
+{
+    if (progress) {
+        progress->addTotal(device->size());
+    }
+
+    QXmlStreamReader xml(device);
+    Document document;
+    if (!parseDocument(xml, document, errorMessage, progress)) {
+        return false;
+    }
+
+    // 全部解析成功后才修改概念图
+    applyDocument(document, map);
+    return true;
+}
+
+/**
+ * @brief 把概念图写入设备
+ * @param device 已打开的输出设备
+ * @param map 概念图对象
+ * @param dialect 写入格式
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果全部写入成功返回 true，否则返回 false
+ */
+bool ConceptMapXml::write(QIODevice* device, const ConceptMap& map, Dialect dialect, OperationProgress* progress)
+{
+    if (progress) {
+        progress->addTotal(map.nodeCount() + map.edgeCount());
+    }
+    ProgressReporter reporter(progress);
+
+    const bool document = (dialect == DocumentDialect);
+    QXmlStreamWriter xml(device);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+
+    if (document) {
+        xml.writeStartElement(QStringLiteral("conceptMap"));
+        xml.writeAttribute(QStringLiteral("name"), map.name());
+        xml.writeAttribute(QStringLiteral("version"), map.version());
+    } else {
+        xml.writeStartElement(QStringLiteral("conceptmap"));
+    }
+
+    // 节点
+    for (const ConceptNode& node : map.allNodes()) {
+        xml.writeEmptyElement(QStringLiteral("node"));
+        xml.writeAttribute(QStringLiteral("id"), IdRegistry::toUuid(node.id()));
+        xml.writeAttribute(QStringLiteral("text"), node.text());
+        xml.writeAttribute(QStringLiteral("x"), numberText(node.x()));
+        xml.writeAttribute(QStringLiteral("y"), numberText(node.y()));
+        xml.writeAttribute(QStringLiteral("width"), numberText(node.width()));
+        xml.writeAttribute(QStringLiteral("height"), numberText(node.height()));
+        xml.writeAttribute(QStringLiteral("color"), colorText(node.color(), dialect));
+        xml.writeAttribute(QStringLiteral("style"), node.style());
+        if (!reporter.step()) {
+            return false;
+        }
+    }
+
+    // 连接线
+    for (const ConceptEdge& edge : map.allEdges()) {
+        xml.writeEmptyElement(QStringLiteral("edge"));
+        xml.writeAttribute(QStringLiteral("id"), IdRegistry::toUuid(edge.id()));
+        xml.writeAttribute(document ? QStringLiteral("sourceNodeId") : QStringLiteral("sourceId"),
+                           IdRegistry::toUuid(edge.sourceNodeId()));
+        xml.writeAttribute(document ? QStringLiteral("targetNodeId") : QStringLiteral("targetId"),
+                           IdRegistry::toUuid(edge.targetNodeId()));
+        xml.writeAttribute(QStringLiteral("label"), edge.label());
+        xml.writeAttribute(QStringLiteral("color"), colorText(edge.color(), dialect));
+        xml.writeAttribute(QStringLiteral("style"), edge.style());
+        if (!reporter.step()) {
+            return false;
+        }
+    }
+
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    return !xml.hasError();
+}
+
+/**
+ * @brief 从文件加载概念图
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度（按字节），可以为 nullptr
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool ConceptMapXml::load(const QString& filePath, ConceptMap& map, OperationProgress* progress)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
+        return false;
+    }
+
+    QString error;
+    bool ok = false;
+    const qint64 size = file.size();
+    uchar* mapped = nullptr;
+    if (size >= RecordBatch::ParallelThreshold && QThread::idealThreadCount() > 1) {
+        mapped = file.map(0, size);
+    }
+
+    if (mapped) {
+        // 大文件映射后分块并行解析
+        const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size);
+        if (progress) {
+            progress->addTotal(size);
+        }
+        Document document;
+        ok = parseParallel(data, document, &error, progress);
+        file.unmap(mapped);
+        if (ok) {
+            applyDocument(document, map);
+        }
+    } else {
+        ok = read(&file, map, &error, progress);
+    }
+
+    if (!ok && !(progress && progress->isCanceled())) {
+        qWarning() << "XML解析错误:" << error;
+    }
+    return ok;
+}
+
+/**
+ * @brief 保存概念图到文件（写完后原子替换目标文件）
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param dialect 写入格式
+ * @param progress 进度（按记录），可以为 nullptr
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool ConceptMapXml::save(const QString& filePath, const ConceptMap& map, Dialect dialect, OperationProgress* progress)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+
+    // 取消或失败时放弃临时文件，目标文件保持原样
+    if (!write(&file, map, dialect, progress)) {
+        if (!(progress && progress->isCanceled())) {
+            qWarning() << "写入文件失败:" << file.errorString();
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 解析颜色字符串
+ * @param text 颜色字符串
+ * @return 颜色，无法解析时返回无效颜色
+ */
+QColor ConceptMapXml::colorFromString(QStringView text)
+{
+    text = text.trimmed();
+    const qsizetype first = text.indexOf(QLatin1Char(','));
+    if (first < 0) {
+        return QColor::fromString(text);
+    }
+
+    // "r,g,b"：按逗号位置切片，不生成字符串列表
+    const qsizetype second = text.indexOf(QLatin1Char(','), first + 1);
+    if (second < 0) {
+        return QColor();
+    }
+    bool okRed = false;
+    bool okGreen = false;
+    bool okBlue = false;
+    const int red = text.first(first).trimmed().toInt(&okRed);
+    const int green = text.sliced(first + 1, second - first - 1).trimmed().toInt(&okGreen);
+    const int blue = text.sliced(second + 1).trimmed().toInt(&okBlue);
+    if (!okRed || !okGreen || !okBlue) {
+        return QColor();
+    }
+    return QColor(red, green, blue);
+}
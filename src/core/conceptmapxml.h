@@ -0,0 +1,96 @@
+#ifndef CONCEPTMAPXML_H
+#define CONCEPTMAPXML_H
+
+#include <QString>
+#include <QStringView>
+#include <QColor>
+#include "conceptmap.h"
+
+class QIODevice;
+class OperationProgress;
+
+/**
+ * @brief 概念图 XML 流式编解码
+ *
+ * 读取时用 QXmlStreamReader 逐个元素解析，数值和颜色直接从属性的 QStringView
+ * 解析，不生成临时字符串列表，也不建立 DOM 树；写入时用 QXmlStreamWriter
+ * 逐条输出元素，保存到文件时通过 QSaveFile 原子替换。内存占用与图的大小无关
+ * （不计最终交给 ConceptMap 的记录本身）。
+ *
+ * 项目中有两种 XML 写法，读取时两种都接受：
+ * - 序列化器格式：根元素 conceptmap，颜色为 "r,g,b"，端点属性为 sourceId/targetId
+ * - 文档格式：根元素 conceptMap 带 name/version，颜色为 "#rrggbb"，
+ *   端点属性为 sourceNodeId/targetNodeId
+ */
+class ConceptMapXml
+{
+public:
+    /**
+     * @brief 写入格式
+     */
+    enum Dialect {
+        SerializerDialect,  // ConceptMapSerializer 使用的格式
+        DocumentDialect     // FileManager 使用的格式
+    };
+
+    /**
+     * @brief 从设备读取概念图
+     *
+     * 解析失败时概念图保持不变。根元素没有 name/version 属性时不修改这两项。
+     *
+     * @param device 已打开的输入设备
+     * @param map 概念图对象
+     * @param errorMessage 解析失败时写入错误信息，可以为 nullptr
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool read(QIODevice* device, ConceptMap& map, QString* errorMessage = nullptr,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 把概念图写入设备
+     * @param device 已打开的输出设备
+     * @param map 概念图对象
+     * @param dialect 写入格式
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果全部写入成功返回 true，否则返回 false
+     */
+    static bool write(QIODevice* device, const ConceptMap& map, Dialect dialect,
+                      OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 从文件加载概念图
+     *
+     * 文件达到 RecordBatch::ParallelThreshold 时映射到内存，切成分块在线程池中并行解析，
+     * 结果与串行读取完全相同；无法切分或任一分块出错时退回串行解析。
+     *
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度（按字节），可以为 nullptr
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    static bool load(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 保存概念图到文件（写完后原子替换目标文件）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param dialect 写入格式
+     * @param progress 进度（按记录），可以为 nullptr
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool save(const QString& filePath, const ConceptMap& map, Dialect dialect,
+                     OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 解析颜色字符串
+     *
+     * 接受 "r,g,b"、"#rrggbb" 以及 QColor 支持的其它写法，不分配临时字符串。
+     *
+     * @param text 颜色字符串
+     * @return 颜色，无法解析时返回无效颜色
+     */
+    static QColor colorFromString(QStringView text);
+};
+
+#endif // CONCEPTMAPXML_H
@@ -1,18 +1,18 @@
 #include "conceptnode.h"
-#include <QUuid>
 
 /**
- * @brief 构造函数 - 创建一个空的概念节点
+ * @brief 构造函数 - 创建一个空的概念节点（ID 为 InvalidId）
  */
 ConceptNode::ConceptNode()
-    : m_id(generateId())
+    : m_id(InvalidId)
     , m_text("新节点")
     , m_x(0.0)
     , m_y(0.0)
     , m_width(120.0)
     , m_height(60.0)
-    , m_color(200, 220, 240)
-    , m_style("default")
+    , m_color(qRgb(200, 220, 240))
+    , m_style(QStringLiteral("default"))
+    , m_shape(NodeShape::Rectangle)
 {
 }
 
@@ -32,8 +32,8 @@ ConceptNode::ConceptNode(const QString& text, qreal x, qreal y, qreal width, qre
     , m_y(y)
     , m_width(width)
     , m_height(height)
-    , m_color(color)
-    , m_style("default")
+    , m_color(color.rgba())
+    , m_style(QStringLiteral("default"))
     , m_shape(NodeShape::Rectangle)
 {
 }
@@ -55,12 +55,29 @@ ConceptNode::ConceptNode(const QString& text, qreal x, qreal y, qreal width, qre
     , m_y(y)
     , m_width(width)
     , m_height(height)
-    , m_color(color)
-    , m_style("default")
+    , m_color(color.rgba())
+    , m_style(QStringLiteral("default"))
     , m_shape(shape)
 {
 }
 
+/**
+ * @brief 构造函数 - 创建一个使用指定ID的默认节点
+ * @param id 节点ID
+ */
+ConceptNode::ConceptNode(NodeId id)
+    : m_id(id)
+    , m_text("新节点")
+    , m_x(0.0)
+    , m_y(0.0)
+    , m_width(120.0)
+    , m_height(60.0)
+    , m_color(qRgb(200, 220, 240))
+    , m_style(QStringLiteral("default"))
+    , m_shape(NodeShape::Rectangle)
+{
+}
+
 /**
  * @brief 析构函数
  */
@@ -70,9 +87,9 @@ ConceptNode::~ConceptNode()
 
 /**
  * @brief 生成新的唯一标识符
- * @return 新的UUID字符串
+ * @return 新的节点ID
  */
-QString ConceptNode::generateId()
+NodeId ConceptNode::generateId()
 {
-    return QUuid::createUuid().toString(QUuid::WithoutBraces);
+    return IdRegistry::create();
 }
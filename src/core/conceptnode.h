@@ -5,7 +5,7 @@
 #include <QColor>
 #include <QSize>
 #include <QPointF>
-#include <QUuid>
+#include "idregistry.h"
 
 /**
  * @brief 节点形状枚举
@@ -33,11 +33,14 @@ class ConceptNode
 public:
     /**
      * @brief 构造函数 - 创建一个空的概念节点
+     *
+     * ID 为 InvalidId，不向 IdRegistry 申请句柄（占位、容器和读取失败时的返回值）。
+     * 新建要加入概念图的节点时使用带文本和位置的构造函数。
      */
     ConceptNode();
 
     /**
-     * @brief 构造函数 - 创建一个带有指定参数的概念节点
+     * @brief 构造函数 - 创建一个带有指定参数的新概念节点（分配新的ID）
      * @param text 节点文本内容
      * @param x 节点X坐标
      * @param y 节点Y坐标
@@ -59,6 +62,16 @@ public:
      */
     ConceptNode(const QString& text, qreal x, qreal y, qreal width, qreal height, const QColor& color, NodeShape shape);
 
+    /**
+     * @brief 构造函数 - 创建一个使用指定ID的默认节点
+     *
+     * 不向 IdRegistry 申请新句柄。加载文件时每条记录的ID都来自文件，
+     * 用这个构造函数可以避免为每条记录白白分配一个句柄。
+     *
+     * @param id 节点ID
+     */
+    explicit ConceptNode(NodeId id);
+
     /**
      * @brief 析构函数
      */
@@ -69,7 +82,7 @@ public:
      * @brief 获取节点唯一标识符
      * @return 节点ID
      */
-    QString id() const { return m_id; }
+    NodeId id() const { return m_id; }
 
     /**
      * @brief 获取节点文本内容
@@ -117,7 +130,7 @@ public:
      * @brief 获取节点颜色
      * @return 节点颜色
      */
-    QColor color() const { return m_color; }
+    QColor color() const { return QColor::fromRgba(m_color); }
 
     /**
      * @brief 获取节点样式
@@ -178,7 +191,7 @@ public:
      * @brief 设置节点颜色
      * @param color 新的颜色
      */
-    void setColor(const QColor& color) { m_color = color; }
+    void setColor(const QColor& color) { m_color = color.rgba(); }
 
     /**
      * @brief 设置节点样式
@@ -196,22 +209,22 @@ public:
      * @brief 设置节点ID
      * @param id 新的节点ID
      */
-    void setId(const QString& id) { m_id = id; }
+    void setId(NodeId id) { m_id = id; }
 
     /**
      * @brief 生成新的唯一标识符
-     * @return 新的UUID字符串
+     * @return 新的节点ID
      */
-    static QString generateId();
+    static NodeId generateId();
 
 private:
-    QString m_id;          // 节点唯一标识符
+    NodeId m_id;           // 节点唯一标识符
     QString m_text;        // 节点文本内容
     qreal m_x;             // 节点X坐标
     qreal m_y;             // 节点Y坐标
     qreal m_width;         // 节点宽度
     qreal m_height;        // 节点高度
-    QColor m_color;        // 节点颜色
+    QRgb m_color;          // 节点颜色
     QString m_style;       // 节点样式
     NodeShape m_shape;      // 节点形状
 };
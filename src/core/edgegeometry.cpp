@@ -0,0 +1,168 @@
+#include "edgegeometry.h"
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @brief 计算连接线（两端截在节点轮廓上）
+ * @param sourceRect 源节点矩形
+ * @param sourceShape 源节点形状
+ * @param targetRect 目标节点矩形
+ * @param targetShape 目标节点形状
+ * @return 从源节点轮廓到目标节点轮廓的线段
+ */
+QLineF EdgeGeometry::line(const QRectF& sourceRect, NodeShape sourceShape,
+                          const QRectF& targetRect, NodeShape targetShape)
+{
+    const QPointF sourceCenter = sourceRect.center();
+    const QPointF targetCenter = targetRect.center();
+    return QLineF(intersection(sourceRect, sourceCenter, targetCenter, sourceShape),
+                  intersection(targetRect, targetCenter, sourceCenter, targetShape));
+}
+
+/**
+ * @brief 计算终点处的箭头
+ * @param line 连接线
+ * @param size 箭头大小
+ * @return 箭头三角形
+ */
+QPolygonF EdgeGeometry::arrowHead(const QLineF& line, qreal size)
+{
+    // 计算箭头角度
+    const QPointF endPoint = line.p2();
+    const double angle = std::atan2(-line.dy(), line.dx());
+
+    // 计算箭头顶点
+    const QPointF arrowP1 = endPoint - QPointF(std::sin(angle + M_PI / 3) * size,
+                                               std::cos(angle + M_PI / 3) * size);
+    const QPointF arrowP2 = endPoint - QPointF(std::sin(angle + M_PI - M_PI / 3) * size,
+                                               std::cos(angle + M_PI - M_PI / 3) * size);
+
+    QPolygonF arrowPolygon;
+    arrowPolygon << endPoint << arrowP1 << arrowP2;
+    return arrowPolygon;
+}
+
+/**
+ * @brief 计算直线与节点的交点
+ * @param rect 节点边界矩形
+ * @param center 节点中心
+ * @param target 目标点
+ * @param shape 节点形状
+ * @return 交点坐标
+ */
+QPointF EdgeGeometry::intersection(const QRectF& rect, const QPointF& center, const QPointF& target, NodeShape shape)
+{
+    switch (shape) {
+    case NodeShape::Rectangle:
+        return rectangleIntersection(rect, center, target);
+    case NodeShape::Ellipse:
+        return ellipseIntersection(rect, center, target);
+    case NodeShape::RoundedRect:
+        return roundedRectIntersection(rect, center, target);
+    default:
+        return center;
+    }
+}
+
+/**
+ * @brief 计算直线与矩形的交点
+ * @param rect 矩形边界
+ * @param center 矩形中心
+ * @param target 目标点
+ * @return 交点坐标
+ */
+QPointF EdgeGeometry::rectangleIntersection(const QRectF& rect, const QPointF& center, const QPointF& target)
+{
+    // 计算从中心到目标的直线
+    QLineF line(center, target);
+
+    // 计算直线与矩形的交点
+    QPointF intersectionPoint;
+    QLineF::IntersectionType intersection = line.intersects(QLineF(rect.topLeft(), rect.topRight()), &intersectionPoint);
+    if (intersection == QLineF::BoundedIntersection) {
+        return intersectionPoint;
+    }
+
+    intersection = line.intersects(QLineF(rect.topRight(), rect.bottomRight()), &intersectionPoint);
+    if (intersection == QLineF::BoundedIntersection) {
+        return intersectionPoint;
+    }
+
+    intersection = line.intersects(QLineF(rect.bottomRight(), rect.bottomLeft()), &intersectionPoint);
+    if (intersection == QLineF::BoundedIntersection) {
+        return intersectionPoint;
+    }
+
+    intersection = line.intersects(QLineF(rect.bottomLeft(), rect.topLeft()), &intersectionPoint);
+    if (intersection == QLineF::BoundedIntersection) {
+        return intersectionPoint;
+    }
+
+    // 如果没有交点，返回中心点
+    return center;
+}
+
+/**
+ * @brief 计算直线与椭圆的交点
+ * @param rect 椭圆的外切矩形
+ * @param center 椭圆中心
+ * @param target 目标点
+ * @return 交点坐标
+ */
+QPointF EdgeGeometry::ellipseIntersection(const QRectF& rect, const QPointF& center, const QPointF& target)
+{
+    // 计算椭圆的半长轴和半短轴
+    qreal a = rect.width() / 2.0;
+    qreal b = rect.height() / 2.0;
+
+    // 如果椭圆退化为直线或点，返回中心
+    if (a <= 0 || b <= 0) {
+        return center;
+    }
+
+    // 计算直线方向向量
+    qreal dx = target.x() - center.x();
+    qreal dy = target.y() - center.y();
+
+    // 如果目标点与中心重合，返回中心
+    if (dx == 0 && dy == 0) {
+        return center;
+    }
+
+    // 计算直线参数方程：x = center.x() + t*dx, y = center.y() + t*dy
+    // 椭圆方程：(x-center.x())²/a² + (y-center.y())²/b² = 1
+    // 代入得：(t*dx)²/a² + (t*dy)²/b² = 1
+    // 整理得：t²*(dx²/a² + dy²/b²) = 1
+    // 解得：t = 1/sqrt(dx²/a² + dy²/b²)
+    qreal t = 1.0 / sqrt((dx*dx)/(a*a) + (dy*dy)/(b*b));
+
+    // 计算交点坐标
+    return QPointF(center.x() + t*dx, center.y() + t*dy);
+}
+
+/**
+ * @brief 计算直线与圆角矩形的交点
+ * @param rect 圆角矩形的外切矩形
+ * @param center 圆角矩形中心
+ * @param target 目标点
+ * @return 交点坐标
+ */
+QPointF EdgeGeometry::roundedRectIntersection(const QRectF& rect, const QPointF& center, const QPointF& target)
+{
+    // 圆角矩形的圆角半径（使用矩形宽度和高度的较小值的1/4）
+    qreal radius = qMin(rect.width(), rect.height()) / 4.0;
+    
+    // 首先尝试与矩形部分相交
+    QRectF rectPart = rect.adjusted(radius, radius, -radius, -radius);
+    QPointF rectIntersection = rectangleIntersection(rectPart, center, target);
+    
+    // 如果与矩形部分相交，直接返回交点
+    if (rectPart.contains(rectIntersection)) {
+        return rectIntersection;
+    }
+    
+    // 否则，计算与圆角部分的交点
+    // 这里使用简化算法：将圆角矩形视为矩形，返回与矩形的交点
+    // 在实际应用中，可以实现更精确的圆角交点计算
+    return rectangleIntersection(rect, center, target);
+}
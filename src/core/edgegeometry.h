@@ -0,0 +1,78 @@
+#ifndef EDGEGEOMETRY_H
+#define EDGEGEOMETRY_H
+
+#include <QRectF>
+#include <QPointF>
+#include <QLineF>
+#include <QPolygonF>
+#include "conceptnode.h"
+
+/**
+ * @brief 连接线的几何计算
+ *
+ * 连接线从源节点中心指向目标节点中心，两端截在节点的轮廓上，终点处画箭头。
+ * 图形场景中的 GraphicsEdge 和离屏绘制的 MapRenderer 共用这些计算，
+ * 保证两者画出的连接线一致。
+ */
+class EdgeGeometry
+{
+public:
+    /**
+     * @brief 计算连接线（两端截在节点轮廓上）
+     * @param sourceRect 源节点矩形
+     * @param sourceShape 源节点形状
+     * @param targetRect 目标节点矩形
+     * @param targetShape 目标节点形状
+     * @return 从源节点轮廓到目标节点轮廓的线段
+     */
+    static QLineF line(const QRectF& sourceRect, NodeShape sourceShape,
+                       const QRectF& targetRect, NodeShape targetShape);
+
+    /**
+     * @brief 计算终点处的箭头
+     * @param line 连接线
+     * @param size 箭头大小
+     * @return 箭头三角形
+     */
+    static QPolygonF arrowHead(const QLineF& line, qreal size);
+
+    /**
+     * @brief 计算直线与节点的交点
+     * @param rect 节点边界矩形
+     * @param center 节点中心
+     * @param target 目标点
+     * @param shape 节点形状
+     * @return 交点坐标
+     */
+    static QPointF intersection(const QRectF& rect, const QPointF& center, const QPointF& target, NodeShape shape);
+
+private:
+    /**
+     * @brief 计算直线与矩形的交点
+     * @param rect 矩形边界
+     * @param center 矩形中心
+     * @param target 目标点
+     * @return 交点坐标
+     */
+    static QPointF rectangleIntersection(const QRectF& rect, const QPointF& center, const QPointF& target);
+
+    /**
+     * @brief 计算直线与椭圆的交点
+     * @param rect 椭圆的外切矩形
+     * @param center 椭圆中心
+     * @param target 目标点
+     * @return 交点坐标
+     */
+    static QPointF ellipseIntersection(const QRectF& rect, const QPointF& center, const QPointF& target);
+
+    /**
+     * @brief 计算直线与圆角矩形的交点
+     * @param rect 圆角矩形的外切矩形
+     * @param center 圆角矩形中心
+     * @param target 目标点
+     * @return 交点坐标
+     */
+    static QPointF roundedRectIntersection(const QRectF& rect, const QPointF& center, const QPointF& target);
+};
+
+#endif // EDGEGEOMETRY_H
@@ -0,0 +1,203 @@
+#include "idregistry.h"
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+#include <QUuid>
+
+/**
+ * @brief 句柄表数据
+ */
+class IdRegistry::Table
+{
+public:
+    QReadWriteLock lock;
+    QHash<QString, quint32> byUuid;     // UUID 到句柄的映射
+    QVector<QString> uuids;             // 句柄到 UUID 的映射（下标为句柄减一）
+};
+
+namespace {
+
+using RegistryData = IdRegistry::Table;
+
+thread_local IdRegistry::TablePointer currentData;  // 当前线程的私有表，为空时使用全局表
+
+RegistryData& registry()
+{
+    if (currentData) {
+        return *currentData;
+    }
+    static RegistryData data;
+    return data;
+}
+
+/**
+ * @brief 驻留一个 UUID（调用方需持有写锁）
+ */
+quint32 internLocked(RegistryData& data, const QString& uuid)
+{
+    auto it = data.byUuid.constFind(uuid);
+    if (it != data.byUuid.constEnd()) {
+        return it.value();
+    }
+
+    // 复制一份独立的字符串，避免引用调用方的原始缓冲区
+    QString owned(uuid.constData(), uuid.size());
+    data.uuids.append(owned);
+    quint32 id = quint32(data.uuids.size());
+    data.byUuid.insert(owned, id);
+    return id;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数 - 新建私有句柄表并在当前线程启用
+ */
+IdRegistry::Scope::Scope()
+    : Scope(TablePointer::create())
+{
+}
+
+/**
+ * @brief 构造函数 - 在当前线程启用已有的句柄表
+ * @param table 句柄表，为空时使用全局表
+ */
+IdRegistry::Scope::Scope(const TablePointer& table)
+    : m_previous(currentData)
+{
+    currentData = table;
+}
+
+/**
+ * @brief 析构函数，恢复进入作用域前的句柄表
+ */
+IdRegistry::Scope::~Scope()
+{
+    currentData = m_previous;
+}
+
+/**
+ * @brief 获取当前线程使用的句柄表
+ * @return 私有句柄表，使用全局表时返回空指针
+ */
+IdRegistry::TablePointer IdRegistry::currentTable()
+{
+    return currentData;
+}
+
+/**
+ * @brief 分配一个新的句柄
+ * @return 新句柄
+ */
+quint32 IdRegistry::create()
+{
+    RegistryData& data = registry();
+    QWriteLocker locker(&data.lock);
+    data.uuids.append(QString());
+    return quint32(data.uuids.size());
+}
+
+/**
+ * @brief 把 UUID 字符串驻留为句柄
+ * @param uuid UUID 字符串
+ * @return 对应的句柄，空字符串返回 InvalidId
+ */
+quint32 IdRegistry::fromUuid(const QString& uuid)
+{
+    if (uuid.isEmpty()) {
+        return InvalidId;
+    }
+
+    RegistryData& data = registry();
+    {
+        QReadLocker locker(&data.lock);
+        quint32 id = data.byUuid.value(uuid, InvalidId);
+        if (id != InvalidId) {
+            return id;
+        }
+    }
+
+    QWriteLocker locker(&data.lock);
+    return internLocked(data, uuid);
+}
+
+/**
+ * @brief 批量把 UUID 字符串驻留为句柄
+ * @param uuids UUID 字符串列表
+ * @return 对应的句柄列表，空字符串对应 InvalidId
+ */
+QVector<quint32> IdRegistry::fromUuids(const QVector<QString>& uuids)
+{
+    QVector<quint32> ids(uuids.size(), InvalidId);
+    RegistryData& data = registry();
+    bool missing = false;
+
+    // 先在读锁下查找已驻留的 UUID
+    {
+        QReadLocker locker(&data.lock);
+        for (int i = 0; i < uuids.size(); ++i) {
+            if (uuids[i].isEmpty()) {
+                continue;
+            }
+            ids[i] = data.byUuid.value(uuids[i], InvalidId);
+            missing = missing || ids[i] == InvalidId;
+        }
+    }
+    if (!missing) {
+        return ids;
+    }
+
+    // 剩下的在一次写锁内驻留
+    QWriteLocker locker(&data.lock);
+    for (int i = 0; i < uuids.size(); ++i) {
+        if (ids[i] == InvalidId && !uuids[i].isEmpty()) {
+            ids[i] = internLocked(data, uuids[i]);
+        }
+    }
+    return ids;
+}
+
+/**
+ * @brief 查找已驻留的 UUID 字符串
+ * @param uuid UUID 字符串
+ * @return 对应的句柄，未驻留时返回 InvalidId
+ */
+quint32 IdRegistry::find(const QString& uuid)
+{
+    RegistryData& data = registry();
+    QReadLocker locker(&data.lock);
+    return data.byUuid.value(uuid, InvalidId);
+}
+
+/**
+ * @brief 获取句柄对应的 UUID 字符串
+ * @param id 句柄
+ * @return UUID 字符串，句柄还没有 UUID 时会先生成一个
+ */
+QString IdRegistry::toUuid(quint32 id)
+{
+    if (id == InvalidId) {
+        return QString();
+    }
+
+    RegistryData& data = registry();
+    {
+        QReadLocker locker(&data.lock);
+        if (id > quint32(data.uuids.size())) {
+            return QString();
+        }
+        const QString& uuid = data.uuids.at(int(id - 1));
+        if (!uuid.isEmpty()) {
+            return uuid;
+        }
+    }
+
+    // 新建的元素第一次需要 UUID 时才生成
+    QWriteLocker locker(&data.lock);
+    QString& uuid = data.uuids[int(id - 1)];
+    if (uuid.isEmpty()) {
+        uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        data.byUuid.insert(uuid, id);
+    }
+    return uuid;
+}
@@ -0,0 +1,116 @@
+#ifndef IDREGISTRY_H
+#define IDREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include <QtGlobal>
+
+/**
+ * @brief 节点和连接线的紧凑标识符
+ *
+ * 核心模块内部使用 32 位整数句柄标识元素，比较和哈希都只是整数运算。
+ * UUID 字符串只在序列化边界（文件读写）上出现，由 IdRegistry 负责转换。
+ */
+using NodeId = quint32;
+using EdgeId = quint32;
+
+/**
+ * @brief 无效标识符
+ */
+constexpr quint32 InvalidId = 0;
+
+/**
+ * @brief 标识符注册表
+ *
+ * 进程内全局唯一，负责分配整数句柄并在句柄与 UUID 字符串之间转换：
+ * - 新建的元素只分配句柄，UUID 在第一次保存时才生成
+ * - 加载文件时同一个 UUID 总是得到同一个句柄
+ *
+ * 所有方法都是线程安全的。全局句柄表只增不减，句柄在进程生命周期内不会被复用，
+ * 供编辑器使用（撤销栈、界面都按句柄引用元素）。
+ *
+ * 只读一下文件就丢弃的场合（命令行转换、缩略图）用 Scope 换成私有的句柄表：
+ * 作用域内当前线程的所有调用都使用私有表，作用域结束后连同其中驻留的 UUID 一起释放，
+ * 不会让全局表无限增长。私有表的句柄不能带出作用域。加载和保存内部的工作线程
+ * 用 currentTable() 取得调用线程的表，在线程内用 Scope(table) 继续使用同一张表。
+ */
+class IdRegistry
+{
+public:
+    class Table;
+    using TablePointer = QSharedPointer<Table>;
+
+    /**
+     * @brief 句柄表作用域（RAII），在当前线程中替换使用的句柄表
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief 构造函数 - 新建私有句柄表并在当前线程启用
+         */
+        Scope();
+
+        /**
+         * @brief 构造函数 - 在当前线程启用已有的句柄表
+         * @param table 句柄表，为空时使用全局表
+         */
+        explicit Scope(const TablePointer& table);
+
+        /**
+         * @brief 析构函数，恢复进入作用域前的句柄表
+         */
+        ~Scope();
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        TablePointer m_previous;    // 进入作用域前的句柄表
+    };
+
+    /**
+     * @brief 获取当前线程使用的句柄表
+     * @return 私有句柄表，使用全局表时返回空指针
+     */
+    static TablePointer currentTable();
+
+    /**
+     * @brief 分配一个新的句柄
+     * @return 新句柄
+     */
+    static quint32 create();
+
+    /**
+     * @brief 把 UUID 字符串驻留为句柄
+     * @param uuid UUID 字符串
+     * @return 对应的句柄，空字符串返回 InvalidId
+     */
+    static quint32 fromUuid(const QString& uuid);
+
+    /**
+     * @brief 批量把 UUID 字符串驻留为句柄
+     *
+     * 整批只加一次读锁和至多一次写锁，多个线程并行加载时不必为每条记录争用锁。
+     *
+     * @param uuids UUID 字符串列表
+     * @return 对应的句柄列表，空字符串对应 InvalidId
+     */
+    static QVector<quint32> fromUuids(const QVector<QString>& uuids);
+
+    /**
+     * @brief 查找已驻留的 UUID 字符串
+     * @param uuid UUID 字符串
+     * @return 对应的句柄，未驻留时返回 InvalidId
+     */
+    static quint32 find(const QString& uuid);
+
+    /**
+     * @brief 获取句柄对应的 UUID 字符串
+     * @param id 句柄
+     * @return UUID 字符串，句柄还没有 UUID 时会先生成一个
+     */
+    static QString toUuid(quint32 id);
+};
+
+#endif // IDREGISTRY_H
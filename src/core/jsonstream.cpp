@@ -0,0 +1,679 @@
+#include "jsonstream.h"
+#include <QIODevice>
+#include <QLocale>
+#include <QtMath>
+
+namespace {
+
+/**
+ * @brief 把码点按 UTF-8 编码追加到字节串
+ */
+void appendUtf8(QByteArray& out, uint code)
+{
+    if (code < 0x80) {
+        out.append(char(code));
+    } else if (code < 0x800) {
+        out.append(char(0xC0 | (code >> 6)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.append(char(0xE0 | (code >> 12)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (code >> 18)));
+        out.append(char(0x80 | ((code >> 12) & 0x3F)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+/**
+ * @brief 解析十六进制数字
+ * @return 数字的值，不是十六进制数字时返回 -1
+ */
+int hexValue(int c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ * @param device 已打开的输入设备
+ */
+JsonStreamReader::JsonStreamReader(QIODevice* device)
+    : m_device(device)
+{
+}
+
+/**
+ * @brief 构造函数 - 直接读取内存中的数据
+ * @param data JSON 文本
+ */
+JsonStreamReader::JsonStreamReader(const QByteArray& data)
+    : m_device(nullptr)
+    , m_buffer(data)
+{
+}
+
+/**
+ * @brief 读取下一个记号
+ * @return 记号类型
+ */
+JsonStreamReader::Token JsonStreamReader::readNext()
+{
+    if (hasError()) {
+        return m_token = Invalid;
+    }
+    if (m_token == EndDocument) {
+        return EndDocument;
+    }
+
+    for (;;) {
+        if (!skipWhitespace()) {
+            if (m_stack.isEmpty() && m_started) {
+                return m_token = EndDocument;
+            }
+            return fail(QStringLiteral("意外的文件结尾"));
+        }
+
+        const char c = m_buffer.at(m_pos);
+
+        // 值之后只能是逗号或结束括号
+        if (m_needSeparator) {
+            if (m_stack.isEmpty()) {
+                return fail(QStringLiteral("文档结束后有多余内容"));
+            }
+            const char container = m_stack.last();
+            if (c == ',') {
+                ++m_pos;
+                m_needSeparator = false;
+                m_afterComma = true;
+                m_expectName = (container == '{');
+                continue;
+            }
+            if ((c == '}' && container == '{') || (c == ']' && container == '[')) {
+                ++m_pos;
+                m_stack.removeLast();
+                return m_token = (c == '}') ? EndObject : EndArray;
+            }
+            return fail(QStringLiteral("缺少逗号或结束括号"));
+        }
+
+        // 对象中的键
+        if (m_expectName) {
+            if (c == '}' && !m_afterComma) {
+                ++m_pos;
+                m_stack.removeLast();
+                m_expectName = false;
+                m_needSeparator = true;
+                return m_token = EndObject;
+            }
+            if (c != '"') {
+                return fail(QStringLiteral("缺少键"));
+            }
+            ++m_pos;
+            if (!readString(m_text)) {
+                return Invalid;
+            }
+            if (!skipWhitespace() || m_buffer.at(m_pos) != ':') {
+                return fail(QStringLiteral("缺少冒号"));
+            }
+            ++m_pos;
+            m_expectName = false;
+            m_afterComma = false;
+            return m_token = Name;
+        }
+
+        // 值
+        switch (c) {
+            case '{':
+                ++m_pos;
+                m_stack.append('{');
+                m_expectName = true;
+                m_afterComma = false;
+                m_started = true;
+                return m_token = BeginObject;
+            case '[':
+                ++m_pos;
+                m_stack.append('[');
+                m_afterComma = false;
+                m_started = true;
+                return m_token = BeginArray;
+            case ']':
+                if (m_stack.isEmpty() || m_stack.last() != '[' || m_afterComma) {
+                    return fail(QStringLiteral("多余的结束括号"));
+                }
+                ++m_pos;
+                m_stack.removeLast();
+                m_needSeparator = true;
+                return m_token = EndArray;
+            case '"':
+                ++m_pos;
+                if (!readString(m_text)) {
+                    return Invalid;
+                }
+                return valueRead(String);
+            case 't':
+                if (!readLiteral("true")) {
+                    return Invalid;
+                }
+                m_bool = true;
+                return valueRead(Bool);
+            case 'f':
+                if (!readLiteral("false")) {
+                    return Invalid;
+                }
+                m_bool = false;
+                return valueRead(Bool);
+            case 'n':
+                if (!readLiteral("null")) {
+                    return Invalid;
+                }
+                return valueRead(Null);
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    if (!readNumber()) {
+                        return Invalid;
+                    }
+                    return valueRead(Number);
+                }
+                return fail(QStringLiteral("无效的字符"));
+        }
+    }
+}
+
+/**
+ * @brief 跳过当前值
+ * @return 如果成功跳过返回 true，遇到错误返回 false
+ */
+bool JsonStreamReader::skipValue()
+{
+    if (m_token == Name && readNext() == Invalid) {
+        return false;
+    }
+    if (m_token != BeginObject && m_token != BeginArray) {
+        return !hasError();
+    }
+
+    int depth = 1;
+    while (depth > 0) {
+        switch (readNext()) {
+            case BeginObject:
+            case BeginArray:
+                ++depth;
+                break;
+            case EndObject:
+            case EndArray:
+                --depth;
+                break;
+            case Invalid:
+            case EndDocument:
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 从设备读取下一块数据（仅在缓冲区读完时调用）
+ * @return 如果读到数据返回 true，到达结尾或读取失败返回 false
+ */
+bool JsonStreamReader::fill()
+{
+    if (!m_device) {
+        return false;
+    }
+
+    m_consumed += m_buffer.size();
+    m_pos = 0;
+    m_buffer.resize(ChunkSize);
+    const qint64 count = m_device->read(m_buffer.data(), ChunkSize);
+    if (count <= 0) {
+        m_buffer.resize(0);
+        if (count < 0) {
+            fail(QStringLiteral("读取失败: %1").arg(m_device->errorString()));
+        }
+        return false;
+    }
+    m_buffer.resize(int(count));
+    return true;
+}
+
+/**
+ * @brief 查看下一个字节但不读取
+ * @return 字节值，到达结尾时返回 -1
+ */
+int JsonStreamReader::peekByte()
+{
+    if (m_pos >= m_buffer.size() && !fill()) {
+        return -1;
+    }
+    return uchar(m_buffer.at(m_pos));
+}
+
+/**
+ * @brief 跳过空白字符
+ * @return 如果之后还有数据返回 true，到达结尾返回 false
+ */
+bool JsonStreamReader::skipWhitespace()
+{
+    for (;;) {
+        const int c = peekByte();
+        if (c < 0) {
+            return false;
+        }
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return true;
+        }
+        ++m_pos;
+    }
+}
+
+/**
+ * @brief 读取字符串（起始引号已读过）
+ * @param out 解码后的字符串
+ * @return 如果成功返回 true，否则返回 false
+ */
+bool JsonStreamReader::readString(QString& out)
+{
+    m_scratch.resize(0);
+
+    for (;;) {
+        if (m_pos >= m_buffer.size() && !fill()) {
+            fail(QStringLiteral("字符串未结束"));
+            return false;
+        }
+
+        // 整段复制不含转义的字节
+        const char* data = m_buffer.constData();
+        const qsizetype end = m_buffer.size();
+        qsizetype i = m_pos;
+        while (i < end) {
+            const uchar ch = uchar(data[i]);
+            if (ch == '"' || ch == '\\' || ch < 0x20) {
+                break;
+            }
+            ++i;
+        }
+        m_scratch.append(data + m_pos, i - m_pos);
+        m_pos = i;
+        if (i == end) {
+            continue;
+        }
+
+        const uchar ch = uchar(data[m_pos++]);
+        if (ch == '"') {
+            out = QString::fromUtf8(m_scratch);
+            return true;
+        }
+        if (ch < 0x20) {
+            fail(QStringLiteral("字符串中有未转义的控制字符"));
+            return false;
+        }
+
+        // 转义序列
+        const int escape = peekByte();
+        ++m_pos;
+        switch (escape) {
+            case '"':  m_scratch.append('"'); break;
+            case '\\': m_scratch.append('\\'); break;
+            case '/':  m_scratch.append('/'); break;
+            case 'b':  m_scratch.append('\b'); break;
+            case 'f':  m_scratch.append('\f'); break;
+            case 'n':  m_scratch.append('\n'); break;
+            case 'r':  m_scratch.append('\r'); break;
+            case 't':  m_scratch.append('\t'); break;
+            case 'u': {
+                uint code = 0;
+                for (int n = 0; n < 4; ++n) {
+                    const int digit = hexValue(peekByte());
+                    if (digit < 0) {
+                        fail(QStringLiteral("无效的 \\u 转义"));
+                        return false;
+                    }
+                    ++m_pos;
+                    code = (code << 4) | uint(digit);
+                }
+
+                // 代理对：高位代理之后应紧跟 \uDC00-\uDFFF
+                if (code >= 0xD800 && code <= 0xDBFF && peekByte() == '\\') {
+                    ++m_pos;
+                    uint low = 0;
+                    if (peekByte() == 'u') {
+                        ++m_pos;
+                        for (int n = 0; n < 4; ++n) {
+                            const int digit = hexValue(peekByte());
+                            if (digit < 0) {
+                                fail(QStringLiteral("无效的 \\u 转义"));
+                                return false;
+                            }
+                            ++m_pos;
+                            low = (low << 4) | uint(digit);
+                        }
+                    }
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        fail(QStringLiteral("不成对的 UTF-16 代理"));
+                        return false;
+                    }
+                } else if (code >= 0xD800 && code <= 0xDFFF) {
+                    code = 0xFFFD;
+                }
+                appendUtf8(m_scratch, code);
+                break;
+            }
+            default:
+                fail(QStringLiteral("无效的转义字符"));
+                return false;
+        }
+    }
+}
+
+/**
+ * @brief 读取数值
+ * @return 如果成功返回 true，否则返回 false
+ */
+bool JsonStreamReader::readNumber()
+{
+    m_scratch.resize(0);
+    for (;;) {
+        const int c = peekByte();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            m_scratch.append(char(c));
+            ++m_pos;
+        } else {
+            break;
+        }
+    }
+
+    bool ok = false;
+    m_number = m_scratch.toDouble(&ok);
+    if (!ok) {
+        fail(QStringLiteral("无效的数值"));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取字面量 true、false 或 null
+ * @param literal 期望的字面量
+ * @return 如果匹配返回 true，否则返回 false
+ */
+bool JsonStreamReader::readLiteral(const char* literal)
+{
+    for (const char* p = literal; *p; ++p) {
+        if (peekByte() != uchar(*p)) {
+            fail(QStringLiteral("无效的字面量"));
+            return false;
+        }
+        ++m_pos;
+    }
+    return true;
+}
+
+/**
+ * @brief 记录错误（只保留第一个错误）
+ * @param message 错误信息
+ * @return Invalid
+ */
+JsonStreamReader::Token JsonStreamReader::fail(const QString& message)
+{
+    if (m_error.isEmpty()) {
+        m_error = QStringLiteral("%1（偏移 %2）").arg(message).arg(m_consumed + m_pos);
+    }
+    return m_token = Invalid;
+}
+
+/**
+ * @brief 读完一个标量值后更新状态
+ * @param token 值的记号类型
+ * @return 记号类型
+ */
+JsonStreamReader::Token JsonStreamReader::valueRead(Token token)
+{
+    m_afterComma = false;
+    m_needSeparator = true;
+    m_started = true;
+    return m_token = token;
+}
+
+/**
+ * @brief 构造函数
+ * @param device 已打开的输出设备
+ */
+JsonStreamWriter::JsonStreamWriter(QIODevice* device)
+    : m_device(device)
+{
+    m_buffer.reserve(FlushThreshold + 4096);
+}
+
+/**
+ * @brief 析构函数，写出缓冲区中剩余的数据
+ */
+JsonStreamWriter::~JsonStreamWriter()
+{
+    flush();
+}
+
+/**
+ * @brief 开始一个对象
+ */
+void JsonStreamWriter::writeStartObject()
+{
+    beginValue();
+    m_buffer.append('{');
+    m_hasItems.append(false);
+}
+
+/**
+ * @brief 结束当前对象
+ */
+void JsonStreamWriter::writeEndObject()
+{
+    const bool hadItems = m_hasItems.takeLast();
+    if (hadItems) {
+        newline();
+    }
+    m_buffer.append('}');
+    if (m_hasItems.isEmpty()) {
+        m_buffer.append('\n');
+    }
+    maybeFlush();
+}
+
+/**
+ * @brief 开始一个数组
+ */
+void JsonStreamWriter::writeStartArray()
+{
+    beginValue();
+    m_buffer.append('[');
+    m_hasItems.append(false);
+}
+
+/**
+ * @brief 结束当前数组
+ */
+void JsonStreamWriter::writeEndArray()
+{
+    const bool hadItems = m_hasItems.takeLast();
+    if (hadItems) {
+        newline();
+    }
+    m_buffer.append(']');
+    if (m_hasItems.isEmpty()) {
+        m_buffer.append('\n');
+    }
+    maybeFlush();
+}
+
+/**
+ * @brief 写入对象的键
+ * @param name 键
+ */
+void JsonStreamWriter::writeName(const QString& name)
+{
+    beginValue();
+    appendEscaped(name);
+    m_buffer.append(": ", 2);
+    m_afterName = true;
+}
+
+/**
+ * @brief 写入字符串值
+ * @param value 字符串
+ */
+void JsonStreamWriter::writeString(const QString& value)
+{
+    beginValue();
+    appendEscaped(value);
+    maybeFlush();
+}
+
+/**
+ * @brief 写入数值（NaN 和无穷大写为 null）
+ * @param value 数值
+ */
+void JsonStreamWriter::writeNumber(double value)
+{
+    beginValue();
+    if (qIsFinite(value)) {
+        m_buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    } else {
+        m_buffer.append("null", 4);
+    }
+}
+
+/**
+ * @brief 写入布尔值
+ * @param value 布尔值
+ */
+void JsonStreamWriter::writeBool(bool value)
+{
+    beginValue();
+    if (value) {
+        m_buffer.append("true", 4);
+    } else {
+        m_buffer.append("false", 5);
+    }
+}
+
+/**
+ * @brief 写入 null
+ */
+void JsonStreamWriter::writeNull()
+{
+    beginValue();
+    m_buffer.append("null", 4);
+}
+
+/**
+ * @brief 把缓冲区写入设备
+ * @return 如果全部写入成功返回 true，否则返回 false
+ */
+bool JsonStreamWriter::flush()
+{
+    if (m_error) {
+        return false;
+    }
+    if (!m_buffer.isEmpty()) {
+        if (m_device->write(m_buffer) != m_buffer.size()) {
+            m_error = true;
+        }
+        m_buffer.resize(0);
+    }
+    return !m_error;
+}
+
+/**
+ * @brief 在值之前写入逗号、换行和缩进
+ */
+void JsonStreamWriter::beginValue()
+{
+    if (m_afterName) {
+        m_afterName = false;
+        return;
+    }
+    if (m_hasItems.isEmpty()) {
+        return;
+    }
+    if (m_hasItems.last()) {
+        m_buffer.append(',');
+    }
+    m_hasItems.last() = true;
+    newline();
+}
+
+/**
+ * @brief 写入换行和当前层级的缩进
+ */
+void JsonStreamWriter::newline()
+{
+    m_buffer.append('\n');
+    m_buffer.append(QByteArray(m_hasItems.size() * 4, ' '));
+}
+
+/**
+ * @brief 写入带引号并转义的字符串
+ * @param value 字符串
+ */
+void JsonStreamWriter::appendEscaped(const QString& value)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    const QByteArray utf8 = value.toUtf8();
+    const char* data = utf8.constData();
+    const int size = utf8.size();
+
+    m_buffer.append('"');
+    int start = 0;
+    for (int i = 0; i < size; ++i) {
+        const uchar ch = uchar(data[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+        m_buffer.append(data + start, i - start);
+        start = i + 1;
+        switch (ch) {
+            case '"':  m_buffer.append("\\\"", 2); break;
+            case '\\': m_buffer.append("\\\\", 2); break;
+            case '\b': m_buffer.append("\\b", 2); break;
+            case '\f': m_buffer.append("\\f", 2); break;
+            case '\n': m_buffer.append("\\n", 2); break;
+            case '\r': m_buffer.append("\\r", 2); break;
+            case '\t': m_buffer.append("\\t", 2); break;
+            default:
+                m_buffer.append("\\u00", 4);
+                m_buffer.append(hexDigits[ch >> 4]);
+                m_buffer.append(hexDigits[ch & 0xF]);
+                break;
+        }
+    }
+    m_buffer.append(data + start, size - start);
+    m_buffer.append('"');
+}
+
+/**
+ * @brief 缓冲区超过阈值时写出
+ */
+void JsonStreamWriter::maybeFlush()
+{
+    if (m_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
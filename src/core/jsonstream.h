@@ -0,0 +1,226 @@
+#ifndef JSONSTREAM_H
+#define JSONSTREAM_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class QIODevice;
+
+/**
+ * @brief 拉取式 JSON 读取器
+ *
+ * 按固定大小的块从设备读取数据，每次 readNext() 返回一个记号，调用者按需取值，
+ * 不在内存中建立完整的文档树。内存占用只与读缓冲区大小和单个字符串的长度有关，
+ * 与文件大小无关。
+ *
+ * 读取器会校验语法（括号匹配、逗号和冒号位置、字面量），遇到错误后 readNext()
+ * 始终返回 Invalid，错误信息通过 errorString() 获取。
+ */
+class JsonStreamReader
+{
+public:
+    /**
+     * @brief 记号类型
+     */
+    enum Token {
+        Invalid,        // 语法错误或读取失败
+        BeginObject,    // {
+        EndObject,      // }
+        BeginArray,     // [
+        EndArray,       // ]
+        Name,           // 对象的键
+        String,         // 字符串值
+        Number,         // 数值
+        Bool,           // true / false
+        Null,           // null
+        EndDocument     // 文档结束
+    };
+
+    /**
+     * @brief 构造函数
+     * @param device 已打开的输入设备
+     */
+    explicit JsonStreamReader(QIODevice* device);
+
+    /**
+     * @brief 构造函数 - 直接读取内存中的数据
+     *
+     * 不复制数据（调用方可以传入 QByteArray::fromRawData 包装的映射内存），
+     * 数据必须在读取器销毁之前保持有效。
+     *
+     * @param data JSON 文本
+     */
+    explicit JsonStreamReader(const QByteArray& data);
+
+    /**
+     * @brief 读取下一个记号
+     * @return 记号类型
+     */
+    Token readNext();
+
+    /**
+     * @brief 获取当前记号类型
+     * @return 记号类型
+     */
+    Token tokenType() const { return m_token; }
+
+    /**
+     * @brief 获取当前键或字符串值（Name、String 记号有效）
+     * @return 字符串
+     */
+    const QString& text() const { return m_text; }
+
+    /**
+     * @brief 获取当前数值（Number 记号有效）
+     * @return 数值
+     */
+    double number() const { return m_number; }
+
+    /**
+     * @brief 获取当前布尔值（Bool 记号有效）
+     * @return 布尔值
+     */
+    bool boolean() const { return m_bool; }
+
+    /**
+     * @brief 获取已读取的字节数（当前记号之后的位置）
+     * @return 字节偏移
+     */
+    qint64 offset() const { return m_consumed + m_pos; }
+
+    /**
+     * @brief 跳过当前值
+     *
+     * 当前记号为 BeginObject/BeginArray 时一直读到匹配的结束记号，
+     * 为 Name 时跳过其后的整个值，其它记号不做任何事。
+     *
+     * @return 如果成功跳过返回 true，遇到错误返回 false
+     */
+    bool skipValue();
+
+    /**
+     * @brief 检查是否发生错误
+     * @return 如果发生错误返回 true，否则返回 false
+     */
+    bool hasError() const { return !m_error.isEmpty(); }
+
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息（包含出错位置的字节偏移）
+     */
+    QString errorString() const { return m_error; }
+
+private:
+    static constexpr int ChunkSize = 64 * 1024;    // 每次从设备读取的字节数
+
+    bool fill();
+    int peekByte();
+    bool skipWhitespace();
+    bool readString(QString& out);
+    bool readNumber();
+    bool readLiteral(const char* literal);
+    Token fail(const QString& message);
+    Token valueRead(Token token);
+
+    QIODevice* m_device;            // 为空时只读取 m_buffer 中的数据
+    QByteArray m_buffer;            // 读缓冲区
+    qsizetype m_pos = 0;            // 缓冲区中的读取位置
+    qint64 m_consumed = 0;          // 已从缓冲区丢弃的字节数
+    QVector<char> m_stack;          // 嵌套的容器，'{' 或 '['
+    QByteArray m_scratch;           // 字符串和数值的临时字节
+    bool m_expectName = false;      // 对象中下一个记号应为键
+    bool m_needSeparator = false;   // 下一个字符应为逗号或结束括号
+    bool m_afterComma = false;      // 刚读过逗号，不允许紧跟结束括号
+    bool m_started = false;         // 已读过顶层值
+
+    Token m_token = Invalid;
+    QString m_text;
+    double m_number = 0.0;
+    bool m_bool = false;
+    QString m_error;
+};
+
+/**
+ * @brief 流式 JSON 写入器
+ *
+ * 把记号直接格式化到写缓冲区，缓冲区满时整块写入设备，不构建文档树，
+ * 也没有先生成完整字节串再写出的第二份拷贝。输出与 QJsonDocument::Indented
+ * 的格式一致（4 个空格缩进，键值之间一个空格）。
+ */
+class JsonStreamWriter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param device 已打开的输出设备
+     */
+    explicit JsonStreamWriter(QIODevice* device);
+
+    /**
+     * @brief 析构函数，写出缓冲区中剩余的数据
+     */
+    ~JsonStreamWriter();
+
+    void writeStartObject();
+    void writeEndObject();
+    void writeStartArray();
+    void writeEndArray();
+
+    /**
+     * @brief 写入对象的键
+     * @param name 键
+     */
+    void writeName(const QString& name);
+
+    /**
+     * @brief 写入字符串值
+     * @param value 字符串
+     */
+    void writeString(const QString& value);
+
+    /**
+     * @brief 写入数值（NaN 和无穷大写为 null）
+     * @param value 数值
+     */
+    void writeNumber(double value);
+
+    /**
+     * @brief 写入布尔值
+     * @param value 布尔值
+     */
+    void writeBool(bool value);
+
+    /**
+     * @brief 写入 null
+     */
+    void writeNull();
+
+    /**
+     * @brief 把缓冲区写入设备
+     * @return 如果全部写入成功返回 true，否则返回 false
+     */
+    bool flush();
+
+    /**
+     * @brief 检查是否发生写入错误
+     * @return 如果发生错误返回 true，否则返回 false
+     */
+    bool hasError() const { return m_error; }
+
+private:
+    static constexpr int FlushThreshold = 64 * 1024;   // 缓冲区达到该大小时写出
+
+    void beginValue();
+    void newline();
+    void appendEscaped(const QString& value);
+    void maybeFlush();
+
+    QIODevice* m_device;
+    QByteArray m_buffer;            // 写缓冲区
+    QVector<bool> m_hasItems;       // 每层容器是否已写入元素
+    bool m_afterName = false;       // 刚写过键，值紧跟在冒号之后
+    bool m_error = false;
+};
+
+#endif // JSONSTREAM_H
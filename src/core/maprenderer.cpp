@@ -0,0 +1,231 @@
+#include "maprenderer.h"
+#include "conceptmap.h"
+#include "edgegeometry.h"
+#include <QPainter>
+#include <QLinearGradient>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QtMath>
+
+namespace {
+
+// 与 GraphicsNode / GraphicsEdge 的外观一致
+constexpr qreal CornerRadius = 8.0;
+constexpr qreal BorderWidth = 2.0;
+constexpr qreal LineWidth = 2.0;
+constexpr qreal ArrowSize = 10.0;
+const QColor BorderColor(80, 80, 80);
+const QColor LabelBackground(255, 255, 255, 200);
+
+/**
+ * @brief 节点文本的字体
+ */
+QFont nodeFont()
+{
+    return QFont(QStringLiteral("Arial"), 10);
+}
+
+/**
+ * @brief 连接线标签的字体
+ */
+QFont labelFont()
+{
+    return QFont(QStringLiteral("Arial"), 9);
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数，使用与图形场景相同的背景色
+ */
+MapRenderer::MapRenderer()
+    : m_background(240, 240, 240)
+    , m_margin(DefaultMargin)
+    , m_textVisible(true)
+{
+}
+
+/**
+ * @brief 把整个概念图缩小绘制到不超过指定大小的图片上（不放大）
+ * @param map 概念图对象
+ * @param maxSize 图片的最大尺寸（像素）
+ * @return 保持宽高比的图片，空概念图返回填充背景色的 maxSize 图片
+ */
+QImage MapRenderer::render(const ConceptMap& map, const QSize& maxSize) const
+{
+    const QRectF source = map.nodesBoundingRect().adjusted(-m_margin, -m_margin, m_margin, m_margin);
+    if (map.nodeCount() == 0 || source.isEmpty() || maxSize.isEmpty()) {
+        QImage image(maxSize.expandedTo(QSize(1, 1)), QImage::Format_ARGB32_Premultiplied);
+        image.fill(m_background);
+        return image;
+    }
+
+    const qreal scale = qMin(1.0, qMin(maxSize.width() / source.width(), maxSize.height() / source.height()));
+    const QSize size = (source.size() * scale).toSize().expandedTo(QSize(1, 1));
+    return render(map, source, size);
+}
+
+/**
+ * @brief 按指定比例绘制整个概念图
+ * @param map 概念图对象
+ * @param scale 缩放比例，图片超过 MaxImageSide 时自动缩小
+ * @return 图片，空概念图返回空图片
+ */
+QImage MapRenderer::render(const ConceptMap& map, qreal scale) const
+{
+    const QRectF source = map.nodesBoundingRect().adjusted(-m_margin, -m_margin, m_margin, m_margin);
+    if (map.nodeCount() == 0 || source.isEmpty() || !(scale > 0.0)) {
+        return QImage();
+    }
+
+    const qreal longest = qMax(source.width(), source.height()) * scale;
+    if (longest > MaxImageSide) {
+        scale *= MaxImageSide / longest;
+    }
+    const QSize size = (source.size() * scale).toSize().expandedTo(QSize(1, 1));
+    return render(map, source, size);
+}
+
+/**
+ * @brief 把概念图的一个区域绘制到图片上
+ * @param map 概念图对象
+ * @param source 区域（场景坐标）
+ * @param size 图片尺寸（像素）
+ * @return 图片
+ */
+QImage MapRenderer::render(const ConceptMap& map, const QRectF& source, const QSize& size) const
+{
+    if (source.isEmpty() || size.isEmpty()) {
+        return QImage();
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(m_background);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.scale(size.width() / source.width(), size.height() / source.height());
+    painter.translate(-source.topLeft());
+    paint(painter, map, source);
+    painter.end();
+    return image;
+}
+
+/**
+ * @brief 用调用方设置好变换的绘制器绘制与区域相交的节点和连接线
+ * @param painter 绘制器（场景坐标）
+ * @param map 概念图对象
+ * @param source 需要绘制的区域（场景坐标）
+ */
+void MapRenderer::paint(QPainter& painter, const ConceptMap& map, const QRectF& source) const
+{
+    // 文字缩放后太小时跳过排版；缩小时线宽也随之变细，避免缩略图被线条糊满
+    const qreal scale = qSqrt(qAbs(painter.worldTransform().determinant()));
+    const bool drawText = m_textVisible
+        && QFontMetricsF(nodeFont(), painter.device()).height() * scale >= MinTextPixelSize;
+    const qreal penWidth = scale < 1.0 ? 1.0 : LineWidth;
+
+    // 先画连接线，节点盖在连接线两端之上
+    const qreal padding = ArrowSize + LineWidth;
+    for (const ConceptEdge& edge : map.allEdges()) {
+        const ConceptNode* sourceNode = map.nodeById(edge.sourceNodeId());
+        const ConceptNode* targetNode = map.nodeById(edge.targetNodeId());
+        if (!sourceNode || !targetNode) {
+            continue;
+        }
+        const QLineF line = EdgeGeometry::line(QRectF(sourceNode->pos(), sourceNode->size()), sourceNode->shape(),
+                                               QRectF(targetNode->pos(), targetNode->size()), targetNode->shape());
+        const QRectF bounds = QRectF(line.p1(), line.p2()).normalized().adjusted(-padding, -padding, padding, padding);
+        if (bounds.intersects(source)) {
+            drawEdge(painter, edge, line, penWidth, drawText);
+        }
+    }
+
+    for (const ConceptNode& node : map.allNodes()) {
+        if (QRectF(node.pos(), node.size()).intersects(source)) {
+            drawNode(painter, node, drawText);
+        }
+    }
+}
+
+/**
+ * @brief 绘制一个节点
+ * @param painter 绘制器
+ * @param node 节点
+ * @param drawText 是否绘制文本
+ */
+void MapRenderer::drawNode(QPainter& painter, const ConceptNode& node, bool drawText) const
+{
+    const QRectF rect(node.pos(), node.size());
+
+    // 渐变背景
+    const QColor color = node.color();
+    QLinearGradient gradient(rect.topLeft(), rect.bottomRight());
+    gradient.setColorAt(0.0, color.lighter(120));
+    gradient.setColorAt(1.0, color);
+    painter.setBrush(QBrush(gradient));
+    painter.setPen(Qt::NoPen);
+    switch (node.shape()) {
+        case NodeShape::Rectangle:
+            painter.drawRect(rect);
+            break;
+        case NodeShape::Ellipse:
+            painter.drawEllipse(rect);
+            break;
+        case NodeShape::RoundedRect:
+            painter.drawRoundedRect(rect, CornerRadius, CornerRadius);
+            break;
+    }
+
+    // 边框
+    QPen pen(BorderColor, BorderWidth);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRoundedRect(rect, CornerRadius, CornerRadius);
+
+    // 文本
+    if (drawText) {
+        painter.setFont(nodeFont());
+        painter.setPen(color.lightness() < 128 ? Qt::white : Qt::black);
+        painter.drawText(rect, Qt::AlignCenter, node.text());
+    }
+}
+
+/**
+ * @brief 绘制一条连接线
+ * @param painter 绘制器
+ * @param edge 连接线
+ * @param line 连接线两端（截在节点轮廓上）
+ * @param penWidth 线宽（像素）
+ * @param drawText 是否绘制标签
+ */
+void MapRenderer::drawEdge(QPainter& painter, const ConceptEdge& edge, const QLineF& line, qreal penWidth, bool drawText) const
+{
+    const QColor color = edge.color();
+    QPen pen(color, penWidth);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawLine(line);
+
+    // 箭头
+    painter.setBrush(QBrush(color));
+    painter.drawPolygon(EdgeGeometry::arrowHead(line, ArrowSize));
+
+    // 标签（连接线中点）
+    if (drawText && !edge.label().isEmpty()) {
+        const QFont font = labelFont();
+        QRectF labelRect = QFontMetricsF(font, painter.device()).boundingRect(edge.label());
+        labelRect.moveCenter(line.center());
+
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(LabelBackground);
+        painter.drawRoundedRect(labelRect.adjusted(-3, -3, 3, 3), 3, 3);
+
+        painter.setFont(font);
+        painter.setPen(Qt::black);
+        painter.drawText(labelRect, Qt::AlignCenter, edge.label());
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef MAPRENDERER_H
+#define MAPRENDERER_H
+
+#include <QImage>
+#include <QColor>
+#include <QSize>
+#include <QRectF>
+
+class QPainter;
+class ConceptMap;
+class ConceptNode;
+class ConceptEdge;
+
+/**
+ * @brief 概念图的离屏绘制
+ *
+ * 直接用 QPainter 把 ConceptMap 画到 QImage 上，不需要 QGraphicsScene 或任何窗口部件，
+ * 外观与图形场景一致（节点渐变填充、边框和文字，连接线、箭头和标签），
+ * 不绘制选中和悬停效果。
+ *
+ * 绘制只读取概念图，可以在工作线程中调用；绘制文字需要 QGuiApplication，
+ * 没有显示器的环境可以使用 offscreen 平台插件（QT_QPA_PLATFORM=offscreen）。
+ * 缩放后文字小到无法辨认时不再绘制文字，缩略图因此不必为排版付出代价。
+ */
+class MapRenderer
+{
+public:
+    static constexpr qreal DefaultMargin = 20.0;     // 默认边距（场景坐标）
+    static constexpr int MaxImageSide = 16384;        // 图片的最大边长（像素）
+    static constexpr qreal MinTextPixelSize = 4.0;    // 文字缩放后低于该像素高度时不绘制
+
+    /**
+     * @brief 构造函数，使用与图形场景相同的背景色
+     */
+    MapRenderer();
+
+    /**
+     * @brief 设置背景色
+     * @param color 背景色，透明色表示透明背景
+     */
+    void setBackground(const QColor& color) { m_background = color; }
+
+    /**
+     * @brief 获取背景色
+     * @return 背景色
+     */
+    QColor background() const { return m_background; }
+
+    /**
+     * @brief 设置节点范围四周的边距
+     * @param margin 边距（场景坐标）
+     */
+    void setMargin(qreal margin) { m_margin = margin; }
+
+    /**
+     * @brief 获取边距
+     * @return 边距（场景坐标）
+     */
+    qreal margin() const { return m_margin; }
+
+    /**
+     * @brief 设置是否绘制文字（节点文本和连接线标签）
+     * @param visible 是否绘制
+     */
+    void setTextVisible(bool visible) { m_textVisible = visible; }
+
+    /**
+     * @brief 检查是否绘制文字
+     * @return 如果绘制返回 true，否则返回 false
+     */
+    bool isTextVisible() const { return m_textVisible; }
+
+    /**
+     * @brief 把整个概念图缩小绘制到不超过指定大小的图片上（不放大）
+     * @param map 概念图对象
+     * @param maxSize 图片的最大尺寸（像素）
+     * @return 保持宽高比的图片，空概念图返回填充背景色的 maxSize 图片
+     */
+    QImage render(const ConceptMap& map, const QSize& maxSize) const;
+
+    /**
+     * @brief 按指定比例绘制整个概念图
+     * @param map 概念图对象
+     * @param scale 缩放比例，图片超过 MaxImageSide 时自动缩小
+     * @return 图片，空概念图返回空图片
+     */
+    QImage render(const ConceptMap& map, qreal scale) const;
+
+    /**
+     * @brief 把概念图的一个区域绘制到图片上
+     * @param map 概念图对象
+     * @param source 区域（场景坐标）
+     * @param size 图片尺寸（像素）
+     * @return 图片
+     */
+    QImage render(const ConceptMap& map, const QRectF& source, const QSize& size) const;
+
+    /**
+     * @brief 用调用方设置好变换的绘制器绘制与区域相交的节点和连接线
+     * @param painter 绘制器（场景坐标）
+     * @param map 概念图对象
+     * @param source 需要绘制的区域（场景坐标）
+     */
+    void paint(QPainter& painter, const ConceptMap& map, const QRectF& source) const;
+
+private:
+    /**
+     * @brief 绘制一个节点
+     * @param painter 绘制器
+     * @param node 节点
+     * @param drawText 是否绘制文本
+     */
+    void drawNode(QPainter& painter, const ConceptNode& node, bool drawText) const;
+
+    /**
+     * @brief 绘制一条连接线
+     * @param painter 绘制器
+     * @param edge 连接线
+     * @param line 连接线两端（截在节点轮廓上）
+     * @param penWidth 线宽（像素）
+     * @param drawText 是否绘制标签
+     */
+    void drawEdge(QPainter& painter, const ConceptEdge& edge, const QLineF& line, qreal penWidth, bool drawText) const;
+
+    QColor m_background;    // 背景色
+    qreal m_margin;         // 边距
+    bool m_textVisible;     // 是否绘制文字
+};
+
+#endif // MAPRENDERER_H
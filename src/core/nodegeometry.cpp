@@ -0,0 +1,359 @@
+#include "nodegeometry.h"
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NODEGEOMETRY_SSE2
+#endif
+
+// 向量内核一次处理 4 个节点，块大小是 4 的倍数时只有最后一块有标量尾部
+static_assert(ChunkedVector<float>::ChunkSize % 4 == 0, "块大小必须是 4 的倍数");
+
+/**
+ * @brief 追加一个节点
+ * @param id 节点ID
+ * @param rect 节点矩形
+ */
+void NodeGeometry::append(NodeId id, const QRectF& rect)
+{
+    m_x.append(float(rect.x()));
+    m_y.append(float(rect.y()));
+    m_width.append(float(rect.width()));
+    m_height.append(float(rect.height()));
+    m_ids.append(id);
+}
+
+/**
+ * @brief 设置指定下标的节点矩形
+ * @param index 下标
+ * @param rect 节点矩形
+ */
+void NodeGeometry::set(int index, const QRectF& rect)
+{
+    m_x[index] = float(rect.x());
+    m_y[index] = float(rect.y());
+    m_width[index] = float(rect.width());
+    m_height[index] = float(rect.height());
+}
+
+/**
+ * @brief 设置指定下标的节点位置
+ * @param index 下标
+ * @param pos 节点左上角位置
+ */
+void NodeGeometry::setPos(int index, const QPointF& pos)
+{
+    m_x[index] = float(pos.x());
+    m_y[index] = float(pos.y());
+}
+
+/**
+ * @brief 删除指定下标的节点（把最后一个节点移入空位）
+ * @param index 下标
+ */
+void NodeGeometry::removeAt(int index)
+{
+    const int last = m_ids.size() - 1;
+    if (index != last) {
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_width[index] = m_width[last];
+        m_height[index] = m_height[last];
+        m_ids[index] = m_ids[last];
+    }
+    m_x.removeLast();
+    m_y.removeLast();
+    m_width.removeLast();
+    m_height.removeLast();
+    m_ids.removeLast();
+}
+
+/**
+ * @brief 获取指定下标的节点矩形
+ * @param index 下标
+ * @return 节点矩形
+ */
+QRectF NodeGeometry::rectAt(int index) const
+{
+    return QRectF(m_x[index], m_y[index], m_width[index], m_height[index]);
+}
+
+/**
+ * @brief 预留容量
+ * @param size 预计的节点数量
+ */
+void NodeGeometry::reserve(int size)
+{
+    m_x.reserve(size);
+    m_y.reserve(size);
+    m_width.reserve(size);
+    m_height.reserve(size);
+    m_ids.reserve(size);
+}
+
+/**
+ * @brief 清空所有节点
+ */
+void NodeGeometry::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_width.clear();
+    m_height.clear();
+    m_ids.clear();
+}
+
+/**
+ * @brief 计算所有节点的包围盒
+ * @return 包围盒，没有节点时返回空矩形
+ */
+QRectF NodeGeometry::boundingRect() const
+{
+    if (m_ids.isEmpty()) {
+        return QRectF();
+    }
+
+    float left = std::numeric_limits<float>::max();
+    float top = std::numeric_limits<float>::max();
+    float right = std::numeric_limits<float>::lowest();
+    float bottom = std::numeric_limits<float>::lowest();
+
+#ifdef NODEGEOMETRY_SSE2
+    __m128 minX = _mm_set1_ps(left);
+    __m128 minY = _mm_set1_ps(top);
+    __m128 maxX = _mm_set1_ps(right);
+    __m128 maxY = _mm_set1_ps(bottom);
+#endif
+
+    for (int chunk = 0; chunk < m_x.chunkCount(); ++chunk) {
+        const int count = m_x.chunkLength(chunk);
+        const float* xs = m_x.chunkData(chunk);
+        const float* ys = m_y.chunkData(chunk);
+        const float* ws = m_width.chunkData(chunk);
+        const float* hs = m_height.chunkData(chunk);
+        int i = 0;
+
+#ifdef NODEGEOMETRY_SSE2
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(xs + i);
+            const __m128 y = _mm_loadu_ps(ys + i);
+            minX = _mm_min_ps(minX, x);
+            minY = _mm_min_ps(minY, y);
+            maxX = _mm_max_ps(maxX, _mm_add_ps(x, _mm_loadu_ps(ws + i)));
+            maxY = _mm_max_ps(maxY, _mm_add_ps(y, _mm_loadu_ps(hs + i)));
+        }
+#endif
+
+        for (; i < count; ++i) {
+            left = qMin(left, xs[i]);
+            top = qMin(top, ys[i]);
+            right = qMax(right, xs[i] + ws[i]);
+            bottom = qMax(bottom, ys[i] + hs[i]);
+        }
+    }
+
+#ifdef NODEGEOMETRY_SSE2
+    // 横向归约 4 个通道
+    alignas(16) float lanes[4][4];
+    _mm_store_ps(lanes[0], minX);
+    _mm_store_ps(lanes[1], minY);
+    _mm_store_ps(lanes[2], maxX);
+    _mm_store_ps(lanes[3], maxY);
+    for (int lane = 0; lane < 4; ++lane) {
+        left = qMin(left, lanes[0][lane]);
+        top = qMin(top, lanes[1][lane]);
+        right = qMax(right, lanes[2][lane]);
+        bottom = qMax(bottom, lanes[3][lane]);
+    }
+#endif
+
+    return QRectF(QPointF(left, top), QPointF(right, bottom));
+}
+
+/**
+ * @brief 查找与矩形相交的节点
+ * @param rect 查询矩形
+ * @return 相交节点的下标（升序）
+ */
+QVector<int> NodeGeometry::indicesIntersecting(const QRectF& rect) const
+{
+    QVector<int> result;
+    if (m_ids.isEmpty() || rect.isEmpty()) {
+        return result;
+    }
+
+    const QRectF r = rect.normalized();
+    const float left = float(r.left());
+    const float top = float(r.top());
+    const float right = float(r.right());
+    const float bottom = float(r.bottom());
+
+#ifdef NODEGEOMETRY_SSE2
+    const __m128 vLeft = _mm_set1_ps(left);
+    const __m128 vTop = _mm_set1_ps(top);
+    const __m128 vRight = _mm_set1_ps(right);
+    const __m128 vBottom = _mm_set1_ps(bottom);
+#endif
+
+    for (int chunk = 0; chunk < m_x.chunkCount(); ++chunk) {
+        const int base = chunk * ChunkedVector<float>::ChunkSize;
+        const int count = m_x.chunkLength(chunk);
+        const float* xs = m_x.chunkData(chunk);
+        const float* ys = m_y.chunkData(chunk);
+        const float* ws = m_width.chunkData(chunk);
+        const float* hs = m_height.chunkData(chunk);
+        int i = 0;
+
+#ifdef NODEGEOMETRY_SSE2
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(xs + i);
+            const __m128 y = _mm_loadu_ps(ys + i);
+            const __m128 x2 = _mm_add_ps(x, _mm_loadu_ps(ws + i));
+            const __m128 y2 = _mm_add_ps(y, _mm_loadu_ps(hs + i));
+
+            // 与 QRectF::intersects 相同的严格不等式
+            __m128 hit = _mm_and_ps(_mm_cmplt_ps(x, vRight), _mm_cmpgt_ps(x2, vLeft));
+            hit = _mm_and_ps(hit, _mm_cmplt_ps(y, vBottom));
+            hit = _mm_and_ps(hit, _mm_cmpgt_ps(y2, vTop));
+
+            int mask = _mm_movemask_ps(hit);
+            while (mask) {
+                const int lane = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+                result.append(base + i + lane);
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        for (; i < count; ++i) {
+            if (xs[i] < right && xs[i] + ws[i] > left && ys[i] < bottom && ys[i] + hs[i] > top) {
+                result.append(base + i);
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief 查找离指定点最近的节点
+ * @param point 查询点
+ * @return 最近节点的下标，没有节点时返回 -1
+ */
+int NodeGeometry::nearestIndex(const QPointF& point) const
+{
+    if (m_ids.isEmpty()) {
+        return -1;
+    }
+
+    const float px = float(point.x());
+    const float py = float(point.y());
+
+    float bestDistance = std::numeric_limits<float>::max();
+    int bestIndex = -1;
+
+#ifdef NODEGEOMETRY_SSE2
+    const __m128 vPx = _mm_set1_ps(px);
+    const __m128 vPy = _mm_set1_ps(py);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 best = _mm_set1_ps(bestDistance);
+    __m128i bestIdx = _mm_set1_epi32(-1);
+    const __m128i step = _mm_set1_epi32(4);
+#endif
+
+    for (int chunk = 0; chunk < m_x.chunkCount(); ++chunk) {
+        const int base = chunk * ChunkedVector<float>::ChunkSize;
+        const int count = m_x.chunkLength(chunk);
+        const float* xs = m_x.chunkData(chunk);
+        const float* ys = m_y.chunkData(chunk);
+        const float* ws = m_width.chunkData(chunk);
+        const float* hs = m_height.chunkData(chunk);
+        int i = 0;
+
+#ifdef NODEGEOMETRY_SSE2
+        __m128i idx = _mm_add_epi32(_mm_set1_epi32(base), _mm_set_epi32(3, 2, 1, 0));
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(xs + i);
+            const __m128 y = _mm_loadu_ps(ys + i);
+            const __m128 x2 = _mm_add_ps(x, _mm_loadu_ps(ws + i));
+            const __m128 y2 = _mm_add_ps(y, _mm_loadu_ps(hs + i));
+
+            // 点到矩形的距离：在矩形内的分量为 0
+            const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(x, vPx), _mm_sub_ps(vPx, x2)), zero);
+            const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(y, vPy), _mm_sub_ps(vPy, y2)), zero);
+            const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+            const __m128 closer = _mm_cmplt_ps(d2, best);
+            best = _mm_or_ps(_mm_and_ps(closer, d2), _mm_andnot_ps(closer, best));
+            const __m128i closerI = _mm_castps_si128(closer);
+            bestIdx = _mm_or_si128(_mm_and_si128(closerI, idx), _mm_andnot_si128(closerI, bestIdx));
+            idx = _mm_add_epi32(idx, step);
+        }
+#endif
+
+        // 只有最后一块可能剩下不足 4 个的尾部
+        for (; i < count; ++i) {
+            const float dx = qMax(qMax(xs[i] - px, px - (xs[i] + ws[i])), 0.0f);
+            const float dy = qMax(qMax(ys[i] - py, py - (ys[i] + hs[i])), 0.0f);
+            const float d2 = dx * dx + dy * dy;
+            if (d2 < bestDistance || bestIndex < 0) {
+                bestDistance = d2;
+                bestIndex = base + i;
+            }
+        }
+    }
+
+#ifdef NODEGEOMETRY_SSE2
+    // 归约 4 个通道，距离相同时取下标较小者，与标量版本一致
+    alignas(16) float laneDistance[4];
+    alignas(16) int laneIndex[4];
+    _mm_store_ps(laneDistance, best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(laneIndex), bestIdx);
+    for (int lane = 0; lane < 4; ++lane) {
+        if (laneIndex[lane] < 0) {
+            continue;
+        }
+        if (bestIndex < 0 || laneDistance[lane] < bestDistance
+            || (laneDistance[lane] == bestDistance && laneIndex[lane] < bestIndex)) {
+            bestDistance = laneDistance[lane];
+            bestIndex = laneIndex[lane];
+        }
+    }
+#endif
+
+    return bestIndex;
+}
+
+/**
+ * @brief 平移所有节点
+ * @param delta 平移量
+ */
+void NodeGeometry::translate(const QPointF& delta)
+{
+    const float dx = float(delta.x());
+    const float dy = float(delta.y());
+
+#ifdef NODEGEOMETRY_SSE2
+    const __m128 vDx = _mm_set1_ps(dx);
+    const __m128 vDy = _mm_set1_ps(dy);
+#endif
+
+    for (int chunk = 0; chunk < m_x.chunkCount(); ++chunk) {
+        const int count = m_x.chunkLength(chunk);
+        float* xs = m_x.chunkData(chunk);
+        float* ys = m_y.chunkData(chunk);
+        int i = 0;
+
+#ifdef NODEGEOMETRY_SSE2
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(xs + i, _mm_add_ps(_mm_loadu_ps(xs + i), vDx));
+            _mm_storeu_ps(ys + i, _mm_add_ps(_mm_loadu_ps(ys + i), vDy));
+        }
+#endif
+
+        for (; i < count; ++i) {
+            xs[i] += dx;
+            ys[i] += dy;
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#include "operationprogress.h"
+
+/**
+ * @brief 获取完成百分比
+ * @return 0 到 100 之间的整数，总量未知时返回 0
+ */
+int OperationProgress::percent() const
+{
+    const qint64 total = m_total;
+    if (total <= 0) {
+        return 0;
+    }
+    return int(qBound<qint64>(0, m_done * 100 / total, 100));
+}
@@ -0,0 +1,135 @@
+#ifndef OPERATIONPROGRESS_H
+#define OPERATIONPROGRESS_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief 文件操作的进度和取消标志
+ *
+ * 由发起操作的线程创建，交给工作线程中的读写函数。读写函数按自己的单位
+ * （读取时为字节，写入时为记录）累加总量和已完成量，并定期检查取消标志；
+ * 界面线程可以随时读取 percent() 或调用 cancel()。所有成员都是原子的，
+ * 并行解析的多个线程可以同时推进同一个进度。
+ *
+ * 读写函数的 progress 参数都可以为 nullptr，此时不报告进度，也不能取消。
+ */
+class OperationProgress
+{
+public:
+    static constexpr int ReportInterval = 1024;    // 每处理这么多条记录报告一次
+
+    /**
+     * @brief 增加总量
+     * @param amount 增加的数量
+     */
+    void addTotal(qint64 amount) { m_total += amount; }
+
+    /**
+     * @brief 推进已完成量
+     * @param amount 推进的数量
+     */
+    void advance(qint64 amount) { m_done += amount; }
+
+    /**
+     * @brief 获取已完成量
+     * @return 已完成量
+     */
+    qint64 done() const { return m_done; }
+
+    /**
+     * @brief 获取总量
+     * @return 总量
+     */
+    qint64 total() const { return m_total; }
+
+    /**
+     * @brief 获取完成百分比
+     * @return 0 到 100 之间的整数，总量未知时返回 0
+     */
+    int percent() const;
+
+    /**
+     * @brief 请求取消操作
+     */
+    void cancel() { m_canceled = true; }
+
+    /**
+     * @brief 检查是否已请求取消
+     * @return 如果已请求取消返回 true，否则返回 false
+     */
+    bool isCanceled() const { return m_canceled; }
+
+private:
+    std::atomic<qint64> m_done{0};
+    std::atomic<qint64> m_total{0};
+    std::atomic<bool> m_canceled{false};
+};
+
+/**
+ * @brief 单个线程内的进度报告器
+ *
+ * 逐条记录调用 step()，或按读取位置调用 moveTo()，攒够一批后才写入共享的
+ * OperationProgress，避免每条记录都访问原子变量。两个函数在已取消时返回 false。
+ */
+class ProgressReporter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param progress 共享进度，可以为 nullptr
+     */
+    explicit ProgressReporter(OperationProgress* progress) : m_progress(progress) {}
+
+    /**
+     * @brief 析构函数，报告剩余的数量
+     */
+    ~ProgressReporter() { flush(); }
+
+    /**
+     * @brief 记录完成一条记录
+     * @return 如果已取消返回 false，否则返回 true
+     */
+    bool step()
+    {
+        if (!m_progress || ++m_pending < OperationProgress::ReportInterval) {
+            return true;
+        }
+        flush();
+        return !m_progress->isCanceled();
+    }
+
+    /**
+     * @brief 记录读取位置（位置只增不减）
+     * @param position 当前读取位置
+     * @return 如果已取消返回 false，否则返回 true
+     */
+    bool moveTo(qint64 position)
+    {
+        if (!m_progress) {
+            return true;
+        }
+        m_pending += position - m_position;
+        m_position = position;
+        flush();
+        return !m_progress->isCanceled();
+    }
+
+    /**
+     * @brief 把攒下的数量写入共享进度
+     */
+    void flush()
+    {
+        if (m_progress && m_pending > 0) {
+            m_progress->advance(m_pending);
+        }
+        m_pending = 0;
+    }
+
+private:
+    OperationProgress* m_progress;
+    qint64 m_pending = 0;       // 尚未报告的数量
+    qint64 m_position = 0;      // moveTo() 的上一个位置
+};
+
+#endif // OPERATIONPROGRESS_H
@@ -0,0 +1,111 @@
+#include "recordbatch.h"
+#include "conceptmap.h"
+#include <QThread>
+#include <QDebug>
+
+/**
+ * @brief 添加节点
+ * @param node 节点（ID 稍后由 resolveIds() 设置）
+ * @param uuid 节点 UUID
+ */
+void RecordBatch::addNode(ConceptNode&& node, const QString& uuid)
+{
+    m_nodes.append(std::move(node));
+    m_nodeUuids.append(uuid);
+}
+
+/**
+ * @brief 添加连接线
+ * @param edge 连接线（ID 和端点稍后由 resolveIds() 设置）
+ * @param uuid 连接线 UUID
+ * @param sourceUuid 源节点 UUID
+ * @param targetUuid 目标节点 UUID
+ */
+void RecordBatch::addEdge(ConceptEdge&& edge, const QString& uuid, const QString& sourceUuid, const QString& targetUuid)
+{
+    m_edges.append(std::move(edge));
+    m_edgeUuids.append(uuid);
+    m_edgeUuids.append(sourceUuid);
+    m_edgeUuids.append(targetUuid);
+}
+
+/**
+ * @brief 把暂存的 UUID 批量换成句柄
+ */
+void RecordBatch::resolveIds()
+{
+    if (!m_nodeUuids.isEmpty()) {
+        const QVector<quint32> ids = IdRegistry::fromUuids(m_nodeUuids);
+        for (int i = 0; i < m_nodes.size(); ++i) {
+            m_nodes[i].setId(ids[i]);
+        }
+        m_nodeUuids = QVector<QString>();
+    }
+
+    if (!m_edgeUuids.isEmpty()) {
+        const QVector<quint32> ids = IdRegistry::fromUuids(m_edgeUuids);
+        for (int i = 0; i < m_edges.size(); ++i) {
+            m_edges[i].setId(ids[3 * i]);
+            m_edges[i].setSourceNodeId(ids[3 * i + 1]);
+            m_edges[i].setTargetNodeId(ids[3 * i + 2]);
+        }
+        m_edgeUuids = QVector<QString>();
+    }
+}
+
+/**
+ * @brief 把另一批记录追加到本批之后（两批都应已调用 resolveIds()）
+ * @param other 另一批记录
+ */
+void RecordBatch::append(RecordBatch&& other)
+{
+    if (m_nodes.isEmpty()) {
+        m_nodes = std::move(other.m_nodes);
+    } else {
+        m_nodes.reserve(m_nodes.size() + other.m_nodes.size());
+        for (ConceptNode& node : other.m_nodes) {
+            m_nodes.append(std::move(node));
+        }
+    }
+
+    if (m_edges.isEmpty()) {
+        m_edges = std::move(other.m_edges);
+    } else {
+        m_edges.reserve(m_edges.size() + other.m_edges.size());
+        for (ConceptEdge& edge : other.m_edges) {
+            m_edges.append(std::move(edge));
+        }
+    }
+
+    other.m_nodes = QVector<ConceptNode>();
+    other.m_edges = QVector<ConceptEdge>();
+}
+
+/**
+ * @brief 替换概念图中的全部节点和连接线
+ * @param map 概念图对象
+ * @return 被拒绝的记录数量
+ */
+int RecordBatch::loadInto(ConceptMap& map)
+{
+    resolveIds();
+    const int rejected = map.bulkLoad(std::move(m_nodes), std::move(m_edges));
+    if (rejected > 0) {
+        qWarning() << "忽略无效记录（ID重复或连接线端点不存在）:" << rejected;
+    }
+    m_nodes = QVector<ConceptNode>();
+    m_edges = QVector<ConceptEdge>();
+    return rejected;
+}
+
+/**
+ * @brief 计算并行解析的分块大小
+ * @param bytes 需要分块的总字节数
+ * @return 每块的目标字节数
+ */
+qint64 RecordBatch::chunkBytes(qint64 bytes)
+{
+    // 每个线程分到若干块，耗时不均时空闲线程可以接着处理剩下的块
+    const qint64 chunks = qMax(1, QThread::idealThreadCount()) * 4;
+    return qMax(MinChunkBytes, bytes / chunks);
+}
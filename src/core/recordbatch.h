@@ -0,0 +1,77 @@
+#ifndef RECORDBATCH_H
+#define RECORDBATCH_H
+
+#include <QVector>
+#include <QString>
+#include "conceptnode.h"
+#include "conceptedge.h"
+
+class ConceptMap;
+
+/**
+ * @brief 解析得到的一批节点和连接线记录
+ *
+ * 文本格式的读取器先把记录收集到批次中，ID 以 UUID 字符串暂存，
+ * 由 resolveIds() 一次性换成句柄，最后通过 loadInto() 交给 ConceptMap::bulkLoad。
+ *
+ * 并行加载时每个分块得到一个批次，各线程分别解析 ID，再按分块在文件中的顺序
+ * 用 append() 合并，因此合并结果与串行读取的记录顺序完全相同。
+ */
+class RecordBatch
+{
+public:
+    static constexpr qint64 ParallelThreshold = 4 * 1024 * 1024;   // 文件达到该大小才并行解析
+    static constexpr qint64 MinChunkBytes = 256 * 1024;            // 分块的最小字节数
+
+    /**
+     * @brief 添加节点
+     * @param node 节点（ID 稍后由 resolveIds() 设置）
+     * @param uuid 节点 UUID
+     */
+    void addNode(ConceptNode&& node, const QString& uuid);
+
+    /**
+     * @brief 添加连接线
+     * @param edge 连接线（ID 和端点稍后由 resolveIds() 设置）
+     * @param uuid 连接线 UUID
+     * @param sourceUuid 源节点 UUID
+     * @param targetUuid 目标节点 UUID
+     */
+    void addEdge(ConceptEdge&& edge, const QString& uuid, const QString& sourceUuid, const QString& targetUuid);
+
+    /**
+     * @brief 把暂存的 UUID 批量换成句柄
+     */
+    void resolveIds();
+
+    /**
+     * @brief 把另一批记录追加到本批之后（两批都应已调用 resolveIds()）
+     * @param other 另一批记录
+     */
+    void append(RecordBatch&& other);
+
+    /**
+     * @brief 替换概念图中的全部节点和连接线
+     * @param map 概念图对象
+     * @return 被拒绝的记录数量
+     */
+    int loadInto(ConceptMap& map);
+
+    int nodeCount() const { return m_nodes.size(); }
+    int edgeCount() const { return m_edges.size(); }
+
+    /**
+     * @brief 计算并行解析的分块大小
+     * @param bytes 需要分块的总字节数
+     * @return 每块的目标字节数
+     */
+    static qint64 chunkBytes(qint64 bytes);
+
+private:
+    QVector<ConceptNode> m_nodes;
+    QVector<ConceptEdge> m_edges;
+    QVector<QString> m_nodeUuids;   // 与 m_nodes 一一对应
+    QVector<QString> m_edgeUuids;   // 每条连接线三项：ID、源节点、目标节点
+};
+
+#endif // RECORDBATCH_H
@@ -0,0 +1,86 @@
+#include "recordstream.h"
+#include "idregistry.h"
+
+/**
+ * @brief 写入一条节点记录
+ * @param out 输出流
+ * @param node 节点
+ */
+void RecordStream::writeNode(QDataStream& out, const ConceptNode& node)
+{
+    out << IdRegistry::toUuid(node.id()) << node.text()
+        << double(node.x()) << double(node.y()) << double(node.width()) << double(node.height())
+        << quint32(node.color().rgba()) << node.style() << quint8(node.shape());
+}
+
+/**
+ * @brief 读取一条节点记录
+ * @param in 输入流
+ * @param node 读出的节点
+ * @return 如果读取完整返回 true，否则返回 false
+ */
+bool RecordStream::readNode(QDataStream& in, ConceptNode& node)
+{
+    QString uuid;
+    QString text;
+    QString style;
+    double x = 0;
+    double y = 0;
+    double width = 0;
+    double height = 0;
+    quint32 color = 0;
+    quint8 shape = 0;
+    in >> uuid >> text >> x >> y >> width >> height >> color >> style >> shape;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    node = ConceptNode(IdRegistry::fromUuid(uuid));
+    node.setText(text);
+    node.setPos(QPointF(x, y));
+    node.setSize(QSizeF(width, height));
+    node.setColor(QColor::fromRgba(color));
+    node.setStyle(style);
+    node.setShape(shape <= quint8(NodeShape::RoundedRect) ? NodeShape(shape) : NodeShape::Rectangle);
+    return true;
+}
+
+/**
+ * @brief 写入一条连接线记录
+ * @param out 输出流
+ * @param edge 连接线
+ */
+void RecordStream::writeEdge(QDataStream& out, const ConceptEdge& edge)
+{
+    out << IdRegistry::toUuid(edge.id())
+        << IdRegistry::toUuid(edge.sourceNodeId()) << IdRegistry::toUuid(edge.targetNodeId())
+        << edge.label() << quint32(edge.color().rgba()) << edge.style();
+}
+
+/**
+ * @brief 读取一条连接线记录
+ * @param in 输入流
+ * @param edge 读出的连接线
+ * @return 如果读取完整返回 true，否则返回 false
+ */
+bool RecordStream::readEdge(QDataStream& in, ConceptEdge& edge)
+{
+    QString uuid;
+    QString sourceUuid;
+    QString targetUuid;
+    QString label;
+    QString style;
+    quint32 color = 0;
+    in >> uuid >> sourceUuid >> targetUuid >> label >> color >> style;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    edge = ConceptEdge(IdRegistry::fromUuid(uuid));
+    edge.setSourceNodeId(IdRegistry::fromUuid(sourceUuid));
+    edge.setTargetNodeId(IdRegistry::fromUuid(targetUuid));
+    edge.setLabel(label);
+    edge.setColor(QColor::fromRgba(color));
+    edge.setStyle(style);
+    return true;
+}
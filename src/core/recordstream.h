@@ -0,0 +1,48 @@
+#ifndef RECORDSTREAM_H
+#define RECORDSTREAM_H
+
+#include <QDataStream>
+#include "conceptnode.h"
+#include "conceptedge.h"
+
+/**
+ * @brief 节点和连接线记录的 QDataStream 编码
+ *
+ * 增量保存日志和瓦片存储共用同一种记录布局：ID保存为 UUID 字符串，
+ * 其余字段依次排列。流的版本由调用方设置（QDataStream::Qt_6_0）。
+ */
+class RecordStream
+{
+public:
+    /**
+     * @brief 写入一条节点记录
+     * @param out 输出流
+     * @param node 节点
+     */
+    static void writeNode(QDataStream& out, const ConceptNode& node);
+
+    /**
+     * @brief 读取一条节点记录
+     * @param in 输入流
+     * @param node 读出的节点
+     * @return 如果读取完整返回 true，否则返回 false
+     */
+    static bool readNode(QDataStream& in, ConceptNode& node);
+
+    /**
+     * @brief 写入一条连接线记录
+     * @param out 输出流
+     * @param edge 连接线
+     */
+    static void writeEdge(QDataStream& out, const ConceptEdge& edge);
+
+    /**
+     * @brief 读取一条连接线记录
+     * @param in 输入流
+     * @param edge 读出的连接线
+     * @return 如果读取完整返回 true，否则返回 false
+     */
+    static bool readEdge(QDataStream& in, ConceptEdge& edge);
+};
+
+#endif // RECORDSTREAM_H
@@ -0,0 +1,235 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "chunkedvector.h"
+#include <utility>
+
+/**
+ * @brief 槽位句柄
+ *
+ * 由槽位索引和代数组成。元素被删除后槽位代数递增，
+ * 旧句柄随之失效，不会误指向复用该槽位的新元素。
+ */
+struct SlotHandle
+{
+    static constexpr quint32 InvalidIndex = 0xFFFFFFFFu;
+
+    quint32 index = InvalidIndex;   // 槽位索引
+    quint32 generation = 0;         // 槽位代数
+
+    /**
+     * @brief 检查句柄是否有效
+     * @return 如果句柄指向某个槽位返回 true，否则返回 false
+     */
+    bool isValid() const { return index != InvalidIndex; }
+
+    bool operator==(const SlotHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 槽位映射容器
+ *
+ * 元素连续存放在稠密数组中，删除时把最后一个元素移入空位（swap-remove），
+ * 因此插入、删除和按句柄查找都是 O(1)。稠密数组的顺序在删除后会改变，
+ * 但句柄始终稳定。
+ *
+ * 元素数组、槽位表和反向映射都是分块隐式共享的（ChunkedVector），复制整个容器是 O(1)，
+ * 复制后插入、删除或修改单个元素只会分离涉及的几个块。
+ */
+template <typename T>
+class SlotMap
+{
+public:
+    /**
+     * @brief 插入元素
+     * @param value 要插入的元素
+     * @return 新元素的句柄
+     */
+    SlotHandle insert(const T& value)
+    {
+        T copy(value);
+        return insert(std::move(copy));
+    }
+
+    /**
+     * @brief 插入元素（移动版本）
+     * @param value 要插入的元素
+     * @return 新元素的句柄
+     */
+    SlotHandle insert(T&& value)
+    {
+        quint32 slotIndex;
+        if (!m_freeSlots.isEmpty()) {
+            slotIndex = m_freeSlots.takeLast();
+        } else {
+            slotIndex = quint32(m_slots.size());
+            m_slots.append(Slot());
+        }
+
+        Slot& slot = m_slots[slotIndex];
+        slot.denseIndex = quint32(m_values.size());
+
+        m_values.append(std::move(value));
+        m_denseToSlot.append(slotIndex);
+
+        SlotHandle handle;
+        handle.index = slotIndex;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    /**
+     * @brief 删除元素
+     * @param handle 元素句柄
+     * @return 如果成功删除返回 true，如果句柄已失效则返回 false
+     */
+    bool remove(const SlotHandle& handle)
+    {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        Slot& slot = m_slots[handle.index];
+        const int dense = int(slot.denseIndex);
+        const int last = m_values.size() - 1;
+
+        // 把最后一个元素移入空位，保持稠密数组连续
+        if (dense != last) {
+            m_values[dense] = std::move(m_values[last]);
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].denseIndex = quint32(dense);
+        }
+        m_values.removeLast();
+        m_denseToSlot.removeLast();
+
+        // 递增代数使旧句柄失效，并回收槽位
+        ++slot.generation;
+        slot.denseIndex = SlotHandle::InvalidIndex;
+        m_freeSlots.append(handle.index);
+        return true;
+    }
+
+    /**
+     * @brief 检查句柄是否仍然有效
+     * @param handle 元素句柄
+     * @return 如果有效返回 true，否则返回 false
+     */
+    bool contains(const SlotHandle& handle) const
+    {
+        return handle.index < quint32(m_slots.size())
+            && m_slots[handle.index].generation == handle.generation
+            && m_slots[handle.index].denseIndex != SlotHandle::InvalidIndex;
+    }
+
+    /**
+     * @brief 根据句柄获取元素
+     * @param handle 元素句柄
+     * @return 元素指针，如果句柄已失效则返回 nullptr
+     */
+    T* get(const SlotHandle& handle)
+    {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &m_values[int(m_slots.at(handle.index).denseIndex)];
+    }
+
+    /**
+     * @brief 根据句柄获取元素（常量版本）
+     * @param handle 元素句柄
+     * @return 元素指针，如果句柄已失效则返回 nullptr
+     */
+    const T* get(const SlotHandle& handle) const
+    {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &m_values.at(int(m_slots.at(handle.index).denseIndex));
+    }
+
+    /**
+     * @brief 获取句柄对应的稠密数组下标
+     * @param handle 元素句柄
+     * @return 稠密下标，如果句柄已失效则返回 -1
+     */
+    int denseIndexOf(const SlotHandle& handle) const
+    {
+        if (!contains(handle)) {
+            return -1;
+        }
+        return int(m_slots[handle.index].denseIndex);
+    }
+
+    /**
+     * @brief 获取稠密数组下标对应的句柄
+     * @param denseIndex 稠密下标
+     * @return 元素句柄
+     */
+    SlotHandle handleAt(int denseIndex) const
+    {
+        SlotHandle handle;
+        handle.index = m_denseToSlot[denseIndex];
+        handle.generation = m_slots[handle.index].generation;
+        return handle;
+    }
+
+    /**
+     * @brief 按稠密下标访问元素
+     */
+    T& at(int denseIndex) { return m_values[denseIndex]; }
+    const T& at(int denseIndex) const { return m_values.at(denseIndex); }
+
+    /**
+     * @brief 获取稠密数组
+     * @return 所有元素（顺序不保证稳定）
+     */
+    const ChunkedVector<T>& values() const { return m_values; }
+
+    int size() const { return m_values.size(); }
+    bool isEmpty() const { return m_values.isEmpty(); }
+
+    /**
+     * @brief 预留容量
+     * @param size 预计的元素数量
+     */
+    void reserve(int size)
+    {
+        m_values.reserve(size);
+        m_denseToSlot.reserve(size);
+        m_slots.reserve(size);
+    }
+
+    /**
+     * @brief 清空容器
+     *
+     * 槽位表被整体丢弃，清空前发出的句柄不应再使用。
+     */
+    void clear()
+    {
+        m_values.clear();
+        m_denseToSlot.clear();
+        m_slots.clear();
+        m_freeSlots.clear();
+    }
+
+private:
+    struct Slot
+    {
+        quint32 denseIndex = SlotHandle::InvalidIndex;  // 稠密数组下标
+        quint32 generation = 0;                         // 槽位代数
+    };
+
+    ChunkedVector<T> m_values;              // 稠密元素数组（分块共享）
+    ChunkedVector<quint32> m_denseToSlot;   // 稠密下标到槽位的反向映射
+    ChunkedVector<Slot> m_slots;            // 槽位表
+    ChunkedVector<quint32> m_freeSlots;     // 空闲槽位
+};
+
+#endif // SLOTMAP_H
@@ -0,0 +1,24 @@
+#include "stringpool.h"
+
+/**
+ * @brief 驻留字符串
+ * @param text 要驻留的字符串
+ * @return 与池中共享缓冲区的字符串
+ */
+QString StringPool::intern(const QString& text)
+{
+    // 空字符串本身不占用堆内存，无需驻留
+    if (text.isEmpty()) {
+        return QString();
+    }
+
+    auto it = m_strings.constFind(text);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+
+    // 调用方的字符串可能是更大缓冲区的一部分（例如 fromRawData），复制一份独立的
+    QString owned(text.constData(), text.size());
+    m_strings.insert(owned);
+    return owned;
+}
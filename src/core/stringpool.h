@@ -0,0 +1,41 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QSet>
+
+/**
+ * @brief 字符串驻留池
+ *
+ * 样式名、连接线标签等字符串在大图中大量重复。加载文件时每条记录都会得到
+ * 一份独立分配的 QString，驻留后相同内容的字符串共享同一块隐式共享缓冲区，
+ * 重复的副本随之释放。
+ *
+ * 池中的字符串只增不减，直到调用 clear()。
+ */
+class StringPool
+{
+public:
+    /**
+     * @brief 驻留字符串
+     * @param text 要驻留的字符串
+     * @return 与池中共享缓冲区的字符串
+     */
+    QString intern(const QString& text);
+
+    /**
+     * @brief 获取池中不同字符串的数量
+     * @return 字符串数量
+     */
+    int size() const { return m_strings.size(); }
+
+    /**
+     * @brief 清空驻留池
+     */
+    void clear() { m_strings.clear(); }
+
+private:
+    QSet<QString> m_strings;    // 已驻留的字符串
+};
+
+#endif // STRINGPOOL_H
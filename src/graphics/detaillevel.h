@@ -0,0 +1,54 @@
+#ifndef DETAILLEVEL_H
+#define DETAILLEVEL_H
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+/**
+ * @brief 图形项的绘制细节等级
+ *
+ * 按视图缩放比例分级，缩小时省掉看不清的部分：
+ * - Minimal：节点画成纯色方块，连接线只画线，不画文本、箭头和标签，不抗锯齿
+ * - Reduced：节点纯色填充加边框和文本，连接线画线和箭头，不画标签
+ * - Full：完整绘制（渐变、文本、箭头、标签）
+ *
+ * 选中和悬停效果在各等级都绘制。
+ */
+enum class DetailLevel {
+    Minimal,
+    Reduced,
+    Full
+};
+
+/**
+ * @brief 细节等级的阈值和计算
+ */
+class DetailLevels
+{
+public:
+    static constexpr qreal MinimalBelow = 0.3;  // 缩放比例低于此值时为 Minimal
+    static constexpr qreal ReducedBelow = 0.6;  // 缩放比例低于此值时为 Reduced
+
+    /**
+     * @brief 按绘制器的变换计算细节等级
+     * @param option 样式选项（为空时按完整绘制）
+     * @param painter 绘制器
+     * @return 细节等级
+     */
+    static DetailLevel fromOption(const QStyleOptionGraphicsItem* option, const QPainter* painter)
+    {
+        if (!option || !painter) {
+            return DetailLevel::Full;
+        }
+        const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+        if (lod < MinimalBelow) {
+            return DetailLevel::Minimal;
+        }
+        if (lod < ReducedBelow) {
+            return DetailLevel::Reduced;
+        }
+        return DetailLevel::Full;
+    }
+};
+
+#endif // DETAILLEVEL_H
@@ -1,27 +1,30 @@
 #include "graphicsedge.h"
+#include "edgegeometry.h"
+#include "detaillevel.h"
+#include "textlayoutcache.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsScene>
-#include <QFontMetrics>
-#include <QLineF>
-#include <QPainterPath>
 #include <QDebug>
 
 /**
  * @brief 构造函数 - 创建一个图形连接线
- * @param edge 概念连接线数据
+ * @param map 概念图数据
+ * @param id 连接线ID
  * @param sourceNode 源图形节点
  * @param targetNode 目标图形节点
  * @param parent 父图形项
  */
-GraphicsEdge::GraphicsEdge(const ConceptEdge& edge, GraphicsNode* sourceNode, GraphicsNode* targetNode, QGraphicsItem* parent)
+GraphicsEdge::GraphicsEdge(const ConceptMap* map, EdgeId id, GraphicsNode* sourceNode, GraphicsNode* targetNode, QGraphicsItem* parent)
     : QGraphicsObject(parent)
-    , m_edge(edge)
+    , m_map(map)
+    , m_id(id)
     , m_sourceNode(sourceNode)
     , m_targetNode(targetNode)
     , m_isSelected(false)
     , m_isHovered(false)
     , m_lineWidth(2.0)
     , m_arrowSize(10.0)
+    , m_labelFont("Arial", 9)
     , m_selectionColor(QColor(0, 120, 215))
     , m_hoverColor(QColor(0, 120, 215, 100))
 {
@@ -31,13 +34,11 @@ GraphicsEdge::GraphicsEdge(const ConceptEdge& edge, GraphicsNode* sourceNode, Gr
     // 设置标志
     setFlag(QGraphicsItem::ItemIsSelectable, true);
 
-    // 连接节点位置变化信号
-    if (m_sourceNode) {
-        connect(m_sourceNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
-    }
-    if (m_targetNode) {
-        connect(m_targetNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
-    }
+    // 连接节点位置、尺寸和形状变化信号
+    connectNode(m_sourceNode);
+    connectNode(m_targetNode);
+
+    updateGeometry();
 }
 
 /**
@@ -53,21 +54,7 @@ GraphicsEdge::~GraphicsEdge()
  */
 QRectF GraphicsEdge::boundingRect() const
 {
-    if (!m_sourceNode || !m_targetNode) {
-        return QRectF();
-    }
-
-    QPointF sourcePoint = calculateSourcePoint();
-    QPointF targetPoint = calculateTargetPoint();
-
-    // 计算包含连接线和箭头的边界矩形
-    qreal padding = m_lineWidth + m_arrowSize + 5.0;
-    qreal minX = qMin(sourcePoint.x(), targetPoint.x()) - padding;
-    qreal minY = qMin(sourcePoint.y(), targetPoint.y()) - padding;
-    qreal maxX = qMax(sourcePoint.x(), targetPoint.x()) + padding;
-    qreal maxY = qMax(sourcePoint.y(), targetPoint.y()) + padding;
-
-    return QRectF(minX, minY, maxX - minX, maxY - minY);
+    return m_boundingRect;
 }
 
 /**
@@ -78,25 +65,28 @@ QRectF GraphicsEdge::boundingRect() const
  */
 void GraphicsEdge::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
-    Q_UNUSED(option);
     Q_UNUSED(widget);
 
-    if (!m_sourceNode || !m_targetNode) {
+    const ConceptEdge* edge = record();
+    if (!edge || !m_sourceNode || !m_targetNode) {
         return;
     }
 
-    painter->setRenderHint(QPainter::Antialiasing);
+    // 按缩放比例选择细节等级：远景只画线，中景不画标签
+    const DetailLevel level = DetailLevels::fromOption(option, painter);
+    painter->setRenderHint(QPainter::Antialiasing, level != DetailLevel::Minimal);
 
     // 绘制连接线
-    drawLine(painter);
+    const QColor color = edge->color();
+    drawLine(painter, color);
 
     // 绘制箭头
-    QPointF sourcePoint = calculateSourcePoint();
-    QPointF targetPoint = calculateTargetPoint();
-    drawArrow(painter, sourcePoint, targetPoint);
+    if (level != DetailLevel::Minimal) {
+        drawArrow(painter, color);
+    }
 
     // 绘制标签
-    if (!m_edge.label().isEmpty()) {
+    if (level == DetailLevel::Full && !m_label.text().isEmpty()) {
         drawLabel(painter);
     }
 
@@ -116,23 +106,33 @@ int GraphicsEdge::type() const
 }
 
 /**
- * @brief 设置连接线标签
- * @param label 新的标签
+ * @brief 获取概念连接线数据
+ * @return 概念连接线数据（复制），连接线不存在时返回默认连接线
  */
-void GraphicsEdge::setLabel(const QString& label)
+ConceptEdge GraphicsEdge::edge() const
 {
-    m_edge.setLabel(label);
-    update();
+    const ConceptEdge* edge = record();
+    return edge ? *edge : ConceptEdge(InvalidId);
 }
 
 /**
- * @brief 设置连接线颜色
- * @param color 新的颜色
+ * @brief 获取连接线标签
+ * @return 连接线标签
  */
-void GraphicsEdge::setColor(const QColor& color)
+QString GraphicsEdge::label() const
 {
-    m_edge.setColor(color);
-    update();
+    const ConceptEdge* edge = record();
+    return edge ? edge->label() : QString();
+}
+
+/**
+ * @brief 获取连接线颜色
+ * @return 连接线颜色
+ */
+QColor GraphicsEdge::color() const
+{
+    const ConceptEdge* edge = record();
+    return edge ? edge->color() : QColor();
 }
 
 /**
@@ -151,13 +151,12 @@ void GraphicsEdge::setSelectedEdge(bool selected)
  */
 void GraphicsEdge::setSourceNode(GraphicsNode* node)
 {
-    if (m_sourceNode) {
-        disconnect(m_sourceNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
+    if (node == m_sourceNode) {
+        return;
     }
+    disconnectNode(m_sourceNode);
     m_sourceNode = node;
-    if (m_sourceNode) {
-        connect(m_sourceNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
-    }
+    connectNode(m_sourceNode);
     updatePosition();
 }
 
@@ -167,33 +166,33 @@ void GraphicsEdge::setSourceNode(GraphicsNode* node)
  */
 void GraphicsEdge::setTargetNode(GraphicsNode* node)
 {
-    if (m_targetNode) {
-        disconnect(m_targetNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
+    if (node == m_targetNode) {
+        return;
     }
+    disconnectNode(m_targetNode);
     m_targetNode = node;
-    if (m_targetNode) {
-        connect(m_targetNode, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
-    }
+    connectNode(m_targetNode);
     updatePosition();
 }
 
 /**
- * @brief 更新连接线数据
- * @param edge 新的连接线数据
+ * @brief 按概念图数据刷新外观（标签可能变化，重新计算几何）
  */
-void GraphicsEdge::updateEdge(const ConceptEdge& edge)
+void GraphicsEdge::refresh()
 {
-    m_edge = edge;
+    updateGeometry();
     update();
 }
 
 /**
- * @brief 更新连接线位置
+ * @brief 端点节点移动、改变尺寸或形状后重新计算几何
  */
 void GraphicsEdge::updatePosition()
 {
-    prepareGeometryChange();
-    update();
+    // 几何没变（例如端点节点只改了颜色）时保留缓存的位图
+    if (updateGeometry()) {
+        update();
+    }
 }
 
 /**
@@ -231,256 +230,119 @@ void GraphicsEdge::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
 }
 
 /**
- * @brief 计算直线与节点的交点
- * @param rect 节点边界矩形
- * @param center 节点中心
- * @param target 目标点
- * @param shape 节点形状
- * @return 交点坐标
+ * @brief 重新计算缓存的几何（端点、路径、箭头、标签矩形和边界矩形）
+ * @return 几何有变化时返回 true
  */
-QPointF GraphicsEdge::calculateIntersectionPoint(const QRectF& rect, const QPointF& center, const QPointF& target, NodeShape shape) const
+bool GraphicsEdge::updateGeometry()
 {
-    switch (shape) {
-    case NodeShape::Rectangle:
-        return calculateRectangleIntersection(rect, center, target);
-    case NodeShape::Ellipse:
-        return calculateEllipseIntersection(rect, center, target);
-    case NodeShape::RoundedRect:
-        return calculateRoundedRectIntersection(rect, center, target);
-    default:
-        return center;
+    const ConceptEdge* edge = record();
+    QLineF line;
+    QStaticText label;
+    QRectF labelRect;
+    QRectF bounds;
+    if (m_sourceNode && m_targetNode) {
+        line = EdgeGeometry::line(QRectF(m_sourceNode->pos(), m_sourceNode->nodeSize()), m_sourceNode->nodeShape(),
+                                  QRectF(m_targetNode->pos(), m_targetNode->nodeSize()), m_targetNode->nodeShape());
+
+        // 包含连接线和箭头
+        const qreal padding = m_lineWidth + m_arrowSize + 5.0;
+        bounds = QRectF(line.p1(), line.p2()).normalized().adjusted(-padding, -padding, padding, padding);
+
+        // 标签位于连接线中点，短连接线上标签可能超出连接线的范围
+        if (edge && !edge->label().isEmpty()) {
+            label = TextLayoutCache::layout(edge->label(), m_labelFont).text;
+            labelRect = QRectF(QPointF(), label.size());
+            labelRect.moveCenter(line.center());
+            bounds = bounds.united(labelRect.adjusted(-4, -4, 4, 4));
+        }
     }
-}
 
-/**
- * @brief 计算直线与矩形的交点
- * @param rect 矩形边界
- * @param center 矩形中心
- * @param target 目标点
- * @return 交点坐标
- */
-QPointF GraphicsEdge::calculateRectangleIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const
-{
-    // 计算从中心到目标的直线
-    QLineF line(center, target);
-
-    // 计算直线与矩形的交点
-    QPointF intersectionPoint;
-    QLineF::IntersectionType intersection = line.intersects(QLineF(rect.topLeft(), rect.topRight()), &intersectionPoint);
-    if (intersection == QLineF::BoundedIntersection) {
-        return intersectionPoint;
+    const bool changed = bounds != m_boundingRect || line != m_line || labelRect != m_labelRect
+                         || label.text() != m_label.text();
+    if (bounds != m_boundingRect) {
+        prepareGeometryChange();
+        m_boundingRect = bounds;
     }
-
-    intersection = line.intersects(QLineF(rect.topRight(), rect.bottomRight()), &intersectionPoint);
-    if (intersection == QLineF::BoundedIntersection) {
-        return intersectionPoint;
+    if (line != m_line) {
+        m_line = line;
+        m_path = QPainterPath();
+        m_path.moveTo(line.p1());
+        m_path.lineTo(line.p2());
+        m_arrow = EdgeGeometry::arrowHead(line, m_arrowSize);
     }
-
-    intersection = line.intersects(QLineF(rect.bottomRight(), rect.bottomLeft()), &intersectionPoint);
-    if (intersection == QLineF::BoundedIntersection) {
-        return intersectionPoint;
-    }
-
-    intersection = line.intersects(QLineF(rect.bottomLeft(), rect.topLeft()), &intersectionPoint);
-    if (intersection == QLineF::BoundedIntersection) {
-        return intersectionPoint;
-    }
-
-    // 如果没有交点，返回中心点
-    return center;
+    m_label = label;
+    m_labelRect = labelRect;
+    return changed;
 }
 
 /**
- * @brief 计算直线与椭圆的交点
- * @param rect 椭圆的外切矩形
- * @param center 椭圆中心
- * @param target 目标点
- * @return 交点坐标
+ * @brief 连接端点节点的几何变化信号
+ * @param node 端点节点
  */
-QPointF GraphicsEdge::calculateEllipseIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const
+void GraphicsEdge::connectNode(GraphicsNode* node)
 {
-    // 计算椭圆的半长轴和半短轴
-    qreal a = rect.width() / 2.0;
-    qreal b = rect.height() / 2.0;
-
-    // 如果椭圆退化为直线或点，返回中心
-    if (a <= 0 || b <= 0) {
-        return center;
+    if (node) {
+        connect(node, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
+        connect(node, &GraphicsNode::geometryChanged, this, &GraphicsEdge::updatePosition);
     }
-
-    // 计算直线方向向量
-    qreal dx = target.x() - center.x();
-    qreal dy = target.y() - center.y();
-
-    // 如果目标点与中心重合，返回中心
-    if (dx == 0 && dy == 0) {
-        return center;
-    }
-
-    // 计算直线参数方程：x = center.x() + t*dx, y = center.y() + t*dy
-    // 椭圆方程：(x-center.x())²/a² + (y-center.y())²/b² = 1
-    // 代入得：(t*dx)²/a² + (t*dy)²/b² = 1
-    // 整理得：t²*(dx²/a² + dy²/b²) = 1
-    // 解得：t = 1/sqrt(dx²/a² + dy²/b²)
-    qreal t = 1.0 / sqrt((dx*dx)/(a*a) + (dy*dy)/(b*b));
-
-    // 计算交点坐标
-    return QPointF(center.x() + t*dx, center.y() + t*dy);
 }
 
 /**
- * @brief 计算直线与圆角矩形的交点
- * @param rect 圆角矩形的外切矩形
- * @param center 圆角矩形中心
- * @param target 目标点
- * @return 交点坐标
+ * @brief 断开端点节点的几何变化信号
+ * @param node 端点节点
  */
-QPointF GraphicsEdge::calculateRoundedRectIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const
+void GraphicsEdge::disconnectNode(GraphicsNode* node)
 {
-    // 圆角矩形的圆角半径（使用矩形宽度和高度的较小值的1/4）
-    qreal radius = qMin(rect.width(), rect.height()) / 4.0;
-    
-    // 首先尝试与矩形部分相交
-    QRectF rectPart = rect.adjusted(radius, radius, -radius, -radius);
-    QPointF rectIntersection = calculateRectangleIntersection(rectPart, center, target);
-    
-    // 如果与矩形部分相交，直接返回交点
-    if (rectPart.contains(rectIntersection)) {
-        return rectIntersection;
+    if (node) {
+        disconnect(node, &GraphicsNode::positionChanged, this, &GraphicsEdge::updatePosition);
+        disconnect(node, &GraphicsNode::geometryChanged, this, &GraphicsEdge::updatePosition);
     }
-    
-    // 否则，计算与圆角部分的交点
-    // 这里使用简化算法：将圆角矩形视为矩形，返回与矩形的交点
-    // 在实际应用中，可以实现更精确的圆角交点计算
-    return calculateRectangleIntersection(rect, center, target);
-}
-
-/**
- * @brief 计算连接线起点
- * @return 起点坐标
- */
-QPointF GraphicsEdge::calculateSourcePoint() const
-{
-    if (!m_sourceNode || !m_targetNode) {
-        return QPointF();
-    }
-
-    // 计算源节点和目标节点的中心点
-    QPointF sourceCenter = QPointF(m_sourceNode->x() + m_sourceNode->node().width() / 2.0,
-                                  m_sourceNode->y() + m_sourceNode->node().height() / 2.0);
-    QPointF targetCenter = QPointF(m_targetNode->x() + m_targetNode->node().width() / 2.0,
-                                  m_targetNode->y() + m_targetNode->node().height() / 2.0);
-
-    // 计算源节点的边界矩形
-    QRectF sourceRect = QRectF(m_sourceNode->x(), m_sourceNode->y(),
-                              m_sourceNode->node().width(), m_sourceNode->node().height());
-
-    // 使用公共方法计算交点，考虑节点形状
-    return calculateIntersectionPoint(sourceRect, sourceCenter, targetCenter, m_sourceNode->node().shape());
-}
-
-/**
- * @brief 计算连接线终点
- * @return 终点坐标
- */
-QPointF GraphicsEdge::calculateTargetPoint() const
-{
-    if (!m_sourceNode || !m_targetNode) {
-        return QPointF();
-    }
-
-    // 计算源节点和目标节点的中心点
-    QPointF sourceCenter = QPointF(m_sourceNode->x() + m_sourceNode->node().width() / 2.0,
-                                  m_sourceNode->y() + m_sourceNode->node().height() / 2.0);
-    QPointF targetCenter = QPointF(m_targetNode->x() + m_targetNode->node().width() / 2.0,
-                                  m_targetNode->y() + m_targetNode->node().height() / 2.0);
-
-    // 计算目标节点的边界矩形
-    QRectF targetRect = QRectF(m_targetNode->x(), m_targetNode->y(),
-                              m_targetNode->node().width(), m_targetNode->node().height());
-
-    // 使用公共方法计算交点，考虑节点形状
-    return calculateIntersectionPoint(targetRect, targetCenter, sourceCenter, m_targetNode->node().shape());
 }
 
 /**
  * @brief 绘制连接线
  * @param painter 绘制器
+ * @param color 线条颜色
  */
-void GraphicsEdge::drawLine(QPainter* painter)
+void GraphicsEdge::drawLine(QPainter* painter, const QColor& color)
 {
-    QPointF sourcePoint = calculateSourcePoint();
-    QPointF targetPoint = calculateTargetPoint();
-
-    QPen pen(m_edge.color(), m_lineWidth);
+    QPen pen(color, m_lineWidth);
     pen.setCosmetic(true);
     painter->setPen(pen);
     painter->setBrush(Qt::NoBrush);
-
-    QPainterPath path;
-    path.moveTo(sourcePoint);
-    path.lineTo(targetPoint);
-    painter->drawPath(path);
+    painter->drawPath(m_path);
 }
 
 /**
  * @brief 绘制箭头
  * @param painter 绘制器
- * @param startPoint 起点
- * @param endPoint 终点
+ * @param color 箭头颜色
  */
-void GraphicsEdge::drawArrow(QPainter* painter, const QPointF& startPoint, const QPointF& endPoint)
+void GraphicsEdge::drawArrow(QPainter* painter, const QColor& color)
 {
-    // 计算箭头角度
-    QLineF line(startPoint, endPoint);
-    double angle = std::atan2(-line.dy(), line.dx());
-
-    // 计算箭头顶点
-    QPointF arrowP1 = endPoint - QPointF(std::sin(angle + M_PI / 3) * m_arrowSize,
-                                          std::cos(angle + M_PI / 3) * m_arrowSize);
-    QPointF arrowP2 = endPoint - QPointF(std::sin(angle + M_PI - M_PI / 3) * m_arrowSize,
-                                          std::cos(angle + M_PI - M_PI / 3) * m_arrowSize);
-
-    // 绘制箭头
-    QPen pen(m_edge.color(), m_lineWidth);
+    QPen pen(color, m_lineWidth);
     pen.setCosmetic(true);
     painter->setPen(pen);
-    painter->setBrush(QBrush(m_edge.color()));
-
-    QPolygonF arrowPolygon;
-    arrowPolygon << endPoint << arrowP1 << arrowP2;
-    painter->drawPolygon(arrowPolygon);
+    painter->setBrush(QBrush(color));
+    painter->drawPolygon(m_arrow);
 }
 
 /**
- * @brief 绘制标签
+ * @brief 绘制标签（连接线中点）
  * @param painter 绘制器
  */
 void GraphicsEdge::drawLabel(QPainter* painter)
 {
-    QPointF sourcePoint = calculateSourcePoint();
-    QPointF targetPoint = calculateTargetPoint();
-
-    // 计算标签位置（连接线中点）
-    QPointF labelPos = (sourcePoint + targetPoint) / 2.0;
-
-    // 设置字体
-    QFont font("Arial", 9);
-    painter->setFont(font);
-
-    // 计算标签边界矩形
-    QFontMetrics metrics(font);
-    QRectF labelRect = metrics.boundingRect(m_edge.label());
-    labelRect.moveCenter(labelPos);
+    painter->setFont(m_labelFont);
 
     // 绘制标签背景
     painter->setPen(Qt::NoPen);
     painter->setBrush(QColor(255, 255, 255, 200));
-    painter->drawRoundedRect(labelRect.adjusted(-3, -3, 3, 3), 3, 3);
+    painter->drawRoundedRect(m_labelRect.adjusted(-3, -3, 3, 3), 3, 3);
 
     // 绘制标签文本
     painter->setPen(Qt::black);
-    painter->drawText(labelRect, Qt::AlignCenter, m_edge.label());
+    painter->drawStaticText(m_labelRect.topLeft(), m_label);
 }
 
 /**
@@ -489,9 +351,6 @@ void GraphicsEdge::drawLabel(QPainter* painter)
  */
 void GraphicsEdge::drawSelection(QPainter* painter)
 {
-    QPointF sourcePoint = calculateSourcePoint();
-    QPointF targetPoint = calculateTargetPoint();
-
     if (isSelectedEdge()) {
         // 绘制选中边框
         QPen pen(m_selectionColor, m_lineWidth + 2.0);
@@ -499,21 +358,13 @@ void GraphicsEdge::drawSelection(QPainter* painter)
         pen.setCosmetic(true);
         painter->setPen(pen);
         painter->setBrush(Qt::NoBrush);
-
-        QPainterPath path;
-        path.moveTo(sourcePoint);
-        path.lineTo(targetPoint);
-        painter->drawPath(path);
+        painter->drawPath(m_path);
     } else if (m_isHovered) {
         // 绘制悬停效果
         QPen pen(m_hoverColor, m_lineWidth + 1.0);
         pen.setCosmetic(true);
         painter->setPen(pen);
         painter->setBrush(Qt::NoBrush);
-
-        QPainterPath path;
-        path.moveTo(sourcePoint);
-        path.lineTo(targetPoint);
-        painter->drawPath(path);
+        painter->drawPath(m_path);
     }
 }
@@ -5,7 +5,11 @@
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
 #include <QWidget>
-#include "conceptedge.h"
+#include <QLineF>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QStaticText>
+#include "conceptmap.h"
 #include "graphicsnode.h"
 
 /**
@@ -16,6 +20,8 @@
  * - 鼠标事件处理（点击、悬停）
  * - 位置更新
  * - 连接线样式管理
+ *
+ * 图形连接线只保存连接线ID，标签和颜色从场景绑定的概念图数据中读取。
  */
 class GraphicsEdge : public QGraphicsObject
 {
@@ -26,12 +32,13 @@ public:
 
     /**
      * @brief 构造函数 - 创建一个图形连接线
-     * @param edge 概念连接线数据
+     * @param map 概念图数据
+     * @param id 连接线ID
      * @param sourceNode 源图形节点
      * @param targetNode 目标图形节点
      * @param parent 父图形项
      */
-    explicit GraphicsEdge(const ConceptEdge& edge, GraphicsNode* sourceNode, GraphicsNode* targetNode, QGraphicsItem* parent = nullptr);
+    GraphicsEdge(const ConceptMap* map, EdgeId id, GraphicsNode* sourceNode, GraphicsNode* targetNode, QGraphicsItem* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -64,37 +71,37 @@ public:
      * @brief 获取连接线ID
      * @return 连接线ID
      */
-    QString id() const { return m_edge.id(); }
+    EdgeId id() const { return m_id; }
 
     /**
      * @brief 获取概念连接线数据
-     * @return 概念连接线数据
+     * @return 概念连接线数据（复制），连接线不存在时返回默认连接线
      */
-    ConceptEdge edge() const { return m_edge; }
+    ConceptEdge edge() const;
 
     /**
      * @brief 获取源节点ID
      * @return 源节点ID
      */
-    QString sourceNodeId() const { return m_edge.sourceNodeId(); }
+    NodeId sourceNodeId() const { return m_sourceNode ? m_sourceNode->id() : InvalidId; }
 
     /**
      * @brief 获取目标节点ID
      * @return 目标节点ID
      */
-    QString targetNodeId() const { return m_edge.targetNodeId(); }
+    NodeId targetNodeId() const { return m_targetNode ? m_targetNode->id() : InvalidId; }
 
     /**
      * @brief 获取连接线标签
      * @return 连接线标签
      */
-    QString label() const { return m_edge.label(); }
+    QString label() const;
 
     /**
      * @brief 获取连接线颜色
      * @return 连接线颜色
      */
-    QColor color() const { return m_edge.color(); }
+    QColor color() const;
 
     /**
      * @brief 获取源图形节点
@@ -115,18 +122,6 @@ public:
     bool isSelectedEdge() const { return m_isSelected; }
 
     // Setter 方法
-    /**
-     * @brief 设置连接线标签
-     * @param label 新的标签
-     */
-    void setLabel(const QString& label);
-
-    /**
-     * @brief 设置连接线颜色
-     * @param color 新的颜色
-     */
-    void setColor(const QColor& color);
-
     /**
      * @brief 设置连接线选中状态
      * @param selected 选中状态
@@ -146,13 +141,12 @@ public:
     void setTargetNode(GraphicsNode* node);
 
     /**
-     * @brief 更新连接线数据
-     * @param edge 新的连接线数据
+     * @brief 按概念图数据刷新外观（标签可能变化，重新计算几何）
      */
-    void updateEdge(const ConceptEdge& edge);
+    void refresh();
 
     /**
-     * @brief 更新连接线位置
+     * @brief 端点节点移动、改变尺寸或形状后重新计算几何
      */
     void updatePosition();
 
@@ -177,67 +171,46 @@ protected:
 
 private:
     /**
-     * @brief 计算直线与节点的交点
-     * @param rect 节点边界矩形
-     * @param center 节点中心
-     * @param target 目标点
-     * @param shape 节点形状
-     * @return 交点坐标
+     * @brief 从概念图数据中读取连接线
+     * @return 连接线指针，如果不存在则返回 nullptr
      */
-    QPointF calculateIntersectionPoint(const QRectF& rect, const QPointF& center, const QPointF& target, NodeShape shape) const;
-    
-    /**
-     * @brief 计算直线与矩形的交点
-     * @param rect 矩形边界
-     * @param center 矩形中心
-     * @param target 目标点
-     * @return 交点坐标
-     */
-    QPointF calculateRectangleIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const;
-    
-    /**
-     * @brief 计算直线与椭圆的交点
-     * @param rect 椭圆的外切矩形
-     * @param center 椭圆中心
-     * @param target 目标点
-     * @return 交点坐标
-     */
-    QPointF calculateEllipseIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const;
-    
+    const ConceptEdge* record() const { return m_map->edgeById(m_id); }
+
     /**
-     * @brief 计算直线与圆角矩形的交点
-     * @param rect 圆角矩形的外切矩形
-     * @param center 圆角矩形中心
-     * @param target 目标点
-     * @return 交点坐标
+     * @brief 重新计算缓存的几何（端点、路径、箭头、标签矩形和边界矩形）
+     *
+     * 端点截在节点轮廓上，计算需要两个节点的矩形和形状。只在端点节点移动、
+     * 改变尺寸或形状、标签变化时调用；绘制和边界查询直接读取缓存。
+     *
+     * @return 几何有变化时返回 true
      */
-    QPointF calculateRoundedRectIntersection(const QRectF& rect, const QPointF& center, const QPointF& target) const;
-    
+    bool updateGeometry();
+
     /**
-     * @brief 计算连接线起点
-     * @return 起点坐标
+     * @brief 连接端点节点的几何变化信号
+     * @param node 端点节点
      */
-    QPointF calculateSourcePoint() const;
-    
+    void connectNode(GraphicsNode* node);
+
     /**
-     * @brief 计算连接线终点
-     * @return 终点坐标
+     * @brief 断开端点节点的几何变化信号
+     * @param node 端点节点
      */
-    QPointF calculateTargetPoint() const;
-    
+    void disconnectNode(GraphicsNode* node);
+
     /**
      * @brief 绘制连接线
      * @param painter 绘制器
+     * @param color 线条颜色
      */
-    void drawLine(QPainter* painter);
+    void drawLine(QPainter* painter, const QColor& color);
     
     /**
      * @brief 绘制箭头
      * @param painter 绘制器
-     * @param startPoint 起点
-     * @param endPoint 终点
+     * @param color 箭头颜色
      */
-    void drawArrow(QPainter* painter, const QPointF& startPoint, const QPointF& endPoint);
+    void drawArrow(QPainter* painter, const QColor& color);
     
     /**
      * @brief 绘制标签
@@ -251,13 +224,21 @@ private:
      */
     void drawSelection(QPainter* painter);
     
-    ConceptEdge m_edge;              // 概念连接线数据
+    const ConceptMap* m_map;         // 概念图数据（不拥有）
+    EdgeId m_id;                     // 连接线ID
     GraphicsNode* m_sourceNode;      // 源图形节点
     GraphicsNode* m_targetNode;      // 目标图形节点
     bool m_isSelected;               // 是否被选中
     bool m_isHovered;                // 是否被悬停
     qreal m_lineWidth;               // 线条宽度
     qreal m_arrowSize;               // 箭头大小
+    QLineF m_line;                   // 缓存：截在节点轮廓上的连接线
+    QPainterPath m_path;             // 缓存：连接线路径
+    QPolygonF m_arrow;               // 缓存：箭头三角形
+    QFont m_labelFont;               // 标签字体
+    QStaticText m_label;             // 缓存：排好版的标签（来自共享的文本排版缓存）
+    QRectF m_labelRect;              // 缓存：标签文本矩形
+    QRectF m_boundingRect;           // 缓存：边界矩形
     QColor m_selectionColor;         // 选中颜色
     QColor m_hoverColor;             // 悬停颜色
 };
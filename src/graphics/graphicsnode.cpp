@@ -1,27 +1,37 @@
 #include "graphicsnode.h"
+#include "detaillevel.h"
+#include "textlayoutcache.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsScene>
-#include <QFontMetrics>
 #include <QDebug>
 
 /**
  * @brief 构造函数 - 创建一个图形节点
- * @param node 概念节点数据
+ * @param map 概念图数据
+ * @param id 节点ID
  * @param parent 父图形项
  */
-GraphicsNode::GraphicsNode(const ConceptNode& node, QGraphicsItem* parent)
+GraphicsNode::GraphicsNode(const ConceptMap* map, NodeId id, QGraphicsItem* parent)
     : QGraphicsObject(parent)
-    , m_node(node)
+    , m_map(map)
+    , m_id(id)
+    , m_shape(NodeShape::Rectangle)
     , m_isSelected(false)
     , m_isHovered(false)
     , m_cornerRadius(8.0)
     , m_borderWidth(2.0)
     , m_borderColor(QColor(80, 80, 80))
+    , m_font("Arial", 10)
     , m_selectionColor(QColor(0, 120, 215))
     , m_hoverColor(QColor(0, 120, 215, 100))
 {
-    // 设置节点位置
-    setPos(node.pos());
+    // 设置节点位置和尺寸
+    if (const ConceptNode* node = record()) {
+        m_size = node->size();
+        m_shape = node->shape();
+        updateText(*node);
+        setPos(node->pos());
+    }
 
     // 启用鼠标悬停事件
     setAcceptHoverEvents(true);
@@ -45,11 +55,12 @@ GraphicsNode::~GraphicsNode()
  */
 QRectF GraphicsNode::boundingRect() const
 {
-    // 返回包含节点、边框和选中效果的边界矩形
+    // 返回包含节点、边框和选中效果的边界矩形；视图只重绘变化的区域，
+    // 超出节点的长文本也要包含在内，否则会留下残影
     qreal padding = m_borderWidth + 5.0;
     return QRectF(-padding, -padding,
-                  m_node.width() + 2 * padding,
-                  m_node.height() + 2 * padding);
+                  m_size.width() + 2 * padding,
+                  m_size.height() + 2 * padding).united(m_textRect);
 }
 
 /**
@@ -60,19 +71,30 @@ QRectF GraphicsNode::boundingRect() const
  */
 void GraphicsNode::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
-    Q_UNUSED(option);
     Q_UNUSED(widget);
 
-    painter->setRenderHint(QPainter::Antialiasing);
+    const ConceptNode* node = record();
+    if (!node) {
+        return;
+    }
+
+    // 按缩放比例选择细节等级，缩小时不排版文本、不建渐变
+    const DetailLevel level = DetailLevels::fromOption(option, painter);
+    painter->setRenderHint(QPainter::Antialiasing, level != DetailLevel::Minimal);
 
-    // 绘制节点背景
-    drawBackground(painter);
+    if (level == DetailLevel::Minimal) {
+        // 远景：纯色方块
+        painter->fillRect(QRectF(QPointF(0, 0), m_size), node->color());
+    } else {
+        // 绘制节点背景
+        drawBackground(painter, *node, level == DetailLevel::Full);
 
-    // 绘制节点边框
-    drawBorder(painter);
+        // 绘制节点边框
+        drawBorder(painter);
 
-    // 绘制节点文本
-    drawText(painter);
+        // 绘制节点文本
+        drawText(painter, *node);
+    }
 
     // 绘制选中效果
     if (isSelectedNode() || m_isHovered) {
@@ -90,23 +112,43 @@ int GraphicsNode::type() const
 }
 
 /**
- * @brief 设置节点文本
- * @param text 新的文本
+ * @brief 获取概念节点数据
+ * @return 概念节点数据（复制），节点不存在时返回默认节点
  */
-void GraphicsNode::setText(const QString& text)
+ConceptNode GraphicsNode::node() const
 {
-    m_node.setText(text);
-    update();
+    const ConceptNode* node = record();
+    return node ? *node : ConceptNode(InvalidId);
 }
 
 /**
- * @brief 设置节点颜色
- * @param color 新的颜色
+ * @brief 获取节点文本
+ * @return 节点文本
  */
-void GraphicsNode::setColor(const QColor& color)
+QString GraphicsNode::text() const
 {
-    m_node.setColor(color);
-    update();
+    const ConceptNode* node = record();
+    return node ? node->text() : QString();
+}
+
+/**
+ * @brief 获取节点颜色
+ * @return 节点颜色
+ */
+QColor GraphicsNode::color() const
+{
+    const ConceptNode* node = record();
+    return node ? node->color() : QColor();
+}
+
+/**
+ * @brief 获取节点形状
+ * @return 节点形状
+ */
+NodeShape GraphicsNode::nodeShape() const
+{
+    const ConceptNode* node = record();
+    return node ? node->shape() : NodeShape::Rectangle;
 }
 
 /**
@@ -120,24 +162,44 @@ void GraphicsNode::setSelectedNode(bool selected)
 }
 
 /**
- * @brief 更新节点数据
- * @param node 新的节点数据
+ * @brief 按概念图数据刷新位置、尺寸和外观
+ *
+ * 只有位置变化时不重绘，已缓存的位图仍然有效。
+ *
+ * @param fields 变化的字段
  */
-void GraphicsNode::updateNode(const ConceptNode& node)
+void GraphicsNode::refresh(ChangeSet::NodeFields fields)
 {
-    m_node = node;
-    setPos(node.pos());
-    update();
+    const ConceptNode* node = record();
+    if (!node) {
+        return;
+    }
+
+    const bool resized = node->size() != m_size;
+    const bool reshaped = node->shape() != m_shape;
+    if (resized || (fields & ChangeSet::NodeText)) {
+        prepareGeometryChange();
+        m_size = node->size();
+        updateText(*node);
+    }
+    m_shape = node->shape();
+    setPos(node->pos());
+    if (fields & ~ChangeSet::NodeFields(ChangeSet::NodePosition)) {
+        update();
+    }
+
+    if (resized || reshaped) {
+        emit geometryChanged();
+    }
 }
 
 /**
- * @brief 更新节点位置
+ * @brief 更新节点位置（位置变化会经由场景写回概念图数据）
  * @param pos 新的位置
  */
 void GraphicsNode::updatePosition(const QPointF& pos)
 {
     setPos(pos);
-    m_node.setPos(pos);
 }
 
 /**
@@ -201,10 +263,6 @@ void GraphicsNode::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
  */
 QVariant GraphicsNode::itemChange(GraphicsItemChange change, const QVariant& value)
 {
-    if (change == ItemPositionChange && scene()) {
-        // 更新节点数据中的位置
-        m_node.setPos(value.toPointF());
-    }
     if (change == ItemPositionHasChanged && scene()) {
         // 发射位置变化信号
         emit positionChanged(pos());
@@ -213,40 +271,45 @@ QVariant GraphicsNode::itemChange(GraphicsItemChange change, const QVariant& val
 }
 
 /**
- * @brief 计算文本边界矩形
- * @return 文本边界矩形
+ * @brief 重新排版文本，更新缓存的文本和文本矩形（文本或尺寸变化时调用）
+ * @param node 节点数据
  */
-QRectF GraphicsNode::calculateTextRect() const
+void GraphicsNode::updateText(const ConceptNode& node)
 {
-    QFont font("Arial", 10);
-    QFontMetrics metrics(font);
-    QRectF textRect = metrics.boundingRect(m_node.text());
+    const TextLayoutCache::Layout layout = TextLayoutCache::layout(node.text(), m_font);
 
     // 居中文本
-    qreal x = (m_node.width() - textRect.width()) / 2.0;
-    qreal y = (m_node.height() - textRect.height()) / 2.0;
+    qreal x = (m_size.width() - layout.size.width()) / 2.0;
+    qreal y = (m_size.height() - layout.size.height()) / 2.0;
 
-    return QRectF(x, y, textRect.width(), textRect.height());
+    m_text = layout.text;
+    m_textRect = QRectF(QPointF(x, y), layout.size);
 }
 
 /**
  * @brief 绘制节点背景
  * @param painter 绘制器
+ * @param node 节点数据
+ * @param gradient 是否使用渐变填充，否则为纯色
  */
-void GraphicsNode::drawBackground(QPainter* painter)
+void GraphicsNode::drawBackground(QPainter* painter, const ConceptNode& node, bool gradient)
 {
-    QRectF rect(0, 0, m_node.width(), m_node.height());
-
-    // 创建渐变背景
-    QLinearGradient gradient(rect.topLeft(), rect.bottomRight());
-    gradient.setColorAt(0.0, m_node.color().lighter(120));
-    gradient.setColorAt(1.0, m_node.color());
-
-    painter->setBrush(QBrush(gradient));
+    QRectF rect(QPointF(0, 0), m_size);
+
+    const QColor color = node.color();
+    if (gradient) {
+        // 创建渐变背景
+        QLinearGradient fill(rect.topLeft(), rect.bottomRight());
+        fill.setColorAt(0.0, color.lighter(120));
+        fill.setColorAt(1.0, color);
+        painter->setBrush(QBrush(fill));
+    } else {
+        painter->setBrush(color);
+    }
     painter->setPen(Qt::NoPen);
 
     // 根据节点形状绘制
-    switch (m_node.shape()) {
+    switch (node.shape()) {
         case NodeShape::Rectangle:
             painter->drawRect(rect);
             break;
@@ -265,7 +328,7 @@ void GraphicsNode::drawBackground(QPainter* painter)
  */
 void GraphicsNode::drawBorder(QPainter* painter)
 {
-    QRectF rect(0, 0, m_node.width(), m_node.height());
+    QRectF rect(QPointF(0, 0), m_size);
 
     QPen pen(m_borderColor, m_borderWidth);
     pen.setCosmetic(true);
@@ -277,20 +340,22 @@ void GraphicsNode::drawBorder(QPainter* painter)
 /**
  * @brief 绘制节点文本
  * @param painter 绘制器
+ * @param node 节点数据
  */
-void GraphicsNode::drawText(QPainter* painter)
+void GraphicsNode::drawText(QPainter* painter, const ConceptNode& node)
 {
-    QFont font("Arial", 10);
-    painter->setFont(font);
-
-    QRectF textRect = calculateTextRect();
+    // 排版在 refresh() 中完成，绘制时只读缓存的结果
+    if (m_text.text().isEmpty()) {
+        return;
+    }
 
     // 设置文本颜色
-    QColor textColor = (m_node.color().lightness() < 128) ? Qt::white : Qt::black;
+    QColor textColor = (node.color().lightness() < 128) ? Qt::white : Qt::black;
     painter->setPen(textColor);
+    painter->setFont(m_font);
 
     // 绘制文本
-    painter->drawText(textRect, Qt::AlignCenter, m_node.text());
+    painter->drawStaticText(m_textRect.topLeft(), m_text);
 }
 
 /**
@@ -299,7 +364,7 @@ void GraphicsNode::drawText(QPainter* painter)
  */
 void GraphicsNode::drawSelection(QPainter* painter)
 {
-    QRectF rect(0, 0, m_node.width(), m_node.height());
+    QRectF rect(QPointF(0, 0), m_size);
 
     if (isSelectedNode()) {
         // 绘制选中边框
@@ -3,9 +3,10 @@
 
 #include <QGraphicsObject>
 #include <QPainter>
+#include <QStaticText>
 #include <QStyleOptionGraphicsItem>
 #include <QWidget>
-#include "conceptnode.h"
+#include "conceptmap.h"
 
 /**
  * @brief 图形节点类（继承 QGraphicsObject）
@@ -15,6 +16,9 @@
  * - 鼠标事件处理（点击、拖拽、悬停）
  * - 位置更新
  * - 节点样式管理
+ *
+ * 图形节点只保存节点ID，绘制时从场景绑定的概念图数据中读取文本、颜色等属性。
+ * 数据变化后由场景调用 refresh() 刷新。
  */
 class GraphicsNode : public QGraphicsObject
 {
@@ -26,10 +30,11 @@ public:
 
     /**
      * @brief 构造函数 - 创建一个图形节点
-     * @param node 概念节点数据
+     * @param map 概念图数据
+     * @param id 节点ID
      * @param parent 父图形项
      */
-    explicit GraphicsNode(const ConceptNode& node, QGraphicsItem* parent = nullptr);
+    GraphicsNode(const ConceptMap* map, NodeId id, QGraphicsItem* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -62,45 +67,45 @@ public:
      * @brief 获取节点ID
      * @return 节点ID
      */
-    QString id() const { return m_node.id(); }
+    NodeId id() const { return m_id; }
 
     /**
      * @brief 获取概念节点数据
-     * @return 概念节点数据
+     * @return 概念节点数据（复制），节点不存在时返回默认节点
      */
-    ConceptNode node() const { return m_node; }
+    ConceptNode node() const;
 
     /**
      * @brief 获取节点文本
      * @return 节点文本
      */
-    QString text() const { return m_node.text(); }
+    QString text() const;
 
     /**
      * @brief 获取节点颜色
      * @return 节点颜色
      */
-    QColor color() const { return m_node.color(); }
+    QColor color() const;
 
     /**
-     * @brief 检查节点是否被选中
-     * @return 如果被选中返回 true，否则返回 false
+     * @brief 获取节点形状
+     * @return 节点形状
      */
-    bool isSelectedNode() const { return m_isSelected; }
+    NodeShape nodeShape() const;
 
-    // Setter 方法
     /**
-     * @brief 设置节点文本
-     * @param text 新的文本
+     * @brief 获取节点尺寸
+     * @return 节点尺寸
      */
-    void setText(const QString& text);
+    QSizeF nodeSize() const { return m_size; }
 
     /**
-     * @brief 设置节点颜色
-     * @param color 新的颜色
+     * @brief 检查节点是否被选中
+     * @return 如果被选中返回 true，否则返回 false
      */
-    void setColor(const QColor& color);
+    bool isSelectedNode() const { return m_isSelected; }
 
+    // Setter 方法
     /**
      * @brief 设置节点选中状态
      * @param selected 选中状态
@@ -108,10 +113,13 @@ public:
     void setSelectedNode(bool selected);
 
     /**
-     * @brief 更新节点数据
-     * @param node 新的节点数据
+     * @brief 按概念图数据刷新位置、尺寸和外观
+     *
+     * 只有位置变化时不重绘，已缓存的位图仍然有效。
+     *
+     * @param fields 变化的字段
      */
-    void updateNode(const ConceptNode& node);
+    void refresh(ChangeSet::NodeFields fields = ChangeSet::AllNodeFields);
 
     /**
      * @brief 更新节点位置
@@ -125,6 +133,11 @@ signals:
      */
     void positionChanged(const QPointF& pos);
 
+    /**
+     * @brief 尺寸或形状变化信号（相连的连接线据此重新计算几何）
+     */
+    void geometryChanged();
+
 protected:
     /**
      * @brief 鼠标按下事件处理
@@ -166,16 +179,24 @@ protected:
 
 private:
     /**
-     * @brief 计算文本边界矩形
-     * @return 文本边界矩形
+     * @brief 从概念图数据中读取节点
+     * @return 节点指针，如果不存在则返回 nullptr
+     */
+    const ConceptNode* record() const { return m_map->nodeById(m_id); }
+
+    /**
+     * @brief 重新排版文本，更新缓存的文本和文本矩形（文本或尺寸变化时调用）
+     * @param node 节点数据
      */
-    QRectF calculateTextRect() const;
+    void updateText(const ConceptNode& node);
 
     /**
      * @brief 绘制节点背景
      * @param painter 绘制器
+     * @param node 节点数据
+     * @param gradient 是否使用渐变填充，否则为纯色
      */
-    void drawBackground(QPainter* painter);
+    void drawBackground(QPainter* painter, const ConceptNode& node, bool gradient);
 
     /**
      * @brief 绘制节点边框
@@ -186,8 +207,9 @@ private:
     /**
      * @brief 绘制节点文本
      * @param painter 绘制器
+     * @param node 节点数据
      */
-    void drawText(QPainter* painter);
+    void drawText(QPainter* painter, const ConceptNode& node);
 
     /**
      * @brief 绘制选中效果
@@ -195,13 +217,19 @@ private:
      */
     void drawSelection(QPainter* painter);
 
-    ConceptNode m_node;              // 概念节点数据
+    const ConceptMap* m_map;         // 概念图数据（不拥有）
+    NodeId m_id;                     // 节点ID
+    QSizeF m_size;                   // 当前尺寸（尺寸变化时需要先通知场景）
+    NodeShape m_shape;               // 当前形状（用于判断形状是否变化）
+    QStaticText m_text;              // 缓存：排好版的文本（来自共享的文本排版缓存）
+    QRectF m_textRect;               // 缓存：文本矩形（长文本可能超出节点）
     bool m_isSelected;               // 是否被选中
     bool m_isHovered;                // 是否被悬停
     QPointF m_dragStartPos;          // 拖拽起始位置
     qreal m_cornerRadius;            // 圆角半径
     qreal m_borderWidth;             // 边框宽度
     QColor m_borderColor;            // 边框颜色
+    QFont m_font;                    // 文本字体
     QColor m_selectionColor;         // 选中颜色
     QColor m_hoverColor;             // 悬停颜色
 };
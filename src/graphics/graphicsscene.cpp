@@ -2,6 +2,9 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QKeyEvent>
 #include <QGraphicsLineItem>
+#include <QGraphicsView>
+#include <QElapsedTimer>
+#include <QSet>
 #include <QDebug>
 
 /**
@@ -10,14 +13,22 @@
  */
 GraphicsScene::GraphicsScene(QObject* parent)
     : QGraphicsScene(parent)
+    , m_conceptMap(&m_localMap)
     , m_isDragging(false)
     , m_isCreatingEdge(false)
     , m_edgeSourceNode(nullptr)
     , m_tempEdgeLine(nullptr)
+    , m_pendingNodeIndex(0)
+    , m_pendingEdgeIndex(0)
+    , m_populateTotal(0)
 {
     // 设置场景大小
     setSceneRect(-2000, -2000, 4000, 4000);
 
+    // 分批创建图形项：每批结束后回到事件循环，先处理绘制和输入
+    m_populateTimer.setInterval(0);
+    connect(&m_populateTimer, &QTimer::timeout, this, &GraphicsScene::populateBatch);
+
     // 设置背景网格
     QBrush gridBrush(QColor(240, 240, 240));
     setBackgroundBrush(gridBrush);
@@ -32,36 +43,121 @@ GraphicsScene::~GraphicsScene()
 }
 
 /**
- * @brief 设置概念图数据
- * @param map 概念图数据
+ * @brief 绑定概念图数据并重建所有图形项
+ * @param map 概念图数据（不拥有），传入 nullptr 时使用场景内部的数据
  */
-void GraphicsScene::setConceptMap(const ConceptMap& map)
+void GraphicsScene::setConceptMap(ConceptMap* map)
 {
-    m_conceptMap = map;
+    m_conceptMap = map ? map : &m_localMap;
     refreshScene();
 }
 
+/**
+ * @brief 开始批量修改
+ */
+void GraphicsScene::beginTransaction()
+{
+    m_conceptMap->beginTransaction();
+}
+
+/**
+ * @brief 提交批量修改，并把变更同步到图形项
+ * @return 本次事务的变更记录
+ */
+ChangeSet GraphicsScene::commitTransaction()
+{
+    const ChangeSet changes = m_conceptMap->commit();
+    if (!changes.isEmpty()) {
+        applyChanges(changes);
+        emit changesCommitted(changes);
+        emit sceneChanged();
+    }
+    return changes;
+}
+
+/**
+ * @brief 按变更记录同步图形项
+ * @param changes 变更记录
+ */
+void GraphicsScene::applyChanges(const ChangeSet& changes)
+{
+    const ConceptMap& map = *m_conceptMap;
+
+    // 先删除，连接线在节点之前，避免悬空的端点指针
+    for (EdgeId edgeId : changes.removedEdges()) {
+        if (GraphicsEdge* graphicsEdge = m_graphicsEdges.take(edgeId)) {
+            destroyItem(graphicsEdge);
+        }
+    }
+    for (NodeId nodeId : changes.removedNodes()) {
+        if (GraphicsNode* graphicsNode = m_graphicsNodes.take(nodeId)) {
+            destroyItem(graphicsNode);
+        }
+    }
+
+    // 再插入，节点在连接线之前
+    for (NodeId nodeId : changes.insertedNodes()) {
+        createGraphicsNode(nodeId);
+    }
+    for (EdgeId edgeId : changes.insertedEdges()) {
+        // 分批创建期间端点可能还没有图形节点，留到节点全部创建之后
+        if (!createGraphicsEdge(edgeId) && isPopulating() && map.hasEdge(edgeId)) {
+            m_pendingEdges.append(edgeId);
+        }
+    }
+
+    // 最后更新被修改的项（移动节点会通过 positionChanged 带动相连的连接线）
+    const QHash<NodeId, ChangeSet::NodeFields> modifiedNodes = changes.modifiedNodes();
+    for (auto it = modifiedNodes.constBegin(); it != modifiedNodes.constEnd(); ++it) {
+        if (GraphicsNode* graphicsNode = graphicsNodeById(it.key())) {
+            graphicsNode->refresh(it.value());
+        }
+    }
+
+    const QHash<EdgeId, ChangeSet::EdgeFields> modifiedEdges = changes.modifiedEdges();
+    for (auto it = modifiedEdges.constBegin(); it != modifiedEdges.constEnd(); ++it) {
+        const ConceptEdge* edge = map.edgeById(it.key());
+        GraphicsEdge* graphicsEdge = graphicsEdgeById(it.key());
+        if (!edge || !graphicsEdge) {
+            continue;
+        }
+        if (it.value() & ChangeSet::EdgeEndpoints) {
+            GraphicsNode* sourceNode = graphicsNodeById(edge->sourceNodeId());
+            GraphicsNode* targetNode = graphicsNodeById(edge->targetNodeId());
+            if (isPopulating() && (!sourceNode || !targetNode)) {
+                // 新端点还没有图形节点，重新排队
+                m_graphicsEdges.remove(it.key());
+                destroyItem(graphicsEdge);
+                m_pendingEdges.append(it.key());
+                continue;
+            }
+            graphicsEdge->setSourceNode(sourceNode);
+            graphicsEdge->setTargetNode(targetNode);
+        }
+        graphicsEdge->refresh();
+    }
+}
+
 /**
  * @brief 添加节点
  * @param node 概念节点数据
- * @return 图形节点指针
+ * @return 图形节点指针，添加失败或处于批量修改中时返回 nullptr
  */
 GraphicsNode* GraphicsScene::addNode(const ConceptNode& node)
 {
-    // 创建图形节点
-    GraphicsNode* graphicsNode = new GraphicsNode(node);
-    addItem(graphicsNode);
+    // 写入概念图数据，提交时创建图形项
+    beginTransaction();
+    const bool added = m_conceptMap->addNode(node);
+    commitTransaction();
 
-    // 添加到映射
-    m_graphicsNodes[node.id()] = graphicsNode;
-
-    // 添加到概念图
-    m_conceptMap.addNode(node);
+    if (!added) {
+        return nullptr;
+    }
 
     // 发送信号
     emit nodeAdded(node);
 
-    return graphicsNode;
+    return graphicsNodeById(node.id());
 }
 
 /**
@@ -69,65 +165,66 @@ GraphicsNode* GraphicsScene::addNode(const ConceptNode& node)
  * @param nodeId 节点ID
  * @return 如果成功删除返回 true，否则返回 false
  */
-bool GraphicsScene::removeNode(const QString& nodeId)
+bool GraphicsScene::removeNode(NodeId nodeId)
 {
-    GraphicsNode* graphicsNode = graphicsNodeById(nodeId);
-    if (!graphicsNode) {
+    if (!m_conceptMap->hasNode(nodeId)) {
         return false;
     }
 
-    // 删除与该节点相关的所有连接线
-    QVector<ConceptEdge> relatedEdges = m_conceptMap.edgesByNodeId(nodeId);
-    for (const ConceptEdge& edge : relatedEdges) {
-        removeEdge(edge.id());
-    }
-
-    // 从场景中移除
-    removeItem(graphicsNode);
-    delete graphicsNode;
-
-    // 从映射中移除
-    m_graphicsNodes.remove(nodeId);
+    // 与该节点相关的连接线会被一并删除
+    const QVector<EdgeId> relatedEdgeIds = m_conceptMap->edgeIdsByNodeId(nodeId);
 
-    // 从概念图中移除
-    m_conceptMap.removeNode(nodeId);
+    beginTransaction();
+    m_conceptMap->removeNode(nodeId);
+    commitTransaction();
 
     // 发送信号
+    for (EdgeId edgeId : relatedEdgeIds) {
+        emit edgeRemoved(edgeId);
+    }
     emit nodeRemoved(nodeId);
-    emit sceneChanged();
 
     return true;
 }
 
+/**
+ * @brief 更新节点
+ * @param node 新的节点数据
+ * @return 如果成功更新返回 true，否则返回 false
+ */
+bool GraphicsScene::updateNode(const ConceptNode& node)
+{
+    beginTransaction();
+    const bool updated = m_conceptMap->updateNode(node);
+    commitTransaction();
+
+    return updated;
+}
+
 /**
  * @brief 添加连接线
  * @param edge 概念连接线数据
- * @return 图形连接线指针
+ * @return 图形连接线指针，添加失败或处于批量修改中时返回 nullptr
  */
 GraphicsEdge* GraphicsScene::addEdge(const ConceptEdge& edge)
 {
-    // 获取源节点和目标节点
-    GraphicsNode* sourceNode = graphicsNodeById(edge.sourceNodeId());
-    GraphicsNode* targetNode = graphicsNodeById(edge.targetNodeId());
-
-    if (!sourceNode || !targetNode) {
+    // 源节点和目标节点必须存在
+    if (!m_conceptMap->hasNode(edge.sourceNodeId()) || !m_conceptMap->hasNode(edge.targetNodeId())) {
         return nullptr;
     }
 
-    // 创建图形连接线
-    GraphicsEdge* graphicsEdge = new GraphicsEdge(edge, sourceNode, targetNode);
-    addItem(graphicsEdge);
-
-    // 添加到映射
-    m_graphicsEdges[edge.id()] = graphicsEdge;
+    beginTransaction();
+    const bool added = m_conceptMap->addEdge(edge);
+    commitTransaction();
 
-    // 添加到概念图
-    m_conceptMap.addEdge(edge);
+    if (!added) {
+        return nullptr;
+    }
 
     // 发送信号
     emit edgeAdded(edge);
 
-    return graphicsEdge;
+    return graphicsEdgeById(edge.id());
 }
 
 /**
@@ -135,36 +232,42 @@ GraphicsEdge* GraphicsScene::addEdge(const ConceptEdge& edge)
  * @param edgeId 连接线ID
  * @return 如果成功删除返回 true，否则返回 false
  */
-bool GraphicsScene::removeEdge(const QString& edgeId)
+bool GraphicsScene::removeEdge(EdgeId edgeId)
 {
-    GraphicsEdge* graphicsEdge = graphicsEdgeById(edgeId);
-    if (!graphicsEdge) {
+    beginTransaction();
+    const bool removed = m_conceptMap->removeEdge(edgeId);
+    commitTransaction();
+
+    if (!removed) {
         return false;
     }
 
-    // 从场景中移除
-    removeItem(graphicsEdge);
-    delete graphicsEdge;
-
-    // 从映射中移除
-    m_graphicsEdges.remove(edgeId);
-
-    // 从概念图中移除
-    m_conceptMap.removeEdge(edgeId);
-
     // 发送信号
     emit edgeRemoved(edgeId);
-    emit sceneChanged();
 
     return true;
 }
 
+/**
+ * @brief 更新连接线
+ * @param edge 新的连接线数据
+ * @return 如果成功更新返回 true，否则返回 false
+ */
+bool GraphicsScene::updateEdge(const ConceptEdge& edge)
+{
+    beginTransaction();
+    const bool updated = m_conceptMap->updateEdge(edge);
+    commitTransaction();
+
+    return updated;
+}
+
 /**
  * @brief 根据ID获取图形节点
  * @param nodeId 节点ID
  * @return 图形节点指针，如果不存在则返回 nullptr
  */
-GraphicsNode* GraphicsScene::graphicsNodeById(const QString& nodeId)
+GraphicsNode* GraphicsScene::graphicsNodeById(NodeId nodeId)
 {
     return m_graphicsNodes.value(nodeId, nullptr);
 }
@@ -174,7 +277,7 @@ GraphicsNode* GraphicsScene::graphicsNodeById(const QString& nodeId)
  * @param edgeId 连接线ID
  * @return 图形连接线指针，如果不存在则返回 nullptr
  */
-GraphicsEdge* GraphicsScene::graphicsEdgeById(const QString& edgeId)
+GraphicsEdge* GraphicsScene::graphicsEdgeById(EdgeId edgeId)
 {
     return m_graphicsEdges.value(edgeId, nullptr);
 }
@@ -227,27 +330,43 @@ QList<GraphicsEdge*> GraphicsScene::allEdges() const
     return m_graphicsEdges.values();
 }
 
+/**
+ * @brief 视图停下后按可见区域更新图形项的绘制缓存
+ * @param rect 可见区域（场景坐标）
+ * @param scale 视图缩放比例
+ */
+void GraphicsScene::updateRenderCache(const QRectF& rect, qreal scale)
+{
+    QList<QGraphicsItem*> visible;
+    for (QGraphicsItem* item : items(rect)) {
+        if (item->type() == GraphicsNode::Type || item->type() == GraphicsEdge::Type) {
+            visible.append(item);
+        }
+    }
+    m_renderCache.updateVisible(visible, scale);
+}
+
 /**
  * @brief 清空场景
  */
 void GraphicsScene::clearScene()
 {
+    stopPopulating();
+
     // 清空图形连接线
     for (GraphicsEdge* edge : m_graphicsEdges) {
-        removeItem(edge);
-        delete edge;
+        destroyItem(edge);
     }
     m_graphicsEdges.clear();
 
     // 清空图形节点
     for (GraphicsNode* node : m_graphicsNodes) {
-        removeItem(node);
-        delete node;
+        destroyItem(node);
     }
     m_graphicsNodes.clear();
 
     // 不清空概念图数据，因为clearScene只负责清空图形元素
-    // m_conceptMap.clear();
+    // m_conceptMap->clear();
 }
 
 /**
@@ -258,26 +377,166 @@ void GraphicsScene::refreshScene()
     // 清空场景
     clearScene();
 
-    // 重新添加节点
-    for (const ConceptNode& node : m_conceptMap.nodes()) {
-        GraphicsNode* graphicsNode = new GraphicsNode(node);
-        addItem(graphicsNode);
-        m_graphicsNodes[node.id()] = graphicsNode;
+    const ConceptMap& map = *m_conceptMap;
+    const int total = map.nodeCount() + map.edgeCount();
+    const QRectF visible = visibleSceneRect();
+
+    // 小概念图或没有视图时一次创建全部图形项
+    if (total <= ProgressiveThreshold || visible.isEmpty()) {
+        for (const ConceptNode& node : map.allNodes()) {
+            createGraphicsNode(node.id());
+        }
+        for (const ConceptEdge& edge : map.allEdges()) {
+            createGraphicsEdge(edge.id());
+        }
+        update();
+        return;
     }
 
-    // 重新添加连接线
-    for (const ConceptEdge& edge : m_conceptMap.edges()) {
-        GraphicsNode* sourceNode = graphicsNodeById(edge.sourceNodeId());
-        GraphicsNode* targetNode = graphicsNodeById(edge.targetNodeId());
+    // 先创建可见区域周围的节点，以及从它们连出去的连接线（另一端节点一并创建）
+    const QRectF focus = visible.adjusted(-visible.width() * ViewportMargin, -visible.height() * ViewportMargin,
+                                          visible.width() * ViewportMargin, visible.height() * ViewportMargin);
+    for (NodeId nodeId : map.nodesIntersecting(focus)) {
+        createGraphicsNode(nodeId);
+        for (EdgeId edgeId : map.edgeIdsByNodeId(nodeId)) {
+            if (const ConceptEdge* edge = map.edgeById(edgeId)) {
+                createGraphicsNode(edge->sourceNodeId());
+                createGraphicsNode(edge->targetNodeId());
+                createGraphicsEdge(edgeId);
+            }
+        }
+    }
 
-        if (sourceNode && targetNode) {
-            GraphicsEdge* graphicsEdge = new GraphicsEdge(edge, sourceNode, targetNode);
-            addItem(graphicsEdge);
-            m_graphicsEdges[edge.id()] = graphicsEdge;
+    // 其余的记下ID，由事件循环分批创建（已创建的在创建时跳过）
+    m_pendingNodes.reserve(map.nodeCount());
+    for (const ConceptNode& node : map.allNodes()) {
+        if (!m_graphicsNodes.contains(node.id())) {
+            m_pendingNodes.append(node.id());
         }
     }
+    m_pendingEdges.reserve(map.edgeCount());
+    for (const ConceptEdge& edge : map.allEdges()) {
+        if (!m_graphicsEdges.contains(edge.id())) {
+            m_pendingEdges.append(edge.id());
+        }
+    }
+    m_populateTotal = total;
+    m_populateTimer.start();
 
     update();
+    emit populationProgress(m_graphicsNodes.size() + m_graphicsEdges.size(), m_populateTotal);
+}
+
+/**
+ * @brief 为概念图中的节点创建图形节点（已存在时直接返回）
+ * @param nodeId 节点ID
+ * @return 图形节点指针，节点不存在时返回 nullptr
+ */
+GraphicsNode* GraphicsScene::createGraphicsNode(NodeId nodeId)
+{
+    if (GraphicsNode* graphicsNode = m_graphicsNodes.value(nodeId, nullptr)) {
+        return graphicsNode;
+    }
+    if (!m_conceptMap->hasNode(nodeId)) {
+        return nullptr;
+    }
+
+    GraphicsNode* graphicsNode = new GraphicsNode(m_conceptMap, nodeId);
+    addItem(graphicsNode);
+    m_graphicsNodes[nodeId] = graphicsNode;
+    trackNodePosition(graphicsNode);
+    return graphicsNode;
+}
+
+/**
+ * @brief 为概念图中的连接线创建图形连接线（已存在时直接返回）
+ * @param edgeId 连接线ID
+ * @return 图形连接线指针，连接线或端点的图形节点不存在时返回 nullptr
+ */
+GraphicsEdge* GraphicsScene::createGraphicsEdge(EdgeId edgeId)
+{
+    if (GraphicsEdge* graphicsEdge = m_graphicsEdges.value(edgeId, nullptr)) {
+        return graphicsEdge;
+    }
+    const ConceptEdge* edge = m_conceptMap->edgeById(edgeId);
+    if (!edge) {
+        return nullptr;
+    }
+
+    GraphicsNode* sourceNode = graphicsNodeById(edge->sourceNodeId());
+    GraphicsNode* targetNode = graphicsNodeById(edge->targetNodeId());
+    if (!sourceNode || !targetNode) {
+        return nullptr;
+    }
+
+    GraphicsEdge* graphicsEdge = new GraphicsEdge(m_conceptMap, edgeId, sourceNode, targetNode);
+    addItem(graphicsEdge);
+    m_graphicsEdges[edgeId] = graphicsEdge;
+    return graphicsEdge;
+}
+
+/**
+ * @brief 获取所有视图可见区域的并集（场景坐标）
+ * @return 可见区域，没有视图时返回空矩形
+ */
+QRectF GraphicsScene::visibleSceneRect() const
+{
+    QRectF visible;
+    for (QGraphicsView* view : views()) {
+        visible |= view->mapToScene(view->viewport()->rect()).boundingRect();
+    }
+    return visible;
+}
+
+/**
+ * @brief 创建一批等待中的图形项，用完时间预算后把剩余的留给下一批
+ */
+void GraphicsScene::populateBatch()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 每创建这么多项检查一次时间，避免频繁读时钟
+    constexpr int CheckInterval = 64;
+    int count = 0;
+    auto outOfTime = [&]() {
+        return ++count % CheckInterval == 0 && timer.elapsed() >= BatchBudget;
+    };
+
+    // 节点全部创建之后再创建连接线，保证端点已经存在
+    while (m_pendingNodeIndex < m_pendingNodes.size()) {
+        createGraphicsNode(m_pendingNodes.at(m_pendingNodeIndex++));
+        if (outOfTime()) {
+            emit populationProgress(m_graphicsNodes.size() + m_graphicsEdges.size(), m_populateTotal);
+            return;
+        }
+    }
+    while (m_pendingEdgeIndex < m_pendingEdges.size()) {
+        createGraphicsEdge(m_pendingEdges.at(m_pendingEdgeIndex++));
+        if (outOfTime()) {
+            emit populationProgress(m_graphicsNodes.size() + m_graphicsEdges.size(), m_populateTotal);
+            return;
+        }
+    }
+
+    stopPopulating();
+    emit populationProgress(m_populateTotal, m_populateTotal);
+    emit populationFinished();
+}
+
+/**
+ * @brief 停止分批创建并清空等待列表
+ */
+void GraphicsScene::stopPopulating()
+{
+    m_populateTimer.stop();
+    m_pendingNodes.clear();
+    m_pendingNodes.squeeze();
+    m_pendingEdges.clear();
+    m_pendingEdges.squeeze();
+    m_pendingNodeIndex = 0;
+    m_pendingEdgeIndex = 0;
+    m_populateTotal = 0;
 }
 
 /**
@@ -318,6 +577,12 @@ void GraphicsScene::mousePressEvent(QGraphicsSceneMouseEvent* event)
 
     QGraphicsScene::mousePressEvent(event);
 
+    // 拖动节点时相连的连接线每帧都在变，不缓存
+    if (event->button() == Qt::LeftButton && mouseGrabberItem()
+        && mouseGrabberItem()->type() == GraphicsNode::Type) {
+        setDraggedEdgesInteractive(true);
+    }
+
     // 检查选中的项
     QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
     if (item) {
@@ -405,7 +670,7 @@ void GraphicsScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
             GraphicsNode* targetNode = qgraphicsitem_cast<GraphicsNode*>(item);
             if (targetNode && targetNode != m_edgeSourceNode) {
                 // 创建连接线
-                ConceptEdge edge(m_edgeSourceNode->id(), targetNode->id(), "连接", QColor(100, 100, 100));
+                ConceptEdge edge(m_edgeSourceNode->id(), targetNode->id(), ConceptEdge::defaultLabel(), QColor(100, 100, 100));
                 addEdge(edge);
             }
         }
@@ -420,6 +685,7 @@ void GraphicsScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 
     if (event->button() == Qt::LeftButton) {
         m_isDragging = false;
+        setDraggedEdgesInteractive(false);
     }
 }
 
@@ -447,6 +713,24 @@ void GraphicsScene::keyPressEvent(QKeyEvent* event)
     QGraphicsScene::keyPressEvent(event);
 }
 
+/**
+ * @brief 把图形节点的位置变化同步到概念图数据
+ * @param graphicsNode 图形节点
+ */
+void GraphicsScene::trackNodePosition(GraphicsNode* graphicsNode)
+{
+    const NodeId nodeId = graphicsNode->id();
+    connect(graphicsNode, &GraphicsNode::positionChanged, this, [this, nodeId](const QPointF& pos) {
+        // 图形项已经在新位置上，只需写回数据并通知其它观察者
+        m_conceptMap->beginTransaction();
+        m_conceptMap->setNodePos(nodeId, pos);
+        const ChangeSet changes = m_conceptMap->commit();
+        if (!changes.isEmpty()) {
+            emit changesCommitted(changes);
+        }
+    });
+}
+
 /**
  * @brief 更新连接线位置
  */
@@ -456,3 +740,57 @@ void GraphicsScene::updateEdgePositions()
         edge->updatePosition();
     }
 }
+
+/**
+ * @brief 删除图形项（先从绘制缓存策略中移除）
+ * @param item 图形项
+ */
+void GraphicsScene::destroyItem(QGraphicsItem* item)
+{
+    m_renderCache.forget(item);
+    if (item->type() == GraphicsEdge::Type) {
+        m_draggedEdges.removeOne(static_cast<GraphicsEdge*>(item));
+    }
+    removeItem(item);
+    delete item;
+}
+
+/**
+ * @brief 设置被拖动节点相连的连接线是否处于交互中（交互中不缓存）
+ * @param interactive 是否处于交互中
+ */
+void GraphicsScene::setDraggedEdgesInteractive(bool interactive)
+{
+    if (!interactive) {
+        for (GraphicsEdge* edge : m_draggedEdges) {
+            m_renderCache.setInteractive(edge, false);
+        }
+        m_draggedEdges.clear();
+        return;
+    }
+
+    // 被拖动的是按下的节点和所有选中的可移动项
+    QList<QGraphicsItem*> moving = selectedItems();
+    moving.append(mouseGrabberItem());
+    QSet<GraphicsEdge*> edges;
+    for (QGraphicsItem* item : moving) {
+        GraphicsNode* node = qgraphicsitem_cast<GraphicsNode*>(item);
+        if (!node) {
+            continue;
+        }
+        for (const ConceptEdge& edge : m_conceptMap->outEdges(node->id())) {
+            if (GraphicsEdge* graphicsEdge = graphicsEdgeById(edge.id())) {
+                edges.insert(graphicsEdge);
+            }
+        }
+        for (const ConceptEdge& edge : m_conceptMap->inEdges(node->id())) {
+            if (GraphicsEdge* graphicsEdge = graphicsEdgeById(edge.id())) {
+                edges.insert(graphicsEdge);
+            }
+        }
+    }
+    for (GraphicsEdge* edge : edges) {
+        m_renderCache.setInteractive(edge, true);
+        m_draggedEdges.append(edge);
+    }
+}
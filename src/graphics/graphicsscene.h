@@ -3,10 +3,14 @@
 
 #include <QGraphicsScene>
 #include <QGraphicsItem>
+#include <QHash>
 #include <QPointF>
+#include <QTimer>
+#include <QVector>
 #include "conceptmap.h"
 #include "graphicsnode.h"
 #include "graphicsedge.h"
+#include "rendercachemanager.h"
 
 /**
  * @brief 图形场景类（继承 QGraphicsScene）
@@ -16,12 +20,25 @@
  * - 节点和连接线的添加、删除
  * - 事件处理
  * - 场景缩放和平移
+ *
+ * 场景不保存概念图数据的副本，而是绑定到外部的概念图数据（通常由 MapModel 持有），
+ * 图形项按ID从中读取。场景对数据的每次修改都会发出 changesCommitted() 信号，
+ * 其它观察者据此增量更新；外部对数据的修改通过 applyChanges() 同步到图形项。
+ * 未绑定时使用场景内部的概念图数据。
+ *
+ * 大概念图（超过 ProgressiveThreshold 条记录）重建时分批创建图形项：先创建视图
+ * 可见区域（及周围一圈）内的节点和与它们相连的连接线，立即显示；其余的图形项由
+ * 事件循环驱动，每批最多占用 BatchBudget 毫秒，期间界面保持可交互。
  */
 class GraphicsScene : public QGraphicsScene
 {
     Q_OBJECT
 
 public:
+    static constexpr int ProgressiveThreshold = 5000;  // 记录数超过该值时分批创建图形项
+    static constexpr int BatchBudget = 8;              // 每批创建图形项的时间预算（毫秒）
+    static constexpr qreal ViewportMargin = 0.5;       // 优先区域在可见区域四周扩展的比例
+
     /**
      * @brief 构造函数 - 创建一个图形场景
      * @param parent 父对象
@@ -34,21 +51,56 @@ public:
     ~GraphicsScene();
 
     /**
-     * @brief 设置概念图数据
-     * @param map 概念图数据
+     * @brief 绑定概念图数据并重建所有图形项
+     * @param map 概念图数据（不拥有），传入 nullptr 时使用场景内部的数据
      */
-    void setConceptMap(const ConceptMap& map);
+    void setConceptMap(ConceptMap* map);
 
     /**
      * @brief 获取概念图数据
      * @return 概念图数据
      */
-    ConceptMap conceptMap() const { return m_conceptMap; }
+    const ConceptMap& conceptMap() const { return *m_conceptMap; }
+
+    /**
+     * @brief 创建概念图的只读快照（可交给后台线程读取）
+     * @return 快照
+     */
+    ConceptMapSnapshot snapshot() const { return m_conceptMap->snapshot(); }
+
+    /**
+     * @brief 开始批量修改
+     *
+     * 之后通过 editableMap() 对概念图数据的修改不会立即反映到图形项，
+     * 而是在 commitTransaction() 时按变更记录一次性同步。
+     */
+    void beginTransaction();
+
+    /**
+     * @brief 获取可修改的概念图数据（应在事务中使用）
+     * @return 概念图数据
+     */
+    ConceptMap& editableMap() { return *m_conceptMap; }
+
+    /**
+     * @brief 提交批量修改，并把变更同步到图形项
+     * @return 本次事务的变更记录
+     */
+    ChangeSet commitTransaction();
+
+    /**
+     * @brief 按变更记录同步图形项
+     *
+     * 只创建、删除或更新受影响的图形项，图形项以当前概念图数据为准。
+     *
+     * @param changes 变更记录
+     */
+    void applyChanges(const ChangeSet& changes);
 
     /**
      * @brief 添加节点
      * @param node 概念节点数据
-     * @return 图形节点指针
+     * @return 图形节点指针，添加失败或处于批量修改中时返回 nullptr
      */
     GraphicsNode* addNode(const ConceptNode& node);
 
@@ -57,12 +109,19 @@ public:
      * @param nodeId 节点ID
      * @return 如果成功删除返回 true，否则返回 false
      */
-    bool removeNode(const QString& nodeId);
+    bool removeNode(NodeId nodeId);
+
+    /**
+     * @brief 更新节点
+     * @param node 新的节点数据
+     * @return 如果成功更新返回 true，否则返回 false
+     */
+    bool updateNode(const ConceptNode& node);
 
     /**
      * @brief 添加连接线
      * @param edge 概念连接线数据
-     * @return 图形连接线指针
+     * @return 图形连接线指针，添加失败或处于批量修改中时返回 nullptr
      */
     GraphicsEdge* addEdge(const ConceptEdge& edge);
 
@@ -71,21 +130,41 @@ public:
      * @param edgeId 连接线ID
      * @return 如果成功删除返回 true，否则返回 false
      */
-    bool removeEdge(const QString& edgeId);
+    bool removeEdge(EdgeId edgeId);
+
+    /**
+     * @brief 更新连接线
+     * @param edge 新的连接线数据
+     * @return 如果成功更新返回 true，否则返回 false
+     */
+    bool updateEdge(const ConceptEdge& edge);
 
     /**
      * @brief 根据ID获取图形节点
      * @param nodeId 节点ID
      * @return 图形节点指针，如果不存在则返回 nullptr
      */
-    GraphicsNode* graphicsNodeById(const QString& nodeId);
+    GraphicsNode* graphicsNodeById(NodeId nodeId);
 
     /**
      * @brief 根据ID获取图形连接线
      * @param edgeId 连接线ID
      * @return 图形连接线指针，如果不存在则返回 nullptr
      */
-    GraphicsEdge* graphicsEdgeById(const QString& edgeId);
+    GraphicsEdge* graphicsEdgeById(EdgeId edgeId);
+
+    /**
+     * @brief 获取图形项的绘制缓存策略
+     * @return 缓存策略
+     */
+    RenderCacheManager& renderCache() { return m_renderCache; }
+
+    /**
+     * @brief 视图停下后按可见区域更新图形项的绘制缓存
+     * @param rect 可见区域（场景坐标）
+     * @param scale 视图缩放比例
+     */
+    void updateRenderCache(const QRectF& rect, qreal scale);
 
     /**
      * @brief 获取所有选中的节点
@@ -117,11 +196,25 @@ public:
     void clearScene();
 
     /**
-     * @brief 刷新场景
+     * @brief 刷新场景（按概念图数据重建所有图形项）
+     *
+     * 大概念图先创建可见区域内的图形项，其余的在之后分批创建。
      */
     void refreshScene();
 
+    /**
+     * @brief 检查是否还有图形项等待分批创建
+     * @return 如果正在分批创建返回 true，否则返回 false
+     */
+    bool isPopulating() const { return m_populateTimer.isActive(); }
+
 signals:
+    /**
+     * @brief 场景修改概念图数据后发出的信号
+     * @param changes 变更记录
+     */
+    void changesCommitted(const ChangeSet& changes);
+
     /**
      * @brief 节点添加信号
      * @param node 添加的节点
@@ -132,7 +225,7 @@ signals:
      * @brief 节点删除信号
      * @param nodeId 删除的节点ID
      */
-    void nodeRemoved(const QString& nodeId);
+    void nodeRemoved(NodeId nodeId);
 
     /**
      * @brief 连接线添加信号
@@ -144,25 +237,37 @@ signals:
      * @brief 连接线删除信号
      * @param edgeId 删除的连接线ID
      */
-    void edgeRemoved(const QString& edgeId);
+    void edgeRemoved(EdgeId edgeId);
 
     /**
      * @brief 节点选中信号
      * @param nodeId 选中的节点ID
      */
-    void nodeSelected(const QString& nodeId);
+    void nodeSelected(NodeId nodeId);
 
     /**
      * @brief 连接线选中信号
      * @param edgeId 选中的连接线ID
      */
-    void edgeSelected(const QString& edgeId);
+    void edgeSelected(EdgeId edgeId);
 
     /**
      * @brief 场景变化信号
      */
     void sceneChanged();
 
+    /**
+     * @brief 分批创建图形项的进度信号
+     * @param created 已创建的图形项数量
+     * @param total 图形项总数
+     */
+    void populationProgress(int created, int total);
+
+    /**
+     * @brief 所有图形项创建完成信号（只在分批创建时发出）
+     */
+    void populationFinished();
+
 protected:
     /**
      * @brief 鼠标按下事件处理
@@ -194,14 +299,71 @@ private:
      */
     void updateEdgePositions();
 
-    ConceptMap m_conceptMap;                    // 概念图数据
-    QMap<QString, GraphicsNode*> m_graphicsNodes; // 图形节点映射
-    QMap<QString, GraphicsEdge*> m_graphicsEdges; // 图形连接线映射
+    /**
+     * @brief 把图形节点的位置变化同步到概念图数据
+     * @param graphicsNode 图形节点
+     */
+    void trackNodePosition(GraphicsNode* graphicsNode);
+
+    /**
+     * @brief 为概念图中的节点创建图形节点（已存在时直接返回）
+     * @param nodeId 节点ID
+     * @return 图形节点指针，节点不存在时返回 nullptr
+     */
+    GraphicsNode* createGraphicsNode(NodeId nodeId);
+
+    /**
+     * @brief 为概念图中的连接线创建图形连接线（已存在时直接返回）
+     * @param edgeId 连接线ID
+     * @return 图形连接线指针，连接线或端点的图形节点不存在时返回 nullptr
+     */
+    GraphicsEdge* createGraphicsEdge(EdgeId edgeId);
+
+    /**
+     * @brief 获取所有视图可见区域的并集（场景坐标）
+     * @return 可见区域，没有视图时返回空矩形
+     */
+    QRectF visibleSceneRect() const;
+
+    /**
+     * @brief 创建一批等待中的图形项，用完时间预算后把剩余的留给下一批
+     */
+    void populateBatch();
+
+    /**
+     * @brief 停止分批创建并清空等待列表
+     */
+    void stopPopulating();
+
+    /**
+     * @brief 删除图形项（先从绘制缓存策略中移除）
+     * @param item 图形项
+     */
+    void destroyItem(QGraphicsItem* item);
+
+    /**
+     * @brief 设置被拖动节点相连的连接线是否处于交互中（交互中不缓存）
+     * @param interactive 是否处于交互中
+     */
+    void setDraggedEdgesInteractive(bool interactive);
+
+    ConceptMap m_localMap;                      // 未绑定外部数据时使用的概念图数据
+    ConceptMap* m_conceptMap;                   // 当前绑定的概念图数据（不拥有）
+    QHash<NodeId, GraphicsNode*> m_graphicsNodes; // 图形节点映射
+    QHash<EdgeId, GraphicsEdge*> m_graphicsEdges; // 图形连接线映射
     bool m_isDragging;                          // 是否正在拖拽
     QPointF m_dragStartPos;                     // 拖拽起始位置
     bool m_isCreatingEdge;                      // 是否正在创建连接线
     GraphicsNode* m_edgeSourceNode;              // 连接线源节点
     QGraphicsLineItem* m_tempEdgeLine;          // 临时连接线（用于拖拽预览）
+    QTimer m_populateTimer;                     // 驱动分批创建图形项
+    QVector<NodeId> m_pendingNodes;             // 等待创建的节点
+    QVector<EdgeId> m_pendingEdges;             // 等待创建的连接线（节点全部创建后处理）
+    int m_pendingNodeIndex;                     // 下一个要创建的节点在等待列表中的位置
+    int m_pendingEdgeIndex;                     // 下一个要创建的连接线在等待列表中的位置
+    int m_populateTotal;                        // 本次重建的图形项总数
+    RenderCacheManager m_renderCache;           // 图形项的绘制缓存策略
+    QList<GraphicsEdge*> m_draggedEdges;        // 拖动中的节点相连的连接线
 };
 
 #endif // GRAPHICSSCENE_H
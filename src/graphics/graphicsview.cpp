@@ -1,6 +1,10 @@
 #include "graphicsview.h"
 #include <QPainter>
 #include <QScrollBar>
+#include <QResizeEvent>
+#include <QPaintEvent>
+#include <QElapsedTimer>
+#include <QVarLengthArray>
 #include <QApplication>
 #include <QDebug>
 
@@ -30,7 +34,10 @@ GraphicsView::GraphicsView(GraphicsScene* scene, QWidget* parent)
 
     // 设置拖拽模式
     setDragMode(QGraphicsView::RubberBandDrag);
-    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+
+    // 只重绘变化的区域（悬停、选中只重绘对应的图形项），背景来自缓存的位图
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+    setCacheMode(QGraphicsView::CacheBackground);
 
     // 设置滚动条策略
     setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
@@ -44,6 +51,17 @@ GraphicsView::GraphicsView(GraphicsScene* scene, QWidget* parent)
 
     // 启用鼠标追踪
     setMouseTracking(true);
+
+    // 滚动和缩放停下后才通知可见区域变化，并按新的可见区域和比例选择绘制缓存
+    m_visibleRectTimer.setSingleShot(true);
+    m_visibleRectTimer.setInterval(VisibleRectDelay);
+    connect(&m_visibleRectTimer, &QTimer::timeout, this, [this]() {
+        const QRectF rect = visibleSceneRect();
+        if (GraphicsScene* conceptScene = qobject_cast<GraphicsScene*>(scene())) {
+            conceptScene->updateRenderCache(rect, m_zoomScale);
+        }
+        emit visibleRectChanged(rect);
+    });
 }
 
 /**
@@ -69,6 +87,11 @@ void GraphicsView::setZoomScale(qreal scale)
     // 计算缩放因子
     qreal scaleFactor = scale / m_zoomScale;
 
+    // 缩放过程中只缩放已缓存的位图，停下后再按新比例重绘
+    if (GraphicsScene* conceptScene = qobject_cast<GraphicsScene*>(scene())) {
+        conceptScene->renderCache().beginZoom();
+    }
+
     // 应用缩放
     QGraphicsView::scale(scaleFactor, scaleFactor);
 
@@ -77,6 +100,7 @@ void GraphicsView::setZoomScale(qreal scale)
 
     // 发送信号
     emit zoomChanged(m_zoomScale);
+    scheduleVisibleRectChanged();
 }
 
 /**
@@ -113,14 +137,22 @@ void GraphicsView::fitInView()
         return;
     }
 
-    // 适应场景中的所有项
-    QGraphicsView::fitInView(scene()->sceneRect(), Qt::KeepAspectRatio);
+    // 适应概念图中的所有节点（包围盒由几何列存储直接算出，不遍历图形项）
+    QRectF targetRect = scene()->sceneRect();
+    GraphicsScene* conceptScene = qobject_cast<GraphicsScene*>(scene());
+    if (conceptScene && conceptScene->conceptMap().nodeCount() > 0) {
+        const qreal margin = 20.0;
+        targetRect = conceptScene->conceptMap().nodesBoundingRect()
+                         .adjusted(-margin, -margin, margin, margin);
+    }
+    QGraphicsView::fitInView(targetRect, Qt::KeepAspectRatio);
 
     // 更新缩放比例
     m_zoomScale = transform().m11();
 
     // 发送信号
     emit zoomChanged(m_zoomScale);
+    scheduleVisibleRectChanged();
 }
 
 /**
@@ -271,6 +303,71 @@ void GraphicsView::keyPressEvent(QKeyEvent* event)
     QGraphicsView::keyPressEvent(event);
 }
 
+/**
+ * @brief 滚动内容，之后通知可见区域变化
+ * @param dx 水平滚动量
+ * @param dy 垂直滚动量
+ */
+void GraphicsView::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+    scheduleVisibleRectChanged();
+}
+
+/**
+ * @brief 设置是否缓存背景（网格和坐标轴）
+ * @param cached 是否缓存
+ */
+void GraphicsView::setBackgroundCached(bool cached)
+{
+    setCacheMode(cached ? QGraphicsView::CacheBackground : QGraphicsView::CacheNone);
+    resetCachedContent();
+    viewport()->update();
+}
+
+/**
+ * @brief 绘制事件处理，记录耗时和重绘区域
+ * @param event 绘制事件
+ */
+void GraphicsView::paintEvent(QPaintEvent* event)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    m_paintStatistics.nanoseconds += timer.nsecsElapsed();
+    ++m_paintStatistics.frames;
+    for (const QRect& rect : event->region()) {
+        m_paintStatistics.pixels += qint64(rect.width()) * rect.height();
+    }
+}
+
+/**
+ * @brief 改变大小事件处理，之后通知可见区域变化
+ * @param event 改变大小事件
+ */
+void GraphicsView::resizeEvent(QResizeEvent* event)
+{
+    QGraphicsView::resizeEvent(event);
+    scheduleVisibleRectChanged();
+}
+
+/**
+ * @brief 获取当前可见的场景区域
+ * @return 场景矩形
+ */
+QRectF GraphicsView::visibleSceneRect() const
+{
+    return mapToScene(viewport()->rect()).boundingRect();
+}
+
+/**
+ * @brief 安排稍后发出 visibleRectChanged()
+ */
+void GraphicsView::scheduleVisibleRectChanged()
+{
+    m_visibleRectTimer.start();
+}
+
 /**
  * @brief 绘制背景事件处理
  * @param painter 绘制器
@@ -308,15 +405,15 @@ void GraphicsView::drawGrid(QPainter* painter, const QRectF& rect)
     qreal left = qFloor(rect.left() / m_gridSize) * m_gridSize;
     qreal top = qFloor(rect.top() / m_gridSize) * m_gridSize;
 
-    // 绘制垂直线
+    // 收集所有网格线后一次绘制
+    QVarLengthArray<QLineF, 256> lines;
     for (qreal x = left; x < rect.right(); x += m_gridSize) {
-        painter->drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+        lines.append(QLineF(x, rect.top(), x, rect.bottom()));
     }
-
-    // 绘制水平线
     for (qreal y = top; y < rect.bottom(); y += m_gridSize) {
-        painter->drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+        lines.append(QLineF(rect.left(), y, rect.right(), y));
     }
+    painter->drawLines(lines.constData(), int(lines.size()));
 
     painter->restore();
 }
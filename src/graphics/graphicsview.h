@@ -6,6 +6,7 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QPointF>
+#include <QTimer>
 #include "graphicsscene.h"
 
 /**
@@ -16,12 +17,27 @@
  * - 平移功能
  * - 视图控制
  * - 鼠标和键盘事件处理
+ *
+ * 滚动、缩放和改变大小后发出 visibleRectChanged()，连续变化时合并为一次，
+ * 供按需载入的概念图跟随可见区域分页。
  */
 class GraphicsView : public QGraphicsView
 {
     Q_OBJECT
 
 public:
+    static constexpr int VisibleRectDelay = 50;    // 可见区域变化后等待合并的时间（毫秒）
+
+    /**
+     * @brief 视口绘制统计（用于比较不同的更新模式）
+     */
+    struct PaintStatistics
+    {
+        qint64 frames = 0;          // 绘制次数
+        qint64 nanoseconds = 0;     // 绘制总耗时
+        qint64 pixels = 0;          // 重绘区域的总像素数
+    };
+
     /**
      * @brief 构造函数 - 创建一个图形视图
      * @param scene 图形场景
@@ -95,6 +111,39 @@ public:
      */
     bool isZoomingEnabled() const { return m_zoomingEnabled; }
 
+    /**
+     * @brief 获取当前可见的场景区域
+     * @return 场景矩形
+     */
+    QRectF visibleSceneRect() const;
+
+    /**
+     * @brief 设置是否缓存背景（网格和坐标轴）
+     *
+     * 缓存时背景画在视口大小的位图上，只在缩放或视口改变大小时重画，
+     * 滚动时只补画新露出的部分。
+     *
+     * @param cached 是否缓存
+     */
+    void setBackgroundCached(bool cached);
+
+    /**
+     * @brief 检查是否缓存背景
+     * @return 如果缓存返回 true，否则返回 false
+     */
+    bool isBackgroundCached() const { return cacheMode().testFlag(QGraphicsView::CacheBackground); }
+
+    /**
+     * @brief 获取视口绘制统计
+     * @return 统计数据
+     */
+    PaintStatistics paintStatistics() const { return m_paintStatistics; }
+
+    /**
+     * @brief 清零视口绘制统计
+     */
+    void resetPaintStatistics() { m_paintStatistics = PaintStatistics(); }
+
 signals:
     /**
      * @brief 视图缩放信号
@@ -108,6 +157,12 @@ signals:
      */
     void viewPanned(const QPointF& delta);
 
+    /**
+     * @brief 可见区域变化信号（连续变化时只在停下后发出一次）
+     * @param rect 可见的场景区域
+     */
+    void visibleRectChanged(const QRectF& rect);
+
 protected:
     /**
      * @brief 鼠标滚轮事件处理
@@ -139,6 +194,25 @@ protected:
      */
     void keyPressEvent(QKeyEvent* event) override;
 
+    /**
+     * @brief 滚动内容，之后通知可见区域变化
+     * @param dx 水平滚动量
+     * @param dy 垂直滚动量
+     */
+    void scrollContentsBy(int dx, int dy) override;
+
+    /**
+     * @brief 绘制事件处理，记录耗时和重绘区域
+     * @param event 绘制事件
+     */
+    void paintEvent(QPaintEvent* event) override;
+
+    /**
+     * @brief 改变大小事件处理，之后通知可见区域变化
+     * @param event 改变大小事件
+     */
+    void resizeEvent(QResizeEvent* event) override;
+
     /**
      * @brief 绘制背景事件处理
      * @param painter 绘制器
@@ -161,6 +235,11 @@ private:
      */
     void drawAxes(QPainter* painter, const QRectF& rect);
 
+    /**
+     * @brief 安排稍后发出 visibleRectChanged()
+     */
+    void scheduleVisibleRectChanged();
+
     qreal m_zoomScale;              // 当前缩放比例
     qreal m_minZoomScale;           // 最小缩放比例
     qreal m_maxZoomScale;           // 最大缩放比例
@@ -174,6 +253,8 @@ private:
     int m_gridSize;                 // 网格大小
     QColor m_gridColor;             // 网格颜色
     QColor m_axisColor;             // 坐标轴颜色
+    QTimer m_visibleRectTimer;      // 合并连续的可见区域变化
+    PaintStatistics m_paintStatistics; // 视口绘制统计
 };
 
 #endif // GRAPHICSVIEW_H
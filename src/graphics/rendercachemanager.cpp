@@ -0,0 +1,227 @@
+#include "rendercachemanager.h"
+#include "detaillevel.h"
+#include <QPixmapCache>
+#include <QVector>
+#include <QPair>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief 构造函数
+ */
+RenderCacheManager::RenderCacheManager()
+    : m_budget(0)
+    , m_cost(0)
+    , m_evictions(0)
+    , m_clock(0)
+    , m_scale(1.0)
+    , m_enabled(true)
+    , m_zooming(false)
+{
+    setBudget(DefaultBudget);
+}
+
+/**
+ * @brief 启用或停用缓存（停用时取消全部缓存）
+ * @param enabled 是否启用
+ */
+void RenderCacheManager::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) {
+        clear();
+    }
+}
+
+/**
+ * @brief 设置缓存预算
+ * @param bytes 所有缓存位图的估算字节数上限
+ */
+void RenderCacheManager::setBudget(qint64 bytes)
+{
+    m_budget = qMax<qint64>(0, bytes);
+
+    // 图形项的缓存位图存放在 QPixmapCache 中，它的上限不能比预算小，
+    // 否则位图会在我们的淘汰之前被它丢掉，每次绘制都重新生成
+    const int budgetKiB = int(qMin<qint64>(m_budget / 1024, std::numeric_limits<int>::max() / 2));
+    if (QPixmapCache::cacheLimit() < budgetKiB * 2) {
+        QPixmapCache::setCacheLimit(budgetKiB * 2);
+    }
+    evict();
+}
+
+/**
+ * @brief 缩放开始：已缓存的图形项改为按图形项坐标缓存
+ */
+void RenderCacheManager::beginZoom()
+{
+    if (m_zooming) {
+        return;
+    }
+    m_zooming = true;
+    const QList<QGraphicsItem*> cached = m_entries.keys();
+    for (QGraphicsItem* item : cached) {
+        apply(item);
+    }
+}
+
+/**
+ * @brief 视图停下后为可见的图形项选择缓存模式，并按预算淘汰
+ * @param items 可见的图形项
+ * @param scale 视图缩放比例
+ */
+void RenderCacheManager::updateVisible(const QList<QGraphicsItem*>& items, qreal scale)
+{
+    const bool rescaled = !qFuzzyCompare(scale, m_scale);
+    m_zooming = false;
+    m_scale = scale;
+    ++m_clock;
+
+    // 比例变了，不可见的旧缓存也要按新比例重新估算（或取消）
+    if (rescaled) {
+        const QList<QGraphicsItem*> cached = m_entries.keys();
+        for (QGraphicsItem* item : cached) {
+            apply(item);
+        }
+    }
+
+    for (QGraphicsItem* item : items) {
+        apply(item);
+        auto it = m_entries.find(item);
+        if (it != m_entries.end()) {
+            it->lastVisible = m_clock;
+        }
+    }
+    evict();
+}
+
+/**
+ * @brief 设置图形项是否处于交互中（交互中不缓存）
+ * @param item 图形项
+ * @param interactive 是否处于交互中
+ */
+void RenderCacheManager::setInteractive(QGraphicsItem* item, bool interactive)
+{
+    if (interactive) {
+        m_interactive.insert(item);
+        release(item);
+    } else if (m_interactive.remove(item)) {
+        apply(item);
+        auto it = m_entries.find(item);
+        if (it != m_entries.end()) {
+            it->lastVisible = ++m_clock;
+        }
+        evict();
+    }
+}
+
+/**
+ * @brief 图形项删除前调用，忘掉它的记录
+ * @param item 图形项
+ */
+void RenderCacheManager::forget(QGraphicsItem* item)
+{
+    auto it = m_entries.find(item);
+    if (it != m_entries.end()) {
+        m_cost -= it->cost;
+        m_entries.erase(it);
+    }
+    m_interactive.remove(item);
+}
+
+/**
+ * @brief 取消全部缓存
+ */
+void RenderCacheManager::clear()
+{
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        it.key()->setCacheMode(QGraphicsItem::NoCache);
+    }
+    m_entries.clear();
+    m_cost = 0;
+}
+
+/**
+ * @brief 获取缓存统计
+ * @return 统计数据
+ */
+RenderCacheManager::Statistics RenderCacheManager::statistics() const
+{
+    Statistics statistics;
+    statistics.cachedItems = int(m_entries.size());
+    statistics.cost = m_cost;
+    statistics.budget = m_budget;
+    statistics.evictions = m_evictions;
+    return statistics;
+}
+
+/**
+ * @brief 按当前缩放比例和状态为图形项设置缓存模式
+ * @param item 图形项
+ */
+void RenderCacheManager::apply(QGraphicsItem* item)
+{
+    // 远景只画纯色方块和直线，比贴位图还便宜
+    if (!m_enabled || m_interactive.contains(item) || m_scale < DetailLevels::MinimalBelow) {
+        release(item);
+        return;
+    }
+
+    const QSize deviceSize = (item->boundingRect().size() * m_scale).toSize();
+    const qint64 pixels = qint64(deviceSize.width()) * deviceSize.height();
+    if (pixels <= 0 || pixels > MaxItemPixels) {
+        release(item);
+        return;
+    }
+
+    Entry& entry = m_entries[item];
+    const QGraphicsItem::CacheMode mode = m_zooming ? QGraphicsItem::ItemCoordinateCache
+                                                    : QGraphicsItem::DeviceCoordinateCache;
+    if (mode != entry.mode) {
+        // ItemCoordinateCache 的位图按缩放开始前的比例生成，缩放过程中保持清晰度
+        item->setCacheMode(mode, mode == QGraphicsItem::ItemCoordinateCache ? deviceSize : QSize());
+        entry.mode = mode;
+    }
+    m_cost += pixels * 4 - entry.cost;
+    entry.cost = pixels * 4;
+}
+
+/**
+ * @brief 取消图形项的缓存
+ * @param item 图形项
+ */
+void RenderCacheManager::release(QGraphicsItem* item)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end()) {
+        return;
+    }
+    item->setCacheMode(QGraphicsItem::NoCache);
+    m_cost -= it->cost;
+    m_entries.erase(it);
+}
+
+/**
+ * @brief 超出预算时取消最久未见的图形项的缓存
+ */
+void RenderCacheManager::evict()
+{
+    if (m_cost <= m_budget) {
+        return;
+    }
+
+    QVector<QPair<quint64, QGraphicsItem*>> order;
+    order.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        order.append(qMakePair(it->lastVisible, it.key()));
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& candidate : order) {
+        if (m_cost <= m_budget) {
+            break;
+        }
+        release(candidate.second);
+        ++m_evictions;
+    }
+}
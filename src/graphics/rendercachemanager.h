@@ -0,0 +1,146 @@
+#ifndef RENDERCACHEMANAGER_H
+#define RENDERCACHEMANAGER_H
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QSet>
+#include <QList>
+
+/**
+ * @brief 图形项的绘制缓存策略
+ *
+ * 按缩放比例和交互状态为节点和连接线选择 QGraphicsItem 的缓存模式：
+ * - 视图停下时：可见的图形项使用 DeviceCoordinateCache，平移和移动节点时直接贴位图
+ * - 缩放过程中：已缓存的图形项改为 ItemCoordinateCache（位图大小取缩放开始前的比例），
+ *   每一帧只缩放已有的位图，停下后再按新比例重绘一次
+ * - 拖拽中的节点相连的连接线：不缓存（几何每帧都在变，缓存只会徒增开销）
+ * - 缩小到 DetailLevel::Minimal 以下、或单个图形项超过 MaxItemPixels 像素：不缓存
+ *
+ * 所有缓存位图的估算大小（宽 × 高 × 4 字节）之和不超过预算，超出时按最近一次
+ * 可见的时间淘汰最久未见的图形项（取消它的缓存）。
+ *
+ * 缓存内容的失效由图形项自己负责：数据变化时只有外观变化的图形项调用 update()，
+ * 只移动位置不会使缓存失效。
+ */
+class RenderCacheManager
+{
+public:
+    static constexpr qint64 DefaultBudget = 64 * 1024 * 1024;  // 默认预算（字节）
+    static constexpr int MaxItemPixels = 1024 * 1024;          // 单个图形项缓存的最大像素数
+
+    /**
+     * @brief 缓存统计
+     */
+    struct Statistics
+    {
+        int cachedItems = 0;    // 当前启用缓存的图形项数量
+        qint64 cost = 0;        // 当前估算字节数
+        qint64 budget = 0;      // 预算（字节）
+        qint64 evictions = 0;   // 因超出预算被取消缓存的次数
+    };
+
+    /**
+     * @brief 构造函数
+     */
+    RenderCacheManager();
+
+    /**
+     * @brief 启用或停用缓存（停用时取消全部缓存）
+     * @param enabled 是否启用
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief 检查是否启用缓存
+     * @return 如果启用返回 true，否则返回 false
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief 设置缓存预算
+     * @param bytes 所有缓存位图的估算字节数上限
+     */
+    void setBudget(qint64 bytes);
+
+    /**
+     * @brief 获取缓存预算
+     * @return 字节数
+     */
+    qint64 budget() const { return m_budget; }
+
+    /**
+     * @brief 缩放开始：已缓存的图形项改为按图形项坐标缓存
+     */
+    void beginZoom();
+
+    /**
+     * @brief 视图停下后为可见的图形项选择缓存模式，并按预算淘汰
+     * @param items 可见的图形项
+     * @param scale 视图缩放比例
+     */
+    void updateVisible(const QList<QGraphicsItem*>& items, qreal scale);
+
+    /**
+     * @brief 设置图形项是否处于交互中（交互中不缓存）
+     * @param item 图形项
+     * @param interactive 是否处于交互中
+     */
+    void setInteractive(QGraphicsItem* item, bool interactive);
+
+    /**
+     * @brief 图形项删除前调用，忘掉它的记录
+     * @param item 图形项
+     */
+    void forget(QGraphicsItem* item);
+
+    /**
+     * @brief 取消全部缓存
+     */
+    void clear();
+
+    /**
+     * @brief 获取缓存统计
+     * @return 统计数据
+     */
+    Statistics statistics() const;
+
+private:
+    /**
+     * @brief 缓存记录
+     */
+    struct Entry
+    {
+        qint64 cost = 0;                                        // 估算字节数
+        quint64 lastVisible = 0;                                // 最近一次可见的时间戳
+        QGraphicsItem::CacheMode mode = QGraphicsItem::NoCache; // 当前缓存模式
+    };
+
+    /**
+     * @brief 按当前缩放比例和状态为图形项设置缓存模式
+     * @param item 图形项
+     */
+    void apply(QGraphicsItem* item);
+
+    /**
+     * @brief 取消图形项的缓存
+     * @param item 图形项
+     */
+    void release(QGraphicsItem* item);
+
+    /**
+     * @brief 超出预算时取消最久未见的图形项的缓存
+     */
+    void evict();
+
+    QHash<QGraphicsItem*, Entry> m_entries;     // 启用缓存的图形项
+    QSet<QGraphicsItem*> m_interactive;         // 交互中的图形项
+    qint64 m_budget;                            // 预算（字节）
+    qint64 m_cost;                              // 当前估算字节数
+    qint64 m_evictions;                         // 淘汰次数
+    quint64 m_clock;                            // 可见时间戳
+    qreal m_scale;                              // 最近一次停下时的缩放比例
+    bool m_enabled;                             // 是否启用
+    bool m_zooming;                             // 是否正在缩放
+};
+
+#endif // RENDERCACHEMANAGER_H
@@ -0,0 +1,87 @@
+#include "textlayoutcache.h"
+#include <QCache>
+#include <QTransform>
+
+namespace {
+
+/**
+ * @brief 缓存的存储和计数（只在 GUI 线程访问）
+ */
+struct CacheState
+{
+    QCache<QString, TextLayoutCache::Layout> layouts{ TextLayoutCache::MaxCost };
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+
+CacheState& state()
+{
+    static CacheState cache;
+    return cache;
+}
+
+/**
+ * @brief 估算一个条目占用的字节数（QStaticText 每个字符保存字形和位置）
+ */
+int estimateCost(const QString& key)
+{
+    return 128 + int(key.size()) * 32;
+}
+
+} // namespace
+
+/**
+ * @brief 获取排好版的文本，未命中时排版并放入缓存
+ * @param text 文本
+ * @param font 字体
+ * @param width 换行宽度，小于 0 表示不换行
+ * @return 排好版的文本
+ */
+TextLayoutCache::Layout TextLayoutCache::layout(const QString& text, const QFont& font, qreal width)
+{
+    CacheState& cache = state();
+    const QString key = font.key() + QChar(0x1f) + QString::number(width) + QChar(0x1f) + text;
+    if (const Layout* layout = cache.layouts.object(key)) {
+        ++cache.hits;
+        return *layout;
+    }
+    ++cache.misses;
+
+    Layout* layout = new Layout;
+    layout->text.setText(text);
+    layout->text.setTextFormat(Qt::PlainText);
+    layout->text.setTextWidth(width);
+    layout->text.setPerformanceHint(QStaticText::AggressiveCaching);
+    layout->text.prepare(QTransform(), font);
+    layout->size = layout->text.size();
+
+    const Layout result = *layout;
+    cache.layouts.insert(key, layout, estimateCost(key));
+    return result;
+}
+
+/**
+ * @brief 获取命中统计
+ * @return 统计数据
+ */
+TextLayoutCache::Statistics TextLayoutCache::statistics()
+{
+    const CacheState& cache = state();
+    Statistics statistics;
+    statistics.hits = cache.hits;
+    statistics.misses = cache.misses;
+    statistics.count = int(cache.layouts.count());
+    statistics.cost = int(cache.layouts.totalCost());
+    return statistics;
+}
+
+/**
+ * @brief 清空缓存和统计
+ */
+void TextLayoutCache::clear()
+{
+    CacheState& cache = state();
+    cache.layouts.clear();
+    cache.hits = 0;
+    cache.misses = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <QString>
+#include <QFont>
+#include <QSizeF>
+#include <QStaticText>
+
+/**
+ * @brief 节点文本和连接线标签共用的文本排版缓存
+ *
+ * 以（文本、字体、换行宽度）为键保存排好版的 QStaticText 和它的尺寸，
+ * 绘制时不再每次构造 QFontMetrics 重新测量。文本或字体变化后键随之变化，
+ * 旧条目不再命中，按最近最少使用淘汰；总占用按估算的字节数限制在 MaxCost 以内。
+ *
+ * 图形项只在文本或尺寸变化时（refresh()）查询一次，把结果保存在自己身上，绘制时不再查询。
+ *
+ * 只在 GUI 线程中使用（图形项的刷新），不加锁。
+ */
+class TextLayoutCache
+{
+public:
+    static constexpr int MaxCost = 4 * 1024 * 1024;    // 缓存的估算字节数上限
+
+    /**
+     * @brief 排好版的文本
+     */
+    struct Layout
+    {
+        QStaticText text;   // 排好版的文本
+        QSizeF size;        // 文本尺寸
+    };
+
+    /**
+     * @brief 命中统计
+     */
+    struct Statistics
+    {
+        qint64 hits = 0;    // 命中次数
+        qint64 misses = 0;  // 未命中（重新排版）次数
+        int count = 0;      // 当前条目数
+        int cost = 0;       // 当前估算字节数
+    };
+
+    /**
+     * @brief 获取排好版的文本，未命中时排版并放入缓存
+     * @param text 文本
+     * @param font 字体
+     * @param width 换行宽度，小于 0 表示不换行
+     * @return 排好版的文本
+     */
+    static Layout layout(const QString& text, const QFont& font, qreal width = -1);
+
+    /**
+     * @brief 获取命中统计
+     * @return 统计数据
+     */
+    static Statistics statistics();
+
+    /**
+     * @brief 清空缓存和统计
+     */
+    static void clear();
+};
+
+#endif // TEXTLAYOUTCACHE_H
@@ -1,13 +1,16 @@
 #include "filemanager.h"
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QDomDocument>
-#include <QDomElement>
+#include "conceptmapjson.h"
+#include "conceptmapxml.h"
+#include "conceptmapbinary.h"
+#include "conceptmapcompressed.h"
+#include "conceptmaptiles.h"
+#include "conceptmapjournal.h"
+#include "recordbatch.h"
+#include "operationprogress.h"
 #include <QFile>
-#include <QPainter>
-#include <QSvgGenerator>
-#include <QPrinter>
+#include <QSaveFile>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QFileInfo>
 #include <QDebug>
 
@@ -19,6 +22,11 @@ FileManager::FileManager(QObject* parent)
     : QObject(parent)
     , m_maxRecentFiles(10)
 {
+    connect(&m_exportTask, &BackgroundTask::finished, this, [this](bool success) {
+        const QString filePath = m_exportPath;
+        m_exportPath.clear();
+        emit exportFinished(filePath, success);
+    });
 }
 
 /**
@@ -29,7 +37,7 @@ FileManager::~FileManager()
 }
 
 /**
- * @brief 加载概念图文件
+ * @brief 加载概念图文件，并重放增量保存的日志
  * @param filePath 文件路径
  * @param map 概念图数据（输出参数）
  * @return 如果成功加载返回 true，否则返回 false
@@ -39,14 +47,31 @@ bool FileManager::loadMap(const QString& filePath, ConceptMap& map)
     QFileInfo fileInfo(filePath);
     QString extension = fileInfo.suffix().toLower();
 
+    bool ok = false;
     if (extension == "json") {
-        return loadJson(filePath, map);
+        ok = loadJson(filePath, map);
     } else if (extension == "xml") {
-        return loadXml(filePath, map);
+        ok = loadXml(filePath, map);
+    } else if (extension == "cmapb") {
+        ok = ConceptMapBinary::load(filePath, map);
+    } else if (extension == "cmapz") {
+        ok = loadCompressed(filePath, map);
+    } else if (extension == "cmapt") {
+        ok = ConceptMapTiles::loadRegion(filePath, QRectF(), map);
+    } else if (extension == "cmap") {
+        // 外部格式，没有增量保存的日志
+        return importFromCmap(filePath, map);
     } else {
         qWarning() << "不支持的文件格式:" << extension;
         return false;
     }
+    if (!ok) {
+        return false;
+    }
+
+    // 与编辑器读到的文档一致：重放增量保存的日志
+    ConceptMapJournal::replay(filePath, map);
+    return true;
 }
 
 /**
@@ -64,6 +89,14 @@ bool FileManager::saveMap(const QString& filePath, const ConceptMap& map)
         return saveJson(filePath, map);
     } else if (extension == "xml") {
         return saveXml(filePath, map);
+    } else if (extension == "cmapb") {
+        return ConceptMapBinary::save(filePath, map);
+    } else if (extension == "cmapz") {
+        return ConceptMapCompressed::save(filePath, map);
+    } else if (extension == "cmapt") {
+        return ConceptMapTiles::save(filePath, map);
+    } else if (extension == "cmap") {
+        return exportToCmap(filePath, map);
     } else {
         qWarning() << "不支持的文件格式:" << extension;
         return false;
@@ -71,160 +104,225 @@ bool FileManager::saveMap(const QString& filePath, const ConceptMap& map)
 }
 
 /**
- * @brief 导出为图片
- * @param filePath 图片文件路径
- * @param scene 图形场景
- * @return 如果成功导出返回 true，否则返回 false
+ * @brief 从瓦片文件（.cmapt）只加载一个区域
+ * @param filePath 文件路径
+ * @param region 区域（场景坐标）
+ * @param map 概念图数据（输出参数，失败时保持不变）
+ * @return 如果成功加载返回 true，否则返回 false
  */
-bool FileManager::exportToImage(const QString& filePath, QGraphicsScene* scene)
+bool FileManager::loadMapRegion(const QString& filePath, const QRectF& region, ConceptMap& map)
 {
-    if (!scene) {
-        qWarning() << "场景为空";
+    if (fileExtension(filePath).toLower() != "cmapt") {
+        qWarning() << "只有瓦片概念图支持部分加载:" << filePath;
         return false;
     }
+    return ConceptMapTiles::loadRegion(filePath, region, map);
+}
 
-    // 创建图片
-    QImage image(scene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-    image.fill(Qt::transparent);
-
-    // 绘制场景
-    QPainter painter(&image);
-    scene->render(&painter);
-    painter.end();
-
-    // 保存图片
-    if (!image.save(filePath)) {
-        qWarning() << "无法保存图片:" << filePath;
+/**
+ * @brief 从瓦片文件（.cmapt）只加载以若干节点为中心的子图
+ * @param filePath 文件路径
+ * @param seedUuids 种子节点的 UUID
+ * @param depth 沿连接线扩展的步数
+ * @param map 概念图数据（输出参数，失败时保持不变）
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool FileManager::loadSubgraph(const QString& filePath, const QStringList& seedUuids, int depth, ConceptMap& map)
+{
+    if (fileExtension(filePath).toLower() != "cmapt") {
+        qWarning() << "只有瓦片概念图支持部分加载:" << filePath;
         return false;
     }
-
-    return true;
+    return ConceptMapTiles::loadSubgraph(filePath, seedUuids, depth, map);
 }
 
 /**
  * @brief 导出为Cmap格式
  * @param filePath Cmap文件路径
  * @param map 概念图数据
+ * @param progress 进度（按记录），可以为 nullptr
  * @return 如果成功导出返回 true，否则返回 false
  */
-bool FileManager::exportToCmap(const QString& filePath, const ConceptMap& map)
+bool FileManager::exportToCmap(const QString& filePath, const ConceptMap& map, OperationProgress* progress)
 {
-    QDomDocument doc;
-    QDomElement root = doc.createElement("cmap");
-    doc.appendChild(root);
-    
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+
+    if (progress) {
+        progress->addTotal(map.nodeCount() + map.edgeCount());
+    }
+    ProgressReporter reporter(progress);
+
+    QXmlStreamWriter xml(&file);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+
     // 设置cmap基本属性
-    root.setAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    root.setAttribute("xsi:noNamespaceSchemaLocation", "http://cmap.ihmc.us/xml/cmap/CMAP.xsd");
-    root.setAttribute("version", "1.0");
-    root.setAttribute("name", "Concept Map");
-    
-    // 创建概念图内容
-    QDomElement conceptMap = doc.createElement("conceptmap");
-    root.appendChild(conceptMap);
-    
-    // 创建概念节点
-    QDomElement concepts = doc.createElement("concepts");
-    conceptMap.appendChild(concepts);
-    
+    const QString xsi = QStringLiteral("http://www.w3.org/2001/XMLSchema-instance");
+    xml.writeStartElement("cmap");
+    xml.writeNamespace(xsi, "xsi");
+    xml.writeAttribute(xsi, "noNamespaceSchemaLocation", "http://cmap.ihmc.us/xml/cmap/CMAP.xsd");
+    xml.writeAttribute("version", "1.0");
+    xml.writeAttribute("name", "Concept Map");
+
+    // 概念图内容
+    xml.writeStartElement("conceptmap");
+
     // 写入节点数据
-    for (const ConceptNode& node : map.nodes()) {
-        QDomElement concept = doc.createElement("concept");
-        concept.setAttribute("id", node.id());
-        concept.setAttribute("label", node.text());
-        
+    xml.writeStartElement("concepts");
+    for (const ConceptNode& node : map.allNodes()) {
+        xml.writeStartElement("concept");
+        xml.writeAttribute("id", IdRegistry::toUuid(node.id()));
+        xml.writeAttribute("label", node.text());
+
         // 位置信息
-        QDomElement location = doc.createElement("location");
-        location.setAttribute("x", QString::number(node.x() + node.width() / 2.0));
-        location.setAttribute("y", QString::number(node.y() + node.height() / 2.0));
-        concept.appendChild(location);
-        
-        concepts.appendChild(concept);
+        xml.writeEmptyElement("location");
+        xml.writeAttribute("x", QString::number(node.x() + node.width() / 2.0));
+        xml.writeAttribute("y", QString::number(node.y() + node.height() / 2.0));
+
+        xml.writeEndElement();
+        if (!reporter.step()) {
+            file.cancelWriting();
+            return false;
+        }
     }
-    
-    // 创建连接线
-    QDomElement connections = doc.createElement("connections");
-    conceptMap.appendChild(connections);
-    
+    xml.writeEndElement();
+
     // 写入连接线数据
-    for (const ConceptEdge& edge : map.edges()) {
-        QDomElement connection = doc.createElement("connection");
-        connection.setAttribute("id", edge.id());
-        connection.setAttribute("sourceId", edge.sourceNodeId());
-        connection.setAttribute("targetId", edge.targetNodeId());
-        
+    xml.writeStartElement("connections");
+    for (const ConceptEdge& edge : map.allEdges()) {
+        xml.writeStartElement("connection");
+        xml.writeAttribute("id", IdRegistry::toUuid(edge.id()));
+        xml.writeAttribute("sourceId", IdRegistry::toUuid(edge.sourceNodeId()));
+        xml.writeAttribute("targetId", IdRegistry::toUuid(edge.targetNodeId()));
+
         // 连接语
-        QDomElement linkLabel = doc.createElement("linkLabel");
-        linkLabel.setAttribute("text", edge.label());
-        connection.appendChild(linkLabel);
-        
-        connections.appendChild(connection);
+        xml.writeEmptyElement("linkLabel");
+        xml.writeAttribute("text", edge.label());
+
+        xml.writeEndElement();
+        if (!reporter.step()) {
+            file.cancelWriting();
+            return false;
+        }
     }
-    
-    // 写入文件
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "无法创建文件:" << filePath;
+    xml.writeEndElement();
+
+    xml.writeEndElement();  // conceptmap
+    xml.writeEndElement();  // cmap
+    xml.writeEndDocument();
+
+    if (xml.hasError()) {
+        qWarning() << "写入文件失败:" << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "保存文件失败:" << file.errorString();
         return false;
     }
-    
-    file.write(doc.toString().toUtf8());
-    file.close();
-    
     return true;
 }
 
 /**
- * @brief 导出为PDF
- * @param filePath PDF文件路径
- * @param scene 图形场景
- * @return 如果成功导出返回 true，否则返回 false
+ * @brief 在后台线程中导出为Cmap格式，完成后发出 exportFinished()
+ * @param filePath Cmap文件路径
+ * @param snapshot 概念图快照
+ * @return 如果已有导出在运行返回 false，否则返回 true
  */
-bool FileManager::exportToPDF(const QString& filePath, QGraphicsScene* scene)
+bool FileManager::exportToCmapAsync(const QString& filePath, const ConceptMapSnapshot& snapshot)
 {
-    if (!scene) {
-        qWarning() << "场景为空";
-        return false;
-    }
-
-    // 创建打印机
-    QPrinter printer(QPrinter::HighResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setOutputFileName(filePath);
-    printer.setPageSize(QPageSize(scene->sceneRect().size(), QPageSize::Point));
-
-    // 绘制场景
-    QPainter painter(&printer);
-    scene->render(&painter);
-    painter.end();
-
-    return true;
+    return startExport(filePath, [this, filePath, snapshot](OperationProgress& progress) {
+        return exportToCmap(filePath, *snapshot, &progress);
+    });
 }
 
 /**
- * @brief 导出为SVG
- * @param filePath SVG文件路径
- * @param scene 图形场景
- * @return 如果成功导出返回 true，否则返回 false
+ * @brief 导入Cmap格式
+ *
+ * 读取 exportToCmap() 写出的元素：概念的 UUID、标签和中心位置，连接的 UUID、
+ * 端点和连接语。Cmap 不保存节点大小和样式，这些属性取默认值。
+ *
+ * @param filePath Cmap文件路径
+ * @param map 概念图数据（输出参数，失败时保持不变）
+ * @return 如果成功导入返回 true，否则返回 false
  */
-bool FileManager::exportToSVG(const QString& filePath, QGraphicsScene* scene)
+bool FileManager::importFromCmap(const QString& filePath, ConceptMap& map)
 {
-    if (!scene) {
-        qWarning() << "场景为空";
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << filePath;
         return false;
     }
 
-    // 创建SVG生成器
-    QSvgGenerator generator;
-    generator.setFileName(filePath);
-    generator.setSize(scene->sceneRect().size().toSize());
-    generator.setViewBox(scene->sceneRect());
+    RecordBatch batch;
+    QString name;
+    ConceptNode node(InvalidId);
+    ConceptEdge edge(InvalidId);
+    QString uuid;
+    QString sourceUuid;
+    QString targetUuid;
+    bool inConcept = false;
+    bool inConnection = false;
+
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        const QStringView tag = xml.name();
+
+        // 元素结束时才把记录交给批次，子元素可能还会补充位置和连接语
+        if (token == QXmlStreamReader::EndElement) {
+            if (inConcept && tag == QLatin1String("concept")) {
+                batch.addNode(std::move(node), uuid);
+                inConcept = false;
+            } else if (inConnection && tag == QLatin1String("connection")) {
+                batch.addEdge(std::move(edge), uuid, sourceUuid, targetUuid);
+                inConnection = false;
+            }
+            continue;
+        }
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (tag == QLatin1String("cmap")) {
+            name = attributes.value(QLatin1String("name")).toString();
+        } else if (tag == QLatin1String("concept")) {
+            node = ConceptNode(InvalidId);
+            uuid = attributes.value(QLatin1String("id")).toString();
+            node.setText(attributes.value(QLatin1String("label")).toString());
+            inConcept = true;
+        } else if (tag == QLatin1String("location") && inConcept) {
+            // Cmap 记录的是中心点
+            const qreal x = attributes.value(QLatin1String("x")).toDouble();
+            const qreal y = attributes.value(QLatin1String("y")).toDouble();
+            node.setPos(QPointF(x - node.width() / 2.0, y - node.height() / 2.0));
+        } else if (tag == QLatin1String("connection")) {
+            edge = ConceptEdge(InvalidId);
+            uuid = attributes.value(QLatin1String("id")).toString();
+            sourceUuid = attributes.value(QLatin1String("sourceId")).toString();
+            targetUuid = attributes.value(QLatin1String("targetId")).toString();
+            inConnection = true;
+        } else if (tag == QLatin1String("linkLabel") && inConnection) {
+            edge.setLabel(attributes.value(QLatin1String("text")).toString());
+        }
+    }
 
-    // 绘制场景
-    QPainter painter(&generator);
-    scene->render(&painter);
-    painter.end();
+    if (xml.hasError()) {
+        qWarning() << "解析Cmap文件失败:" << filePath << xml.errorString()
+                   << "行" << xml.lineNumber() << "列" << xml.columnNumber();
+        return false;
+    }
 
+    batch.resolveIds();
+    batch.loadInto(map);
+    if (!name.isEmpty()) {
+        map.setName(name);
+    }
     return true;
 }
 
@@ -263,7 +361,7 @@ void FileManager::clearRecentFiles()
  */
 QString FileManager::fileFilter()
 {
-    return "概念图文件 (*.json *.xml);;JSON 文件 (*.json);;XML 文件 (*.xml)";
+    return "概念图文件 (*.json *.xml *.cmapb *.cmapz *.cmapt);;JSON 文件 (*.json);;XML 文件 (*.xml);;二进制概念图 (*.cmapb);;压缩概念图 (*.cmapz);;瓦片概念图 (*.cmapt)";
 }
 
 /**
@@ -283,7 +381,8 @@ QString FileManager::imageFilter()
 bool FileManager::isConceptMapFile(const QString& filePath)
 {
     QString extension = fileExtension(filePath).toLower();
-    return extension == "json" || extension == "xml";
+    return extension == "json" || extension == "xml" || extension == "cmapb" || extension == "cmapz"
+        || extension == "cmapt";
 }
 
 /**
@@ -305,75 +404,18 @@ QString FileManager::fileExtension(const QString& filePath)
  */
 bool FileManager::loadJson(const QString& filePath, ConceptMap& map)
 {
-    try {
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly)) {
-            throw std::runtime_error("无法打开文件: " + filePath.toStdString());
-        }
-
-        QByteArray data = file.readAll();
-        file.close();
-
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (doc.isNull() || !doc.isObject()) {
-            throw std::runtime_error("无效的JSON格式");
-        }
-
-        QJsonObject root = doc.object();
-
-        // 读取概念图信息
-        map.setName(root["name"].toString("未命名概念图"));
-        map.setVersion(root["version"].toString("1.0"));
-
-        // 清空现有数据
-        map.clear();
-
-        // 读取节点
-        QJsonArray nodesArray = root["nodes"].toArray();
-        for (const QJsonValue& value : nodesArray) {
-            QJsonObject nodeObj = value.toObject();
-
-            ConceptNode node(
-                nodeObj["text"].toString(),
-                nodeObj["x"].toDouble(),
-                nodeObj["y"].toDouble(),
-                nodeObj["width"].toDouble(),
-                nodeObj["height"].toDouble(),
-                QColor(nodeObj["color"].toString())
-            );
-
-            node.setId(nodeObj["id"].toString());
-            node.setStyle(nodeObj["style"].toString());
-
-            map.addNode(node);
-        }
-
-        // 读取连接线
-        QJsonArray edgesArray = root["edges"].toArray();
-        for (const QJsonValue& value : edgesArray) {
-            QJsonObject edgeObj = value.toObject();
-
-            ConceptEdge edge(
-                edgeObj["sourceNodeId"].toString(),
-                edgeObj["targetNodeId"].toString(),
-                edgeObj["label"].toString(),
-                QColor(edgeObj["color"].toString())
-            );
-
-            edge.setId(edgeObj["id"].toString());
-            edge.setStyle(edgeObj["style"].toString());
-
-            map.addEdge(edge);
-        }
-
-        return true;
-    } catch (const std::exception& e) {
-        qWarning() << "加载文件失败:" << e.what();
-        return false;
-    } catch (...) {
-        qWarning() << "未知错误: 加载文件失败";
+    // 文件中没有 name/version 时使用默认值，加载失败时恢复原值
+    const QString oldName = map.name();
+    const QString oldVersion = map.version();
+    map.setName("未命名概念图");
+    map.setVersion("1.0");
+
+    if (!ConceptMapJson::load(filePath, map)) {
+        map.setName(oldName);
+        map.setVersion(oldVersion);
         return false;
     }
+    return true;
 }
 
 /**
@@ -384,54 +426,8 @@ bool FileManager::loadJson(const QString& filePath, ConceptMap& map)
  */
 bool FileManager::saveJson(const QString& filePath, const ConceptMap& map)
 {
-    QJsonObject root;
-
-    // 保存概念图信息
-    root["name"] = map.name();
-    root["version"] = map.version();
-
-    // 保存节点
-    QJsonArray nodesArray;
-    for (const ConceptNode& node : map.nodes()) {
-        QJsonObject nodeObj;
-        nodeObj["id"] = node.id();
-        nodeObj["text"] = node.text();
-        nodeObj["x"] = node.x();
-        nodeObj["y"] = node.y();
-        nodeObj["width"] = node.width();
-        nodeObj["height"] = node.height();
-        nodeObj["color"] = node.color().name();
-        nodeObj["style"] = node.style();
-        nodesArray.append(nodeObj);
-    }
-    root["nodes"] = nodesArray;
-
-    // 保存连接线
-    QJsonArray edgesArray;
-    for (const ConceptEdge& edge : map.edges()) {
-        QJsonObject edgeObj;
-        edgeObj["id"] = edge.id();
-        edgeObj["sourceNodeId"] = edge.sourceNodeId();
-        edgeObj["targetNodeId"] = edge.targetNodeId();
-        edgeObj["label"] = edge.label();
-        edgeObj["color"] = edge.color().name();
-        edgeObj["style"] = edge.style();
-        edgesArray.append(edgeObj);
-    }
-    root["edges"] = edgesArray;
-
-    // 保存到文件
-    QJsonDocument doc(root);
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "无法打开文件:" << filePath;
-        return false;
-    }
-
-    file.write(doc.toJson());
-    file.close();
-
-    return true;
+    // 逐条写入记录，写完后原子替换目标文件
+    return ConceptMapJson::save(filePath, map, ConceptMapJson::DocumentDialect);
 }
 
 /**
@@ -442,67 +438,17 @@ bool FileManager::saveJson(const QString& filePath, const ConceptMap& map)
  */
 bool FileManager::loadXml(const QString& filePath, ConceptMap& map)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "无法打开文件:" << filePath;
+    // 根元素没有 name/version 时使用默认值，加载失败时恢复原值
+    const QString oldName = map.name();
+    const QString oldVersion = map.version();
+    map.setName("未命名概念图");
+    map.setVersion("1.0");
+
+    if (!ConceptMapXml::load(filePath, map)) {
+        map.setName(oldName);
+        map.setVersion(oldVersion);
         return false;
     }
-
-    QDomDocument doc;
-    if (!doc.setContent(&file)) {
-        qWarning() << "无效的XML格式";
-        file.close();
-        return false;
-    }
-    file.close();
-
-    QDomElement root = doc.documentElement();
-
-    // 读取概念图信息
-    map.setName(root.attribute("name", "未命名概念图"));
-    map.setVersion(root.attribute("version", "1.0"));
-
-    // 清空现有数据
-    map.clear();
-
-    // 读取节点
-    QDomNodeList nodesList = root.elementsByTagName("node");
-    for (int i = 0; i < nodesList.size(); ++i) {
-        QDomElement nodeElement = nodesList.at(i).toElement();
-
-        ConceptNode node(
-            nodeElement.attribute("text"),
-            nodeElement.attribute("x").toDouble(),
-            nodeElement.attribute("y").toDouble(),
-            nodeElement.attribute("width").toDouble(),
-            nodeElement.attribute("height").toDouble(),
-            QColor(nodeElement.attribute("color"))
-        );
-
-        node.setId(nodeElement.attribute("id"));
-        node.setStyle(nodeElement.attribute("style"));
-
-        map.addNode(node);
-    }
-
-    // 读取连接线
-    QDomNodeList edgesList = root.elementsByTagName("edge");
-    for (int i = 0; i < edgesList.size(); ++i) {
-        QDomElement edgeElement = edgesList.at(i).toElement();
-
-        ConceptEdge edge(
-            edgeElement.attribute("sourceNodeId"),
-            edgeElement.attribute("targetNodeId"),
-            edgeElement.attribute("label"),
-            QColor(edgeElement.attribute("color"))
-        );
-
-        edge.setId(edgeElement.attribute("id"));
-        edge.setStyle(edgeElement.attribute("style"));
-
-        map.addEdge(edge);
-    }
-
     return true;
 }
 
@@ -514,50 +460,43 @@ bool FileManager::loadXml(const QString& filePath, ConceptMap& map)
  */
 bool FileManager::saveXml(const QString& filePath, const ConceptMap& map)
 {
-    QDomDocument doc;
-
-    // 创建根元素
-    QDomElement root = doc.createElement("conceptMap");
-    root.setAttribute("name", map.name());
-    root.setAttribute("version", map.version());
-    doc.appendChild(root);
-
-    // 保存节点
-    for (const ConceptNode& node : map.nodes()) {
-        QDomElement nodeElement = doc.createElement("node");
-        nodeElement.setAttribute("id", node.id());
-        nodeElement.setAttribute("text", node.text());
-        nodeElement.setAttribute("x", node.x());
-        nodeElement.setAttribute("y", node.y());
-        nodeElement.setAttribute("width", node.width());
-        nodeElement.setAttribute("height", node.height());
-        nodeElement.setAttribute("color", node.color().name());
-        nodeElement.setAttribute("style", node.style());
-        root.appendChild(nodeElement);
-    }
+    // 逐个元素写入，写完后原子替换目标文件
+    return ConceptMapXml::save(filePath, map, ConceptMapXml::DocumentDialect);
+}
 
-    // 保存连接线
-    for (const ConceptEdge& edge : map.edges()) {
-        QDomElement edgeElement = doc.createElement("edge");
-        edgeElement.setAttribute("id", edge.id());
-        edgeElement.setAttribute("sourceNodeId", edge.sourceNodeId());
-        edgeElement.setAttribute("targetNodeId", edge.targetNodeId());
-        edgeElement.setAttribute("label", edge.label());
-        edgeElement.setAttribute("color", edge.color().name());
-        edgeElement.setAttribute("style", edge.style());
-        root.appendChild(edgeElement);
+/**
+ * @brief 加载压缩格式文件
+ * @param filePath 文件路径
+ * @param map 概念图数据（输出参数）
+ * @return 如果成功加载返回 true，否则返回 false
+ */
+bool FileManager::loadCompressed(const QString& filePath, ConceptMap& map)
+{
+    // 内容是 JSON 文档，与 loadJson 相同：没有 name/version 时使用默认值，加载失败时恢复原值
+    const QString oldName = map.name();
+    const QString oldVersion = map.version();
+    map.setName("未命名概念图");
+    map.setVersion("1.0");
+
+    if (!ConceptMapCompressed::load(filePath, map)) {
+        map.setName(oldName);
+        map.setVersion(oldVersion);
+        return false;
     }
+    return true;
+}
 
-    // 保存到文件
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "无法打开文件:" << filePath;
+/**
+ * @brief 在后台任务中运行导出，完成后发出 exportFinished()
+ * @param filePath 导出的文件路径
+ * @param job 在工作线程中执行的导出
+ * @return 如果已有导出在运行返回 false，否则返回 true
+ */
+bool FileManager::startExport(const QString& filePath, BackgroundTask::Job job)
+{
+    if (m_exportTask.isRunning()) {
         return false;
     }
-
-    QTextStream stream(&file);
-    stream << doc.toString();
-    file.close();
-
-    return true;
+    m_exportPath = filePath;
+    return m_exportTask.start(QString("正在导出 %1").arg(QFileInfo(filePath).fileName()), std::move(job));
 }
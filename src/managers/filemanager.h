@@ -4,8 +4,12 @@
 #include <QObject>
 #include <QString>
 #include <QFileInfo>
-#include <QGraphicsScene>
+#include <QImage>
+#include <QPicture>
 #include "conceptmap.h"
+#include "backgroundtask.h"
+
+class QGraphicsScene;
 
 /**
  * @brief 文件管理器类
@@ -15,6 +19,13 @@
  * - 文件保存
  * - 文件格式转换
  * - 最近文件管理
+ *
+ * exportTo*Async() 在界面线程中把场景绘制成图片或记录成 QPicture（场景只能在
+ * 界面线程中绘制），编码和写文件交给线程池；Cmap 导出直接读取概念图快照。
+ * 结果通过 exportFinished() 通知，进度和取消通过 exportTask()。
+ *
+ * 场景导出实现在 filemanagerexport.cpp 中，只有它依赖 Widgets 和 QtSvg；
+ * 概念图文件的读写、格式转换和 Cmap 导入导出不依赖界面，命令行工具也使用。
  */
 class FileManager : public QObject
 {
@@ -33,7 +44,7 @@ public:
     ~FileManager();
 
     /**
-     * @brief 加载概念图文件
+     * @brief 加载概念图文件，并重放增量保存的日志（与编辑器读到的文档一致）
      * @param filePath 文件路径
      * @param map 概念图数据（输出参数）
      * @return 如果成功加载返回 true，否则返回 false
@@ -48,6 +59,25 @@ public:
      */
     bool saveMap(const QString& filePath, const ConceptMap& map);
 
+    /**
+     * @brief 从瓦片文件（.cmapt）只加载一个区域
+     * @param filePath 文件路径
+     * @param region 区域（场景坐标）
+     * @param map 概念图数据（输出参数，失败时保持不变）
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    bool loadMapRegion(const QString& filePath, const QRectF& region, ConceptMap& map);
+
+    /**
+     * @brief 从瓦片文件（.cmapt）只加载以若干节点为中心的子图
+     * @param filePath 文件路径
+     * @param seedUuids 种子节点的 UUID
+     * @param depth 沿连接线扩展的步数
+     * @param map 概念图数据（输出参数，失败时保持不变）
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    bool loadSubgraph(const QString& filePath, const QStringList& seedUuids, int depth, ConceptMap& map);
+
     /**
      * @brief 导出为图片
      * @param filePath 图片文件路径
@@ -78,7 +108,53 @@ public:
      * @param map 概念图数据
      * @return 如果成功导出返回 true，否则返回 false
      */
-    bool exportToCmap(const QString& filePath, const ConceptMap& map);
+    bool exportToCmap(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 导入Cmap格式
+     * @param filePath Cmap文件路径
+     * @param map 概念图数据（输出参数，失败时保持不变）
+     * @return 如果成功导入返回 true，否则返回 false
+     */
+    bool importFromCmap(const QString& filePath, ConceptMap& map);
+
+    /**
+     * @brief 在后台线程中导出为图片，完成后发出 exportFinished()
+     * @param filePath 图片文件路径
+     * @param scene 图形场景
+     * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+     */
+    bool exportToImageAsync(const QString& filePath, QGraphicsScene* scene);
+
+    /**
+     * @brief 在后台线程中导出为PDF，完成后发出 exportFinished()
+     * @param filePath PDF文件路径
+     * @param scene 图形场景
+     * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+     */
+    bool exportToPDFAsync(const QString& filePath, QGraphicsScene* scene);
+
+    /**
+     * @brief 在后台线程中导出为SVG，完成后发出 exportFinished()
+     * @param filePath SVG文件路径
+     * @param scene 图形场景
+     * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+     */
+    bool exportToSVGAsync(const QString& filePath, QGraphicsScene* scene);
+
+    /**
+     * @brief 在后台线程中导出为Cmap格式，完成后发出 exportFinished()
+     * @param filePath Cmap文件路径
+     * @param snapshot 概念图快照
+     * @return 如果已有导出在运行返回 false，否则返回 true
+     */
+    bool exportToCmapAsync(const QString& filePath, const ConceptMapSnapshot& snapshot);
+
+    /**
+     * @brief 获取后台导出任务（用于显示进度和取消）
+     * @return 后台任务
+     */
+    BackgroundTask* exportTask() { return &m_exportTask; }
 
     /**
      * @brief 添加到最近文件列表
@@ -141,7 +217,62 @@ signals:
      */
     void recentFilesChanged();
 
+    /**
+     * @brief 后台导出结束信号
+     * @param filePath 导出的文件路径
+     * @param success 是否成功（被取消时为 false）
+     */
+    void exportFinished(const QString& filePath, bool success);
+
 private:
+    /**
+     * @brief 把场景绘制成图片（只能在界面线程中调用）
+     * @param scene 图形场景
+     * @return 场景图片
+     */
+    static QImage renderImage(QGraphicsScene* scene);
+
+    /**
+     * @brief 把场景的绘制命令记录成 QPicture（只能在界面线程中调用）
+     * @param scene 图形场景
+     * @return 记录的绘制命令，原点对应场景矩形的左上角
+     */
+    static QPicture recordScene(QGraphicsScene* scene);
+
+    /**
+     * @brief 编码并保存图片（可在任意线程调用）
+     * @param filePath 图片文件路径
+     * @param image 图片
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    static bool writeImage(const QString& filePath, const QImage& image);
+
+    /**
+     * @brief 把记录的绘制命令写成PDF（可在任意线程调用）
+     * @param filePath PDF文件路径
+     * @param picture 记录的绘制命令
+     * @param size 页面大小（点）
+     * @return 如果成功写入返回 true，否则返回 false
+     */
+    static bool writePDF(const QString& filePath, const QPicture& picture, const QSizeF& size);
+
+    /**
+     * @brief 把记录的绘制命令写成SVG（可在任意线程调用）
+     * @param filePath SVG文件路径
+     * @param picture 记录的绘制命令
+     * @param size 图片大小
+     * @return 如果成功写入返回 true，否则返回 false
+     */
+    static bool writeSVG(const QString& filePath, const QPicture& picture, const QSizeF& size);
+
+    /**
+     * @brief 在后台任务中运行导出，完成后发出 exportFinished()
+     * @param filePath 导出的文件路径
+     * @param job 在工作线程中执行的导出
+     * @return 如果已有导出在运行返回 false，否则返回 true
+     */
+    bool startExport(const QString& filePath, BackgroundTask::Job job);
+
     /**
      * @brief 加载JSON格式文件
      * @param filePath 文件路径
@@ -174,8 +305,18 @@ private:
      */
     bool saveXml(const QString& filePath, const ConceptMap& map);
 
+    /**
+     * @brief 加载压缩格式文件
+     * @param filePath 文件路径
+     * @param map 概念图数据（输出参数）
+     * @return 如果成功加载返回 true，否则返回 false
+     */
+    bool loadCompressed(const QString& filePath, ConceptMap& map);
+
     QStringList m_recentFiles;     // 最近文件列表
     int m_maxRecentFiles;          // 最近文件最大数量
+    BackgroundTask m_exportTask;   // 后台导出
+    QString m_exportPath;          // 正在导出的文件路径
 };
 
 #endif // FILEMANAGER_H
@@ -0,0 +1,239 @@
+#include "filemanager.h"
+#include "operationprogress.h"
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QSvgGenerator>
+#include <QPdfWriter>
+#include <QDebug>
+
+// 场景导出放在单独的文件中：只有这里依赖 QGraphicsScene（Widgets）和 QtSvg，
+// 只读写概念图文件的程序（例如 conceptmap-cli）不需要链接它们
+
+/**
+ * @brief 导出为图片
+ * @param filePath 图片文件路径
+ * @param scene 图形场景
+ * @return 如果成功导出返回 true，否则返回 false
+ */
+bool FileManager::exportToImage(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+
+    return writeImage(filePath, renderImage(scene));
+}
+
+/**
+ * @brief 在后台线程中导出为图片，完成后发出 exportFinished()
+ * @param filePath 图片文件路径
+ * @param scene 图形场景
+ * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+ */
+bool FileManager::exportToImageAsync(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+    if (m_exportTask.isRunning()) {
+        return false;
+    }
+
+    // 绘制在界面线程中完成，编码和写文件在后台
+    const QImage image = renderImage(scene);
+    return startExport(filePath, [filePath, image](OperationProgress& progress) {
+        progress.addTotal(1);
+        const bool ok = !progress.isCanceled() && writeImage(filePath, image);
+        progress.advance(1);
+        return ok;
+    });
+}
+
+/**
+ * @brief 导出为PDF
+ * @param filePath PDF文件路径
+ * @param scene 图形场景
+ * @return 如果成功导出返回 true，否则返回 false
+ */
+bool FileManager::exportToPDF(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+
+    return writePDF(filePath, recordScene(scene), scene->sceneRect().size());
+}
+
+/**
+ * @brief 在后台线程中导出为PDF，完成后发出 exportFinished()
+ * @param filePath PDF文件路径
+ * @param scene 图形场景
+ * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+ */
+bool FileManager::exportToPDFAsync(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+    if (m_exportTask.isRunning()) {
+        return false;
+    }
+
+    // 在界面线程中记录绘制命令，在后台重放到PDF
+    const QPicture picture = recordScene(scene);
+    const QSizeF size = scene->sceneRect().size();
+    return startExport(filePath, [filePath, picture, size](OperationProgress& progress) {
+        progress.addTotal(1);
+        const bool ok = !progress.isCanceled() && writePDF(filePath, picture, size);
+        progress.advance(1);
+        return ok;
+    });
+}
+
+/**
+ * @brief 导出为SVG
+ * @param filePath SVG文件路径
+ * @param scene 图形场景
+ * @return 如果成功导出返回 true，否则返回 false
+ */
+bool FileManager::exportToSVG(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+
+    return writeSVG(filePath, recordScene(scene), scene->sceneRect().size());
+}
+
+/**
+ * @brief 在后台线程中导出为SVG，完成后发出 exportFinished()
+ * @param filePath SVG文件路径
+ * @param scene 图形场景
+ * @return 如果已有导出在运行或场景为空返回 false，否则返回 true
+ */
+bool FileManager::exportToSVGAsync(const QString& filePath, QGraphicsScene* scene)
+{
+    if (!scene) {
+        qWarning() << "场景为空";
+        return false;
+    }
+    if (m_exportTask.isRunning()) {
+        return false;
+    }
+
+    // 在界面线程中记录绘制命令，在后台重放到SVG
+    const QPicture picture = recordScene(scene);
+    const QSizeF size = scene->sceneRect().size();
+    return startExport(filePath, [filePath, picture, size](OperationProgress& progress) {
+        progress.addTotal(1);
+        const bool ok = !progress.isCanceled() && writeSVG(filePath, picture, size);
+        progress.advance(1);
+        return ok;
+    });
+}
+
+/**
+ * @brief 把场景绘制成图片（只能在界面线程中调用）
+ * @param scene 图形场景
+ * @return 场景图片
+ */
+QImage FileManager::renderImage(QGraphicsScene* scene)
+{
+    // 创建图片
+    QImage image(scene->sceneRect().size().toSize(), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    // 绘制场景
+    QPainter painter(&image);
+    scene->render(&painter);
+    painter.end();
+    return image;
+}
+
+/**
+ * @brief 把场景的绘制命令记录成 QPicture（只能在界面线程中调用）
+ * @param scene 图形场景
+ * @return 记录的绘制命令，原点对应场景矩形的左上角
+ */
+QPicture FileManager::recordScene(QGraphicsScene* scene)
+{
+    const QRectF source = scene->sceneRect();
+    QPicture picture;
+    QPainter painter(&picture);
+    scene->render(&painter, QRectF(QPointF(0, 0), source.size()), source);
+    painter.end();
+    return picture;
+}
+
+/**
+ * @brief 编码并保存图片（可在任意线程调用）
+ * @param filePath 图片文件路径
+ * @param image 图片
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool FileManager::writeImage(const QString& filePath, const QImage& image)
+{
+    if (!image.save(filePath)) {
+        qWarning() << "无法保存图片:" << filePath;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 把记录的绘制命令写成PDF（可在任意线程调用）
+ *
+ * QPrinter 只能在界面线程中使用，这里改用 QPdfWriter。
+ *
+ * @param filePath PDF文件路径
+ * @param picture 记录的绘制命令
+ * @param size 页面大小（点）
+ * @return 如果成功写入返回 true，否则返回 false
+ */
+bool FileManager::writePDF(const QString& filePath, const QPicture& picture, const QSizeF& size)
+{
+    QPdfWriter writer(filePath);
+    writer.setPageSize(QPageSize(size, QPageSize::Point));
+    writer.setPageMargins(QMarginsF());
+
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+    // 绘制命令以点为单位，映射到整页
+    painter.setWindow(QRect(QPoint(0, 0), size.toSize()));
+    painter.drawPicture(0, 0, picture);
+    painter.end();
+    return true;
+}
+
+/**
+ * @brief 把记录的绘制命令写成SVG（可在任意线程调用）
+ * @param filePath SVG文件路径
+ * @param picture 记录的绘制命令
+ * @param size 图片大小
+ * @return 如果成功写入返回 true，否则返回 false
+ */
+bool FileManager::writeSVG(const QString& filePath, const QPicture& picture, const QSizeF& size)
+{
+    // 创建SVG生成器
+    QSvgGenerator generator;
+    generator.setFileName(filePath);
+    generator.setSize(size.toSize());
+    generator.setViewBox(QRectF(QPointF(0, 0), size));
+
+    QPainter painter;
+    if (!painter.begin(&generator)) {
+        qWarning() << "无法创建文件:" << filePath;
+        return false;
+    }
+    painter.drawPicture(0, 0, picture);
+    painter.end();
+    return true;
+}
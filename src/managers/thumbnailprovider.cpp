@@ -0,0 +1,177 @@
+#include "thumbnailprovider.h"
+#include "filemanager.h"
+#include "maprenderer.h"
+#include "conceptmapjournal.h"
+#include "idregistry.h"
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+/**
+ * @brief 构造函数，缓存目录默认为系统缓存目录下的 thumbnails
+ * @param parent 父对象
+ */
+ThumbnailProvider::ThumbnailProvider(QObject* parent)
+    : QObject(parent)
+    , m_images(MemoryCacheSize)
+    , m_size(DefaultSize)
+{
+    m_pool.setMaxThreadCount(MaxThreads);
+    const QString cache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cache.isEmpty()) {
+        m_directory = QDir(cache).filePath(QStringLiteral("thumbnails"));
+    }
+}
+
+/**
+ * @brief 析构函数，等待正在生成的缩略图
+ */
+ThumbnailProvider::~ThumbnailProvider()
+{
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief 设置缩略图的最大边长
+ * @param size 边长（像素）
+ */
+void ThumbnailProvider::setThumbnailSize(int size)
+{
+    if (size != m_size) {
+        m_size = qMax(1, size);
+        m_images.clear();
+        m_failed.clear();
+    }
+}
+
+/**
+ * @brief 获取文件的缩略图
+ * @param filePath 概念图文件路径
+ * @return 内存中已有时返回缩略图，否则返回空图片并在后台生成
+ */
+QImage ThumbnailProvider::thumbnail(const QString& filePath)
+{
+    const QString key = cacheKey(filePath);
+    if (key.isEmpty()) {
+        return QImage();
+    }
+    if (const QImage* image = m_images.object(key)) {
+        return *image;
+    }
+    if (m_pending.contains(key) || m_failed.contains(key)) {
+        return QImage();
+    }
+
+    m_pending.insert(key);
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, filePath, key]() {
+        const QImage image = watcher->result();
+        watcher->deleteLater();
+        m_pending.remove(key);
+        if (image.isNull()) {
+            m_failed.insert(key);
+            return;
+        }
+        m_images.insert(key, new QImage(image));
+        emit thumbnailReady(filePath);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &ThumbnailProvider::loadOrRender,
+                                         filePath, key, m_directory, m_size));
+    return QImage();
+}
+
+/**
+ * @brief 计算文件的缓存键
+ * @param filePath 概念图文件路径
+ * @return "<路径哈希>-<修改时间>[.<日志大小>.<日志修改时间>]..."，文件不存在时返回空字符串
+ */
+QString ThumbnailProvider::cacheKey(const QString& filePath)
+{
+    const QFileInfo info(filePath);
+    if (!info.isFile()) {
+        return QString();
+    }
+    const QByteArray hash = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1);
+    QString key = QStringLiteral("%1-%2").arg(QString::fromLatin1(hash.toHex()))
+                                         .arg(info.lastModified().toMSecsSinceEpoch());
+
+    // 缩略图画的是重放日志之后的文档，追加日志后也要失效
+    const QString basePath = info.absoluteFilePath();
+    for (const QString& journal : { ConceptMapJournal::compactingPath(basePath),
+                                    ConceptMapJournal::journalPath(basePath) }) {
+        const QFileInfo journalInfo(journal);
+        if (journalInfo.isFile()) {
+            key += QStringLiteral(".%1.%2").arg(journalInfo.size())
+                                           .arg(journalInfo.lastModified().toMSecsSinceEpoch());
+        }
+    }
+    return key;
+}
+
+/**
+ * @brief 加载文件（重放增量保存的日志）并绘制缩略图（可在任意线程调用）
+ * @param filePath 概念图文件路径
+ * @param size 最大边长（像素）
+ * @return 缩略图，加载失败时返回空图片
+ */
+QImage ThumbnailProvider::renderThumbnail(const QString& filePath, int size)
+{
+    // 概念图只用来绘制，句柄不必进入编辑器使用的全局句柄表
+    const IdRegistry::Scope ids;
+    FileManager files;
+    ConceptMap map;
+    if (!files.loadMap(filePath, map)) {
+        return QImage();
+    }
+    return MapRenderer().render(map, QSize(size, size));
+}
+
+/**
+ * @brief 读取磁盘缓存，没有时绘制并写入磁盘缓存（在工作线程中调用）
+ * @param filePath 概念图文件路径
+ * @param key 缓存键
+ * @param directory 磁盘缓存目录
+ * @param size 最大边长（像素）
+ * @return 缩略图，加载失败时返回空图片
+ */
+QImage ThumbnailProvider::loadOrRender(const QString& filePath, const QString& key, const QString& directory, int size)
+{
+    if (directory.isEmpty()) {
+        return renderThumbnail(filePath, size);
+    }
+
+    const QDir cache(directory);
+    const QString fileName = QStringLiteral("%1-%2.png").arg(key).arg(size);
+    QImage image(cache.filePath(fileName));
+    if (!image.isNull()) {
+        return image;
+    }
+
+    image = renderThumbnail(filePath, size);
+    if (image.isNull() || !QDir().mkpath(directory)) {
+        return image;
+    }
+
+    // 磁盘缓存写失败不影响返回的缩略图
+    QSaveFile file(cache.filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+        qWarning() << "无法写入缩略图缓存:" << file.fileName();
+        return image;
+    }
+
+    // 删除同一文件的其他缩略图（修改前的或其他尺寸的）
+    const QString prefix = key.left(key.indexOf(QLatin1Char('-')) + 1);
+    for (const QString& stale : cache.entryList({ prefix + QStringLiteral("*.png") }, QDir::Files)) {
+        if (stale != fileName) {
+            QFile::remove(cache.filePath(stale));
+        }
+    }
+    return image;
+}
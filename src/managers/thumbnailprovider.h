@@ -0,0 +1,116 @@
+#ifndef THUMBNAILPROVIDER_H
+#define THUMBNAILPROVIDER_H
+
+#include <QObject>
+#include <QString>
+#include <QImage>
+#include <QCache>
+#include <QSet>
+#include <QThreadPool>
+
+/**
+ * @brief 概念图文件的缩略图
+ *
+ * 缩略图由 MapRenderer 离屏绘制，不需要图形场景，内容是重放增量保存的日志之后的文档。
+ * 缓存键由文件绝对路径的哈希、修改时间以及日志的大小和修改时间组成，文件或日志
+ * 改动后自动失效。缓存分两级：
+ * - 内存：最近使用的若干张
+ * - 磁盘：缓存目录中的 PNG 文件，文件名为 "<缓存键>-<边长>.png"，
+ *   写入新缩略图时删除同一文件的其他缩略图
+ *
+ * thumbnail() 只查内存，未命中时在后台线程读取磁盘缓存或加载文件绘制，
+ * 完成后发出 thumbnailReady()。加载失败的文件在修改前不再重试。
+ */
+class ThumbnailProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultSize = 128;        // 缩略图的默认最大边长（像素）
+    static constexpr int MemoryCacheSize = 64;     // 内存中保留的缩略图数量
+    static constexpr int MaxThreads = 2;           // 同时生成缩略图的线程数
+
+    /**
+     * @brief 构造函数，缓存目录默认为系统缓存目录下的 thumbnails
+     * @param parent 父对象
+     */
+    explicit ThumbnailProvider(QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数，等待正在生成的缩略图
+     */
+    ~ThumbnailProvider();
+
+    /**
+     * @brief 设置磁盘缓存目录
+     * @param directory 目录，空字符串表示不使用磁盘缓存
+     */
+    void setCacheDirectory(const QString& directory) { m_directory = directory; }
+
+    /**
+     * @brief 获取磁盘缓存目录
+     * @return 目录
+     */
+    QString cacheDirectory() const { return m_directory; }
+
+    /**
+     * @brief 设置缩略图的最大边长
+     * @param size 边长（像素）
+     */
+    void setThumbnailSize(int size);
+
+    /**
+     * @brief 获取缩略图的最大边长
+     * @return 边长（像素）
+     */
+    int thumbnailSize() const { return m_size; }
+
+    /**
+     * @brief 获取文件的缩略图
+     * @param filePath 概念图文件路径
+     * @return 内存中已有时返回缩略图，否则返回空图片并在后台生成
+     */
+    QImage thumbnail(const QString& filePath);
+
+    /**
+     * @brief 计算文件的缓存键
+     * @param filePath 概念图文件路径
+     * @return "<路径哈希>-<修改时间>[.<日志大小>.<日志修改时间>]..."，文件不存在时返回空字符串
+     */
+    static QString cacheKey(const QString& filePath);
+
+    /**
+     * @brief 加载文件（重放增量保存的日志）并绘制缩略图（可在任意线程调用）
+     * @param filePath 概念图文件路径
+     * @param size 最大边长（像素）
+     * @return 缩略图，加载失败时返回空图片
+     */
+    static QImage renderThumbnail(const QString& filePath, int size);
+
+signals:
+    /**
+     * @brief 缩略图生成完成信号（失败时不发出）
+     * @param filePath 概念图文件路径
+     */
+    void thumbnailReady(const QString& filePath);
+
+private:
+    /**
+     * @brief 读取磁盘缓存，没有时绘制并写入磁盘缓存（在工作线程中调用）
+     * @param filePath 概念图文件路径
+     * @param key 缓存键
+     * @param directory 磁盘缓存目录
+     * @param size 最大边长（像素）
+     * @return 缩略图，加载失败时返回空图片
+     */
+    static QImage loadOrRender(const QString& filePath, const QString& key, const QString& directory, int size);
+
+    QCache<QString, QImage> m_images;   // 缓存键 -> 缩略图
+    QSet<QString> m_pending;            // 正在生成的缓存键
+    QSet<QString> m_failed;             // 生成失败的缓存键
+    QThreadPool m_pool;                 // 生成缩略图的线程
+    QString m_directory;                // 磁盘缓存目录
+    int m_size;                         // 缩略图的最大边长
+};
+
+#endif // THUMBNAILPROVIDER_H
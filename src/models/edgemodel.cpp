@@ -6,6 +6,7 @@
  */
 EdgeModel::EdgeModel(QObject* parent)
     : QAbstractTableModel(parent)
+    , m_map(nullptr)
 {
 }
 
@@ -24,7 +25,7 @@ EdgeModel::~EdgeModel()
 int EdgeModel::rowCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
-    return m_edges.size();
+    return m_rows.size();
 }
 
 /**
@@ -46,17 +47,18 @@ int EdgeModel::columnCount(const QModelIndex& parent) const
  */
 QVariant EdgeModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_edges.size()) {
+    const ConceptEdge* stored = edgeAt(index);
+    if (!stored) {
         return QVariant();
     }
 
-    const ConceptEdge& edge = m_edges[index.row()];
+    const ConceptEdge& edge = *stored;
 
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         switch (index.column()) {
-            case 0: return edge.id();
-            case 1: return edge.sourceNodeId();
-            case 2: return edge.targetNodeId();
+            case 0: return IdRegistry::toUuid(edge.id());
+            case 1: return IdRegistry::toUuid(edge.sourceNodeId());
+            case 2: return IdRegistry::toUuid(edge.targetNodeId());
             case 3: return edge.label();
             case 4: return edge.color().name();
             default: return QVariant();
@@ -79,19 +81,28 @@ QVariant EdgeModel::data(const QModelIndex& index, int role) const
  */
 bool EdgeModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
-    if (!index.isValid() || index.row() >= m_edges.size() || role != Qt::EditRole) {
+    const ConceptEdge* stored = edgeAt(index);
+    if (!stored || role != Qt::EditRole) {
         return false;
     }
 
-    ConceptEdge& edge = m_edges[index.row()];
+    ConceptEdge edge = *stored;
 
     switch (index.column()) {
         case 1:
-            edge.setSourceNodeId(value.toString());
-            break;
-        case 2:
-            edge.setTargetNodeId(value.toString());
+        case 2: {
+            // 界面上显示的是 UUID，只接受概念图中存在的节点
+            const NodeId nodeId = IdRegistry::find(value.toString());
+            if (nodeId == InvalidId || !m_map->hasNode(nodeId)) {
+                return false;
+            }
+            if (index.column() == 1) {
+                edge.setSourceNodeId(nodeId);
+            } else {
+                edge.setTargetNodeId(nodeId);
+            }
             break;
+        }
         case 3:
             edge.setLabel(value.toString());
             break;
@@ -102,8 +113,15 @@ bool EdgeModel::setData(const QModelIndex& index, const QVariant& value, int rol
             return false;
     }
 
+    m_map->beginTransaction();
+    m_map->updateEdge(edge);
+    const ChangeSet changes = m_map->commit();
+
     emit dataChanged(index, index, {role});
     emit edgeUpdated(edge);
+    if (!changes.isEmpty()) {
+        emit changesCommitted(changes);
+    }
 
     return true;
 }
@@ -151,24 +169,39 @@ Qt::ItemFlags EdgeModel::flags(const QModelIndex& index) const
 }
 
 /**
- * @brief 添加连接线
- * @param edge 要添加的连接线
+ * @brief 绑定概念图数据并重新加载所有行
+ * @param map 概念图数据
+ */
+void EdgeModel::setConceptMap(ConceptMap* map)
+{
+    m_map = map;
+    reload();
+}
+
+/**
+ * @brief 为概念图中已有的连接线添加一行
+ * @param id 连接线ID
  */
-void EdgeModel::addEdge(const ConceptEdge& edge)
+void EdgeModel::addEdge(EdgeId id)
 {
-    if (m_edgeIndexMap.contains(edge.id())) {
+    if (!m_map || m_edgeIndexMap.contains(id)) {
         return;
     }
 
-    int row = m_edges.size();
+    const ConceptEdge* edge = m_map->edgeById(id);
+    if (!edge) {
+        return;
+    }
+
+    int row = m_rows.size();
     beginInsertRows(QModelIndex(), row, row);
 
-    m_edges.append(edge);
-    m_edgeIndexMap[edge.id()] = row;
+    m_rows.append(id);
+    m_edgeIndexMap[id] = row;
 
     endInsertRows();
 
-    emit edgeAdded(edge);
+    emit edgeAdded(*edge);
 }
 
 /**
@@ -177,20 +210,21 @@ void EdgeModel::addEdge(const ConceptEdge& edge)
  */
 void EdgeModel::removeEdge(const QModelIndex& index)
 {
-    if (!index.isValid() || index.row() >= m_edges.size()) {
+    if (!index.isValid() || index.row() >= m_rows.size()) {
         return;
     }
 
-    QString edgeId = m_edges[index.row()].id();
+    const int row = index.row();
+    EdgeId edgeId = m_rows[row];
 
-    beginRemoveRows(QModelIndex(), index.row(), index.row());
+    beginRemoveRows(QModelIndex(), row, row);
 
-    m_edges.removeAt(index.row());
+    m_rows.removeAt(row);
+    m_edgeIndexMap.remove(edgeId);
 
-    // 更新索引映射
-    m_edgeIndexMap.clear();
-    for (int i = 0; i < m_edges.size(); ++i) {
-        m_edgeIndexMap[m_edges[i].id()] = i;
+    // 只有被删除行之后的行号发生变化
+    for (int i = row; i < m_rows.size(); ++i) {
+        m_edgeIndexMap[m_rows[i]] = i;
     }
 
     endRemoveRows();
@@ -199,76 +233,62 @@ void EdgeModel::removeEdge(const QModelIndex& index)
 }
 
 /**
- * @brief 更新连接线
+ * @brief 通知连接线数据已在概念图中更新
  * @param index 模型索引
- * @param edge 新的连接线数据
  */
-void EdgeModel::updateEdge(const QModelIndex& index, const ConceptEdge& edge)
+void EdgeModel::updateEdge(const QModelIndex& index)
 {
-    if (!index.isValid() || index.row() >= m_edges.size()) {
+    const ConceptEdge* edge = edgeAt(index);
+    if (!edge) {
         return;
     }
 
-    m_edges[index.row()] = edge;
-
-    emit dataChanged(index, index);
-    emit edgeUpdated(edge);
-}
-
-/**
- * @brief 根据索引获取连接线
- * @param index 模型索引
- * @return 连接线指针，如果不存在则返回 nullptr
- */
-ConceptEdge* EdgeModel::edgeAt(const QModelIndex& index)
-{
-    if (!index.isValid() || index.row() >= m_edges.size()) {
-        return nullptr;
-    }
-
-    return &m_edges[index.row()];
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), columnCount() - 1));
+    emit edgeUpdated(*edge);
 }
 
 /**
- * @brief 根据索引获取连接线（常量版本）
+ * @brief 根据索引获取连接线（只读）
  * @param index 模型索引
  * @return 连接线指针，如果不存在则返回 nullptr
  */
 const ConceptEdge* EdgeModel::edgeAt(const QModelIndex& index) const
 {
-    if (!index.isValid() || index.row() >= m_edges.size()) {
+    if (!m_map || !index.isValid() || index.row() >= m_rows.size()) {
         return nullptr;
     }
 
-    return &m_edges[index.row()];
+    return m_map->edgeById(m_rows[index.row()]);
 }
 
 /**
- * @brief 根据ID获取连接线
+ * @brief 根据ID获取连接线（只读）
  * @param id 连接线ID
  * @return 连接线指针，如果不存在则返回 nullptr
  */
-ConceptEdge* EdgeModel::edgeById(const QString& id)
+const ConceptEdge* EdgeModel::edgeById(EdgeId id) const
 {
-    if (!m_edgeIndexMap.contains(id)) {
+    if (!m_map || !m_edgeIndexMap.contains(id)) {
         return nullptr;
     }
 
-    return &m_edges[m_edgeIndexMap[id]];
+    return m_map->edgeById(id);
 }
 
 /**
- * @brief 根据ID获取连接线（常量版本）
- * @param id 连接线ID
- * @return 连接线指针，如果不存在则返回 nullptr
+ * @brief 获取所有连接线（按行顺序复制）
+ * @return 连接线列表
  */
-const ConceptEdge* EdgeModel::edgeById(const QString& id) const
+QVector<ConceptEdge> EdgeModel::edges() const
 {
-    if (!m_edgeIndexMap.contains(id)) {
-        return nullptr;
+    QVector<ConceptEdge> result;
+    result.reserve(m_rows.size());
+    for (EdgeId id : m_rows) {
+        if (const ConceptEdge* edge = edgeById(id)) {
+            result.append(*edge);
+        }
     }
-
-    return &m_edges[m_edgeIndexMap[id]];
+    return result;
 }
 
 /**
@@ -278,26 +298,28 @@ void EdgeModel::clear()
 {
     beginResetModel();
 
-    m_edges.clear();
+    m_rows.clear();
     m_edgeIndexMap.clear();
 
     endResetModel();
 }
 
 /**
- * @brief 设置连接线列表
- * @param edges 连接线列表
+ * @brief 按概念图数据重新生成所有行
  */
-void EdgeModel::setEdges(const QVector<ConceptEdge>& edges)
+void EdgeModel::reload()
 {
     beginResetModel();
 
-    m_edges = edges;
-
-    // 更新索引映射
+    m_rows.clear();
     m_edgeIndexMap.clear();
-    for (int i = 0; i < m_edges.size(); ++i) {
-        m_edgeIndexMap[m_edges[i].id()] = i;
+
+    if (m_map) {
+        m_rows.reserve(m_map->edgeCount());
+        for (const ConceptEdge& edge : m_map->allEdges()) {
+            m_edgeIndexMap[edge.id()] = m_rows.size();
+            m_rows.append(edge.id());
+        }
     }
 
     endResetModel();
@@ -308,7 +330,7 @@ void EdgeModel::setEdges(const QVector<ConceptEdge>& edges)
  * @param id 连接线ID
  * @return 模型索引
  */
-QModelIndex EdgeModel::findIndexById(const QString& id) const
+QModelIndex EdgeModel::findIndexById(EdgeId id) const
 {
     if (!m_edgeIndexMap.contains(id)) {
         return QModelIndex();
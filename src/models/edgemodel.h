@@ -3,8 +3,9 @@
 
 #include <QAbstractTableModel>
 #include <QBrush>
+#include <QHash>
 #include <QVector>
-#include "conceptedge.h"
+#include "conceptmap.h"
 
 /**
  * @brief 连接线模型类（继承 QAbstractTableModel）
@@ -13,6 +14,9 @@
  * - 连接线数据的增删改查
  * - 数据持久化
  * - 数据验证
+ *
+ * 模型本身不保存连接线数据，只保存行顺序（连接线ID列表），
+ * 显示和编辑时直接读写绑定的概念图数据。
  */
 class EdgeModel : public QAbstractTableModel
 {
@@ -78,59 +82,50 @@ public:
      */
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
-    // 连接线操作
     /**
-     * @brief 添加连接线
-     * @param edge 要添加的连接线
+     * @brief 绑定概念图数据并重新加载所有行
+     * @param map 概念图数据
      */
-    void addEdge(const ConceptEdge& edge);
+    void setConceptMap(ConceptMap* map);
 
+    // 连接线操作
     /**
-     * @brief 删除连接线
-     * @param index 模型索引
+     * @brief 为概念图中已有的连接线添加一行
+     * @param id 连接线ID
      */
-    void removeEdge(const QModelIndex& index);
+    void addEdge(EdgeId id);
 
     /**
-     * @brief 更新连接线
+     * @brief 删除连接线
      * @param index 模型索引
-     * @param edge 新的连接线数据
      */
-    void updateEdge(const QModelIndex& index, const ConceptEdge& edge);
+    void removeEdge(const QModelIndex& index);
 
     /**
-     * @brief 根据索引获取连接线
+     * @brief 通知连接线数据已在概念图中更新
      * @param index 模型索引
-     * @return 连接线指针，如果不存在则返回 nullptr
      */
-    ConceptEdge* edgeAt(const QModelIndex& index);
+    void updateEdge(const QModelIndex& index);
 
     /**
-     * @brief 根据索引获取连接线（常量版本）
+     * @brief 根据索引获取连接线（只读）
      * @param index 模型索引
      * @return 连接线指针，如果不存在则返回 nullptr
      */
     const ConceptEdge* edgeAt(const QModelIndex& index) const;
 
     /**
-     * @brief 根据ID获取连接线
+     * @brief 根据ID获取连接线（只读）
      * @param id 连接线ID
      * @return 连接线指针，如果不存在则返回 nullptr
      */
-    ConceptEdge* edgeById(const QString& id);
+    const ConceptEdge* edgeById(EdgeId id) const;
 
     /**
-     * @brief 根据ID获取连接线（常量版本）
-     * @param id 连接线ID
-     * @return 连接线指针，如果不存在则返回 nullptr
-     */
-    const ConceptEdge* edgeById(const QString& id) const;
-
-    /**
-     * @brief 获取所有连接线
+     * @brief 获取所有连接线（按行顺序复制）
      * @return 连接线列表
      */
-    QVector<ConceptEdge> edges() const { return m_edges; }
+    QVector<ConceptEdge> edges() const;
 
     /**
      * @brief 清空所有连接线
@@ -138,17 +133,16 @@ public:
     void clear();
 
     /**
-     * @brief 设置连接线列表
-     * @param edges 连接线列表
+     * @brief 按概念图数据重新生成所有行
      */
-    void setEdges(const QVector<ConceptEdge>& edges);
+    void reload();
 
     /**
      * @brief 根据ID查找连接线索引
      * @param id 连接线ID
      * @return 模型索引
      */
-    QModelIndex findIndexById(const QString& id) const;
+    QModelIndex findIndexById(EdgeId id) const;
 
 signals:
     /**
@@ -161,7 +155,7 @@ signals:
      * @brief 连接线删除信号
      * @param edgeId 删除的连接线ID
      */
-    void edgeRemoved(const QString& edgeId);
+    void edgeRemoved(EdgeId edgeId);
 
     /**
      * @brief 连接线更新信号
@@ -169,9 +163,16 @@ signals:
      */
     void edgeUpdated(const ConceptEdge& edge);
 
+    /**
+     * @brief 通过表格编辑修改概念图数据后发出的信号
+     * @param changes 变更记录
+     */
+    void changesCommitted(const ChangeSet& changes);
+
 private:
-    QVector<ConceptEdge> m_edges;         // 连接线列表
-    QMap<QString, int> m_edgeIndexMap;    // 连接线ID到索引的映射
+    ConceptMap* m_map;                    // 概念图数据（不拥有）
+    QVector<EdgeId> m_rows;               // 每行对应的连接线ID
+    QHash<EdgeId, int> m_edgeIndexMap;    // 连接线ID到索引的映射
 };
 
 #endif // EDGEMODEL_H
@@ -1,5 +1,9 @@
 #include "mapmodel.h"
 #include "conceptmapserializer.h"
+#include "conceptmapjournal.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QDebug>
 
 /**
@@ -8,7 +12,14 @@
  */
 MapModel::MapModel(QObject* parent)
     : QObject(parent)
+    , m_needsFullSave(true)
+    , m_savingNeedsFullSave(false)
+    , m_fileOperation(LoadOperation)
 {
+    // 节点模型和连接线模型直接读写同一份概念图数据
+    m_nodeModel.setConceptMap(&m_conceptMap);
+    m_edgeModel.setConceptMap(&m_conceptMap);
+
     // 连接节点模型的信号
     connect(&m_nodeModel, &NodeModel::nodeAdded, this, &MapModel::nodeAdded);
     connect(&m_nodeModel, &NodeModel::nodeRemoved, this, &MapModel::nodeRemoved);
@@ -19,6 +30,18 @@ MapModel::MapModel(QObject* parent)
     connect(&m_edgeModel, &EdgeModel::edgeRemoved, this, &MapModel::edgeRemoved);
     connect(&m_edgeModel, &EdgeModel::edgeUpdated, this, &MapModel::edgeUpdated);
 
+    // 通过表格编辑产生的修改已经写入概念图数据，只需转发给其它观察者
+    auto forwardChanges = [this](const ChangeSet& changes) {
+        recordChanges(changes);
+        emit changesCommitted(changes);
+        emit mapChanged();
+    };
+    connect(&m_nodeModel, &NodeModel::changesCommitted, this, forwardChanges);
+    connect(&m_edgeModel, &EdgeModel::changesCommitted, this, forwardChanges);
+
+    connect(&m_compaction, &QFutureWatcher<bool>::finished, this, &MapModel::finishCompaction);
+    connect(&m_fileTask, &BackgroundTask::finished, this, &MapModel::finishFileTask);
+
     // 创建新概念图
     newMap();
 }
@@ -28,6 +51,12 @@ MapModel::MapModel(QObject* parent)
  */
 MapModel::~MapModel()
 {
+    // 整理完成后还要更新日志，不能让它在对象销毁后才结束
+    waitForCompaction();
+
+    // 正在进行的加载或保存放弃，目标文件保持原样
+    m_fileTask.cancel();
+    m_fileTask.waitForFinished();
 }
 
 /**
@@ -37,13 +66,15 @@ MapModel::~MapModel()
 void MapModel::setConceptMap(const ConceptMap& map)
 {
     m_conceptMap = map;
+    m_tiles.close();
+    m_unsavedChanges.clear();
+    m_needsFullSave = true;
 
-    // 更新节点模型
-    m_nodeModel.setNodes(map.nodes());
-
-    // 更新连接线模型
-    m_edgeModel.setEdges(map.edges());
+    // 更新节点模型和连接线模型
+    m_nodeModel.reload();
+    m_edgeModel.reload();
 
+    emit mapReset();
     emit mapChanged();
 }
 
@@ -68,90 +99,136 @@ void MapModel::setVersion(const QString& version)
 }
 
 /**
- * @brief 添加节点
- * @param node 要添加的节点
- * @return 如果成功添加返回 true，否则返回 false
+ * @brief 开始批量修改
  */
-bool MapModel::addNode(const ConceptNode& node)
+void MapModel::beginTransaction()
 {
-    if (!m_conceptMap.addNode(node)) {
-        return false;
+    m_conceptMap.beginTransaction();
+}
+
+/**
+ * @brief 提交批量修改
+ * @return 本次事务的变更记录
+ */
+ChangeSet MapModel::commitTransaction()
+{
+    const ChangeSet changes = m_conceptMap.commit();
+    if (m_conceptMap.inTransaction() || changes.isEmpty()) {
+        return changes;
     }
 
-    m_nodeModel.addNode(node);
+    recordChanges(changes);
+    syncModels(changes);
+    emit changesCommitted(changes);
     emit mapChanged();
-
-    return true;
+    return changes;
 }
 
 /**
- * @brief 删除节点
- * @param nodeId 要删除的节点ID
- * @return 如果成功删除返回 true，否则返回 false
+ * @brief 同步已经写入概念图数据的变更
+ * @param changes 变更记录
  */
-bool MapModel::removeNode(const QString& nodeId)
+void MapModel::applyChanges(const ChangeSet& changes)
 {
-    if (!m_conceptMap.removeNode(nodeId)) {
-        return false;
+    if (changes.isEmpty()) {
+        return;
     }
 
-    // 从节点模型中删除
-    QModelIndex index = m_nodeModel.findIndexById(nodeId);
-    if (index.isValid()) {
-        m_nodeModel.removeNode(index);
+    recordChanges(changes);
+    syncModels(changes);
+    emit mapChanged();
+}
+
+/**
+ * @brief 按变更记录更新节点模型和连接线模型
+ * @param changes 变更记录
+ */
+void MapModel::syncModels(const ChangeSet& changes)
+{
+    // 变更覆盖了大部分行时，整体重新加载比逐行删除更便宜
+    if (changes.size() * 4 > m_conceptMap.nodeCount() + m_conceptMap.edgeCount()) {
+        m_nodeModel.reload();
+        m_edgeModel.reload();
+        return;
     }
 
-    // 从连接线模型中删除相关的连接线
-    QVector<ConceptEdge> relatedEdges = m_conceptMap.edgesByNodeId(nodeId);
-    for (const ConceptEdge& edge : relatedEdges) {
-        QModelIndex edgeIndex = m_edgeModel.findIndexById(edge.id());
-        if (edgeIndex.isValid()) {
-            m_edgeModel.removeEdge(edgeIndex);
+    for (EdgeId edgeId : changes.removedEdges()) {
+        QModelIndex index = m_edgeModel.findIndexById(edgeId);
+        if (index.isValid()) {
+            m_edgeModel.removeEdge(index);
         }
     }
+    for (NodeId nodeId : changes.removedNodes()) {
+        QModelIndex index = m_nodeModel.findIndexById(nodeId);
+        if (index.isValid()) {
+            m_nodeModel.removeNode(index);
+        }
+    }
+    for (NodeId nodeId : changes.insertedNodes()) {
+        m_nodeModel.addNode(nodeId);
+    }
+    for (EdgeId edgeId : changes.insertedEdges()) {
+        m_edgeModel.addEdge(edgeId);
+    }
 
-    emit mapChanged();
-
-    return true;
+    const QHash<NodeId, ChangeSet::NodeFields> modifiedNodes = changes.modifiedNodes();
+    for (auto it = modifiedNodes.constBegin(); it != modifiedNodes.constEnd(); ++it) {
+        m_nodeModel.updateNode(m_nodeModel.findIndexById(it.key()));
+    }
+    const QHash<EdgeId, ChangeSet::EdgeFields> modifiedEdges = changes.modifiedEdges();
+    for (auto it = modifiedEdges.constBegin(); it != modifiedEdges.constEnd(); ++it) {
+        m_edgeModel.updateEdge(m_edgeModel.findIndexById(it.key()));
+    }
 }
 
 /**
- * @brief 更新节点
- * @param node 要更新的节点
- * @return 如果成功更新返回 true，否则返回 false
+ * @brief 添加节点
+ * @param node 要添加的节点
+ * @return 如果成功添加返回 true，否则返回 false
  */
-bool MapModel::updateNode(const ConceptNode& node)
+bool MapModel::addNode(const ConceptNode& node)
 {
-    if (!m_conceptMap.updateNode(node)) {
-        return false;
-    }
+    beginTransaction();
+    const bool added = m_conceptMap.addNode(node);
+    commitTransaction();
 
-    QModelIndex index = m_nodeModel.findIndexById(node.id());
-    if (index.isValid()) {
-        m_nodeModel.updateNode(index, node);
-    }
+    return added;
+}
 
-    emit mapChanged();
+/**
+ * @brief 删除节点（相关连接线一并删除）
+ * @param nodeId 要删除的节点ID
+ * @return 如果成功删除返回 true，否则返回 false
+ */
+bool MapModel::removeNode(NodeId nodeId)
+{
+    beginTransaction();
+    const bool removed = m_conceptMap.removeNode(nodeId);
+    commitTransaction();
 
-    return true;
+    return removed;
 }
 
 /**
- * @brief 根据ID获取节点
- * @param id 节点ID
- * @return 节点指针，如果不存在则返回 nullptr
+ * @brief 更新节点
+ * @param node 要更新的节点
+ * @return 如果成功更新返回 true，否则返回 false
  */
-ConceptNode* MapModel::nodeById(const QString& id)
+bool MapModel::updateNode(const ConceptNode& node)
 {
-    return m_conceptMap.nodeById(id);
+    beginTransaction();
+    const bool updated = m_conceptMap.updateNode(node);
+    commitTransaction();
+
+    return updated;
 }
 
 /**
- * @brief 根据ID获取节点（常量版本）
+ * @brief 根据ID获取节点（只读，修改节点用 updateNode()）
  * @param id 节点ID
  * @return 节点指针，如果不存在则返回 nullptr
  */
-const ConceptNode* MapModel::nodeById(const QString& id) const
+const ConceptNode* MapModel::nodeById(NodeId id) const
 {
     return m_conceptMap.nodeById(id);
 }
@@ -163,14 +240,11 @@ const ConceptNode* MapModel::nodeById(const QString& id) const
  */
 bool MapModel::addEdge(const ConceptEdge& edge)
 {
-    if (!m_conceptMap.addEdge(edge)) {
-        return false;
-    }
-
-    m_edgeModel.addEdge(edge);
-    emit mapChanged();
+    beginTransaction();
+    const bool added = m_conceptMap.addEdge(edge);
+    commitTransaction();
 
-    return true;
+    return added;
 }
 
 /**
@@ -178,20 +252,13 @@ bool MapModel::addEdge(const ConceptEdge& edge)
  * @param edgeId 要删除的连接线ID
  * @return 如果成功删除返回 true，否则返回 false
  */
-bool MapModel::removeEdge(const QString& edgeId)
+bool MapModel::removeEdge(EdgeId edgeId)
 {
-    if (!m_conceptMap.removeEdge(edgeId)) {
-        return false;
-    }
-
-    QModelIndex index = m_edgeModel.findIndexById(edgeId);
-    if (index.isValid()) {
-        m_edgeModel.removeEdge(index);
-    }
-
-    emit mapChanged();
+    beginTransaction();
+    const bool removed = m_conceptMap.removeEdge(edgeId);
+    commitTransaction();
 
-    return true;
+    return removed;
 }
 
 /**
@@ -201,36 +268,19 @@ bool MapModel::removeEdge(const QString& edgeId)
  */
 bool MapModel::updateEdge(const ConceptEdge& edge)
 {
-    if (!m_conceptMap.updateEdge(edge)) {
-        return false;
-    }
-
-    QModelIndex index = m_edgeModel.findIndexById(edge.id());
-    if (index.isValid()) {
-        m_edgeModel.updateEdge(index, edge);
-    }
+    beginTransaction();
+    const bool updated = m_conceptMap.updateEdge(edge);
+    commitTransaction();
 
-    emit mapChanged();
-
-    return true;
-}
-
-/**
- * @brief 根据ID获取连接线
- * @param id 连接线ID
- * @return 连接线指针，如果不存在则返回 nullptr
- */
-ConceptEdge* MapModel::edgeById(const QString& id)
-{
-    return m_conceptMap.edgeById(id);
+    return updated;
 }
 
 /**
- * @brief 根据ID获取连接线（常量版本）
+ * @brief 根据ID获取连接线（只读，修改连接线用 updateEdge()）
  * @param id 连接线ID
  * @return 连接线指针，如果不存在则返回 nullptr
  */
-const ConceptEdge* MapModel::edgeById(const QString& id) const
+const ConceptEdge* MapModel::edgeById(EdgeId id) const
 {
     return m_conceptMap.edgeById(id);
 }
@@ -241,9 +291,13 @@ const ConceptEdge* MapModel::edgeById(const QString& id) const
 void MapModel::clear()
 {
     m_conceptMap.clear();
+    m_tiles.close();
     m_nodeModel.clear();
     m_edgeModel.clear();
+    m_unsavedChanges.clear();
+    m_needsFullSave = true;
 
+    emit mapReset();
     emit mapChanged();
 }
 
@@ -267,25 +321,19 @@ void MapModel::newMap(const QString& name)
  */
 bool MapModel::loadFromFile(const QString& filePath)
 {
-    // 根据文件扩展名选择加载方式
-    if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
-        if (!ConceptMapSerializer::loadFromJson(filePath, m_conceptMap)) {
-            return false;
-        }
-    } else if (filePath.endsWith(".xml", Qt::CaseInsensitive)) {
-        if (!ConceptMapSerializer::loadFromXml(filePath, m_conceptMap)) {
-            return false;
-        }
-    } else {
-        qWarning() << "不支持的文件格式:" << filePath;
+    waitForCompaction();
+
+    // 读入独立的概念图，失败时当前数据保持不变；文件中没有名称和版本时沿用当前值
+    ConceptMap map(m_conceptMap.name());
+    map.setVersion(m_conceptMap.version());
+    ConceptMapTiles tiles;
+    tiles.setBudget(m_tiles.budget());
+    const bool ok = isTiledFile(filePath) ? openTiledFile(filePath, map, tiles, nullptr) : readMapFile(filePath, map);
+    if (!ok) {
         return false;
     }
-
-    // 更新节点模型和连接线模型
-    m_nodeModel.setNodes(m_conceptMap.nodes());
-    m_edgeModel.setEdges(m_conceptMap.edges());
-
-    emit mapChanged();
+    m_tiles = tiles;
+    setLoadedMap(map);
     return true;
 }
 
@@ -296,13 +344,392 @@ bool MapModel::loadFromFile(const QString& filePath)
  */
 bool MapModel::saveToFile(const QString& filePath)
 {
-    // 根据文件扩展名选择保存方式
+    const ConceptMapSnapshot snapshot = beginSave();
+    bool success = false;
+    if (m_tiles.isOpen()) {
+        ConceptMapTiles tiles(m_tiles);
+        success = writeTiledMap(filePath, *snapshot, tiles, nullptr);
+        if (success && isTiledFile(filePath)) {
+            m_tiles.adoptSaved(tiles);
+        }
+    } else {
+        success = writeMapFile(filePath, *snapshot);
+    }
+    finishSave(filePath, success);
+    return success;
+}
+
+/**
+ * @brief 在后台线程中加载概念图
+ * @param filePath 文件路径
+ * @return 如果已有加载或保存在运行返回 false，否则返回 true
+ */
+bool MapModel::loadFromFileAsync(const QString& filePath)
+{
+    if (m_fileTask.isRunning()) {
+        return false;
+    }
+    waitForCompaction();
+
+    // 工作线程读入独立的概念图，文件中没有名称和版本时沿用当前值
+    const QSharedPointer<ConceptMap> map = QSharedPointer<ConceptMap>::create();
+    map->setName(m_conceptMap.name());
+    map->setVersion(m_conceptMap.version());
+
+    // 瓦片文件在工作线程中打开并载入初始区域
+    QSharedPointer<ConceptMapTiles> tiles;
+    if (isTiledFile(filePath)) {
+        tiles = QSharedPointer<ConceptMapTiles>::create();
+        tiles->setBudget(m_tiles.budget());
+    }
+
+    m_fileOperation = LoadOperation;
+    m_fileOperationPath = filePath;
+    m_loadedMap = map;
+    m_taskTiles = tiles;
+    return m_fileTask.start(QString("正在打开 %1").arg(QFileInfo(filePath).fileName()),
+                            [filePath, map, tiles](OperationProgress& progress) {
+        return tiles ? openTiledFile(filePath, *map, *tiles, &progress) : readMapFile(filePath, *map, &progress);
+    });
+}
+
+/**
+ * @brief 在后台线程中把快照保存到文件
+ * @param filePath 文件路径
+ * @return 如果已有加载或保存在运行返回 false，否则返回 true
+ */
+bool MapModel::saveToFileAsync(const QString& filePath)
+{
+    if (m_fileTask.isRunning()) {
+        return false;
+    }
+
+    // 按需载入的概念图交给存储的副本写回，保存期间分页暂停
+    QSharedPointer<ConceptMapTiles> tiles;
+    if (m_tiles.isOpen()) {
+        tiles = QSharedPointer<ConceptMapTiles>::create(m_tiles);
+    }
+
+    const ConceptMapSnapshot snapshot = beginSave();
+    m_fileOperation = SaveOperation;
+    m_fileOperationPath = filePath;
+    m_taskTiles = tiles;
+    return m_fileTask.start(QString("正在保存 %1").arg(QFileInfo(filePath).fileName()),
+                            [filePath, snapshot, tiles](OperationProgress& progress) {
+        return tiles ? writeTiledMap(filePath, *snapshot, *tiles, &progress)
+                     : writeMapFile(filePath, *snapshot, &progress);
+    });
+}
+
+/**
+ * @brief 按扩展名从文件读取概念图，并重放增量保存的日志
+ * @param filePath 文件路径
+ * @param map 概念图对象（失败时保持不变）
+ * @param progress 进度，可以为 nullptr
+ * @return 如果成功读取返回 true，否则返回 false
+ */
+bool MapModel::readMapFile(const QString& filePath, ConceptMap& map, OperationProgress* progress)
+{
+    return ConceptMapSerializer::loadFromFile(filePath, map, progress);
+}
+
+/**
+ * @brief 按扩展名把概念图完整写入文件
+ * @param filePath 文件路径
+ * @param map 概念图对象
+ * @param progress 进度，可以为 nullptr
+ * @return 如果成功写入返回 true，否则返回 false
+ */
+bool MapModel::writeMapFile(const QString& filePath, const ConceptMap& map, OperationProgress* progress)
+{
     if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
-        return ConceptMapSerializer::saveToJson(filePath, m_conceptMap);
+        return ConceptMapSerializer::saveToJson(filePath, map, progress);
     } else if (filePath.endsWith(".xml", Qt::CaseInsensitive)) {
-        return ConceptMapSerializer::saveToXml(filePath, m_conceptMap);
+        return ConceptMapSerializer::saveToXml(filePath, map, progress);
+    } else if (filePath.endsWith(".cmapb", Qt::CaseInsensitive)) {
+        return ConceptMapSerializer::saveToBinary(filePath, map, progress);
+    } else if (filePath.endsWith(".cmapz", Qt::CaseInsensitive)) {
+        return ConceptMapSerializer::saveToCompressed(filePath, map, progress);
+    } else if (isTiledFile(filePath)) {
+        return ConceptMapSerializer::saveToTiles(filePath, map, progress);
     } else {
         qWarning() << "不支持的文件格式:" << filePath;
         return false;
     }
 }
+
+/**
+ * @brief 增量保存：把上次保存以来的变更追加到文件的日志
+ * @param filePath 基础文件路径（上次加载或保存的文件）
+ * @return 如果成功保存返回 true，否则返回 false
+ */
+bool MapModel::saveIncremental(const QString& filePath)
+{
+    if (!canSaveIncrementally(filePath)) {
+        return saveToFile(filePath);
+    }
+    if (m_unsavedChanges.isEmpty()) {
+        return true;
+    }
+
+    // 日志不属于基础文件（例如完整保存后没来得及删除的旧日志）时不覆盖，改为完整保存
+    if (!ConceptMapJournal::append(filePath, m_conceptMap, m_unsavedChanges)) {
+        return saveToFile(filePath);
+    }
+    m_unsavedChanges.clear();
+
+    if (!m_compaction.isRunning() && ConceptMapJournal::needsCompaction(filePath)) {
+        startCompaction(filePath);
+    }
+    return true;
+}
+
+/**
+ * @brief 检查增量保存能否只追加日志
+ *
+ * 文件不存在、或概念图被整体替换过（新建、清空、设置整图）时需要完整保存。
+ * 瓦片文件不使用日志，保存时直接写回修改过的瓦片。
+ *
+ * @param filePath 基础文件路径
+ * @return 如果只需追加日志返回 true，需要完整保存时返回 false
+ */
+bool MapModel::canSaveIncrementally(const QString& filePath) const
+{
+    return !m_needsFullSave && !m_tiles.isOpen() && !isTiledFile(filePath) && QFile::exists(filePath);
+}
+
+/**
+ * @brief 按可见区域载入附近的瓦片，并卸载超出内存预算的瓦片
+ * @param region 可见区域（场景坐标）
+ * @return 如果概念图发生变化返回 true，否则返回 false
+ */
+bool MapModel::pageRegion(const QRectF& region)
+{
+    // 后台加载和保存期间存储由工作线程使用；事务中途不能混入分页的修改
+    if (!m_tiles.isOpen() || m_fileTask.isRunning() || m_conceptMap.inTransaction()) {
+        return false;
+    }
+
+    m_conceptMap.beginTransaction();
+    m_tiles.page(m_conceptMap, region);
+    const ChangeSet changes = m_conceptMap.commit();
+    if (changes.isEmpty()) {
+        return false;
+    }
+
+    // 载入和卸载不是编辑：不计入未保存的变更，也不发出 mapChanged()
+    syncModels(changes);
+    emit changesCommitted(changes);
+    return true;
+}
+
+/**
+ * @brief 检查文件是否为瓦片格式（.cmapt）
+ * @param filePath 文件路径
+ * @return 如果是返回 true，否则返回 false
+ */
+bool MapModel::isTiledFile(const QString& filePath)
+{
+    return filePath.endsWith(".cmapt", Qt::CaseInsensitive);
+}
+
+/**
+ * @brief 记录一次编辑：累积到未保存的变更，并标记受影响的瓦片
+ * @param changes 变更记录
+ */
+void MapModel::recordChanges(const ChangeSet& changes)
+{
+    m_unsavedChanges.merge(changes);
+    m_tiles.markDirty(changes, m_conceptMap);
+}
+
+/**
+ * @brief 打开瓦片文件并载入初始区域
+ * @param filePath 文件路径
+ * @param map 概念图对象（失败时保持不变）
+ * @param tiles 瓦片存储
+ * @param progress 进度，可以为 nullptr
+ * @return 如果成功打开返回 true，否则返回 false
+ */
+bool MapModel::openTiledFile(const QString& filePath, ConceptMap& map, ConceptMapTiles& tiles,
+                             OperationProgress* progress)
+{
+    if (!tiles.open(filePath)) {
+        return false;
+    }
+    ConceptMap loaded(tiles.mapName());
+    loaded.setVersion(tiles.mapVersion());
+    if (!tiles.page(loaded, tiles.initialRegion(), progress)) {
+        return false;
+    }
+    map = loaded;
+    return true;
+}
+
+/**
+ * @brief 保存按需载入的概念图
+ * @param filePath 文件路径
+ * @param map 已载入的概念图
+ * @param tiles 瓦片存储（的副本）
+ * @param progress 进度，可以为 nullptr
+ * @return 如果成功写入返回 true，否则返回 false
+ */
+bool MapModel::writeTiledMap(const QString& filePath, const ConceptMap& map, ConceptMapTiles& tiles,
+                             OperationProgress* progress)
+{
+    if (isTiledFile(filePath)) {
+        return tiles.writeBack(filePath, map, progress);
+    }
+
+    // 其它格式需要完整的概念图，未载入的瓦片读进副本（修改过的瓦片从不卸载）
+    ConceptMap full(map);
+    if (!tiles.loadAll(full, progress)) {
+        return false;
+    }
+    return writeMapFile(filePath, full, progress);
+}
+
+/**
+ * @brief 把快照写入基础文件并在完成后清理日志（在后台线程中写入）
+ * @param filePath 基础文件路径
+ */
+void MapModel::startCompaction(const QString& filePath)
+{
+    // 快照与基础文件加日志的内容一致，之后的保存写入新日志
+    if (!ConceptMapJournal::beginCompaction(filePath)) {
+        qWarning() << "无法开始整理日志:" << filePath;
+        return;
+    }
+
+    const ConceptMapSnapshot snapshot = m_conceptMap.snapshot();
+    m_compactingPath = filePath;
+    m_compaction.setFuture(QtConcurrent::run([filePath, snapshot]() {
+        return writeMapFile(filePath, *snapshot);
+    }));
+}
+
+/**
+ * @brief 整理结束后清理日志并发出 compactionFinished()
+ */
+void MapModel::finishCompaction()
+{
+    // waitForCompaction() 已经处理过时，稍后到达的 finished 信号不再重复处理
+    if (m_compactingPath.isEmpty()) {
+        return;
+    }
+
+    const QString filePath = m_compactingPath;
+    m_compactingPath.clear();
+    const bool success = m_compaction.result();
+    if (success) {
+        ConceptMapJournal::finishCompaction(filePath);
+    } else {
+        // 整理日志保留，下次打开时仍会重放，下次整理时接着使用
+        qWarning() << "整理日志失败:" << filePath;
+    }
+    emit compactionFinished(filePath, success);
+}
+
+/**
+ * @brief 等待正在进行的整理完成
+ */
+void MapModel::waitForCompaction()
+{
+    if (!m_compactingPath.isEmpty()) {
+        m_compaction.waitForFinished();
+        finishCompaction();
+    }
+}
+
+/**
+ * @brief 用加载完成的概念图替换当前数据
+ * @param map 加载完成的概念图
+ */
+void MapModel::setLoadedMap(const ConceptMap& map)
+{
+    m_conceptMap = map;
+    m_unsavedChanges.clear();
+    m_needsFullSave = false;
+
+    // 更新节点模型和连接线模型
+    m_nodeModel.reload();
+    m_edgeModel.reload();
+
+    emit mapReset();
+    emit mapChanged();
+}
+
+/**
+ * @brief 开始完整保存：取得快照，并把已累积的变更移到一边
+ *
+ * 保存期间的修改照常累积，保存成功后它们就是下次增量保存的内容。
+ *
+ * @return 要写入文件的快照
+ */
+ConceptMapSnapshot MapModel::beginSave()
+{
+    // 不能与后台整理同时写同一个文件
+    waitForCompaction();
+
+    m_savingChanges = m_unsavedChanges;
+    m_savingNeedsFullSave = m_needsFullSave;
+    m_unsavedChanges.clear();
+    m_needsFullSave = false;
+    return m_conceptMap.snapshot();
+}
+
+/**
+ * @brief 完整保存结束
+ *
+ * 成功时清理日志；失败时把保存前的变更放回，下次仍然保存它们。
+ *
+ * @param filePath 文件路径
+ * @param success 是否成功写入
+ */
+void MapModel::finishSave(const QString& filePath, bool success)
+{
+    if (success) {
+        // 基础文件已经包含快照的全部内容，日志不再需要
+        ConceptMapJournal::discard(filePath);
+    } else {
+        ChangeSet changes = m_savingChanges;
+        changes.merge(m_unsavedChanges);
+        m_unsavedChanges = changes;
+        m_needsFullSave = m_needsFullSave || m_savingNeedsFullSave;
+    }
+    m_savingChanges.clear();
+}
+
+/**
+ * @brief 后台加载或保存结束后更新模型并发出对应的信号
+ * @param success 是否成功（被取消时为 false）
+ */
+void MapModel::finishFileTask(bool success)
+{
+    const QString filePath = m_fileOperationPath;
+    m_fileOperationPath.clear();
+
+    const QSharedPointer<ConceptMapTiles> tiles = m_taskTiles;
+    m_taskTiles.reset();
+
+    if (m_fileOperation == LoadOperation) {
+        const QSharedPointer<ConceptMap> map = m_loadedMap;
+        m_loadedMap.reset();
+        if (success) {
+            if (tiles) {
+                m_tiles = *tiles;
+            } else {
+                m_tiles.close();
+            }
+            setLoadedMap(*map);
+        }
+        emit loadFinished(filePath, success);
+    } else {
+        // 写回瓦片文件成功后存储指向新文件；另存为其它格式时仍指向原来的瓦片文件
+        if (success && tiles && isTiledFile(filePath)) {
+            m_tiles.adoptSaved(*tiles);
+        }
+        finishSave(filePath, success);
+        emit saveFinished(filePath, success);
+    }
+}
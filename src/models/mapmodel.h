@@ -2,7 +2,11 @@
 #define MAPMODEL_H
 
 #include <QObject>
+#include <QFutureWatcher>
+#include <QSharedPointer>
 #include "conceptmap.h"
+#include "conceptmaptiles.h"
+#include "backgroundtask.h"
 #include "nodemodel.h"
 #include "edgemodel.h"
 
@@ -13,6 +17,25 @@
  * - 节点和连接线的统一管理
  * - 数据同步
  * - 文件操作
+ *
+ * 在 beginTransaction()/commitTransaction() 之间的修改只写入概念图数据，
+ * 提交时按变更记录一次性更新节点模型和连接线模型，并只发出一次
+ * changesCommitted() 和 mapChanged() 信号。
+ *
+ * 概念图数据只有这一份：节点模型、连接线模型和图形场景都绑定到
+ * editableMap() 返回的对象上，按ID读取，不再各自保存副本。
+ * 其它观察者直接修改数据后，通过 applyChanges() 通知本模型。
+ *
+ * 模型累积上次保存以来的所有变更记录，saveIncremental() 只把这些变更追加到
+ * 基础文件旁边的日志（ConceptMapJournal），日志过大时在后台整理回基础文件。
+ *
+ * loadFromFileAsync()/saveToFileAsync() 在线程池中读写文件：保存写的是开始时的
+ * 快照，保存期间可以继续编辑；加载读入独立的概念图，完成后才替换当前数据。
+ * 结果通过 loadFinished()/saveFinished() 通知，进度和取消通过 fileTask()。
+ *
+ * 瓦片文件（.cmapt）打开后只载入初始区域，视图通过 pageRegion() 按可见区域
+ * 载入和卸载瓦片；分页以一次事务提交，发出 changesCommitted()，但不算作修改。
+ * 保存回瓦片文件时只重新编码修改过的瓦片，另存为其它格式时先补齐未载入的瓦片。
  */
 class MapModel : public QObject
 {
@@ -35,7 +58,19 @@ public:
      * @brief 获取概念图数据
      * @return 概念图数据
      */
-    ConceptMap conceptMap() const { return m_conceptMap; }
+    const ConceptMap& conceptMap() const { return m_conceptMap; }
+
+    /**
+     * @brief 创建概念图的只读快照（可交给后台线程读取）
+     * @return 快照
+     */
+    ConceptMapSnapshot snapshot() const { return m_conceptMap.snapshot(); }
+
+    /**
+     * @brief 获取可修改的概念图数据（供图形场景绑定同一份数据）
+     * @return 概念图数据
+     */
+    ConceptMap& editableMap() { return m_conceptMap; }
 
     /**
      * @brief 获取节点模型
@@ -98,6 +133,28 @@ public:
      */
     void setVersion(const QString& version);
 
+    // 事务
+    /**
+     * @brief 开始批量修改
+     */
+    void beginTransaction();
+
+    /**
+     * @brief 提交批量修改
+     * @return 本次事务的变更记录
+     */
+    ChangeSet commitTransaction();
+
+    /**
+     * @brief 同步已经写入概念图数据的变更
+     *
+     * 用于场景等观察者直接修改共享数据之后，只更新受影响的表格行，
+     * 不会再次发出 changesCommitted() 信号。
+     *
+     * @param changes 变更记录
+     */
+    void applyChanges(const ChangeSet& changes);
+
     // 节点操作
     /**
      * @brief 添加节点
@@ -107,11 +164,11 @@ public:
     bool addNode(const ConceptNode& node);
 
     /**
-     * @brief 删除节点
+     * @brief 删除节点（相关连接线一并删除）
      * @param nodeId 要删除的节点ID
      * @return 如果成功删除返回 true，否则返回 false
      */
-    bool removeNode(const QString& nodeId);
+    bool removeNode(NodeId nodeId);
 
     /**
      * @brief 更新节点
@@ -121,18 +178,11 @@ public:
     bool updateNode(const ConceptNode& node);
 
     /**
-     * @brief 根据ID获取节点
-     * @param id 节点ID
-     * @return 节点指针，如果不存在则返回 nullptr
-     */
-    ConceptNode* nodeById(const QString& id);
-
-    /**
-     * @brief 根据ID获取节点（常量版本）
+     * @brief 根据ID获取节点（只读，修改节点用 updateNode()）
      * @param id 节点ID
      * @return 节点指针，如果不存在则返回 nullptr
      */
-    const ConceptNode* nodeById(const QString& id) const;
+    const ConceptNode* nodeById(NodeId id) const;
 
     // 连接线操作
     /**
@@ -147,7 +197,7 @@ public:
      * @param edgeId 要删除的连接线ID
      * @return 如果成功删除返回 true，否则返回 false
      */
-    bool removeEdge(const QString& edgeId);
+    bool removeEdge(EdgeId edgeId);
 
     /**
      * @brief 更新连接线
@@ -157,18 +207,11 @@ public:
     bool updateEdge(const ConceptEdge& edge);
 
     /**
-     * @brief 根据ID获取连接线
-     * @param id 连接线ID
-     * @return 连接线指针，如果不存在则返回 nullptr
-     */
-    ConceptEdge* edgeById(const QString& id);
-
-    /**
-     * @brief 根据ID获取连接线（常量版本）
+     * @brief 根据ID获取连接线（只读，修改连接线用 updateEdge()）
      * @param id 连接线ID
      * @return 连接线指针，如果不存在则返回 nullptr
      */
-    const ConceptEdge* edgeById(const QString& id) const;
+    const ConceptEdge* edgeById(EdgeId id) const;
 
     /**
      * @brief 清空概念图
@@ -195,12 +238,115 @@ public:
      */
     bool saveToFile(const QString& filePath);
 
+    /**
+     * @brief 在后台线程中加载概念图，完成后发出 loadFinished()
+     * @param filePath 文件路径
+     * @return 如果已有加载或保存在运行返回 false，否则返回 true
+     */
+    bool loadFromFileAsync(const QString& filePath);
+
+    /**
+     * @brief 在后台线程中把当前概念图的快照保存到文件，完成后发出 saveFinished()
+     * @param filePath 文件路径
+     * @return 如果已有加载或保存在运行返回 false，否则返回 true
+     */
+    bool saveToFileAsync(const QString& filePath);
+
+    /**
+     * @brief 获取后台加载和保存任务（用于显示进度和取消）
+     * @return 后台任务
+     */
+    BackgroundTask* fileTask() { return &m_fileTask; }
+
+    /**
+     * @brief 检查是否正在后台加载
+     * @return 如果正在加载返回 true，否则返回 false
+     */
+    bool isLoading() const { return m_fileTask.isRunning() && m_fileOperation == LoadOperation; }
+
+    /**
+     * @brief 检查当前概念图是否来自按需载入的瓦片文件
+     * @return 如果是返回 true，否则返回 false
+     */
+    bool isTiled() const { return m_tiles.isOpen(); }
+
+    /**
+     * @brief 按可见区域载入附近的瓦片，并卸载超出内存预算的瓦片
+     *
+     * 没有打开瓦片文件、后台加载或保存期间、事务进行中时不做任何事。
+     *
+     * @param region 可见区域（场景坐标）
+     * @return 如果概念图发生变化返回 true，否则返回 false
+     */
+    bool pageRegion(const QRectF& region);
+
+    /**
+     * @brief 检查文件是否为瓦片格式（.cmapt）
+     * @param filePath 文件路径
+     * @return 如果是返回 true，否则返回 false
+     */
+    static bool isTiledFile(const QString& filePath);
+
+    /**
+     * @brief 检查增量保存能否只追加日志
+     * @param filePath 基础文件路径
+     * @return 如果只需追加日志返回 true，需要完整保存时返回 false
+     */
+    bool canSaveIncrementally(const QString& filePath) const;
+
+    /**
+     * @brief 按扩展名从文件读取概念图，并重放增量保存的日志（可在任意线程调用）
+     * @param filePath 文件路径
+     * @param map 概念图对象（失败时保持不变）
+     * @param progress 进度，可以为 nullptr
+     * @return 如果成功读取返回 true，否则返回 false
+     */
+    static bool readMapFile(const QString& filePath, ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 按扩展名把概念图完整写入文件（可在任意线程调用）
+     * @param filePath 文件路径
+     * @param map 概念图对象
+     * @param progress 进度，可以为 nullptr
+     * @return 如果成功写入返回 true，否则返回 false
+     */
+    static bool writeMapFile(const QString& filePath, const ConceptMap& map, OperationProgress* progress = nullptr);
+
+    /**
+     * @brief 增量保存：把上次保存以来的变更追加到文件的日志
+     *
+     * 文件不存在、或概念图被整体替换过（新建、清空、设置整图）、或已有的日志不属于
+     * 该文件时改为完整保存；没有未保存的变更时什么也不做。
+     * 日志过大时启动后台整理，完成后发出 compactionFinished()。
+     *
+     * @param filePath 基础文件路径（上次加载或保存的文件）
+     * @return 如果成功保存返回 true，否则返回 false
+     */
+    bool saveIncremental(const QString& filePath);
+
+    /**
+     * @brief 检查是否正在后台整理日志
+     * @return 如果正在整理返回 true，否则返回 false
+     */
+    bool isCompacting() const { return m_compaction.isRunning(); }
+
 signals:
+    /**
+     * @brief 批量修改提交信号
+     * @param changes 本次事务的变更记录
+     */
+    void changesCommitted(const ChangeSet& changes);
+
     /**
      * @brief 概念图变化信号
      */
     void mapChanged();
 
+    /**
+     * @brief 概念图数据被整体替换信号（新建、加载、清空）
+     */
+    void mapReset();
+
     /**
      * @brief 节点添加信号
      * @param node 添加的节点
@@ -211,7 +357,7 @@ signals:
      * @brief 节点删除信号
      * @param nodeId 删除的节点ID
      */
-    void nodeRemoved(const QString& nodeId);
+    void nodeRemoved(NodeId nodeId);
 
     /**
      * @brief 节点更新信号
@@ -229,7 +375,7 @@ signals:
      * @brief 连接线删除信号
      * @param edgeId 删除的连接线ID
      */
-    void edgeRemoved(const QString& edgeId);
+    void edgeRemoved(EdgeId edgeId);
 
     /**
      * @brief 连接线更新信号
@@ -237,10 +383,128 @@ signals:
      */
     void edgeUpdated(const ConceptEdge& edge);
 
+    /**
+     * @brief 后台整理日志完成信号
+     * @param filePath 基础文件路径
+     * @param success 是否成功写入基础文件
+     */
+    void compactionFinished(const QString& filePath, bool success);
+
+    /**
+     * @brief 后台加载结束信号
+     * @param filePath 文件路径
+     * @param success 是否成功（被取消时为 false，概念图保持不变）
+     */
+    void loadFinished(const QString& filePath, bool success);
+
+    /**
+     * @brief 后台保存结束信号
+     * @param filePath 文件路径
+     * @param success 是否成功（被取消时为 false，目标文件保持不变）
+     */
+    void saveFinished(const QString& filePath, bool success);
+
 private:
+    // 后台任务正在进行的文件操作
+    enum FileOperation {
+        LoadOperation,
+        SaveOperation
+    };
+
+    /**
+     * @brief 按变更记录更新节点模型和连接线模型
+     * @param changes 变更记录
+     */
+    void syncModels(const ChangeSet& changes);
+
+    /**
+     * @brief 记录一次编辑：累积到未保存的变更，并标记受影响的瓦片
+     * @param changes 变更记录
+     */
+    void recordChanges(const ChangeSet& changes);
+
+    /**
+     * @brief 打开瓦片文件并载入初始区域
+     * @param filePath 文件路径
+     * @param map 概念图对象（失败时保持不变）
+     * @param tiles 瓦片存储
+     * @param progress 进度，可以为 nullptr
+     * @return 如果成功打开返回 true，否则返回 false
+     */
+    static bool openTiledFile(const QString& filePath, ConceptMap& map, ConceptMapTiles& tiles,
+                              OperationProgress* progress);
+
+    /**
+     * @brief 保存按需载入的概念图
+     *
+     * 保存为瓦片文件时只写回修改过的瓦片；其它格式先把未载入的瓦片读进副本，
+     * 再完整写入。
+     *
+     * @param filePath 文件路径
+     * @param map 已载入的概念图
+     * @param tiles 瓦片存储（的副本）
+     * @param progress 进度，可以为 nullptr
+     * @return 如果成功写入返回 true，否则返回 false
+     */
+    static bool writeTiledMap(const QString& filePath, const ConceptMap& map, ConceptMapTiles& tiles,
+                              OperationProgress* progress);
+
+    /**
+     * @brief 把快照写入基础文件并在完成后清理日志（在后台线程中写入）
+     * @param filePath 基础文件路径
+     */
+    void startCompaction(const QString& filePath);
+
+    /**
+     * @brief 整理结束后清理日志并发出 compactionFinished()
+     */
+    void finishCompaction();
+
+    /**
+     * @brief 等待正在进行的整理完成
+     */
+    void waitForCompaction();
+
+    /**
+     * @brief 用加载完成的概念图替换当前数据
+     * @param map 加载完成的概念图
+     */
+    void setLoadedMap(const ConceptMap& map);
+
+    /**
+     * @brief 开始完整保存：取得快照，并把已累积的变更移到一边
+     * @return 要写入文件的快照
+     */
+    ConceptMapSnapshot beginSave();
+
+    /**
+     * @brief 完整保存结束：成功时清理日志，失败时放回保存前的变更
+     * @param filePath 文件路径
+     * @param success 是否成功写入
+     */
+    void finishSave(const QString& filePath, bool success);
+
+    /**
+     * @brief 后台加载或保存结束后更新模型并发出对应的信号
+     * @param success 是否成功（被取消时为 false）
+     */
+    void finishFileTask(bool success);
+
     ConceptMap m_conceptMap;    // 概念图数据
     NodeModel m_nodeModel;      // 节点模型
     EdgeModel m_edgeModel;      // 连接线模型
+    ChangeSet m_unsavedChanges; // 上次保存以来的变更
+    bool m_needsFullSave;       // 概念图被整体替换过，下次必须完整保存
+    QFutureWatcher<bool> m_compaction;  // 后台整理
+    QString m_compactingPath;   // 正在整理的基础文件
+    ChangeSet m_savingChanges;  // 正在完整保存的快照之前的变更（失败时放回）
+    bool m_savingNeedsFullSave; // 开始完整保存前的 m_needsFullSave
+    BackgroundTask m_fileTask;  // 后台加载和保存
+    FileOperation m_fileOperation;      // 后台任务正在进行的文件操作
+    QString m_fileOperationPath;        // 后台任务读写的文件
+    QSharedPointer<ConceptMap> m_loadedMap; // 后台加载读入的概念图
+    ConceptMapTiles m_tiles;    // 瓦片文件的存储，未打开表示概念图完整在内存中
+    QSharedPointer<ConceptMapTiles> m_taskTiles;    // 后台加载打开、或后台保存写回的存储
 };
 
 #endif // MAPMODEL_H
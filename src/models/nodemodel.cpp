@@ -6,6 +6,7 @@
  */
 NodeModel::NodeModel(QObject* parent)
     : QAbstractTableModel(parent)
+    , m_map(nullptr)
 {
 }
 
@@ -24,7 +25,7 @@ NodeModel::~NodeModel()
 int NodeModel::rowCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
-    return m_nodes.size();
+    return m_rows.size();
 }
 
 /**
@@ -46,15 +47,16 @@ int NodeModel::columnCount(const QModelIndex& parent) const
  */
 QVariant NodeModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_nodes.size()) {
+    const ConceptNode* stored = nodeAt(index);
+    if (!stored) {
         return QVariant();
     }
 
-    const ConceptNode& node = m_nodes[index.row()];
+    const ConceptNode& node = *stored;
 
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         switch (index.column()) {
-            case 0: return node.id();
+            case 0: return IdRegistry::toUuid(node.id());
             case 1: return node.text();
             case 2: return node.x();
             case 3: return node.y();
@@ -80,11 +82,12 @@ QVariant NodeModel::data(const QModelIndex& index, int role) const
  */
 bool NodeModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
-    if (!index.isValid() || index.row() >= m_nodes.size() || role != Qt::EditRole) {
+    const ConceptNode* stored = nodeAt(index);
+    if (!stored || role != Qt::EditRole) {
         return false;
     }
 
-    ConceptNode& node = m_nodes[index.row()];
+    ConceptNode node = *stored;
 
     switch (index.column()) {
         case 1:
@@ -106,8 +109,15 @@ bool NodeModel::setData(const QModelIndex& index, const QVariant& value, int rol
             return false;
     }
 
+    m_map->beginTransaction();
+    m_map->updateNode(node);
+    const ChangeSet changes = m_map->commit();
+
     emit dataChanged(index, index, {role});
     emit nodeUpdated(node);
+    if (!changes.isEmpty()) {
+        emit changesCommitted(changes);
+    }
 
     return true;
 }
@@ -156,24 +166,39 @@ Qt::ItemFlags NodeModel::flags(const QModelIndex& index) const
 }
 
 /**
- * @brief 添加节点
- * @param node 要添加的节点
+ * @brief 绑定概念图数据并重新加载所有行
+ * @param map 概念图数据
  */
-void NodeModel::addNode(const ConceptNode& node)
+void NodeModel::setConceptMap(ConceptMap* map)
 {
-    if (m_nodeIndexMap.contains(node.id())) {
+    m_map = map;
+    reload();
+}
+
+/**
+ * @brief 为概念图中已有的节点添加一行
+ * @param id 节点ID
+ */
+void NodeModel::addNode(NodeId id)
+{
+    if (!m_map || m_nodeIndexMap.contains(id)) {
         return;
     }
 
-    int row = m_nodes.size();
+    const ConceptNode* node = m_map->nodeById(id);
+    if (!node) {
+        return;
+    }
+
+    int row = m_rows.size();
     beginInsertRows(QModelIndex(), row, row);
 
-    m_nodes.append(node);
-    m_nodeIndexMap[node.id()] = row;
+    m_rows.append(id);
+    m_nodeIndexMap[id] = row;
 
     endInsertRows();
 
-    emit nodeAdded(node);
+    emit nodeAdded(*node);
 }
 
 /**
@@ -182,20 +207,21 @@ void NodeModel::addNode(const ConceptNode& node)
  */
 void NodeModel::removeNode(const QModelIndex& index)
 {
-    if (!index.isValid() || index.row() >= m_nodes.size()) {
+    if (!index.isValid() || index.row() >= m_rows.size()) {
         return;
     }
 
-    QString nodeId = m_nodes[index.row()].id();
+    const int row = index.row();
+    NodeId nodeId = m_rows[row];
 
-    beginRemoveRows(QModelIndex(), index.row(), index.row());
+    beginRemoveRows(QModelIndex(), row, row);
 
-    m_nodes.removeAt(index.row());
+    m_rows.removeAt(row);
+    m_nodeIndexMap.remove(nodeId);
 
-    // 更新索引映射
-    m_nodeIndexMap.clear();
-    for (int i = 0; i < m_nodes.size(); ++i) {
-        m_nodeIndexMap[m_nodes[i].id()] = i;
+    // 只有被删除行之后的行号发生变化
+    for (int i = row; i < m_rows.size(); ++i) {
+        m_nodeIndexMap[m_rows[i]] = i;
     }
 
     endRemoveRows();
@@ -204,76 +230,62 @@ void NodeModel::removeNode(const QModelIndex& index)
 }
 
 /**
- * @brief 更新节点
+ * @brief 通知节点数据已在概念图中更新
  * @param index 模型索引
- * @param node 新的节点数据
  */
-void NodeModel::updateNode(const QModelIndex& index, const ConceptNode& node)
+void NodeModel::updateNode(const QModelIndex& index)
 {
-    if (!index.isValid() || index.row() >= m_nodes.size()) {
+    const ConceptNode* node = nodeAt(index);
+    if (!node) {
         return;
     }
 
-    m_nodes[index.row()] = node;
-
-    emit dataChanged(index, index);
-    emit nodeUpdated(node);
-}
-
-/**
- * @brief 根据索引获取节点
- * @param index 模型索引
- * @return 节点指针，如果不存在则返回 nullptr
- */
-ConceptNode* NodeModel::nodeAt(const QModelIndex& index)
-{
-    if (!index.isValid() || index.row() >= m_nodes.size()) {
-        return nullptr;
-    }
-
-    return &m_nodes[index.row()];
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), columnCount() - 1));
+    emit nodeUpdated(*node);
 }
 
 /**
- * @brief 根据索引获取节点（常量版本）
+ * @brief 根据索引获取节点（只读）
  * @param index 模型索引
  * @return 节点指针，如果不存在则返回 nullptr
  */
 const ConceptNode* NodeModel::nodeAt(const QModelIndex& index) const
 {
-    if (!index.isValid() || index.row() >= m_nodes.size()) {
+    if (!m_map || !index.isValid() || index.row() >= m_rows.size()) {
         return nullptr;
     }
 
-    return &m_nodes[index.row()];
+    return m_map->nodeById(m_rows[index.row()]);
 }
 
 /**
- * @brief 根据ID获取节点
+ * @brief 根据ID获取节点（只读）
  * @param id 节点ID
  * @return 节点指针，如果不存在则返回 nullptr
  */
-ConceptNode* NodeModel::nodeById(const QString& id)
+const ConceptNode* NodeModel::nodeById(NodeId id) const
 {
-    if (!m_nodeIndexMap.contains(id)) {
+    if (!m_map || !m_nodeIndexMap.contains(id)) {
         return nullptr;
     }
 
-    return &m_nodes[m_nodeIndexMap[id]];
+    return m_map->nodeById(id);
 }
 
 /**
- * @brief 根据ID获取节点（常量版本）
- * @param id 节点ID
- * @return 节点指针，如果不存在则返回 nullptr
+ * @brief 获取所有节点（按行顺序复制）
+ * @return 节点列表
  */
-const ConceptNode* NodeModel::nodeById(const QString& id) const
+QVector<ConceptNode> NodeModel::nodes() const
 {
-    if (!m_nodeIndexMap.contains(id)) {
-        return nullptr;
+    QVector<ConceptNode> result;
+    result.reserve(m_rows.size());
+    for (NodeId id : m_rows) {
+        if (const ConceptNode* node = nodeById(id)) {
+            result.append(*node);
+        }
     }
-
-    return &m_nodes[m_nodeIndexMap[id]];
+    return result;
 }
 
 /**
@@ -283,26 +295,28 @@ void NodeModel::clear()
 {
     beginResetModel();
 
-    m_nodes.clear();
+    m_rows.clear();
     m_nodeIndexMap.clear();
 
     endResetModel();
 }
 
 /**
- * @brief 设置节点列表
- * @param nodes 节点列表
+ * @brief 按概念图数据重新生成所有行
  */
-void NodeModel::setNodes(const QVector<ConceptNode>& nodes)
+void NodeModel::reload()
 {
     beginResetModel();
 
-    m_nodes = nodes;
-
-    // 更新索引映射
+    m_rows.clear();
     m_nodeIndexMap.clear();
-    for (int i = 0; i < m_nodes.size(); ++i) {
-        m_nodeIndexMap[m_nodes[i].id()] = i;
+
+    if (m_map) {
+        m_rows.reserve(m_map->nodeCount());
+        for (const ConceptNode& node : m_map->allNodes()) {
+            m_nodeIndexMap[node.id()] = m_rows.size();
+            m_rows.append(node.id());
+        }
     }
 
     endResetModel();
@@ -313,7 +327,7 @@ void NodeModel::setNodes(const QVector<ConceptNode>& nodes)
  * @param id 节点ID
  * @return 模型索引
  */
-QModelIndex NodeModel::findIndexById(const QString& id) const
+QModelIndex NodeModel::findIndexById(NodeId id) const
 {
     if (!m_nodeIndexMap.contains(id)) {
         return QModelIndex();
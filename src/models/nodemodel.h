@@ -3,8 +3,9 @@
 
 #include <QAbstractTableModel>
 #include <QBrush>
+#include <QHash>
 #include <QVector>
-#include "conceptnode.h"
+#include "conceptmap.h"
 
 /**
  * @brief 节点模型类（继承 QAbstractTableModel）
@@ -13,6 +14,9 @@
  * - 节点数据的增删改查
  * - 数据持久化
  * - 数据验证
+ *
+ * 模型本身不保存节点数据，只保存行顺序（节点ID列表），
+ * 显示和编辑时直接读写绑定的概念图数据。
  */
 class NodeModel : public QAbstractTableModel
 {
@@ -78,59 +82,50 @@ public:
      */
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
-    // 节点操作
     /**
-     * @brief 添加节点
-     * @param node 要添加的节点
+     * @brief 绑定概念图数据并重新加载所有行
+     * @param map 概念图数据
      */
-    void addNode(const ConceptNode& node);
+    void setConceptMap(ConceptMap* map);
 
+    // 节点操作
     /**
-     * @brief 删除节点
-     * @param index 模型索引
+     * @brief 为概念图中已有的节点添加一行
+     * @param id 节点ID
      */
-    void removeNode(const QModelIndex& index);
+    void addNode(NodeId id);
 
     /**
-     * @brief 更新节点
+     * @brief 删除节点
      * @param index 模型索引
-     * @param node 新的节点数据
      */
-    void updateNode(const QModelIndex& index, const ConceptNode& node);
+    void removeNode(const QModelIndex& index);
 
     /**
-     * @brief 根据索引获取节点
+     * @brief 通知节点数据已在概念图中更新
      * @param index 模型索引
-     * @return 节点指针，如果不存在则返回 nullptr
      */
-    ConceptNode* nodeAt(const QModelIndex& index);
+    void updateNode(const QModelIndex& index);
 
     /**
-     * @brief 根据索引获取节点（常量版本）
+     * @brief 根据索引获取节点（只读）
      * @param index 模型索引
      * @return 节点指针，如果不存在则返回 nullptr
      */
     const ConceptNode* nodeAt(const QModelIndex& index) const;
 
     /**
-     * @brief 根据ID获取节点
+     * @brief 根据ID获取节点（只读）
      * @param id 节点ID
      * @return 节点指针，如果不存在则返回 nullptr
      */
-    ConceptNode* nodeById(const QString& id);
+    const ConceptNode* nodeById(NodeId id) const;
 
     /**
-     * @brief 根据ID获取节点（常量版本）
-     * @param id 节点ID
-     * @return 节点指针，如果不存在则返回 nullptr
-     */
-    const ConceptNode* nodeById(const QString& id) const;
-
-    /**
-     * @brief 获取所有节点
+     * @brief 获取所有节点（按行顺序复制）
      * @return 节点列表
      */
-    QVector<ConceptNode> nodes() const { return m_nodes; }
+    QVector<ConceptNode> nodes() const;
 
     /**
      * @brief 清空所有节点
@@ -138,17 +133,16 @@ public:
     void clear();
 
     /**
-     * @brief 设置节点列表
-     * @param nodes 节点列表
+     * @brief 按概念图数据重新生成所有行
      */
-    void setNodes(const QVector<ConceptNode>& nodes);
+    void reload();
 
     /**
      * @brief 根据ID查找节点索引
      * @param id 节点ID
      * @return 模型索引
      */
-    QModelIndex findIndexById(const QString& id) const;
+    QModelIndex findIndexById(NodeId id) const;
 
 signals:
     /**
@@ -161,7 +155,7 @@ signals:
      * @brief 节点删除信号
      * @param nodeId 删除的节点ID
      */
-    void nodeRemoved(const QString& nodeId);
+    void nodeRemoved(NodeId nodeId);
 
     /**
      * @brief 节点更新信号
@@ -169,9 +163,16 @@ signals:
      */
     void nodeUpdated(const ConceptNode& node);
 
+    /**
+     * @brief 通过表格编辑修改概念图数据后发出的信号
+     * @param changes 变更记录
+     */
+    void changesCommitted(const ChangeSet& changes);
+
 private:
-    QVector<ConceptNode> m_nodes;         // 节点列表
-    QMap<QString, int> m_nodeIndexMap;    // 节点ID到索引的映射
+    ConceptMap* m_map;                    // 概念图数据（不拥有）
+    QVector<NodeId> m_rows;               // 每行对应的节点ID
+    QHash<NodeId, int> m_nodeIndexMap;    // 节点ID到索引的映射
 };
 
 #endif // NODEMODEL_H
@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 #include "deleteedgecommand.h"
 #include "deletenodecommand.h"
+#include "textlayoutcache.h"
 #include <QMenuBar>
 #include <QStatusBar>
 #include <QMessageBox>
@@ -10,9 +11,15 @@
 #include <QAction>
 #include <QApplication>
 #include <QLabel>
+#include <QProgressBar>
+#include <QToolButton>
 #include <QTimer>
 #include <QDockWidget>
 #include <QQueue>
+#include <QIcon>
+#include <QPixmap>
+#include <QPushButton>
+#include <QActionGroup>
 
 /**
  * @brief 构造函数 - 创建主窗口
@@ -27,6 +34,11 @@ MainWindow::MainWindow(QWidget* parent)
     , m_splitter(nullptr)
     , m_isModified(false)
     , m_recentFilesMenu(nullptr)
+    , m_progressBar(nullptr)
+    , m_cancelButton(nullptr)
+    , m_cancelAction(nullptr)
+    , m_changeCount(0)
+    , m_savingChangeCount(0)
 {
     // 设置窗口属性
     setWindowTitle("ConceptMap - 概念图软件");
@@ -38,7 +50,6 @@ MainWindow::MainWindow(QWidget* parent)
 
     // 创建新概念图（不调用 newFile，避免启动时弹出对话框）
     m_mapModel.newMap();
-    m_scene->setConceptMap(m_mapModel.conceptMap());
     m_currentFilePath.clear();
     m_isModified = false;
     updateWindowTitle();
@@ -58,6 +69,12 @@ MainWindow::~MainWindow()
 void MainWindow::closeEvent(QCloseEvent* event)
 {
     if (maybeSave()) {
+        // 正在进行的保存和导出等它完成，加载直接放弃
+        if (m_mapModel.isLoading()) {
+            m_mapModel.fileTask()->cancel();
+        }
+        m_mapModel.fileTask()->waitForFinished();
+        m_fileManager.exportTask()->waitForFinished();
         event->accept();
     } else {
         event->ignore();
@@ -118,6 +135,7 @@ void MainWindow::createMenuBar()
 
     // 最近文件菜单
     m_recentFilesMenu = fileMenu->addMenu("最近文件(&R)");
+    m_recentFilesMenu->setToolTipsVisible(true);
     updateRecentFilesMenu();
 
     fileMenu->addSeparator();
@@ -139,6 +157,13 @@ void MainWindow::createMenuBar()
 
     fileMenu->addSeparator();
 
+    // 取消后台的打开、保存或导出
+    m_cancelAction = fileMenu->addAction("取消后台操作(&B)");
+    m_cancelAction->setEnabled(false);
+    connect(m_cancelAction, &QAction::triggered, this, &MainWindow::cancelBackgroundTask);
+
+    fileMenu->addSeparator();
+
     QAction* exitAction = fileMenu->addAction("退出(&X)");
     exitAction->setShortcut(QKeySequence::Quit);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
@@ -197,6 +222,41 @@ void MainWindow::createMenuBar()
     autoLayoutAction->setShortcut(QKeySequence("Ctrl+L"));
     connect(autoLayoutAction, &QAction::triggered, this, &MainWindow::autoLayout);
 
+    viewMenu->addSeparator();
+
+    // 视口更新模式，可切换后在渲染统计中比较重绘耗时和面积（视图此时还没有创建，
+    // 初始勾选与 GraphicsView 的默认设置一致：智能更新、缓存背景）
+    QMenu* updateModeMenu = viewMenu->addMenu("视口更新模式(&U)");
+    QActionGroup* updateModeGroup = new QActionGroup(this);
+    const QList<QPair<QString, QGraphicsView::ViewportUpdateMode>> updateModes = {
+        { "智能(&S)", QGraphicsView::SmartViewportUpdate },
+        { "最小区域(&M)", QGraphicsView::MinimalViewportUpdate },
+        { "边界矩形(&B)", QGraphicsView::BoundingRectViewportUpdate },
+        { "整个视口(&F)", QGraphicsView::FullViewportUpdate }
+    };
+    for (const auto& updateMode : updateModes) {
+        QAction* action = updateModeMenu->addAction(updateMode.first);
+        action->setCheckable(true);
+        action->setChecked(updateMode.second == QGraphicsView::SmartViewportUpdate);
+        updateModeGroup->addAction(action);
+        const QGraphicsView::ViewportUpdateMode mode = updateMode.second;
+        connect(action, &QAction::triggered, this, [this, mode]() {
+            m_view->setViewportUpdateMode(mode);
+            m_view->resetPaintStatistics();
+        });
+    }
+
+    QAction* backgroundCacheAction = viewMenu->addAction("缓存背景(&G)");
+    backgroundCacheAction->setCheckable(true);
+    backgroundCacheAction->setChecked(true);
+    connect(backgroundCacheAction, &QAction::toggled, this, [this](bool checked) {
+        m_view->setBackgroundCached(checked);
+        m_view->resetPaintStatistics();
+    });
+
+    QAction* statisticsAction = viewMenu->addAction("渲染统计(&D)...");
+    connect(statisticsAction, &QAction::triggered, this, &MainWindow::showRenderStatistics);
+
     // 帮助菜单
     QMenu* helpMenu = menuBar()->addMenu("帮助(&H)");
 
@@ -230,6 +290,19 @@ void MainWindow::createStatusBar()
     QLabel* statusLabel = new QLabel("就绪");
     statusBar()->addWidget(statusLabel);
 
+    // 后台操作的进度和取消按钮，只在操作进行时显示
+    m_progressBar = new QProgressBar;
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setMaximumWidth(200);
+    m_progressBar->setVisible(false);
+    statusBar()->addPermanentWidget(m_progressBar);
+
+    m_cancelButton = new QToolButton;
+    m_cancelButton->setDefaultAction(m_cancelAction);
+    m_cancelButton->setText("取消");
+    m_cancelButton->setVisible(false);
+    statusBar()->addPermanentWidget(m_cancelButton);
+
     m_zoomLabel = new QLabel("缩放: 100%");
     statusBar()->addPermanentWidget(m_zoomLabel);
 }
@@ -239,8 +312,9 @@ void MainWindow::createStatusBar()
  */
 void MainWindow::createCentralWidget()
 {
-    // 创建图形场景
+    // 创建图形场景，与模型共用同一份概念图数据
     m_scene = new GraphicsScene(this);
+    m_scene->setConceptMap(&m_mapModel.editableMap());
 
     // 创建图形视图
     m_view = new GraphicsView(m_scene, this);
@@ -253,11 +327,27 @@ void MainWindow::createCentralWidget()
         m_zoomLabel->setText(QString("缩放: %1%").arg(qRound(scale * 100)));
     });
 
+    // 瓦片概念图跟随可见区域载入和卸载瓦片
+    connect(m_view, &GraphicsView::visibleRectChanged, &m_mapModel, &MapModel::pageRegion);
+
     // 连接场景信号
     connect(m_scene, &GraphicsScene::sceneChanged, this, [this]() {
         m_isModified = true;
         updateWindowTitle();
     });
+
+    // 一方修改共享数据后，另一方按变更记录增量同步
+    connect(m_scene, &GraphicsScene::changesCommitted, &m_mapModel, &MapModel::applyChanges);
+    connect(&m_mapModel, &MapModel::changesCommitted, m_scene, &GraphicsScene::applyChanges);
+    connect(&m_mapModel, &MapModel::mapReset, m_scene, &GraphicsScene::refreshScene);
+
+    // 大概念图的图形项分批创建，状态栏显示进度
+    connect(m_scene, &GraphicsScene::populationProgress, this, [this](int created, int total) {
+        statusBar()->showMessage(QString("正在显示图形项: %1/%2").arg(created).arg(total));
+    });
+    connect(m_scene, &GraphicsScene::populationFinished, this, [this]() {
+        statusBar()->showMessage("已显示全部图形项", 3000);
+    });
 }
 
 /**
@@ -278,8 +368,9 @@ void MainWindow::createPropertyPanel()
         // 更新选中节点的文本
         QList<GraphicsNode*> selectedNodes = m_scene->selectedNodes();
         if (!selectedNodes.isEmpty()) {
-            GraphicsNode* node = selectedNodes.first();
-            node->setText(text);
+            ConceptNode node = selectedNodes.first()->node();
+            node.setText(text);
+            m_scene->updateNode(node);
             m_isModified = true;
             updateWindowTitle();
         }
@@ -289,8 +380,9 @@ void MainWindow::createPropertyPanel()
         // 更新选中节点的颜色
         QList<GraphicsNode*> selectedNodes = m_scene->selectedNodes();
         if (!selectedNodes.isEmpty()) {
-            GraphicsNode* node = selectedNodes.first();
-            node->setColor(color);
+            ConceptNode node = selectedNodes.first()->node();
+            node.setColor(color);
+            m_scene->updateNode(node);
             m_isModified = true;
             updateWindowTitle();
         }
@@ -304,16 +396,39 @@ void MainWindow::connectSignals()
 {
     // 连接文件管理器信号
     connect(&m_fileManager, &FileManager::recentFilesChanged, this, &MainWindow::updateRecentFilesMenu);
+    connect(&m_thumbnails, &ThumbnailProvider::thumbnailReady, this, &MainWindow::updateRecentFilesMenu);
+
+    // 后台的打开、保存和导出：进度显示在状态栏，结果通过信号返回
+    for (BackgroundTask* task : { m_mapModel.fileTask(), m_fileManager.exportTask() }) {
+        connect(task, &BackgroundTask::started, this, &MainWindow::updateTaskProgress);
+        connect(task, &BackgroundTask::progressChanged, m_progressBar, &QProgressBar::setValue);
+        connect(task, &BackgroundTask::finished, this, &MainWindow::updateTaskProgress);
+    }
+    connect(&m_mapModel, &MapModel::loadFinished, this, &MainWindow::onLoadFinished);
+    connect(&m_mapModel, &MapModel::saveFinished, this, &MainWindow::onSaveFinished);
+    connect(&m_fileManager, &FileManager::exportFinished, this, &MainWindow::onExportFinished);
+
+    // 记录修改次数，保存完成时据此判断保存期间是否又有修改
+    connect(&m_mapModel, &MapModel::mapChanged, this, [this]() {
+        ++m_changeCount;
+    });
+
+    // 后台整理日志失败时提示（日志仍然保留，数据不会丢失）
+    connect(&m_mapModel, &MapModel::compactionFinished, this, [this](const QString& filePath, bool success) {
+        if (!success) {
+            statusBar()->showMessage(QString("整理保存日志失败: %1").arg(filePath), 5000);
+        }
+    });
 
     // 连接场景选中信号
-    connect(m_scene, &GraphicsScene::nodeSelected, [this](const QString& nodeId) {
+    connect(m_scene, &GraphicsScene::nodeSelected, [this](NodeId nodeId) {
         GraphicsNode* node = m_scene->graphicsNodeById(nodeId);
         if (node) {
             m_propertyPanel->setNode(node->node());
         }
     });
 
-    connect(m_scene, &GraphicsScene::edgeSelected, [this](const QString& edgeId) {
+    connect(m_scene, &GraphicsScene::edgeSelected, [this](EdgeId edgeId) {
         GraphicsEdge* edge = m_scene->graphicsEdgeById(edgeId);
         if (edge) {
             m_propertyPanel->setEdge(edge->edge());
@@ -328,7 +443,6 @@ void MainWindow::newFile()
 {
     if (maybeSave()) {
         m_mapModel.newMap();
-        m_scene->setConceptMap(m_mapModel.conceptMap());
         m_currentFilePath.clear();
         m_isModified = false;
         m_undoStack.clear();
@@ -344,17 +458,7 @@ void MainWindow::openFile()
     if (maybeSave()) {
         QString filePath = QFileDialog::getOpenFileName(this, "打开概念图", "", m_fileManager.fileFilter());
         if (!filePath.isEmpty()) {
-            if (m_mapModel.loadFromFile(filePath)) {
-                m_scene->setConceptMap(m_mapModel.conceptMap());
-                m_currentFilePath = filePath;
-                m_isModified = false;
-                m_undoStack.clear();
-                m_fileManager.addToRecentFiles(filePath);
-                updateWindowTitle();
-                statusBar()->showMessage(QString("已打开: %1").arg(filePath), 3000);
-            } else {
-                QMessageBox::warning(this, "错误", "无法打开文件");
-            }
+            openPath(filePath);
         }
     }
 }
@@ -366,16 +470,21 @@ void MainWindow::saveFile()
 {
     if (m_currentFilePath.isEmpty()) {
         saveAsFile();
-    } else {
-        // 同步场景数据到模型
-        m_mapModel.setConceptMap(m_scene->conceptMap());
-        if (m_mapModel.saveToFile(m_currentFilePath)) {
+    } else if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+    } else if (m_mapModel.canSaveIncrementally(m_currentFilePath)) {
+        // 只把上次保存以来的修改追加到日志，耗时与修改量有关而与概念图大小无关
+        if (m_mapModel.saveIncremental(m_currentFilePath)) {
             m_isModified = false;
             updateWindowTitle();
             statusBar()->showMessage(QString("已保存: %1").arg(m_currentFilePath), 3000);
         } else {
             QMessageBox::warning(this, "错误", "无法保存文件");
         }
+    } else {
+        // 需要完整保存时在后台写入快照
+        m_savingChangeCount = m_changeCount;
+        m_mapModel.saveToFileAsync(m_currentFilePath);
     }
 }
 
@@ -384,19 +493,15 @@ void MainWindow::saveFile()
  */
 void MainWindow::saveAsFile()
 {
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
     QString filePath = QFileDialog::getSaveFileName(this, "保存概念图", "", m_fileManager.fileFilter());
     if (!filePath.isEmpty()) {
-        // 同步场景数据到模型
-        m_mapModel.setConceptMap(m_scene->conceptMap());
-        if (m_mapModel.saveToFile(filePath)) {
-            m_currentFilePath = filePath;
-            m_isModified = false;
-            m_fileManager.addToRecentFiles(filePath);
-            updateWindowTitle();
-            statusBar()->showMessage(QString("已保存: %1").arg(filePath), 3000);
-        } else {
-            QMessageBox::warning(this, "错误", "无法保存文件");
-        }
+        m_savingChangeCount = m_changeCount;
+        m_mapModel.saveToFileAsync(filePath);
     }
 }
 
@@ -405,13 +510,14 @@ void MainWindow::saveAsFile()
  */
 void MainWindow::exportImage()
 {
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
     QString filePath = QFileDialog::getSaveFileName(this, "导出为图片", "", m_fileManager.imageFilter());
     if (!filePath.isEmpty()) {
-        if (m_fileManager.exportToImage(filePath, m_scene)) {
-            statusBar()->showMessage(QString("已导出: %1").arg(filePath), 3000);
-        } else {
-            QMessageBox::warning(this, "错误", "无法导出图片");
-        }
+        m_fileManager.exportToImageAsync(filePath, m_scene);
     }
 }
 
@@ -420,13 +526,14 @@ void MainWindow::exportImage()
  */
 void MainWindow::exportPDF()
 {
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
     QString filePath = QFileDialog::getSaveFileName(this, "导出为PDF", "", "PDF 文件 (*.pdf)");
     if (!filePath.isEmpty()) {
-        if (m_fileManager.exportToPDF(filePath, m_scene)) {
-            statusBar()->showMessage(QString("已导出: %1").arg(filePath), 3000);
-        } else {
-            QMessageBox::warning(this, "错误", "无法导出PDF");
-        }
+        m_fileManager.exportToPDFAsync(filePath, m_scene);
     }
 }
 
@@ -435,13 +542,14 @@ void MainWindow::exportPDF()
  */
 void MainWindow::exportSVG()
 {
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
     QString filePath = QFileDialog::getSaveFileName(this, "导出为SVG", "", "SVG 文件 (*.svg)");
     if (!filePath.isEmpty()) {
-        if (m_fileManager.exportToSVG(filePath, m_scene)) {
-            statusBar()->showMessage(QString("已导出: %1").arg(filePath), 3000);
-        } else {
-            QMessageBox::warning(this, "错误", "无法导出SVG");
-        }
+        m_fileManager.exportToSVGAsync(filePath, m_scene);
     }
 }
 
@@ -450,14 +558,128 @@ void MainWindow::exportSVG()
  */
 void MainWindow::exportCmap()
 {
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
     QString filePath = QFileDialog::getSaveFileName(this, "导出为Cmap", "", "Cmap 文件 (*.cmap)");
     if (!filePath.isEmpty()) {
-        if (m_fileManager.exportToCmap(filePath, m_mapModel.conceptMap())) {
-            statusBar()->showMessage(QString("已导出: %1").arg(filePath), 3000);
-        } else {
-            QMessageBox::warning(this, "错误", "无法导出Cmap");
+        m_fileManager.exportToCmapAsync(filePath, m_mapModel.snapshot());
+    }
+}
+
+/**
+ * @brief 在后台打开指定文件
+ * @param filePath 文件路径
+ */
+void MainWindow::openPath(const QString& filePath)
+{
+    if (isBusy()) {
+        statusBar()->showMessage("请等待当前操作完成", 3000);
+        return;
+    }
+
+    m_mapModel.loadFromFileAsync(filePath);
+}
+
+/**
+ * @brief 后台打开结束
+ * @param filePath 文件路径
+ * @param success 是否成功
+ */
+void MainWindow::onLoadFinished(const QString& filePath, bool success)
+{
+    if (success) {
+        m_currentFilePath = filePath;
+        m_isModified = false;
+        m_undoStack.clear();
+        m_fileManager.addToRecentFiles(filePath);
+        updateWindowTitle();
+        statusBar()->showMessage(QString("已打开: %1").arg(filePath), 3000);
+
+        // 瓦片概念图只载入了初始区域，视图移到那里，之后跟随可见区域分页
+        if (m_mapModel.isTiled()) {
+            m_view->fitInView();
         }
+    } else if (m_mapModel.fileTask()->isCanceled()) {
+        statusBar()->showMessage(QString("已取消打开: %1").arg(filePath), 3000);
+    } else {
+        QMessageBox::warning(this, "错误", "无法打开文件");
+    }
+}
+
+/**
+ * @brief 后台保存结束
+ * @param filePath 文件路径
+ * @param success 是否成功
+ */
+void MainWindow::onSaveFinished(const QString& filePath, bool success)
+{
+    // 保存期间暂停了分页，补上这段时间的视图变化
+    m_mapModel.pageRegion(m_view->visibleSceneRect());
+
+    if (success) {
+        m_currentFilePath = filePath;
+        // 保存的是开始时的快照，保存期间又有修改时仍然标记为已修改
+        m_isModified = (m_changeCount != m_savingChangeCount);
+        m_fileManager.addToRecentFiles(filePath);
+        updateWindowTitle();
+        statusBar()->showMessage(QString("已保存: %1").arg(filePath), 3000);
+    } else if (m_mapModel.fileTask()->isCanceled()) {
+        statusBar()->showMessage(QString("已取消保存: %1").arg(filePath), 3000);
+    } else {
+        QMessageBox::warning(this, "错误", "无法保存文件");
+    }
+}
+
+/**
+ * @brief 后台导出结束
+ * @param filePath 导出的文件路径
+ * @param success 是否成功
+ */
+void MainWindow::onExportFinished(const QString& filePath, bool success)
+{
+    if (success) {
+        statusBar()->showMessage(QString("已导出: %1").arg(filePath), 3000);
+    } else if (m_fileManager.exportTask()->isCanceled()) {
+        statusBar()->showMessage(QString("已取消导出: %1").arg(filePath), 3000);
+    } else {
+        QMessageBox::warning(this, "错误", QString("无法导出: %1").arg(filePath));
+    }
+}
+
+/**
+ * @brief 取消正在进行的后台操作
+ */
+void MainWindow::cancelBackgroundTask()
+{
+    m_mapModel.fileTask()->cancel();
+    m_fileManager.exportTask()->cancel();
+}
+
+/**
+ * @brief 后台操作开始或结束时更新状态栏的进度条和取消按钮
+ */
+void MainWindow::updateTaskProgress()
+{
+    const bool busy = isBusy();
+    if (busy) {
+        BackgroundTask* task = m_mapModel.fileTask()->isRunning() ? m_mapModel.fileTask() : m_fileManager.exportTask();
+        m_progressBar->setFormat(task->description() + " %p%");
     }
+    m_progressBar->setVisible(busy);
+    m_cancelButton->setVisible(busy);
+    m_cancelAction->setEnabled(busy);
+}
+
+/**
+ * @brief 检查是否有后台操作正在进行
+ * @return 如果有后台操作返回 true，否则返回 false
+ */
+bool MainWindow::isBusy()
+{
+    return m_mapModel.fileTask()->isRunning() || m_fileManager.exportTask()->isRunning();
 }
 
 /**
@@ -591,14 +813,61 @@ void MainWindow::fitView()
     }
 }
 
+/**
+ * @brief 显示渲染统计（文本排版缓存、图形项位图缓存和视口绘制）
+ */
+void MainWindow::showRenderStatistics()
+{
+    const TextLayoutCache::Statistics text = TextLayoutCache::statistics();
+    const qint64 lookups = text.hits + text.misses;
+    const double hitRate = lookups > 0 ? 100.0 * text.hits / lookups : 0.0;
+    const RenderCacheManager::Statistics items = m_scene->renderCache().statistics();
+    const GraphicsView::PaintStatistics paint = m_view->paintStatistics();
+    const qint64 frames = qMax<qint64>(1, paint.frames);
+
+    QMessageBox box(this);
+    box.setWindowTitle("渲染统计");
+    box.setText(QString("<b>文本排版缓存</b><br>"
+                        "命中: %1<br>未命中: %2<br>命中率: %3%<br>"
+                        "条目: %4<br>占用: %5 / %6 KiB<br><br>"
+                        "<b>图形项位图缓存</b><br>"
+                        "启用缓存的图形项: %7<br>占用: %8 / %9 KiB<br>淘汰: %10<br><br>"
+                        "<b>视口绘制</b>（切换更新模式后清零）<br>"
+                        "绘制次数: %11<br>平均耗时: %12 ms<br>平均重绘: %13 万像素")
+                    .arg(text.hits)
+                    .arg(text.misses)
+                    .arg(hitRate, 0, 'f', 1)
+                    .arg(text.count)
+                    .arg(text.cost / 1024)
+                    .arg(TextLayoutCache::MaxCost / 1024)
+                    .arg(items.cachedItems)
+                    .arg(items.cost / 1024)
+                    .arg(items.budget / 1024)
+                    .arg(items.evictions)
+                    .arg(paint.frames)
+                    .arg(paint.nanoseconds / 1e6 / frames, 0, 'f', 2)
+                    .arg(paint.pixels / 1e4 / frames, 0, 'f', 1));
+    QPushButton* clearButton = box.addButton("清空缓存", QMessageBox::ResetRole);
+    box.addButton(QMessageBox::Close);
+    box.exec();
+
+    if (box.clickedButton() == clearButton) {
+        TextLayoutCache::clear();
+        m_scene->renderCache().clear();
+        m_view->resetPaintStatistics();
+        m_scene->update();
+    }
+}
+
 /**
  * @brief 自动排版
  */
 void MainWindow::autoLayout()
 {
-    // 获取所有节点和连接线
-    QVector<ConceptNode> nodes = m_mapModel.conceptMap().nodes();
-    QVector<ConceptEdge> edges = m_mapModel.conceptMap().edges();
+    // 获取所有节点和连接线（直接遍历共享数据，不复制）
+    const ConceptMap& map = m_scene->conceptMap();
+    const ChunkedVector<ConceptNode>& nodes = map.allNodes();
+    const ChunkedVector<ConceptEdge>& edges = map.allEdges();
     
     if (nodes.isEmpty()) {
         QMessageBox::information(this, "自动排版", "没有节点需要排版");
@@ -606,14 +875,14 @@ void MainWindow::autoLayout()
     }
     
     // 构建邻接表：节点ID -> 子节点列表
-    QMap<QString, QVector<QString>> adjacencyList;
+    QHash<NodeId, QVector<NodeId>> adjacencyList;
     for (const ConceptEdge& edge : edges) {
         adjacencyList[edge.sourceNodeId()].append(edge.targetNodeId());
     }
     
     // 识别根节点（没有入边的节点）
-    QVector<QString> rootNodes;
-    QSet<QString> hasIncomingEdge;
+    QVector<NodeId> rootNodes;
+    QSet<NodeId> hasIncomingEdge;
     for (const ConceptEdge& edge : edges) {
         hasIncomingEdge.insert(edge.targetNodeId());
     }
@@ -629,8 +898,8 @@ void MainWindow::autoLayout()
     }
     
     // 使用BFS遍历节点，按层级组织
-    QMap<QString, int> nodeLevel;  // 节点 -> 层级
-    QList<QString> visitOrder;  // 访问顺序
+    QHash<NodeId, int> nodeLevel;  // 节点 -> 层级
+    QList<NodeId> visitOrder;   // 访问顺序
     
     // 初始化所有节点的层级为-1（未访问）
     for (const ConceptNode& node : nodes) {
@@ -638,9 +907,9 @@ void MainWindow::autoLayout()
     }
     
     // 从根节点开始BFS
-    for (const QString& rootId : rootNodes) {
+    for (NodeId rootId : rootNodes) {
         if (nodeLevel[rootId] == -1) {
-            QList<QString> levelQueue;
+            QList<NodeId> levelQueue;
             levelQueue.append(rootId);
             nodeLevel[rootId] = 0;
             visitOrder.append(rootId);
@@ -648,12 +917,12 @@ void MainWindow::autoLayout()
             // 按层级遍历
             int currentLevel = 0;
             while (!levelQueue.isEmpty()) {
-                QString currentId = levelQueue.takeFirst();
+                NodeId currentId = levelQueue.takeFirst();
                 currentLevel = nodeLevel[currentId];
                 
                 // 遍历子节点
-                QVector<QString> children = adjacencyList.value(currentId);
-                for (const QString& childId : children) {
+                QVector<NodeId> children = adjacencyList.value(currentId);
+                for (NodeId childId : children) {
                     if (nodeLevel[childId] == -1) {
                         nodeLevel[childId] = currentLevel + 1;
                         levelQueue.append(childId);
@@ -678,15 +947,15 @@ void MainWindow::autoLayout()
         }
     }
     
-    // 按层级排列节点
-    for (const QString& nodeId : visitOrder) {
+    // 按层级排列节点（批量修改，提交时一次性同步图形项和模型）
+    m_scene->beginTransaction();
+    for (NodeId nodeId : visitOrder) {
         int level = nodeLevel[nodeId];
-        ConceptNode* node = m_mapModel.conceptMap().nodeById(nodeId);
         
-        if (node) {
+        if (map.hasNode(nodeId)) {
             // 计算该层中当前节点的位置
             int positionInLevel = 0;
-            for (const QString& otherId : visitOrder) {
+            for (NodeId otherId : visitOrder) {
                 if (otherId == nodeId) {
                     break;
                 }
@@ -703,19 +972,12 @@ void MainWindow::autoLayout()
             qreal newX = levelStartX + positionInLevel * nodeSpacing;
             qreal newY = startY + level * levelSpacing;
             
-            // 更新数据模型中的节点位置
-            node->setPos(QPointF(newX, newY));
-            
-            // 更新图形节点对象的位置
-            GraphicsNode* graphicsNode = m_scene->graphicsNodeById(nodeId);
-            if (graphicsNode) {
-                graphicsNode->setPos(QPointF(newX, newY));
-            }
+            // 更新节点位置
+            m_scene->editableMap().setNodePos(nodeId, QPointF(newX, newY));
         }
     }
-    
-    // 同步场景数据到模型
-    m_mapModel.setConceptMap(m_scene->conceptMap());
+    // 提交时场景更新图形项，并通过 changesCommitted 通知模型
+    m_scene->commitTransaction();
     
     // 标记为已修改
     m_isModified = true;
@@ -749,17 +1011,7 @@ void MainWindow::loadRecentFile()
     if (action) {
         QString filePath = action->data().toString();
         if (maybeSave()) {
-            if (m_mapModel.loadFromFile(filePath)) {
-                m_scene->setConceptMap(m_mapModel.conceptMap());
-                m_currentFilePath = filePath;
-                m_isModified = false;
-                m_undoStack.clear();
-                m_fileManager.addToRecentFiles(filePath);
-                updateWindowTitle();
-                statusBar()->showMessage(QString("已打开: %1").arg(filePath), 3000);
-            } else {
-                QMessageBox::warning(this, "错误", "无法打开文件");
-            }
+            openPath(filePath);
         }
     }
 }
@@ -775,6 +1027,13 @@ void MainWindow::updateRecentFilesMenu()
     for (const QString& filePath : recentFiles) {
         QAction* action = m_recentFilesMenu->addAction(QFileInfo(filePath).fileName());
         action->setData(filePath);
+        action->setToolTip(filePath);
+
+        // 缩略图在后台生成，生成后 thumbnailReady 会再次更新菜单
+        const QImage thumbnail = m_thumbnails.thumbnail(filePath);
+        if (!thumbnail.isNull()) {
+            action->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+        }
         connect(action, &QAction::triggered, this, &MainWindow::loadRecentFile);
     }
 
@@ -811,7 +1070,13 @@ bool MainWindow::maybeSave()
             QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel);
 
         if (ret == QMessageBox::Save) {
+            if (isBusy()) {
+                statusBar()->showMessage("请等待当前操作完成", 3000);
+                return false;
+            }
+            // 完整保存在后台进行，这里需要等它完成才知道结果
             saveFile();
+            m_mapModel.fileTask()->waitForFinished();
             return !m_isModified;
         } else if (ret == QMessageBox::Cancel) {
             return false;
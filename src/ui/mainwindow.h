@@ -4,11 +4,14 @@
 #include <QMainWindow>
 #include <QUndoStack>
 #include <QSplitter>
+#include <QProgressBar>
+#include <QToolButton>
 #include "graphicsscene.h"
 #include "graphicsview.h"
 #include "mapmodel.h"
 #include "stylemanager.h"
 #include "filemanager.h"
+#include "thumbnailprovider.h"
 #include "toolbar.h"
 #include "propertypanel.h"
 
@@ -212,6 +215,11 @@ private:
      */
     void autoLayout();
 
+    /**
+     * @brief 显示渲染统计（文本排版缓存、图形项位图缓存和视口绘制）
+     */
+    void showRenderStatistics();
+
     // 导出操作
     /**
      * @brief 导出为Cmap格式
@@ -245,12 +253,57 @@ private:
      */
     bool maybeSave();
 
+    // 后台操作
+    /**
+     * @brief 在后台打开指定文件
+     * @param filePath 文件路径
+     */
+    void openPath(const QString& filePath);
+
+    /**
+     * @brief 后台打开结束
+     * @param filePath 文件路径
+     * @param success 是否成功
+     */
+    void onLoadFinished(const QString& filePath, bool success);
+
+    /**
+     * @brief 后台保存结束
+     * @param filePath 文件路径
+     * @param success 是否成功
+     */
+    void onSaveFinished(const QString& filePath, bool success);
+
+    /**
+     * @brief 后台导出结束
+     * @param filePath 导出的文件路径
+     * @param success 是否成功
+     */
+    void onExportFinished(const QString& filePath, bool success);
+
+    /**
+     * @brief 取消正在进行的后台操作
+     */
+    void cancelBackgroundTask();
+
+    /**
+     * @brief 后台操作开始或结束时更新状态栏的进度条和取消按钮
+     */
+    void updateTaskProgress();
+
+    /**
+     * @brief 检查是否有后台操作正在进行
+     * @return 如果有后台操作返回 true，否则返回 false
+     */
+    bool isBusy();
+
     GraphicsScene* m_scene;              // 图形场景
     GraphicsView* m_view;                // 图形视图
     MapModel m_mapModel;                 // 概念图模型
     QUndoStack m_undoStack;              // 撤销栈
     StyleManager m_styleManager;         // 样式管理器
     FileManager m_fileManager;           // 文件管理器
+    ThumbnailProvider m_thumbnails;      // 最近文件的缩略图
     ToolBar* m_toolBar;                  // 工具栏
     PropertyPanel* m_propertyPanel;      // 属性面板
     QSplitter* m_splitter;               // 分割器
@@ -258,6 +311,11 @@ private:
     bool m_isModified;                   // 是否已修改
     QMenu* m_recentFilesMenu;            // 最近文件菜单
     QLabel* m_zoomLabel;                // 缩放标签
+    QProgressBar* m_progressBar;         // 后台操作进度条
+    QToolButton* m_cancelButton;         // 后台操作取消按钮
+    QAction* m_cancelAction;             // 取消后台操作
+    quint64 m_changeCount;               // 概念图修改次数
+    quint64 m_savingChangeCount;         // 开始后台保存时的修改次数
 };
 
 #endif // MAINWINDOW_H
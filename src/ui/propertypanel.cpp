@@ -257,7 +257,7 @@ void PropertyPanel::updateNodeProperties()
     m_nodeHeightSpinBox->blockSignals(true);
 
     // 更新节点属性
-    m_nodeIdEdit->setText(m_currentNode.id());
+    m_nodeIdEdit->setText(IdRegistry::toUuid(m_currentNode.id()));
     m_nodeTextEdit->setText(m_currentNode.text());
     m_nodeXSpinBox->setValue(m_currentNode.x());
     m_nodeYSpinBox->setValue(m_currentNode.y());
@@ -282,9 +282,9 @@ void PropertyPanel::updateEdgeProperties()
     m_edgeLabelEdit->blockSignals(true);
 
     // 更新连接线属性
-    m_edgeIdEdit->setText(m_currentEdge.id());
-    m_edgeSourceNodeIdEdit->setText(m_currentEdge.sourceNodeId());
-    m_edgeTargetNodeIdEdit->setText(m_currentEdge.targetNodeId());
+    m_edgeIdEdit->setText(IdRegistry::toUuid(m_currentEdge.id()));
+    m_edgeSourceNodeIdEdit->setText(IdRegistry::toUuid(m_currentEdge.sourceNodeId()));
+    m_edgeTargetNodeIdEdit->setText(IdRegistry::toUuid(m_currentEdge.targetNodeId()));
     m_edgeLabelEdit->setText(m_currentEdge.label());
     m_edgeColorLabel->setStyleSheet(QString("background-color: %1").arg(m_currentEdge.color().name()));
 